@@ -0,0 +1,245 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+/// @file   bake/bake.c
+/// @brief  Bakes the data of a module into a module bundle, see egolib/FileFormats/module_bundle_file.h
+/// @details The game reads baked entries instead of their source files as long as the source
+///          files did not change, so a module only needs to be baked again to speed it up.
+/// @remark  Only the MD2 models of the module's objects are baked. A cold module load still parses
+///          all other module data from its sources:
+///          - the AI scripts, the profiles (data.txt, part*.txt, enchant.txt), passage.txt and the mesh
+///            arrays built from mesh.mpd, as their loaders depend on the game, which this tool does not link
+///          - wawalite.txt and spawn.txt, which are one small file each per module, and spawn.txt picks
+///            random skins while it is read
+///          Their entries can be added to the bundle with their own names once their loaders can run here.
+
+#include "egolib/egolib.h"
+#include "egolib/Graphics/MD2Model.hpp"
+#include "egolib/Graphics/ModelDescriptor.hpp"
+#include "egolib/Graphics/MD2Interpolator.hpp"
+
+//--------------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------------
+
+/// Bake the tris.md2 of all objects of a module into a bundle
+static size_t bake_module_models( const char *modname, module_bundle_t& bundle )
+{
+    // find the objects the same way as game_load_module_profiles(), so that the names of the entries match
+    STRING newloadname;
+    make_newloadname( modname, "objects", newloadname );
+
+    size_t count = 0;
+    vfs_search_context_t *ctxt = vfs_findFirst( newloadname, "obj", VFS_SEARCH_DIR );
+    const char *filehandle = vfs_search_context_get_current( ctxt );
+    while ( NULL != ctxt && VALID_CSTR( filehandle ) )
+    {
+        const std::string folderPath = filehandle;
+        const std::string modelPath = folderPath + "/tris.md2";
+
+        const Ego::VFS::FileStamp stamp = Ego::VFS::FileStamp::of( modelPath );
+        std::shared_ptr<MD2Model> md2Model = !stamp.isKnown() ? nullptr : Ego::ModelDescriptor::loadMD2( folderPath );
+        if ( md2Model )
+        {
+            std::vector<char> buffer;
+            bundle_writer_t writer( buffer );
+            md2Model->write( writer );
+            bundle.add( modelPath, stamp, buffer.data(), buffer.size() );
+            count++;
+        }
+        else
+        {
+            printf( "    skipping %s\n", modelPath.c_str() );
+        }
+
+        ctxt = vfs_findNext( &ctxt );
+        filehandle = vfs_search_context_get_current( ctxt );
+    }
+    vfs_findClose( &ctxt );
+
+    return count;
+}
+
+/// Append the object folders ( *.obj ) in a folder to a list
+static void find_object_folders( const char *folderPath, std::vector<std::string>& folders )
+{
+    vfs_search_context_t *ctxt = vfs_findFirst( folderPath, "obj", VFS_SEARCH_DIR );
+    const char *filehandle = vfs_search_context_get_current( ctxt );
+    while ( NULL != ctxt && VALID_CSTR( filehandle ) )
+    {
+        folders.push_back( filehandle );
+
+        ctxt = vfs_findNext( &ctxt );
+        filehandle = vfs_search_context_get_current( ctxt );
+    }
+    vfs_findClose( &ctxt );
+}
+
+/// Measure the MD2Interpolator kernels with the models of all modules and of the global objects
+static int benchmark_models()
+{
+    // find the objects of all modules and the global objects
+    std::vector<std::string> folders;
+    for ( const char *searchPath : { "mp_modules", "mp_data/globalobjects" } )
+    {
+        std::vector<std::string> parents;
+        vfs_search_context_t *ctxt = vfs_findFirst( searchPath, NULL, VFS_SEARCH_DIR );
+        const char *filehandle = vfs_search_context_get_current( ctxt );
+        while ( NULL != ctxt && VALID_CSTR( filehandle ) )
+        {
+            parents.push_back( filehandle );
+
+            ctxt = vfs_findNext( &ctxt );
+            filehandle = vfs_search_context_get_current( ctxt );
+        }
+        vfs_findClose( &ctxt );
+
+        for ( const std::string& parent : parents )
+        {
+            // modules keep their objects in a subfolder
+            find_object_folders( ( parent + "/objects" ).c_str(), folders );
+            find_object_folders( parent.c_str(), folders );
+        }
+    }
+
+    std::vector<std::shared_ptr<MD2Model>> models;
+    size_t frameVertexCount = 0;
+    for ( const std::string& folderPath : folders )
+    {
+        if ( !vfs_exists( folderPath + "/tris.md2" ) ) continue;
+
+        std::shared_ptr<MD2Model> md2Model = Ego::ModelDescriptor::loadMD2( folderPath );
+        if ( md2Model && md2Model->getFrames().size() > 1 )
+        {
+            frameVertexCount += md2Model->getVertexCount() * ( md2Model->getFrames().size() - 1 );
+            models.push_back( md2Model );
+        }
+    }
+    if ( models.empty() )
+    {
+        printf( "cannot find any models\n" );
+        return EXIT_FAILURE;
+    }
+    printf( "interpolating %" PRIuZ " models, %" PRIuZ " vertices per pass\n", models.size(), frameVertexCount );
+
+    // interpolate every frame of every model to the next frame
+    const int passCount = 20;
+    std::vector<MD2_InterpolatedVertex> vertices;
+    const MD2Interpolator::Kernel kernels[] = { MD2Interpolator::Kernel::Scalar, MD2Interpolator::Kernel::SSE, MD2Interpolator::Kernel::AVX };
+    for ( MD2Interpolator::Kernel kernel : kernels )
+    {
+        if ( !MD2Interpolator::isSupported( kernel ) )
+        {
+            printf( "%-8s not supported\n", MD2Interpolator::getName( kernel ) );
+            continue;
+        }
+
+        Ego::Time::Stopwatch stopwatch;
+        stopwatch.start();
+        for ( int pass = 0; pass < passCount; ++pass )
+        {
+            const float flip = ( pass + 1 ) / float( passCount + 1 );
+            for ( const std::shared_ptr<MD2Model>& md2Model : models )
+            {
+                const std::vector<MD2_Frame>& frames = md2Model->getFrames();
+                const int vertexCount = md2Model->getVertexCount();
+                vertices.resize( vertexCount );
+                for ( size_t frame = 0; frame + 1 < frames.size(); ++frame )
+                {
+                    MD2Interpolator::interpolate( kernel, vertices.data(), sizeof( MD2_InterpolatedVertex ), frames[frame].arrays, frames[frame + 1].arrays, 0, vertexCount - 1, flip );
+                }
+            }
+        }
+        stopwatch.stop();
+
+        const double seconds = stopwatch.elapsed();
+        printf( "%-8s %.1f million vertices/sec\n", MD2Interpolator::getName( kernel ), passCount * frameVertexCount / seconds / 1e6 );
+    }
+
+    return EXIT_SUCCESS;
+}
+
+//--------------------------------------------------------------------------------------------
+int SDL_main( int argcnt, char* argtext[] )
+{
+    STRING egoboo_path;
+    STRING modulename;
+
+    // grab the egoboo directory and the module name from the command line
+    if ( argcnt < 2 || argcnt > 3 )
+    {
+        printf( "USAGE: BAKE [PATH] MODULE ( without .MOD )\n" );
+        printf( "       BAKE [PATH] -benchmark ( measure the model interpolation )\n\n" );
+        return EXIT_SUCCESS;
+    }
+    else if ( argcnt < 3 )
+    {
+        snprintf( egoboo_path, SDL_arraysize( egoboo_path ), "%s", "." );
+        snprintf( modulename, SDL_arraysize( modulename ), "%s.mod", argtext[1] );
+    }
+    else
+    {
+        snprintf( egoboo_path, SDL_arraysize( egoboo_path ), "%s", argtext[1] );
+        snprintf( modulename, SDL_arraysize( modulename ), "%s.mod", argtext[2] );
+    }
+
+    // Only the virtual file system is needed, not the video and audio services of Ego::Core::System.
+    if ( 0 != vfs_init( argtext[0], egoboo_path ) )
+    {
+        printf( "cannot initialize the virtual file system\n" );
+        return EXIT_FAILURE;
+    }
+    setup_init_base_vfs_paths();
+    log_initialize( "/debug/bake_log.txt", LOG_DEBUG );
+
+    int result = EXIT_FAILURE;
+    if ( 0 == strcmp( argtext[argcnt - 1], "-benchmark" ) )
+    {
+        result = benchmark_models();
+    }
+    else if ( !setup_init_module_vfs_paths( modulename ) )
+    {
+        printf( "cannot find module %s\n", modulename );
+    }
+    else
+    {
+        STRING modname;
+        snprintf( modname, SDL_arraysize( modname ), "mp_modules/%s/", modulename );
+
+        module_bundle_t bundle;
+        const size_t modelCount = bake_module_models( modname, bundle );
+
+        STRING bundlename;
+        snprintf( bundlename, SDL_arraysize( bundlename ), "/modules/%s/gamedat/" MODULE_BUNDLE_FILENAME, modulename );
+        if ( bundle.save( bundlename ) )
+        {
+            printf( "baked %" PRIuZ " models into %s\n", modelCount, bundlename );
+            result = EXIT_SUCCESS;
+        }
+        else
+        {
+            printf( "cannot write %s\n", bundlename );
+        }
+    }
+
+    setup_clear_module_vfs_paths();
+    setup_clear_base_vfs_paths();
+    log_uninitialize();
+
+    return result;
+}
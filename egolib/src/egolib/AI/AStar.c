@@ -30,84 +30,266 @@
 
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
-#define MAX_ASTAR_NODES 512    //Maximum number of nodes to explore
-#define MAX_ASTAR_PATH  128    //Maximum length of the final path (before pruning)
 
-//------------------------------------------------------------------------------
-//Local private variables
-static AStar_Node_t node_list[MAX_ASTAR_NODES];
-static int          node_list_length = 0;
-static AStar_Node_t *final_node = NULL;
-static AStar_Node_t *start_node = NULL;
+/// The node of a tile which was visited and is blocked
+#define ASTAR_BLOCKED_NODE -1
 
 //------------------------------------------------------------------------------
 //"Private" functions
-static AStar_Node_t* AStar_get_next_node();
-static AStar_Node_t* AStar_add_node( const int x, const int y, AStar_Node_t *parent, float weight, bool closed );
-static void AStar_reset();
+static void AStar_reset( AStar_Context_t& context, const ego_mesh_t *mesh );
+static bool AStar_visit_tile( AStar_Context_t& context, const ego_mesh_t *mesh, const int x, const int y, int *node );
+static int  AStar_add_node( AStar_Context_t& context, const int x, const int y, const int parent, const int cost, const int estimate );
+static int  AStar_pop_node( AStar_Context_t& context );
+static void AStar_heap_up( AStar_Context_t& context, size_t index );
+static void AStar_heap_down( AStar_Context_t& context, size_t index );
 
 //------------------------------------------------------------------------------
-AStar_Node_t* AStar_get_next_node()
+// The pool of contexts shared by all threads
+namespace
 {
-    /// @author ZF
-    /// @details This function finds and returns the next cheapest open node
+struct ContextPool
+{
+    std::mutex mutex;
+    std::vector<std::unique_ptr<AStar_Context_t>> contexts;
+};
 
-    int i, best_node = -1;
+ContextPool& getContextPool()
+{
+    static ContextPool pool;
+    return pool;
+}
+}
 
-    for ( i = 0; i < node_list_length; i++ )
+//------------------------------------------------------------------------------
+AStar_Context_t::AStar_Context_t() :
+    nodes(),
+    openHeap(),
+    path(),
+    tileStamps(),
+    tileNodes(),
+    generation(0)
+{
+}
+
+//------------------------------------------------------------------------------
+AStar_ScopedContext::AStar_ScopedContext() :
+    _context()
+{
+    ContextPool& pool = getContextPool();
+    {
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        if (!pool.contexts.empty())
+        {
+            _context = std::move(pool.contexts.back());
+            pool.contexts.pop_back();
+        }
+    }
+    if (!_context)
     {
-        if ( node_list[i].closed ) continue;
-        if ( best_node == -1 || node_list[i].weight < node_list[best_node].weight ) best_node = i;
+        _context.reset(new AStar_Context_t());
     }
+}
 
-    //return the node if found, NULL otherwise
-    return ( best_node != -1 ) ? &node_list[best_node] : NULL;
+AStar_ScopedContext::~AStar_ScopedContext()
+{
+    ContextPool& pool = getContextPool();
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    pool.contexts.push_back(std::move(_context));
 }
 
 //------------------------------------------------------------------------------
-AStar_Node_t* AStar_add_node( const int x, const int y, AStar_Node_t *parent, float weight, bool closed )
+void AStar_reset( AStar_Context_t& context, const ego_mesh_t *mesh )
 {
     /// @author ZF
-    /// @details Adds one new node to the end of the node list
+    /// @details Reset AStar memory. This doesn't actually clear anything to make it work as fast as possible
 
-    if ( node_list_length >= MAX_ASTAR_NODES ) return NULL;
+    context.nodes.clear();
+    context.openHeap.clear();
+    context.path.clear();
 
-    //add the node
-    node_list[node_list_length].ix      = x;
-    node_list[node_list_length].iy      = y;
-    node_list[node_list_length].closed  = closed;
-    node_list[node_list_length].weight  = weight;
-    node_list[node_list_length].parent  = parent;
-    node_list_length++;
+    // the tile map is only cleared if the mesh has a different size or the generation wraps around
+    const size_t tileCount = mesh->info.tiles_count;
+    context.generation++;
+    if ( context.tileStamps.size() != tileCount || 0 == context.generation )
+    {
+        context.tileStamps.assign( tileCount, 0 );
+        context.tileNodes.resize( tileCount );
+        context.generation = 1;
+    }
+}
 
-    //return the new node
-    return &node_list[node_list_length-1];
+//------------------------------------------------------------------------------
+bool AStar_visit_tile( AStar_Context_t& context, const ego_mesh_t *mesh, const int x, const int y, int *node )
+{
+    /// @details Looks up the node of a tile in the current search.
+    //              Returns false if the tile is off the mesh or was not visited yet.
+
+    TileIndex itile = ego_mesh_t::get_tile_int( mesh, PointGrid(x, y) );
+    if ( TileIndex::Invalid == itile || itile.getI() >= context.tileStamps.size() )
+    {
+        *node = ASTAR_BLOCKED_NODE;
+        return true;
+    }
+
+    if ( context.tileStamps[itile.getI()] != context.generation )
+    {
+        return false;
+    }
+
+    *node = context.tileNodes[itile.getI()];
+    return true;
 }
 
 //------------------------------------------------------------------------------
-void AStar_reset()
+int AStar_add_node( AStar_Context_t& context, const int x, const int y, const int parent, const int cost, const int estimate )
 {
     /// @author ZF
-    /// @details Reset AStar memory. This doesn't actually clear anything to make it work as fast as possible
+    /// @details Adds one new open node to the end of the node list and marks its tile as visited
+
+    AStar_Node_t node;
+    node.ix        = x;
+    node.iy        = y;
+    node.cost      = cost;
+    node.estimate  = estimate;
+    node.parent    = parent;
+    node.heapIndex = static_cast<int>(context.openHeap.size());
+
+    const int index = static_cast<int>(context.nodes.size());
+    context.nodes.push_back( node );
+    context.openHeap.push_back( index );
+    AStar_heap_up( context, context.openHeap.size() - 1 );
+
+    return index;
+}
+
+//------------------------------------------------------------------------------
+int AStar_pop_node( AStar_Context_t& context )
+{
+    /// @details Removes the cheapest open node from the heap and closes it. Returns -1 if there are no open nodes.
+
+    if ( context.openHeap.empty() ) return -1;
 
-    node_list_length = 0;
-    final_node = NULL;
-    start_node = NULL;
+    const int best = context.openHeap.front();
+    context.nodes[best].heapIndex = -1;
+
+    const int last = context.openHeap.back();
+    context.openHeap.pop_back();
+    if ( !context.openHeap.empty() )
+    {
+        context.openHeap.front() = last;
+        context.nodes[last].heapIndex = 0;
+        AStar_heap_down( context, 0 );
+    }
+
+    return best;
 }
 
 //------------------------------------------------------------------------------
-bool AStar_find_path( ego_mesh_t *PMesh, Uint32 stoppedby, const int src_ix, const int src_iy, int dst_ix, int dst_iy )
+void AStar_heap_up( AStar_Context_t& context, size_t index )
+{
+    /// @details Moves a node towards the top of the heap until its parent is not more expensive
+
+    std::vector<int>& heap = context.openHeap;
+    const int node = heap[index];
+    const int estimate = context.nodes[node].estimate;
+
+    while ( index > 0 )
+    {
+        const size_t parent = ( index - 1 ) / 2;
+        if ( context.nodes[heap[parent]].estimate <= estimate ) break;
+
+        heap[index] = heap[parent];
+        context.nodes[heap[index]].heapIndex = static_cast<int>(index);
+        index = parent;
+    }
+
+    heap[index] = node;
+    context.nodes[node].heapIndex = static_cast<int>(index);
+}
+
+//------------------------------------------------------------------------------
+void AStar_heap_down( AStar_Context_t& context, size_t index )
+{
+    /// @details Moves a node towards the bottom of the heap until no child is cheaper
+
+    std::vector<int>& heap = context.openHeap;
+    const size_t size = heap.size();
+    const int node = heap[index];
+    const int estimate = context.nodes[node].estimate;
+
+    while ( true )
+    {
+        size_t child = 2 * index + 1;
+        if ( child >= size ) break;
+        if ( child + 1 < size && context.nodes[heap[child + 1]].estimate < context.nodes[heap[child]].estimate ) child++;
+        if ( estimate <= context.nodes[heap[child]].estimate ) break;
+
+        heap[index] = heap[child];
+        context.nodes[heap[index]].heapIndex = static_cast<int>(index);
+        index = child;
+    }
+
+    heap[index] = node;
+    context.nodes[node].heapIndex = static_cast<int>(index);
+}
+
+//------------------------------------------------------------------------------
+bool AStar_tile_is_passable( const ego_mesh_t *PMesh, Uint32 stoppedby, const int ix, const int iy )
+{
+    TileIndex itile = ego_mesh_t::get_tile_int( PMesh, PointGrid(ix, iy) );
+    if ( TileIndex::Invalid == itile ) return false;
+
+    //Dont walk into pits
+    //@todo: might need to check tile Z level here instead
+    const ego_tile_info_t *ptile = PMesh->get_ptile( itile );
+    if ( NULL == ptile || TILE_IS_FANOFF( ptile ) ) return false;
+
+    ///
+    /// @todo  I need to check for collisions with static objects, like trees
+
+    // is this a wall or impassable?
+    return !ego_mesh_tile_has_bits( PMesh, PointGrid(ix, iy), stoppedby );
+}
+
+//------------------------------------------------------------------------------
+bool AStar_get_free_destination( const ego_mesh_t *PMesh, Uint32 stoppedby, int *dst_ix, int *dst_iy )
+{
+    int j, k;
+
+    if ( !ego_mesh_tile_has_bits( PMesh, PointGrid(*dst_ix, *dst_iy), stoppedby ) ) return true;
+
+    //check all tiles edging to this one, including corners
+    for ( j = -1; j <= 1; j++ )
+        for ( k = -1; k <= 1; k++ )
+        {
+            //we already checked this one
+            if ( j == 0 && k == 0 ) continue;
+
+            //Did we find a free tile?
+            if ( !ego_mesh_tile_has_bits( PMesh, PointGrid(*dst_ix + j, *dst_iy + k), stoppedby ) )
+            {
+                *dst_ix = *dst_ix + j;
+                *dst_iy = *dst_iy + k;
+                return true;
+            }
+        }
+
+    return false;
+}
+
+//------------------------------------------------------------------------------
+bool AStar_find_path( AStar_Context_t& context, ego_mesh_t *PMesh, Uint32 stoppedby, const int src_ix, const int src_iy, int dst_ix, int dst_iy, size_t nodeBudget )
 {
     /// @author ZF
-    /// @details Explores up to MAX_ASTAR_NODES number of nodes to find a path between the source coordinates and destination coordinates.
-    //              The result is stored in a node list and can be accessed through AStar_get_path(). Returns false if no path was found.
+    /// @details Explores up to nodeBudget number of nodes to find a path between the source coordinates and destination coordinates.
+    //              The result is stored in the context and can be accessed through AStar_get_path(). Returns false if no path was found.
+    //              The open nodes are kept in a binary heap, so that the cheapest one is found in O(log n).
+
+    // the orthogonal neighbours of a tile, diagonals are not checked
+    static const int offsets[4][2] = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
 
-    int j, k, cnt;
-    bool done;
-    int deadend_count;
-    AStar_Node_t * popen;
-    float weight;
-    ego_tile_info_t * ptile;
+    int j;
+    int final_node;
 
     // do not start if the initial point is off the mesh
     if (TileIndex::Invalid == ego_mesh_t::get_tile_int( PMesh, PointGrid(src_ix, src_iy)))
@@ -119,155 +301,103 @@ bool AStar_find_path( ego_mesh_t *PMesh, Uint32 stoppedby, const int src_ix, con
     }
 
     //be a bit flexible if the destination is inside a wall
-    if ( ego_mesh_tile_has_bits( PMesh, PointGrid(dst_ix, dst_iy), stoppedby ) )
+    if ( !AStar_get_free_destination( PMesh, stoppedby, &dst_ix, &dst_iy ) )
     {
-        //check all tiles edging to this one, including corners
-        for ( j = -1; j <= 1; j++ )
-            for ( k = -1; k <= 1; k++ )
-            {
-                //we already checked this one
-                if ( j == 0 && k == 0 ) continue;
-
-                //Did we find a free tile?
-                if ( !ego_mesh_tile_has_bits( PMesh, PointGrid(dst_ix + j, dst_iy + k), stoppedby ) )
-                {
-                    dst_ix = dst_ix + j;
-                    dst_iy = dst_iy + k;
-                    goto flexible_destination;
-                }
-            }
 #ifdef DEBUG_ASTAR
         printf( "AStar failed because goal position is impassable (and no nearby non-impassable tile found).\n" );
 #endif
         return false;
     }
-flexible_destination:
 
     // restart the algorithm
-    done = false;
-    AStar_reset();
+    AStar_reset( context, PMesh );
+    final_node = -1;
 
-    // initialize the starting node
-    weight = std::sqrt(( src_ix - dst_ix ) * ( src_ix - dst_ix ) + ( src_iy - dst_iy ) * ( src_iy - dst_iy ) );
-    start_node = AStar_add_node( src_ix, src_iy, NULL, weight, false );
+    // initialize the starting node. The estimate is the Manhattan distance, which never
+    // overestimates the number of orthogonal steps, so the path found is a shortest one
+    const size_t src_tile = ego_mesh_t::get_tile_int( PMesh, PointGrid(src_ix, src_iy) ).getI();
+    context.tileStamps[src_tile] = context.generation;
+    context.tileNodes[src_tile]  = AStar_add_node( context, src_ix, src_iy, -1, 0, std::abs( src_ix - dst_ix ) + std::abs( src_iy - dst_iy ) );
 
     // do the algorithm
-    while ( !done )
+    while ( final_node < 0 )
     {
-        int tmp_x, tmp_y;
-        bool stop;
+        //Get the cheapest open node, it is closed now
+        const int popen = AStar_pop_node( context );
+
+        //Found no open nodes
+        if ( popen < 0 ) break;
 
-        // list is completely full... we failed
-        if ( node_list_length == MAX_ASTAR_NODES ) break;
+        const int open_x = context.nodes[popen].ix;
+        const int open_y = context.nodes[popen].iy;
+        const int cost   = context.nodes[popen].cost + 1;
 
-        //Get the cheapest open node
-        popen = AStar_get_next_node();
-        if ( popen != NULL )
+        // find some child nodes
+        for ( j = 0; j < 4; j++ )
         {
-            // find some child nodes
-            deadend_count = 0;
-            for ( j = -1; j <= 1; j++ )
+            const int tmp_x = open_x + offsets[j][0];
+            const int tmp_y = open_y + offsets[j][1];
+            const int estimate = cost + std::abs( tmp_x - dst_ix ) + std::abs( tmp_y - dst_iy );
+
+            // is this already in the list? (must be checked before wall or fanoff)
+            int child;
+            if ( AStar_visit_tile( context, PMesh, tmp_x, tmp_y, &child ) )
             {
-                tmp_x = popen->ix + j;
+                // a blocked tile, a tile off the mesh or a closed node
+                if ( ASTAR_BLOCKED_NODE == child || context.nodes[child].heapIndex < 0 ) continue;
 
-                for ( k = -1; k <= 1; k++ )
+                // we found a cheaper way to an open node
+                if ( cost < context.nodes[child].cost )
                 {
-                    // do not recompute the open node!
-                    if ( j == 0 && k == 0 ) continue;
-
-                    // do not check diagonals
-                    if ( j != 0 && k != 0 ) continue;
-
-                    tmp_y = popen->iy + k;
-
-                    // check for the simplest case, is this the destination node?
-                    if ( tmp_x == dst_ix && tmp_y == dst_iy )
-                    {
-                        weight = ( tmp_x - popen->ix ) * ( tmp_x - popen->ix ) + ( tmp_y - popen->iy ) * ( tmp_y - popen->iy );
-                        weight = sqrt( weight );
-                        final_node = AStar_add_node( tmp_x, tmp_y, popen, weight, false );
-                        done = true;
-                        continue;
-                    }
-
-                    // is the test node on the mesh?
-                    TileIndex itile = ego_mesh_t::get_tile_int(PMesh, PointGrid(tmp_x, tmp_y));
-                    if (TileIndex::Invalid == itile)
-                    {
-                        deadend_count++;
-                        continue;
-                    }
-
-                    // is this already in the list? (must be checked before wall or fanoff)
-                    stop = false;
-                    for ( cnt = 0; cnt < node_list_length; cnt++ )
-                    {
-                        if ( node_list[cnt].ix == tmp_x && node_list[cnt].iy == tmp_y )
-                        {
-                            deadend_count++;
-                            stop = true;
-                            break;
-                        }
-                    }
-                    if ( stop ) continue;
-
-                    //Dont walk into pits
-                    //@todo: might need to check tile Z level here instead
-                    ptile = PMesh->get_ptile(itile);
-                    if ( NULL == ptile ) continue;
-
-                    if ( TILE_IS_FANOFF( ptile ) )
-                    {
-                        // add the invalid tile to the list as a closed tile
-                        AStar_add_node( tmp_x, tmp_y, popen, 0xFFFF, true );
-                        deadend_count++;
-                        continue;
-                    }
-
-                    // is this a wall or impassable?
-                    if ( ego_mesh_tile_has_bits( PMesh, PointGrid(tmp_x, tmp_y), stoppedby ) )
-                    {
-                        // add the invalid tile to the list as a closed tile
-                        AStar_add_node( tmp_x, tmp_y, popen, 0xFFFF, true );
-                        deadend_count++;
-                        continue;
-                    }
-
-                    ///
-                    /// @todo  I need to check for collisions with static objects, like trees
-
-                    // OK. determine the weight (F + H)
-                    weight  = ( tmp_x - popen->ix ) * ( tmp_x - popen->ix ) + ( tmp_y - popen->iy ) * ( tmp_y - popen->iy );
-                    weight += ( tmp_x - dst_ix ) * ( tmp_x - dst_ix ) + ( tmp_y - dst_iy ) * ( tmp_y - dst_iy );
-                    weight  = sqrt( weight );
-                    AStar_add_node( tmp_x, tmp_y, popen, weight, false );
+                    context.nodes[child].cost     = cost;
+                    context.nodes[child].estimate = estimate;
+                    context.nodes[child].parent   = popen;
+                    AStar_heap_up( context, context.nodes[child].heapIndex );
                 }
+                continue;
             }
 
-            if ( deadend_count == 4 )
+            // the tile is on the mesh, but was not visited yet
+            const size_t itile = ego_mesh_t::get_tile_int( PMesh, PointGrid(tmp_x, tmp_y) ).getI();
+            context.tileStamps[itile] = context.generation;
+            context.tileNodes[itile]  = ASTAR_BLOCKED_NODE;
+
+            // check for the simplest case, is this the destination node?
+            if ( tmp_x == dst_ix && tmp_y == dst_iy )
             {
-                // this node is no longer active.
-                // move it to the closed list so that we do not get any loops
-                popen->closed = true;
+                final_node = AStar_add_node( context, tmp_x, tmp_y, popen, cost, cost );
+                break;
             }
-        }
 
-        //Found no open nodes
-        else
-        {
-            break;
-        }
-    }
+            // is this a pit, a wall or impassable?
+            if ( !AStar_tile_is_passable( PMesh, stoppedby, tmp_x, tmp_y ) ) continue;
 
+            // the budget is exhausted... we failed
+            if ( context.nodes.size() >= nodeBudget )
+            {
 #ifdef DEBUG_ASTAR
-    if ( !done && node_list_length == MAX_ASTAR_NODES ) printf( "AStar failed because maximum number of nodes were explored (%d)\n", MAX_ASTAR_NODES );
+                printf( "AStar failed because maximum number of nodes were explored (%d)\n", static_cast<int>(nodeBudget) );
 #endif
+                return false;
+            }
+
+            context.tileNodes[itile] = AStar_add_node( context, tmp_x, tmp_y, popen, cost, estimate );
+        }
+    }
+
+    if ( final_node < 0 ) return false;
 
-    return done;
+    // store the path from the destination to the start
+    for ( int node = final_node; node >= 0; node = context.nodes[node].parent )
+    {
+        context.path.push_back( node );
+    }
+
+    return true;
 }
 
 //------------------------------------------------------------------------------
-bool AStar_get_path( const int pos_x, const int dst_y, waypoint_list_t *plst )
+bool AStar_get_path( const AStar_Context_t& context, const int pos_x, const int dst_y, waypoint_list_t *plst )
 {
     /// @author ZF
     /// @details Fills a waypoint list with sensible waypoints. It will return false if it failed to add at least one waypoint.
@@ -276,36 +406,25 @@ bool AStar_get_path( const int pos_x, const int dst_y, waypoint_list_t *plst )
     //              the destination coordinates.
 
     int i;
-    size_t path_length, waypoint_num;
-    //bool diagonal_movement = false;
+    size_t waypoint_num;
+
+    const AStar_Node_t *current_node, *last_waypoint, *safe_waypoint;
 
-    AStar_Node_t *current_node, *last_waypoint, *safe_waypoint;
-    AStar_Node_t *node_path[MAX_ASTAR_PATH];
+    // the path ends with the start node
+    if ( context.path.size() < 2 ) return false;
 
     //Fill the waypoint list as much as we can, the final waypoint will always be the destination waypoint
     waypoint_num = 0;
-    current_node = final_node;
-    last_waypoint = start_node;
-
-    //Build the local node path tree
-    path_length = 0;
-    while ( path_length < MAX_ASTAR_PATH && current_node != start_node )
-    {
-        // add the node to the end of the path
-        node_path[path_length++] = current_node;
-
-        // get next node
-        current_node = current_node->parent;
-    }
+    last_waypoint = &context.nodes[context.path.back()];
 
-    //Begin at the end of the list, which contains the starting node
+    //Begin at the end of the list, which contains the node after the starting node
     safe_waypoint = NULL;
-    for ( i = path_length - 1; i >= 0 && waypoint_num < MAXWAY; i-- )
+    for ( i = static_cast<int>(context.path.size()) - 2; i >= 0 && waypoint_num < MAXWAY; i-- )
     {
         bool change_direction;
 
         //get current node
-        current_node = node_path[i];
+        current_node = &context.nodes[context.path[i]];
 
         //the first node should be safe
         if ( NULL == safe_waypoint ) safe_waypoint = current_node;
@@ -313,19 +432,6 @@ bool AStar_get_path( const int pos_x, const int dst_y, waypoint_list_t *plst )
         //is there a change in direction?
         change_direction = ( last_waypoint->ix != current_node->ix && last_waypoint->iy != current_node->iy );
 
-        //are we moving diagonally? if so, then don't fill the waypoint list with unessecary waypoints
-        /*if( i != 0 )
-        {
-            if( diagonal_movement ) diagonal_movement = (ABS(current_node->ix - safe_waypoint->ix) == 1)  && (ABS(current_node->iy - safe_waypoint->iy) == 1);
-            else                    diagonal_movement = (ABS(current_node->ix - last_waypoint->ix) == 1)  && (ABS(current_node->iy - last_waypoint->iy) == 1);
-
-            if( diagonal_movement )
-            {
-                safe_waypoint = current_node;
-                continue;
-            }
-        }*/
-
         //If we have a change in direction, we need to add it as a waypoint, always add the last waypoint
         if ( i == 0 || change_direction )
         {
@@ -348,7 +454,7 @@ bool AStar_get_path( const int pos_x, const int dst_y, waypoint_list_t *plst )
 #ifdef DEBUG_ASTAR
             // using >> for division only works if you know for certainty that the value
             // you are shifting is not intended to be neative
-            printf( "Waypoint %d: X: %d, Y: %d \n", waypoint_num, static_cast<int>(way_x / GRID_ISIZE), static_cast<int>(way_y / GRID_ISIZE) );
+            printf( "Waypoint %d: X: %d, Y: %d \n", static_cast<int>(waypoint_num), static_cast<int>(way_x / GRID_ISIZE), static_cast<int>(way_y / GRID_ISIZE) );
             point_list_add( way_x, way_y, 200, 800 );
             line_list_add( last_waypoint->ix*GRID_FSIZE + ( GRID_ISIZE / 2 ), last_waypoint->iy*GRID_FSIZE + ( GRID_ISIZE / 2 ), 200, way_x, way_y, 200, 800 );
 #endif
@@ -370,7 +476,7 @@ bool AStar_get_path( const int pos_x, const int dst_y, waypoint_list_t *plst )
     }
 
 #ifdef DEBUG_ASTAR
-    if ( waypoint_num > 0 ) point_list_add( start_node->ix*GRID_FSIZE + ( GRID_ISIZE / 2 ), start_node->iy*GRID_FSIZE + ( GRID_ISIZE / 2 ), 200, 80 );
+    if ( waypoint_num > 0 ) point_list_add( context.nodes[context.path.back()].ix*GRID_FSIZE + ( GRID_ISIZE / 2 ), context.nodes[context.path.back()].iy*GRID_FSIZE + ( GRID_ISIZE / 2 ), 200, 80 );
 #endif
 
     return waypoint_num > 0;
@@ -19,8 +19,9 @@
 
 /// @file egolib/AI/AStar.h
 /// @brief A* pathfinding.
-/// @details A very ugly implementation of the A* pathfinding agorithm.
-///          There is lots of room for improvement.
+/// @details The open nodes are kept in an indexed binary heap and the visited tiles in a map
+///          which is stamped with the generation of the search, so the memory of a search
+///          context can be reused without clearing it.
 
 #pragma once
 
@@ -37,16 +38,88 @@ struct waypoint_list_t;
 // A* pathfinding --------------------------------------------------------------
 //------------------------------------------------------------------------------
 
+/// The default number of nodes a search may create before it gives up
+#define DEFAULT_ASTAR_NODE_BUDGET 4096
+
 struct AStar_Node_t
 {
-    float  weight;
-    bool closed;
-
     int    ix, iy;
-    AStar_Node_t *parent;
+    int    cost;       ///< The number of steps from the start node
+    int    estimate;   ///< The cost plus the estimated number of steps to the destination
+    int    parent;     ///< The index of the parent node or -1 for the start node
+    int    heapIndex;  ///< The index in the open heap or -1 if the node is closed
+};
+
+/**
+ * @brief
+ *  The memory of a search. A context can be reused by any number of searches,
+ *  it keeps its memory between them, but a context must only be used by one thread at a time.
+ *  Use AStar_ScopedContext to borrow a context from a pool shared by all threads.
+ */
+struct AStar_Context_t : Id::NonCopyable
+{
+    AStar_Context_t();
+
+    std::vector<AStar_Node_t> nodes;   ///< All nodes created by the current search
+    std::vector<int> openHeap;         ///< The indices of the open nodes, a binary heap ordered by their estimate
+    std::vector<int> path;             ///< The indices of the nodes of the last path found, from the destination to the start
+
+    /// The search generation in which a tile was visited, sized to the mesh.
+    /// A tile is only visited in the current search if its stamp equals the generation,
+    /// so the map does not need to be cleared between searches.
+    std::vector<Uint32> tileStamps;
+    std::vector<int> tileNodes;        ///< The node of a visited tile, or -1 if the tile is blocked
+    Uint32 generation;
+};
+
+/**
+ * @brief
+ *  Borrows a context from a pool shared by all threads and returns it when it goes out of scope.
+ */
+class AStar_ScopedContext : Id::NonCopyable
+{
+public:
+    AStar_ScopedContext();
+    ~AStar_ScopedContext();
+
+    AStar_Context_t& operator*() const { return *_context; }
+    AStar_Context_t *operator->() const { return _context.get(); }
+
+private:
+    std::unique_ptr<AStar_Context_t> _context;
 };
 
 //------------------------------------------------------------------------------
 //Public functions
-bool AStar_find_path( ego_mesh_t *mesh, Uint32 stoppedBy, const int src_ix, const int src_iy, int dst_ix, int dst_iy );
-bool AStar_get_path( const int pos_x, const int dst_y, waypoint_list_t *plst );
+
+/**
+ * @brief
+ *  Can a path lead through a tile? Tiles off the mesh, pits and tiles with any of the @a stoppedBy bits are not passable.
+ */
+bool AStar_tile_is_passable( const ego_mesh_t *mesh, Uint32 stoppedBy, const int ix, const int iy );
+
+/**
+ * @brief
+ *  Be a bit flexible if the destination is inside a wall: move it to a free tile next to it, including corners.
+ * @return
+ *  @a false if neither the destination nor a tile next to it is free
+ */
+bool AStar_get_free_destination( const ego_mesh_t *mesh, Uint32 stoppedBy, int *dst_ix, int *dst_iy );
+
+/**
+ * @brief
+ *  Find a path between the source tile and the destination tile.
+ * @param context
+ *  the context which stores the path, see AStar_get_path()
+ * @param nodeBudget
+ *  the number of nodes which may be explored before the search fails
+ * @return
+ *  @a true if a path was found, @a false otherwise
+ */
+bool AStar_find_path( AStar_Context_t& context, ego_mesh_t *mesh, Uint32 stoppedBy, const int src_ix, const int src_iy, int dst_ix, int dst_iy, size_t nodeBudget = DEFAULT_ASTAR_NODE_BUDGET );
+
+/**
+ * @brief
+ *  Fill a waypoint list with the corners of the path found by the last successful call to AStar_find_path().
+ */
+bool AStar_get_path( const AStar_Context_t& context, const int pos_x, const int dst_y, waypoint_list_t *plst );
@@ -0,0 +1,518 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+
+/// @file egolib/AI/BlockGraph.c
+/// @brief Hierarchical pathfinding over the blocks of a mesh.
+
+#include "egolib/AI/BlockGraph.h"
+#include "egolib/AI/AStar.h"
+
+#include "game/mesh.h"
+
+#include <queue>
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+#define BLOCK_AREA (BLOCKGRAPH_BLOCK_TILES * BLOCKGRAPH_BLOCK_TILES)
+
+/// The tiles of a block. The blocks at the right and bottom edges of the mesh may be smaller.
+struct BlockBounds
+{
+    int x0, y0, x1, y1;   ///< x1 and y1 are exclusive
+
+    BlockBounds( const BlockGraph_t& graph, const int bx, const int by ) :
+        x0( bx * BLOCKGRAPH_BLOCK_TILES ),
+        y0( by * BLOCKGRAPH_BLOCK_TILES ),
+        x1( std::min( ( bx + 1 ) * BLOCKGRAPH_BLOCK_TILES, graph.tiles_x ) ),
+        y1( std::min( ( by + 1 ) * BLOCKGRAPH_BLOCK_TILES, graph.tiles_y ) )
+    {
+    }
+
+    bool contains( const int ix, const int iy ) const
+    {
+        return ix >= x0 && ix < x1 && iy >= y0 && iy < y1;
+    }
+
+    int local( const int ix, const int iy ) const
+    {
+        return ( iy - y0 ) * BLOCKGRAPH_BLOCK_TILES + ( ix - x0 );
+    }
+};
+
+// the orthogonal neighbours of a tile
+static const int blockgraph_offsets[4][2] = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
+
+//------------------------------------------------------------------------------
+//"Private" functions
+static Uint32 BlockGraph_tile( const BlockGraph_t& graph, const int ix, const int iy );
+static bool   BlockGraph_is_passable( const BlockGraph_t& graph, const int ix, const int iy );
+static void   BlockGraph_search_block( const BlockGraph_t& graph, const BlockBounds& block, const int ix, const int iy, int distance[], int parent[], const int goal_x = -1, const int goal_y = -1 );
+static void   BlockGraph_add_portals( BlockGraph_t& graph, const int bx, const int by, const int dx, const int dy );
+static void   BlockGraph_build_block( BlockGraph_t& graph, const int bx, const int by );
+
+//------------------------------------------------------------------------------
+// The cache of graphs shared by all threads
+namespace
+{
+struct Cache
+{
+    std::mutex mutex;
+    std::unordered_map<Uint32, std::shared_ptr<const BlockGraph_t>> graphs;
+    BlockGraph_Stats_t stats;
+};
+
+Cache& getCache()
+{
+    static Cache cache;
+    return cache;
+}
+}
+
+//------------------------------------------------------------------------------
+BlockGraph_t::BlockGraph_t() :
+    mesh(nullptr),
+    stoppedBy(0),
+    fxRevision(0),
+    tiles_x(0),
+    tiles_y(0),
+    blocks_x(0),
+    blocks_y(0),
+    passable(),
+    blockNodes(),
+    nodes()
+{
+}
+
+//------------------------------------------------------------------------------
+Uint32 BlockGraph_tile( const BlockGraph_t& graph, const int ix, const int iy )
+{
+    return ego_mesh_t::get_tile_int( graph.mesh, PointGrid(ix, iy) ).getI();
+}
+
+//------------------------------------------------------------------------------
+bool BlockGraph_is_passable( const BlockGraph_t& graph, const int ix, const int iy )
+{
+    TileIndex itile = ego_mesh_t::get_tile_int( graph.mesh, PointGrid(ix, iy) );
+    return TileIndex::Invalid != itile && 0 != graph.passable[itile.getI()];
+}
+
+//------------------------------------------------------------------------------
+void BlockGraph_search_block( const BlockGraph_t& graph, const BlockBounds& block, const int ix, const int iy, int distance[], int parent[], const int goal_x, const int goal_y )
+{
+    /// @details A breadth-first search from a tile which does not leave the block.
+    //              The tile itself and the goal tile need not be passable, e.g. if they are
+    //              the position of a character and a destination at the edge of a pit.
+
+    int queue[BLOCK_AREA];
+    int head = 0, tail = 0;
+
+    for ( int i = 0; i < BLOCK_AREA; i++ )
+    {
+        distance[i] = -1;
+        parent[i] = -1;
+    }
+
+    distance[block.local( ix, iy )] = 0;
+    queue[tail++] = block.local( ix, iy );
+
+    while ( head < tail )
+    {
+        const int current = queue[head++];
+        const int cx = block.x0 + current % BLOCKGRAPH_BLOCK_TILES;
+        const int cy = block.y0 + current / BLOCKGRAPH_BLOCK_TILES;
+
+        for ( int d = 0; d < 4; d++ )
+        {
+            const int tmp_x = cx + blockgraph_offsets[d][0];
+            const int tmp_y = cy + blockgraph_offsets[d][1];
+            if ( !block.contains( tmp_x, tmp_y ) ) continue;
+            if ( !BlockGraph_is_passable( graph, tmp_x, tmp_y ) && ( tmp_x != goal_x || tmp_y != goal_y ) ) continue;
+
+            const int next = block.local( tmp_x, tmp_y );
+            if ( distance[next] >= 0 ) continue;
+
+            distance[next] = distance[current] + 1;
+            parent[next] = current;
+            queue[tail++] = next;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void BlockGraph_add_portals( BlockGraph_t& graph, const int bx, const int by, const int dx, const int dy )
+{
+    /// @details Adds a node in the middle of every span of passable tiles along the border
+    //              to the neighbouring block in the direction (dx, dy). The neighbour finds the
+    //              same spans, so the node on its side is the tile across the border.
+
+    if ( bx + dx < 0 || bx + dx >= graph.blocks_x || by + dy < 0 || by + dy >= graph.blocks_y ) return;
+
+    const BlockBounds block( graph, bx, by );
+
+    // the border is a column if the neighbour is to the left or the right, a row otherwise
+    const int length = ( 0 != dx ) ? block.y1 - block.y0 : block.x1 - block.x0;
+    const int border_x = ( dx < 0 ) ? block.x0 : block.x1 - 1;
+    const int border_y = ( dy < 0 ) ? block.y0 : block.y1 - 1;
+
+    int span = -1;
+    for ( int i = 0; i <= length; i++ )
+    {
+        const int ix = ( 0 != dx ) ? border_x : block.x0 + i;
+        const int iy = ( 0 != dx ) ? block.y0 + i : border_y;
+        const bool open = i < length && BlockGraph_is_passable( graph, ix, iy ) && BlockGraph_is_passable( graph, ix + dx, iy + dy );
+
+        if ( open && span < 0 ) span = i;
+        if ( open || span < 0 ) continue;
+
+        // the span ended, add its portal
+        const int middle = ( span + i - 1 ) / 2;
+        const int portal_x = ( 0 != dx ) ? border_x : block.x0 + middle;
+        const int portal_y = ( 0 != dx ) ? block.y0 + middle : border_y;
+        const Uint32 tile = BlockGraph_tile( graph, portal_x, portal_y );
+
+        auto it = graph.nodes.find( tile );
+        if ( graph.nodes.end() == it )
+        {
+            BlockGraph_Node_t node;
+            node.ix = portal_x;
+            node.iy = portal_y;
+            it = graph.nodes.insert( std::make_pair( tile, node ) ).first;
+            graph.blockNodes[by * graph.blocks_x + bx].push_back( tile );
+        }
+        it->second.edges.push_back( std::make_pair( BlockGraph_tile( graph, portal_x + dx, portal_y + dy ), 1 ) );
+
+        span = -1;
+    }
+}
+
+//------------------------------------------------------------------------------
+void BlockGraph_build_block( BlockGraph_t& graph, const int bx, const int by )
+{
+    std::vector<Uint32>& blockNodes = graph.blockNodes[by * graph.blocks_x + bx];
+    for ( Uint32 tile : blockNodes )
+    {
+        graph.nodes.erase( tile );
+    }
+    blockNodes.clear();
+
+    // the portals to the four neighbours
+    for ( int d = 0; d < 4; d++ )
+    {
+        BlockGraph_add_portals( graph, bx, by, blockgraph_offsets[d][0], blockgraph_offsets[d][1] );
+    }
+
+    // connect the nodes inside the block
+    const BlockBounds block( graph, bx, by );
+    int distance[BLOCK_AREA], parent[BLOCK_AREA];
+    for ( Uint32 tile : blockNodes )
+    {
+        BlockGraph_Node_t& node = graph.nodes[tile];
+        BlockGraph_search_block( graph, block, node.ix, node.iy, distance, parent );
+
+        for ( Uint32 other : blockNodes )
+        {
+            if ( other == tile ) continue;
+
+            const BlockGraph_Node_t& target = graph.nodes[other];
+            const int steps = distance[block.local( target.ix, target.iy )];
+            if ( steps > 0 ) node.edges.push_back( std::make_pair( other, steps ) );
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void BlockGraph_build( BlockGraph_t& graph, const ego_mesh_t *mesh, Uint32 stoppedBy )
+{
+    graph.mesh = mesh;
+    graph.stoppedBy = stoppedBy;
+    graph.fxRevision = mesh->fxRevision;
+    graph.tiles_x = mesh->info.tiles_x;
+    graph.tiles_y = mesh->info.tiles_y;
+    graph.blocks_x = ( graph.tiles_x + BLOCKGRAPH_BLOCK_TILES - 1 ) / BLOCKGRAPH_BLOCK_TILES;
+    graph.blocks_y = ( graph.tiles_y + BLOCKGRAPH_BLOCK_TILES - 1 ) / BLOCKGRAPH_BLOCK_TILES;
+
+    graph.passable.assign( mesh->info.tiles_count, 0 );
+    for ( int iy = 0; iy < graph.tiles_y; iy++ )
+    {
+        for ( int ix = 0; ix < graph.tiles_x; ix++ )
+        {
+            graph.passable[BlockGraph_tile( graph, ix, iy )] = AStar_tile_is_passable( mesh, stoppedBy, ix, iy ) ? 1 : 0;
+        }
+    }
+
+    graph.nodes.clear();
+    graph.blockNodes.assign( graph.blocks_x * graph.blocks_y, std::vector<Uint32>() );
+    for ( int by = 0; by < graph.blocks_y; by++ )
+    {
+        for ( int bx = 0; bx < graph.blocks_x; bx++ )
+        {
+            BlockGraph_build_block( graph, bx, by );
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+size_t BlockGraph_refresh( BlockGraph_t& graph )
+{
+    // find the blocks with tiles which changed. A changed tile changes the portals
+    // to the neighbouring blocks, so the neighbours are rebuilt as well.
+    std::vector<Uint8> rebuild( graph.blockNodes.size(), 0 );
+    for ( int iy = 0; iy < graph.tiles_y; iy++ )
+    {
+        for ( int ix = 0; ix < graph.tiles_x; ix++ )
+        {
+            const Uint32 tile = BlockGraph_tile( graph, ix, iy );
+            const Uint8 passable = AStar_tile_is_passable( graph.mesh, graph.stoppedBy, ix, iy ) ? 1 : 0;
+            if ( passable == graph.passable[tile] ) continue;
+
+            graph.passable[tile] = passable;
+
+            const int bx = ix / BLOCKGRAPH_BLOCK_TILES;
+            const int by = iy / BLOCKGRAPH_BLOCK_TILES;
+            rebuild[by * graph.blocks_x + bx] = 1;
+            for ( int d = 0; d < 4; d++ )
+            {
+                const int nx = bx + blockgraph_offsets[d][0];
+                const int ny = by + blockgraph_offsets[d][1];
+                if ( nx < 0 || nx >= graph.blocks_x || ny < 0 || ny >= graph.blocks_y ) continue;
+                rebuild[ny * graph.blocks_x + nx] = 1;
+            }
+        }
+    }
+    graph.fxRevision = graph.mesh->fxRevision;
+
+    size_t count = 0;
+    for ( size_t i = 0; i < rebuild.size(); i++ )
+    {
+        if ( 0 == rebuild[i] ) continue;
+
+        BlockGraph_build_block( graph, static_cast<int>( i ) % graph.blocks_x, static_cast<int>( i ) / graph.blocks_x );
+        count++;
+    }
+
+    return count;
+}
+
+//------------------------------------------------------------------------------
+bool BlockGraph_find_path( const BlockGraph_t& graph, const int src_ix, const int src_iy, int dst_ix, int dst_iy, AStar_Context_t& context )
+{
+    /// @details A* over the nodes of the graph with the source and the destination as additional nodes,
+    //              which are connected to the nodes of their blocks. The plan is then refined block by block.
+
+    typedef std::pair<int, Uint32> OpenNode;   // the estimate and the tile of a node
+
+    context.nodes.clear();
+    context.openHeap.clear();
+    context.path.clear();
+
+    if ( !AStar_get_free_destination( graph.mesh, graph.stoppedBy, &dst_ix, &dst_iy ) ) return false;
+
+    TileIndex src_tile = ego_mesh_t::get_tile_int( graph.mesh, PointGrid(src_ix, src_iy) );
+    TileIndex dst_tile = ego_mesh_t::get_tile_int( graph.mesh, PointGrid(dst_ix, dst_iy) );
+    if ( TileIndex::Invalid == src_tile || TileIndex::Invalid == dst_tile ) return false;
+    if ( src_tile.getI() >= graph.passable.size() || dst_tile.getI() >= graph.passable.size() ) return false;
+
+    const BlockBounds src_block( graph, src_ix / BLOCKGRAPH_BLOCK_TILES, src_iy / BLOCKGRAPH_BLOCK_TILES );
+    const BlockBounds dst_block( graph, dst_ix / BLOCKGRAPH_BLOCK_TILES, dst_iy / BLOCKGRAPH_BLOCK_TILES );
+    if ( src_block.contains( dst_ix, dst_iy ) ) return false;
+
+    // the steps from the source to the nodes of its block and from the nodes of the destination block to the destination
+    int src_distance[BLOCK_AREA], dst_distance[BLOCK_AREA], parent[BLOCK_AREA];
+    BlockGraph_search_block( graph, src_block, src_ix, src_iy, src_distance, parent );
+    BlockGraph_search_block( graph, dst_block, dst_ix, dst_iy, dst_distance, parent );
+
+    const std::vector<Uint32>& src_nodes = graph.blockNodes[( src_block.y0 / BLOCKGRAPH_BLOCK_TILES ) * graph.blocks_x + src_block.x0 / BLOCKGRAPH_BLOCK_TILES];
+
+    // the cost and the previous tile of every tile reached
+    std::unordered_map<Uint32, std::pair<int, Uint32>> reached;
+    std::priority_queue<OpenNode, std::vector<OpenNode>, std::greater<OpenNode>> open;
+
+    const Uint32 src = src_tile.getI(), dst = dst_tile.getI();
+    reached[src] = std::make_pair( 0, src );
+    open.push( OpenNode( std::abs( src_ix - dst_ix ) + std::abs( src_iy - dst_iy ), src ) );
+
+    bool found = false;
+    while ( !open.empty() )
+    {
+        const Uint32 tile = open.top().second;
+        const int estimate = open.top().first;
+        open.pop();
+
+        if ( dst == tile )
+        {
+            found = true;
+            break;
+        }
+
+        const int cost = reached[tile].first;
+        const int ix = static_cast<int>( tile % graph.tiles_x );
+        const int iy = static_cast<int>( tile / graph.tiles_x );
+
+        // skip the nodes which were reached more cheaply after they were opened
+        if ( estimate > cost + std::abs( ix - dst_ix ) + std::abs( iy - dst_iy ) ) continue;
+
+        // the edges of this tile
+        std::vector<std::pair<Uint32, int>> edges;
+        auto node = graph.nodes.find( tile );
+        if ( graph.nodes.end() != node ) edges = node->second.edges;
+        if ( src == tile )
+        {
+            for ( Uint32 other : src_nodes )
+            {
+                const BlockGraph_Node_t& target = graph.nodes.find( other )->second;
+                const int steps = src_distance[src_block.local( target.ix, target.iy )];
+                if ( steps > 0 ) edges.push_back( std::make_pair( other, steps ) );
+            }
+        }
+        if ( dst_block.contains( ix, iy ) )
+        {
+            const int steps = dst_distance[dst_block.local( ix, iy )];
+            if ( steps >= 0 ) edges.push_back( std::make_pair( dst, steps ) );
+        }
+
+        for ( const auto& edge : edges )
+        {
+            const int next_cost = cost + edge.second;
+            auto it = reached.find( edge.first );
+            if ( reached.end() != it && it->second.first <= next_cost ) continue;
+
+            reached[edge.first] = std::make_pair( next_cost, tile );
+            const int next_x = static_cast<int>( edge.first % graph.tiles_x );
+            const int next_y = static_cast<int>( edge.first / graph.tiles_x );
+            open.push( OpenNode( next_cost + std::abs( next_x - dst_ix ) + std::abs( next_y - dst_iy ), edge.first ) );
+        }
+    }
+
+    if ( !found ) return false;
+
+    // the plan from the destination to the source
+    std::vector<Uint32> plan;
+    for ( Uint32 tile = dst; ; tile = reached[tile].second )
+    {
+        plan.push_back( tile );
+        if ( src == tile ) break;
+    }
+
+    // refine the plan. The tiles of every step are either next to each other or in the same block.
+    context.nodes.reserve( reached[dst].first + 1 );
+    for ( size_t i = plan.size() - 1; ; i-- )
+    {
+        const int ix = static_cast<int>( plan[i] % graph.tiles_x );
+        const int iy = static_cast<int>( plan[i] / graph.tiles_x );
+
+        if ( 0 == i || std::abs( ix - static_cast<int>( plan[i - 1] % graph.tiles_x ) ) + std::abs( iy - static_cast<int>( plan[i - 1] / graph.tiles_x ) ) <= 1 )
+        {
+            AStar_Node_t node;
+            node.ix = ix;
+            node.iy = iy;
+            node.cost = static_cast<int>( context.nodes.size() );
+            node.estimate = node.cost;
+            node.parent = node.cost - 1;
+            node.heapIndex = -1;
+            context.nodes.push_back( node );
+        }
+        else
+        {
+            // walk back from the next tile of the plan to this one
+            const int next_x = static_cast<int>( plan[i - 1] % graph.tiles_x );
+            const int next_y = static_cast<int>( plan[i - 1] / graph.tiles_x );
+            const BlockBounds block( graph, ix / BLOCKGRAPH_BLOCK_TILES, iy / BLOCKGRAPH_BLOCK_TILES );
+            int distance[BLOCK_AREA];
+            BlockGraph_search_block( graph, block, ix, iy, distance, parent, next_x, next_y );
+
+            int steps[BLOCK_AREA];
+            int count = 0;
+            for ( int local = block.local( next_x, next_y ); local >= 0; local = parent[local] )
+            {
+                steps[count++] = local;
+            }
+
+            // the tiles from this one up to, but not including, the next one
+            for ( int j = count - 1; j > 0; j-- )
+            {
+                AStar_Node_t node;
+                node.ix = block.x0 + steps[j] % BLOCKGRAPH_BLOCK_TILES;
+                node.iy = block.y0 + steps[j] / BLOCKGRAPH_BLOCK_TILES;
+                node.cost = static_cast<int>( context.nodes.size() );
+                node.estimate = node.cost;
+                node.parent = node.cost - 1;
+                node.heapIndex = -1;
+                context.nodes.push_back( node );
+            }
+        }
+
+        if ( 0 == i ) break;
+    }
+
+    // the path is stored from the destination to the start
+    for ( int node = static_cast<int>( context.nodes.size() ) - 1; node >= 0; node-- )
+    {
+        context.path.push_back( node );
+    }
+
+    Cache& cache = getCache();
+    std::lock_guard<std::mutex> lock( cache.mutex );
+    cache.stats.paths++;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+std::shared_ptr<const BlockGraph_t> BlockGraph_get( const ego_mesh_t *mesh, Uint32 stoppedBy )
+{
+    Cache& cache = getCache();
+    std::lock_guard<std::mutex> lock( cache.mutex );
+
+    std::shared_ptr<const BlockGraph_t>& graph = cache.graphs[stoppedBy];
+    if ( !graph || graph->mesh != mesh || graph->passable.size() != mesh->info.tiles_count )
+    {
+        std::shared_ptr<BlockGraph_t> built = std::make_shared<BlockGraph_t>();
+        BlockGraph_build( *built, mesh, stoppedBy );
+        cache.stats.builds++;
+        graph = built;
+    }
+    else if ( graph->fxRevision != mesh->fxRevision )
+    {
+        // the graph may be in use by other threads, refresh a copy
+        std::shared_ptr<BlockGraph_t> refreshed = std::make_shared<BlockGraph_t>( *graph );
+        cache.stats.refreshedBlocks += BlockGraph_refresh( *refreshed );
+        graph = refreshed;
+    }
+
+    return graph;
+}
+
+//------------------------------------------------------------------------------
+void BlockGraph_clear_cache()
+{
+    Cache& cache = getCache();
+    std::lock_guard<std::mutex> lock( cache.mutex );
+    cache.graphs.clear();
+    cache.stats = BlockGraph_Stats_t();
+}
+
+//------------------------------------------------------------------------------
+BlockGraph_Stats_t BlockGraph_get_stats()
+{
+    Cache& cache = getCache();
+    std::lock_guard<std::mutex> lock( cache.mutex );
+    return cache.stats;
+}
@@ -0,0 +1,119 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+
+/// @file egolib/AI/BlockGraph.h
+/// @brief Hierarchical pathfinding over the blocks of a mesh.
+/// @details The mesh is divided into blocks of 4 x 4 tiles. Where tiles on both sides of the border
+///          between two blocks are passable, the border has a portal: a node on either side, in the
+///          middle of every span of such tiles. The nodes of a block are connected by the length of
+///          the shortest path between them inside the block. A long path is first planned over this
+///          graph, and then every step of the plan is refined to tiles inside a single block.
+
+#pragma once
+
+#include "egolib/typedef.h"
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+// Forward declarations.
+class ego_mesh_t;
+struct AStar_Context_t;
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+/// The number of tiles along each side of a block (BLOCK_BITS - GRID_BITS = 2)
+#define BLOCKGRAPH_BLOCK_TILES  4
+
+/// The Manhattan distance in tiles from which FindPath plans over the blocks
+#define BLOCKGRAPH_MIN_DISTANCE 16
+
+struct BlockGraph_Node_t
+{
+    int ix, iy;
+
+    /// The nodes which can be reached directly: the tile of the other node and the number of steps
+    std::vector<std::pair<Uint32, int>> edges;
+};
+
+struct BlockGraph_t
+{
+    BlockGraph_t();
+
+    const ego_mesh_t *mesh;
+    Uint32 stoppedBy;                                   ///< The bits of impassable tiles
+    Uint32 fxRevision;                                  ///< The revision of the mesh the graph is up to date with
+
+    int tiles_x, tiles_y;
+    int blocks_x, blocks_y;
+
+    std::vector<Uint8> passable;                        ///< The passability of the tiles when the graph was updated
+    std::vector<std::vector<Uint32>> blockNodes;        ///< The tiles of the nodes of every block
+    std::unordered_map<Uint32, BlockGraph_Node_t> nodes; ///< The nodes by their tile
+};
+
+/// The counters of the block graphs
+struct BlockGraph_Stats_t
+{
+    size_t builds;           ///< The number of graphs built from scratch
+    size_t refreshedBlocks;  ///< The number of blocks rebuilt because the passability changed
+    size_t paths;            ///< The number of paths planned over the blocks
+};
+
+//------------------------------------------------------------------------------
+//Public functions
+
+/// Build the graph of a mesh from scratch.
+void BlockGraph_build( BlockGraph_t& graph, const ego_mesh_t *mesh, Uint32 stoppedBy );
+
+/**
+ * @brief
+ *  Bring a graph up to date with the passability of its mesh.
+ *  Only the blocks with tiles which changed and the blocks next to them are rebuilt.
+ * @return
+ *  the number of blocks rebuilt
+ */
+size_t BlockGraph_refresh( BlockGraph_t& graph );
+
+/**
+ * @brief
+ *  Plan a path over the blocks and refine it to tiles.
+ * @param context
+ *  receives the path in the same form as AStar_find_path(), so that it can be passed to AStar_get_path()
+ * @return
+ *  @a false if no path was found or both tiles are in the same block
+ */
+bool BlockGraph_find_path( const BlockGraph_t& graph, const int src_ix, const int src_iy, int dst_ix, int dst_iy, AStar_Context_t& context );
+
+/**
+ * @brief
+ *  Get the up-to-date graph of a mesh for some @a stoppedBy bits, building or refreshing it if necessary.
+ * @remark
+ *  This function may be called from several threads. The graphs returned are never changed,
+ *  a graph which needs to be refreshed is copied first.
+ */
+std::shared_ptr<const BlockGraph_t> BlockGraph_get( const ego_mesh_t *mesh, Uint32 stoppedBy );
+
+/// Remove all graphs and reset the counters, e.g. when a mesh is loaded or released
+void BlockGraph_clear_cache();
+
+/// @return the counters since the cache was cleared
+BlockGraph_Stats_t BlockGraph_get_stats();
@@ -0,0 +1,256 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+
+/// @file egolib/AI/FlowField.c
+/// @brief Flow fields for pathfinding goals which are shared by many agents.
+
+#include "egolib/AI/FlowField.h"
+#include "egolib/AI/AStar.h"
+
+#include "game/mesh.h"
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+// the orthogonal neighbours of a tile. The opposite of direction d is d ^ 1.
+static const int flowfield_offsets[4][2] = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
+
+//------------------------------------------------------------------------------
+// The cache of flow fields shared by all threads
+namespace
+{
+struct CacheEntry
+{
+    std::shared_ptr<const FlowField_t> field;   ///< The field or @a nullptr if the goal was only requested once
+    const ego_mesh_t *mesh;
+    Uint32 fxRevision;                          ///< The revision of the mesh when the entry was made
+    Uint32 tick;                                ///< The update when the entry was made
+};
+
+struct Cache
+{
+    std::mutex mutex;
+    std::unordered_map<Uint64, CacheEntry> entries;
+    FlowField_Stats_t stats;
+};
+
+Cache& getCache()
+{
+    static Cache cache;
+    return cache;
+}
+
+bool isFresh( const CacheEntry& entry, const ego_mesh_t *mesh, Uint32 tick )
+{
+    return entry.mesh == mesh && entry.fxRevision == mesh->fxRevision && tick - entry.tick <= FLOWFIELD_LIFETIME;
+}
+}
+
+//------------------------------------------------------------------------------
+FlowField_t::FlowField_t() :
+    goal_ix(0),
+    goal_iy(0),
+    stoppedBy(0),
+    distance(),
+    direction()
+{
+}
+
+//------------------------------------------------------------------------------
+bool FlowField_build( FlowField_t& field, const ego_mesh_t *mesh, Uint32 stoppedBy, int dst_ix, int dst_iy )
+{
+    /// @details A breadth-first search from the goal over the passable tiles.
+    //              Every step costs the same, so the first time a tile is reached is the shortest way.
+
+    if ( !AStar_get_free_destination( mesh, stoppedBy, &dst_ix, &dst_iy ) ) return false;
+
+    TileIndex goal = ego_mesh_t::get_tile_int( mesh, PointGrid(dst_ix, dst_iy) );
+    if ( TileIndex::Invalid == goal ) return false;
+
+    field.distance.assign( mesh->info.tiles_count, FLOWFIELD_UNREACHABLE );
+    field.direction.assign( mesh->info.tiles_count, FLOWFIELD_NO_DIRECTION );
+    field.stoppedBy = stoppedBy;
+    field.goal_ix = dst_ix;
+    field.goal_iy = dst_iy;
+
+    // the goal itself is always reachable, even if it is a pit
+    std::vector<std::pair<int, int>> queue;
+    queue.reserve( mesh->info.tiles_count );
+    queue.push_back( std::make_pair( dst_ix, dst_iy ) );
+    field.distance[goal.getI()] = 0;
+
+    for ( size_t i = 0; i < queue.size(); i++ )
+    {
+        const int ix = queue[i].first;
+        const int iy = queue[i].second;
+        const Uint32 distance = field.distance[ego_mesh_t::get_tile_int( mesh, PointGrid(ix, iy) ).getI()] + 1;
+
+        for ( int d = 0; d < 4; d++ )
+        {
+            const int tmp_x = ix + flowfield_offsets[d][0];
+            const int tmp_y = iy + flowfield_offsets[d][1];
+
+            TileIndex itile = ego_mesh_t::get_tile_int( mesh, PointGrid(tmp_x, tmp_y) );
+            if ( TileIndex::Invalid == itile || FLOWFIELD_UNREACHABLE != field.distance[itile.getI()] ) continue;
+            if ( !AStar_tile_is_passable( mesh, stoppedBy, tmp_x, tmp_y ) ) continue;
+
+            // the next step from the neighbour leads back to this tile
+            field.distance[itile.getI()]  = distance;
+            field.direction[itile.getI()] = static_cast<Uint8>( d ^ 1 );
+            queue.push_back( std::make_pair( tmp_x, tmp_y ) );
+        }
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+bool FlowField_get_path( const FlowField_t& field, const ego_mesh_t *mesh, const int src_ix, const int src_iy, AStar_Context_t& context )
+{
+    context.nodes.clear();
+    context.path.clear();
+
+    TileIndex itile = ego_mesh_t::get_tile_int( mesh, PointGrid(src_ix, src_iy) );
+    if ( TileIndex::Invalid == itile || itile.getI() >= field.distance.size() ) return false;
+    if ( FLOWFIELD_UNREACHABLE == field.distance[itile.getI()] ) return false;
+
+    // follow the directions from the source to the goal
+    int ix = src_ix, iy = src_iy;
+    while ( true )
+    {
+        AStar_Node_t node;
+        node.ix        = ix;
+        node.iy        = iy;
+        node.cost      = static_cast<int>( context.nodes.size() );
+        node.estimate  = node.cost;
+        node.parent    = static_cast<int>( context.nodes.size() ) - 1;
+        node.heapIndex = -1;
+        context.nodes.push_back( node );
+
+        const Uint8 d = field.direction[itile.getI()];
+        if ( FLOWFIELD_NO_DIRECTION == d ) break;
+
+        ix += flowfield_offsets[d][0];
+        iy += flowfield_offsets[d][1];
+        itile = ego_mesh_t::get_tile_int( mesh, PointGrid(ix, iy) );
+    }
+
+    // the path is stored from the destination to the start
+    for ( int node = static_cast<int>( context.nodes.size() ) - 1; node >= 0; node-- )
+    {
+        context.path.push_back( node );
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+std::shared_ptr<const FlowField_t> FlowField_find( const ego_mesh_t *mesh, Uint32 stoppedBy, const int dst_ix, const int dst_iy, Uint32 tick )
+{
+    TileIndex goal = ego_mesh_t::get_tile_int( mesh, PointGrid(dst_ix, dst_iy) );
+    if ( TileIndex::Invalid == goal ) return nullptr;
+
+    const Uint64 key = ( static_cast<Uint64>( stoppedBy ) << 32 ) | goal.getI();
+
+    Cache& cache = getCache();
+    {
+        std::lock_guard<std::mutex> lock( cache.mutex );
+        cache.stats.requests++;
+
+        auto it = cache.entries.find( key );
+        if ( cache.entries.end() != it && isFresh( it->second, mesh, tick ) )
+        {
+            if ( it->second.field )
+            {
+                cache.stats.served++;
+                return it->second.field;
+            }
+        }
+        else
+        {
+            // the first request for this goal, remember it
+            if ( cache.entries.size() >= FLOWFIELD_CACHE_SIZE )
+            {
+                // drop the stale entries, or the oldest one if all of them are fresh
+                for ( auto jt = cache.entries.begin(); jt != cache.entries.end(); )
+                {
+                    if ( isFresh( jt->second, mesh, tick ) ) ++jt;
+                    else jt = cache.entries.erase( jt );
+                }
+                if ( cache.entries.size() >= FLOWFIELD_CACHE_SIZE )
+                {
+                    auto oldest = cache.entries.begin();
+                    for ( auto jt = cache.entries.begin(); jt != cache.entries.end(); ++jt )
+                    {
+                        if ( tick - jt->second.tick > tick - oldest->second.tick ) oldest = jt;
+                    }
+                    cache.entries.erase( oldest );
+                }
+            }
+
+            CacheEntry& entry = cache.entries[key];
+            entry.field = nullptr;
+            entry.mesh = mesh;
+            entry.fxRevision = mesh->fxRevision;
+            entry.tick = tick;
+            return nullptr;
+        }
+    }
+
+    // the goal was requested before, build the field for everyone. The search does not hold the lock,
+    // so that other agents are not blocked while it runs.
+    std::shared_ptr<FlowField_t> field = std::make_shared<FlowField_t>();
+    if ( !FlowField_build( *field, mesh, stoppedBy, dst_ix, dst_iy ) ) return nullptr;
+
+    std::lock_guard<std::mutex> lock( cache.mutex );
+    cache.stats.served++;
+
+    // another thread may have published the same field in the meantime, use the first one
+    auto it = cache.entries.find( key );
+    if ( cache.entries.end() != it && isFresh( it->second, mesh, tick ) && it->second.field )
+    {
+        return it->second.field;
+    }
+    cache.stats.builds++;
+
+    CacheEntry& entry = cache.entries[key];
+    entry.field = field;
+    entry.mesh = mesh;
+    entry.fxRevision = mesh->fxRevision;
+    entry.tick = tick;
+    return field;
+}
+
+//------------------------------------------------------------------------------
+void FlowField_clear_cache()
+{
+    Cache& cache = getCache();
+    std::lock_guard<std::mutex> lock( cache.mutex );
+    cache.entries.clear();
+    cache.stats = FlowField_Stats_t();
+}
+
+//------------------------------------------------------------------------------
+FlowField_Stats_t FlowField_get_stats()
+{
+    Cache& cache = getCache();
+    std::lock_guard<std::mutex> lock( cache.mutex );
+    return cache.stats;
+}
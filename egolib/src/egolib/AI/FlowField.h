@@ -0,0 +1,112 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+
+/// @file egolib/AI/FlowField.h
+/// @brief Flow fields for pathfinding goals which are shared by many agents.
+/// @details A flow field stores, for every tile of the mesh, the number of steps to a goal
+///          and the direction of the next step. It is built once with a breadth-first search
+///          from the goal, and then any agent can follow it to the goal without searching.
+///          The fields are cached by goal tile and @a stoppedBy bits and reused for
+///          FLOWFIELD_LIFETIME updates, or until the passability of the mesh changes.
+
+#pragma once
+
+#include "egolib/typedef.h"
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+// Forward declarations.
+class ego_mesh_t;
+struct AStar_Context_t;
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+/// The number of updates a cached flow field is reused (one second)
+#define FLOWFIELD_LIFETIME      50
+
+/// The maximum number of goals which are cached
+#define FLOWFIELD_CACHE_SIZE    16
+
+/// The distance of a tile from which the goal can not be reached
+#define FLOWFIELD_UNREACHABLE   0xFFFFFFFF
+
+/// The direction of the goal and of the tiles from which the goal can not be reached
+#define FLOWFIELD_NO_DIRECTION  0xFF
+
+struct FlowField_t
+{
+    FlowField_t();
+
+    int    goal_ix, goal_iy;          ///< The goal, after it was moved out of a wall
+    Uint32 stoppedBy;                 ///< The bits of impassable tiles
+
+    std::vector<Uint32> distance;     ///< The number of steps from a tile to the goal
+    std::vector<Uint8>  direction;    ///< The neighbour of a tile which is one step closer to the goal
+};
+
+/// The counters of the flow field cache
+struct FlowField_Stats_t
+{
+    size_t requests;   ///< The number of paths requested from the cache
+    size_t served;     ///< The number of paths followed along a cached field
+    size_t builds;     ///< The number of fields built
+};
+
+//------------------------------------------------------------------------------
+//Public functions
+
+/**
+ * @brief
+ *  Build a flow field towards a destination.
+ * @return
+ *  @a false if the destination is impassable and there is no free tile next to it
+ */
+bool FlowField_build( FlowField_t& field, const ego_mesh_t *mesh, Uint32 stoppedBy, int dst_ix, int dst_iy );
+
+/**
+ * @brief
+ *  Follow a flow field from a source tile to its goal.
+ * @param context
+ *  receives the path in the same form as AStar_find_path(), so that it can be passed to AStar_get_path()
+ * @return
+ *  @a false if the goal can not be reached from the source tile
+ */
+bool FlowField_get_path( const FlowField_t& field, const ego_mesh_t *mesh, const int src_ix, const int src_iy, AStar_Context_t& context );
+
+/**
+ * @brief
+ *  Get the cached flow field towards a destination.
+ * @param tick
+ *  the current update, see update_wld
+ * @return
+ *  the flow field or @a nullptr if the agent should search on its own. A field is only built for a goal
+ *  which is requested a second time within FLOWFIELD_LIFETIME updates, a single agent is better off with A*.
+ * @remark
+ *  This function may be called from several threads. The fields returned are never changed.
+ */
+std::shared_ptr<const FlowField_t> FlowField_find( const ego_mesh_t *mesh, Uint32 stoppedBy, const int dst_ix, const int dst_iy, Uint32 tick );
+
+/// Remove all cached fields and reset the counters, e.g. when the module is released
+void FlowField_clear_cache();
+
+/// @return the counters since the cache was cleared
+FlowField_Stats_t FlowField_get_stats();
@@ -0,0 +1,250 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+/// @file   egolib/Core/PairList.hpp
+/// @brief  A list of unique pairs ordered by time, e.g. for collisions
+
+#pragma once
+
+#include "egolib/platform.h"
+
+namespace Ego
+{
+
+/**
+* @brief
+*	A list of elements describing pairs of objects. Each pair is identified by a 64-bit key
+*	and is stored at most once, each element has a time by which the list can be sorted.
+* @remark
+*	All storage is kept in contiguous, growable buffers which are reused after clear(), so once
+*	the buffers have grown to the size of a busy scene no more heap allocations happen and
+*	the list never runs out of space. Duplicates are rejected with an open addressing hash set
+*	and sort() is a stable LSD radix sort on the time, so it is O(n).
+**/
+template<typename T>
+class PairList
+{
+public:
+	typedef typename std::vector<T>::iterator iterator;
+	typedef typename std::vector<T>::const_iterator const_iterator;
+
+	PairList() :
+		_elements(),
+		_scratch(),
+		_keys(),
+		_times(),
+		_order(),
+		_orderScratch(),
+		_slots(),
+		_slotMask(0)
+	{
+		rehash(INITIAL_SLOTS);
+	}
+
+	/**
+	* @brief
+	*	Make a key for an unordered pair of object identifiers.
+	* @remark
+	*	makeKey(a, b) == makeKey(b, a)
+	**/
+	static uint64_t makeKey(uint32_t a, uint32_t b)
+	{
+		if (a > b) std::swap(a, b);
+		return (static_cast<uint64_t>(a) << 32) | static_cast<uint64_t>(b);
+	}
+
+	/**
+	* @brief
+	*	Add an element unless an element with the same key was already added.
+	* @param key
+	*	the key of the pair, must not be RESERVED_KEY
+	* @param time
+	*	the time used for sorting
+	* @return
+	*	true if the element was added, false if it was a duplicate
+	**/
+	bool insert(const uint64_t key, const float time, const T& element)
+	{
+		if (2 * (_elements.size() + 1) > _slots.size())
+		{
+			rehash(2 * _slots.size());
+		}
+
+		size_t slot = findSlot(key);
+		if (RESERVED_KEY != _slots[slot])
+		{
+			return false;
+		}
+		_slots[slot] = key;
+
+		_elements.push_back(element);
+		_keys.push_back(key);
+		_times.push_back(toSortable(time));
+		return true;
+	}
+
+	/**
+	* @brief
+	*	Get if an element with the given key was added.
+	**/
+	bool contains(const uint64_t key) const
+	{
+		return RESERVED_KEY != _slots[findSlot(key)];
+	}
+
+	/**
+	* @brief
+	*	Order the elements by increasing time. Elements with equal times keep the
+	*	order in which they were inserted.
+	**/
+	void sort()
+	{
+		const size_t size = _elements.size();
+		if (size < 2) return;
+
+		_order.resize(size);
+		_orderScratch.resize(size);
+		for (size_t i = 0; i < size; ++i)
+		{
+			_order[i] = static_cast<uint32_t>(i);
+		}
+
+		// 8 bits per pass, skip passes in which all times have the same digit
+		for (unsigned shift = 0; shift < 32; shift += 8)
+		{
+			size_t counts[256] = {};
+			for (size_t i = 0; i < size; ++i)
+			{
+				counts[(_times[i] >> shift) & 0xFF]++;
+			}
+			if (counts[(_times[0] >> shift) & 0xFF] == size) continue;
+
+			size_t offset = 0;
+			for (size_t digit = 0; digit < 256; ++digit)
+			{
+				size_t count = counts[digit];
+				counts[digit] = offset;
+				offset += count;
+			}
+			for (size_t i = 0; i < size; ++i)
+			{
+				uint32_t index = _order[i];
+				_orderScratch[counts[(_times[index] >> shift) & 0xFF]++] = index;
+			}
+			_order.swap(_orderScratch);
+		}
+
+		// move the elements into their final order
+		_scratch.clear();
+		for (size_t i = 0; i < size; ++i)
+		{
+			_scratch.push_back(_elements[_order[i]]);
+			_orderScratch[i] = _times[_order[i]];
+		}
+		_elements.swap(_scratch);
+		_times.swap(_orderScratch);
+	}
+
+	/**
+	* @brief
+	*	Remove all elements. The capacity of this list is kept.
+	**/
+	void clear()
+	{
+		if (!_keys.empty())
+		{
+			std::fill(_slots.begin(), _slots.end(), RESERVED_KEY);
+		}
+		_elements.clear();
+		_keys.clear();
+		_times.clear();
+	}
+
+	size_t size() const { return _elements.size(); }
+	bool empty() const { return _elements.empty(); }
+
+	T& operator[](const size_t index) { return _elements[index]; }
+	const T& operator[](const size_t index) const { return _elements[index]; }
+
+	iterator begin() { return _elements.begin(); }
+	iterator end() { return _elements.end(); }
+	const_iterator begin() const { return _elements.begin(); }
+	const_iterator end() const { return _elements.end(); }
+
+public:
+	/// A key which can not be used for a pair
+	static const uint64_t RESERVED_KEY = std::numeric_limits<uint64_t>::max();
+
+private:
+	static const size_t INITIAL_SLOTS = 1024;
+
+	/// Map a float to an unsigned integer with the same ordering.
+	static uint32_t toSortable(const float time)
+	{
+		uint32_t bits;
+		std::memcpy(&bits, &time, sizeof(bits));
+		return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+	}
+
+	static size_t hashKey(uint64_t key)
+	{
+		key ^= key >> 33;
+		key *= 0xff51afd7ed558ccdull;
+		key ^= key >> 33;
+		return static_cast<size_t>(key);
+	}
+
+	/// Get the slot holding the key or the empty slot where it would be inserted.
+	size_t findSlot(const uint64_t key) const
+	{
+		size_t slot = hashKey(key) & _slotMask;
+		while (RESERVED_KEY != _slots[slot] && key != _slots[slot])
+		{
+			slot = (slot + 1) & _slotMask;
+		}
+		return slot;
+	}
+
+	void rehash(const size_t slotCount)
+	{
+		_slots.assign(slotCount, RESERVED_KEY);
+		_slotMask = slotCount - 1;
+		for (const uint64_t key : _keys)
+		{
+			_slots[findSlot(key)] = key;
+		}
+	}
+
+	std::vector<T> _elements;
+	std::vector<T> _scratch;            ///< Target buffer of sort()
+	std::vector<uint64_t> _keys;        ///< The key of each element
+	std::vector<uint32_t> _times;       ///< The sortable time of each element
+	std::vector<uint32_t> _order;
+	std::vector<uint32_t> _orderScratch;
+	std::vector<uint64_t> _slots;       ///< Open addressing hash set of keys, the size is a power of two
+	size_t _slotMask;
+};
+
+template<typename T>
+const uint64_t PairList<T>::RESERVED_KEY;
+
+template<typename T>
+const size_t PairList<T>::INITIAL_SLOTS;
+
+} //Ego
@@ -24,10 +24,25 @@
 #pragma once
 
 #include "egolib/Math/Standard.hpp"
+#include <unordered_map>
 
 namespace Ego
 {
 
+/**
+* @brief
+*	A persistent QuadTree. All nodes are kept in a pool which is recycled instead of freed,
+*	so elements can be moved around every update without any heap allocations. An element
+*	is stored in the deepest node that fully contains its bounding box and is only removed and
+*	re-inserted once it leaves the bounds of that node.
+* @remark
+*	Node bounds are cached in flat arrays (one per coordinate) so that a query only touches
+*	contiguous memory while culling nodes. query() visits raw element pointers and does not
+*	touch any reference counts.
+* @remark
+*	The QuadTree does not own its elements. An element must be removed from the tree before
+*	it is destroyed.
+**/
 template<typename T>
 class QuadTree
 {
@@ -37,55 +52,123 @@ public:
 	* @brief
 	*	Construct a root QuadTree node with infinite bounds
 	**/
-	QuadTree() : QuadTree(
-		std::numeric_limits<float>::lowest(), 
-		std::numeric_limits<float>::lowest(), 
-		std::numeric_limits<float>::max(), 
-		std::numeric_limits<float>::max())
+	QuadTree() :
+		_pool(),
+		_minX(),
+		_minY(),
+		_maxX(),
+		_maxY(),
+		_freeBlocks(),
+		_location(),
+		_reinsertions(0)
 	{
-		//ctor	
+		allocateNode(
+			std::numeric_limits<float>::lowest(), 
+			std::numeric_limits<float>::lowest(), 
+			std::numeric_limits<float>::max(), 
+			std::numeric_limits<float>::max(),
+			NO_NODE, 0);
 	}
 
 	/**
 	* @brief
-	*	Inserts an element into this QuadTree
+	*	Inserts an element into this QuadTree. If the element is already part of this
+	*	QuadTree, then its location is updated instead.
 	* @return
 	*	true if the object fits within the bounds of this tree
 	**/
 	bool insert(const std::shared_ptr<T> &element)
 	{
+		const AABB_2D bounds = element->getAABB2D();
+
 		//Element does not belong in this tree
-		if(!element->getAABB2D().overlaps(_bounds)) {
+		if(!overlaps(ROOT, bounds)) {
 			return false;
 		}
 
-		//Check if we have room
-		if(_nodes.size() < QUAD_TREE_NODE_CAPACITY) {
-			_nodes.push_back(element);
+		//Already in the tree, just move it
+		if(_location.find(element.get()) != _location.end()) {
+			update(element);
 			return true;
 		}
 
-		// Otherwise, subdivide and then add the point to whichever node will accept it
-		if(_northWest == nullptr) {
-			subdivide();
+		insertAt(ROOT, element, bounds);
+		return true;
+	}
+
+	/**
+	* @brief
+	*	Update the location of an element in this QuadTree. The element stays in place as long as
+	*	it is contained in its current node. Otherwise it is removed and re-inserted starting at
+	*	the closest ancestor node that contains it. Elements not yet in this QuadTree are inserted.
+	* @return
+	*	true if the element had to be re-inserted
+	**/
+	bool update(const std::shared_ptr<T> &element)
+	{
+		auto it = _location.find(element.get());
+		if(it == _location.end()) {
+			insert(element);
+			return false;
 		}
 
-		//Add element to a sub-tree
-		if(_northWest->insert(element)) {
-			return true;
+		const AABB_2D bounds = element->getAABB2D();
+		const size_t oldNode = it->second;
+
+		//Element has left the tree completely
+		if(!overlaps(ROOT, bounds)) {
+			remove(element.get());
+			return false;
 		}
-		if(_northEast->insert(element)) {
-			return true;
+
+		//Still within the same cell
+		if(fits(oldNode, bounds)) {
+			return false;
 		}
-		if(_southWest->insert(element)) {
-			return true;
+
+		removeFromNode(oldNode, element.get());
+
+		//Walk up until we find a node that can hold the element again
+		size_t nodeIndex = _pool[oldNode].parent;
+		while(!fits(nodeIndex, bounds)) {
+			nodeIndex = _pool[nodeIndex].parent;
 		}
-		if(_southEast->insert(element)) {
-			return true;
+		insertAt(nodeIndex, element, bounds);
+
+		//Give empty cells back to the pool
+		collapse(oldNode);
+
+		_reinsertions++;
+		return true;
+	}
+
+	/**
+	* @brief
+	*	Removes an element from this QuadTree
+	* @return
+	*	true if the element was part of this QuadTree
+	**/
+	bool remove(const T *element)
+	{
+		auto it = _location.find(element);
+		if(it == _location.end()) {
+			return false;
 		}
 
-		//Should never happen
-		throw std::logic_error("unable to add element to QuadTree");
+		const size_t nodeIndex = it->second;
+		_location.erase(it);
+		removeFromNode(nodeIndex, element);
+		collapse(nodeIndex);
+		return true;
+	}
+
+	/**
+	* @return
+	*	true if the specified element is part of this QuadTree
+	**/
+	bool contains(const T *element) const
+	{
+		return _location.find(element) != _location.end();
 	}
 
 	/**
@@ -120,103 +203,420 @@ public:
 	**/
 	void find(const AABB_2D &searchArea, std::vector<std::shared_ptr<T>> &result) const
 	{
-		//Search grid is not part of our bounds
-		if(!_bounds.overlaps(searchArea)) {
-			return;
-		}
+		find(ROOT, searchArea, result);
+	}
 
-		//Check all nodes in this QuadTree
-		for(const std::weak_ptr<T> &weakElement : _nodes) {
-			std::shared_ptr<T> element = weakElement.lock();
+	/**
+	* @brief
+	*	Visit all elements that overlap the search area without allocating memory or
+	*	touching reference counts. Terminated elements are skipped.
+	* @param searchArea
+	*	The bounding box which is used for finding elements
+	* @param visitor
+	*	Callable invoked as visitor(T&) for each element found
+	**/
+	template<typename Visitor>
+	void query(const AABB_2D &searchArea, Visitor &&visitor) const
+	{
+		const float searchMinX = searchArea._min[kX], searchMinY = searchArea._min[kY];
+		const float searchMaxX = searchArea._max[kX], searchMaxY = searchArea._max[kY];
 
-			//Make sure element still exists
-			if(element != nullptr && !element->isTerminated()) {
+		//Each visited node replaces itself with at most four children
+		size_t stack[3 * QUAD_TREE_MAX_DEPTH + 4];
+		size_t top = 0;
+		stack[top++] = ROOT;
 
-				//Check if element is within search area
-				if(element->getAABB2D().overlaps(searchArea)) {
-					result.push_back(element);
+		while(top > 0) {
+			const size_t nodeIndex = stack[--top];
+
+			//Search grid is not part of this node (elements of the root might stick out of the tree)
+			if(nodeIndex != ROOT && (_minX[nodeIndex] > searchMaxX || _maxX[nodeIndex] < searchMinX || 
+			                         _minY[nodeIndex] > searchMaxY || _maxY[nodeIndex] < searchMinY)) {
+				continue;
+			}
+
+			const Node &node = _pool[nodeIndex];
+			for(const Entry &entry : node.elements) {
+				T &element = *entry.element;
+				if(!element.isTerminated() && element.getAABB2D().overlaps(searchArea)) {
+					visitor(element);
 				}
 			}
-		}
 
-		//Check subtrees (if any)
-		if(_northWest != nullptr) {
-			_northWest->find(searchArea, result);
-			_northEast->find(searchArea, result);
-			_southWest->find(searchArea, result);
-			_southEast->find(searchArea, result);
+			if(node.firstChild != NO_NODE) {
+				stack[top++] = node.firstChild + 3;
+				stack[top++] = node.firstChild + 2;
+				stack[top++] = node.firstChild + 1;
+				stack[top++] = node.firstChild + 0;
+			}
 		}
 	}
 
 	/**
 	* @brief
-	*	Clears all elements from this QuadTree and all its children
+	*	Find all elements that overlap the search area without allocating memory (as long as
+	*	the result has enough capacity) or touching reference counts.
+	* @param searchArea
+	*	The bounding box which is used for finding elements
+	* @param result
+	*	Elements found are appended to this vector, it is not cleared
+	**/
+	void query(const AABB_2D &searchArea, std::vector<T*> &result) const
+	{
+		query(searchArea, [&result](T &element) { result.push_back(&element); });
+	}
+
+	/**
+	* @brief
+	*	Clears all elements from this QuadTree and all its children and sets new bounds.
+	*	Nodes are returned to the pool and not deallocated.
 	**/
 	void clear(const float minX, const float minY, const float maxX, const float maxY)
 	{
 		//Reset bounds
-		_bounds._min[kX] = minX;
-		_bounds._min[kY] = minY;
-		_bounds._max[kX] = maxX;
-		_bounds._max[kY] = maxY;
+		_minX[ROOT] = minX;
+		_minY[ROOT] = minY;
+		_maxX[ROOT] = maxX;
+		_maxY[ROOT] = maxY;
+
+		clear();
+	}
+
+	/**
+	* @brief
+	*	Clears all elements from this QuadTree and all its children, keeping the current bounds.
+	*	Nodes are returned to the pool and not deallocated.
+	**/
+	void clear()
+	{
+		for(Node &node : _pool) {
+			node.elements.clear();
+		}
+		_pool[ROOT].firstChild = NO_NODE;
+
+		//Every block of four children is free again
+		_freeBlocks.clear();
+		for(size_t block = ROOT + 1; block < _pool.size(); block += 4) {
+			_freeBlocks.push_back(block);
+		}
+
+		_location.clear();
+	}
+
+	/**
+	* @return
+	*	the bounds of the root node of this QuadTree
+	**/
+	AABB_2D getBounds() const
+	{
+		return AABB_2D(Vector2f(_minX[ROOT], _minY[ROOT]), Vector2f(_maxX[ROOT], _maxY[ROOT]));
+	}
+
+	/**
+	* @return
+	*	number of elements in this QuadTree
+	**/
+	size_t size() const
+	{
+		return _location.size();
+	}
+
+	/**
+	* @return
+	*	number of nodes currently in use (the pool might hold more)
+	**/
+	size_t getNodeCount() const
+	{
+		return _pool.size() - 4*_freeBlocks.size();
+	}
+
+	/**
+	* @return
+	*	number of elements that had to be re-inserted by update() since the last call to resetReinsertionCount()
+	**/
+	size_t getReinsertionCount() const
+	{
+		return _reinsertions;
+	}
 
-		//Clear children and all elements
-		_nodes.clear();
-		_northWest.reset(nullptr);
-		_northEast.reset(nullptr);
-		_southWest.reset(nullptr);
-		_southEast.reset(nullptr);
+	void resetReinsertionCount()
+	{
+		_reinsertions = 0;
 	}
 
 private:
+	static const size_t QUAD_TREE_NODE_CAPACITY = 4;	//< Maximum number of elements in a node before subdivision
+	static const size_t QUAD_TREE_MAX_DEPTH = 10;		//< Nodes at this depth are never subdivided
+	static const size_t ROOT = 0;						//< Index of the root node in the pool
+	static const size_t NO_NODE = std::numeric_limits<size_t>::max();
+
+	struct Entry
+	{
+		Entry(T *pointer, const std::weak_ptr<T> &weak) :
+			element(pointer),
+			weakElement(weak)
+		{
+			//ctor
+		}
+
+		T *element;
+		std::weak_ptr<T> weakElement;
+	};
+
+	struct Node
+	{
+		Node(const size_t parentNode, const size_t nodeDepth) :
+			elements(),
+			parent(parentNode),
+			firstChild(NO_NODE),
+			depth(nodeDepth)
+		{
+			//ctor
+		}
+
+		/**
+		* @brief
+		*	Re-initialize a pooled node, keeping the memory already reserved for elements
+		**/
+		void reset(const size_t parentNode, const size_t nodeDepth)
+		{
+			elements.clear();
+			parent = parentNode;
+			firstChild = NO_NODE;
+			depth = nodeDepth;
+		}
+
+		std::vector<Entry> elements;					//< Elements contained in this node
+		size_t parent;									//< Index of the parent node or NO_NODE
+		size_t firstChild;								//< Index of the first of four consecutive children or NO_NODE
+		size_t depth;
+	};
+
+	/**
+	* @return
+	*	true if the specified node can hold an element with the specified bounds
+	**/
+	bool fits(const size_t nodeIndex, const AABB_2D &bounds) const
+	{
+		//The root also holds elements that are partially outside of the tree
+		if(nodeIndex == ROOT) {
+			return true;
+		}
+
+		return _minX[nodeIndex] <= bounds._min[kX] && _minY[nodeIndex] <= bounds._min[kY]
+		    && _maxX[nodeIndex] >= bounds._max[kX] && _maxY[nodeIndex] >= bounds._max[kY];
+	}
+
+	/**
+	* @return
+	*	true if the bounds of the specified node overlap the specified bounds
+	**/
+	bool overlaps(const size_t nodeIndex, const AABB_2D &bounds) const
+	{
+		return _minX[nodeIndex] <= bounds._max[kX] && _maxX[nodeIndex] >= bounds._min[kX]
+		    && _minY[nodeIndex] <= bounds._max[kY] && _maxY[nodeIndex] >= bounds._min[kY];
+	}
+
 	/**
 	* @brief
-	*	Helper function to subdivide this QuadTree into four more QuadTrees
+	*	Append a new node to the pool
 	**/
-	void subdivide()
+	void allocateNode(const float minX, const float minY, const float maxX, const float maxY, const size_t parentNode, const size_t nodeDepth)
 	{
-		float topLeftX = _bounds.getMin()[kX];
-		float topLeftY = _bounds.getMin()[kY];
+		_pool.emplace_back(parentNode, nodeDepth);
+		_minX.push_back(minX);
+		_minY.push_back(minY);
+		_maxX.push_back(maxX);
+		_maxY.push_back(maxY);
+	}
 
-		float bottomRightX = _bounds.getMax()[kX];
-		float bottomRightY = _bounds.getMax()[kY];
+	/**
+	* @brief
+	*	Re-initialize a pooled node
+	**/
+	void resetNode(const size_t nodeIndex, const float minX, const float minY, const float maxX, const float maxY, const size_t parentNode, const size_t nodeDepth)
+	{
+		_pool[nodeIndex].reset(parentNode, nodeDepth);
+		_minX[nodeIndex] = minX;
+		_minY[nodeIndex] = minY;
+		_maxX[nodeIndex] = maxX;
+		_maxY[nodeIndex] = maxY;
+	}
 
-		float midX = (topLeftX + bottomRightX) * 0.5f;
-		float midY = (topLeftY + bottomRightY) * 0.5f;
+	/**
+	* @return
+	*	the child of the specified node which contains the bounds or NO_NODE if no child does
+	**/
+	size_t findChild(const size_t nodeIndex, const AABB_2D &bounds) const
+	{
+		const size_t firstChild = _pool[nodeIndex].firstChild;
+		for(size_t child = firstChild; child < firstChild + 4; ++child) {
+			if(fits(child, bounds)) {
+				return child;
+			}
+		}
+		return NO_NODE;
+	}
+
+	void insertAt(size_t nodeIndex, const std::shared_ptr<T> &element, const AABB_2D &bounds)
+	{
+		while(true) {
+			if(_pool[nodeIndex].firstChild != NO_NODE) {
+				const size_t child = findChild(nodeIndex, bounds);
+
+				//Element overlaps several children, it has to stay here
+				if(child == NO_NODE) {
+					break;
+				}
+				nodeIndex = child;
+				continue;
+			}
+
+			//Check if we have room
+			if(_pool[nodeIndex].elements.size() < QUAD_TREE_NODE_CAPACITY || _pool[nodeIndex].depth >= QUAD_TREE_MAX_DEPTH) {
+				break;
+			}
 
-		//Allocate memory for the subdivision
-		_northWest = std::unique_ptr<QuadTree<T>>(new QuadTree<T>(topLeftX, topLeftY, midX, midY));
-		_northEast = std::unique_ptr<QuadTree<T>>(new QuadTree<T>(midX, topLeftY, bottomRightX, midY));
-		_southWest = std::unique_ptr<QuadTree<T>>(new QuadTree<T>(topLeftX, midY, midX, bottomRightY));
-		_southEast = std::unique_ptr<QuadTree<T>>(new QuadTree<T>(midX, midY, bottomRightX, bottomRightY));
+			// Otherwise, subdivide and then add the element to whichever node will accept it
+			subdivide(nodeIndex);
+		}
+
+		_pool[nodeIndex].elements.emplace_back(element.get(), element);
+		_location[element.get()] = nodeIndex;
+	}
+
+	void removeFromNode(const size_t nodeIndex, const T *element)
+	{
+		std::vector<Entry> &elements = _pool[nodeIndex].elements;
+		for(size_t i = 0; i < elements.size(); ++i) {
+			if(elements[i].element == element) {
+				elements[i] = elements.back();
+				elements.pop_back();
+				return;
+			}
+		}
+
+		//Should never happen
+		throw std::logic_error("element not found in QuadTree node");
 	}
 
 	/**
 	* @brief
-	*	Private constructor with bounded limits
+	*	Helper function to subdivide this QuadTree node into four more nodes taken from the pool
 	**/
-	QuadTree(const float minX, const float minY, const float maxX, const float maxY) :
-		_bounds(Vector2f(minX, minY), Vector2f(maxX, maxY)),
-		_nodes(),
-		_northWest(nullptr),
-		_northEast(nullptr),
-		_southWest(nullptr),
-		_southEast(nullptr)
+	void subdivide(const size_t nodeIndex)
 	{
-		//ctor
+		float topLeftX = _minX[nodeIndex];
+		float topLeftY = _minY[nodeIndex];
+
+		float bottomRightX = _maxX[nodeIndex];
+		float bottomRightY = _maxY[nodeIndex];
+
+		float midX = topLeftX * 0.5f + bottomRightX * 0.5f;
+		float midY = topLeftY * 0.5f + bottomRightY * 0.5f;
+
+		const size_t depth = _pool[nodeIndex].depth + 1;
+
+		//Reuse a block of four nodes if possible, only allocate memory if the pool is exhausted
+		size_t firstChild;
+		if(!_freeBlocks.empty()) {
+			firstChild = _freeBlocks.back();
+			_freeBlocks.pop_back();
+			resetNode(firstChild + 0, topLeftX, topLeftY, midX, midY, nodeIndex, depth);
+			resetNode(firstChild + 1, midX, topLeftY, bottomRightX, midY, nodeIndex, depth);
+			resetNode(firstChild + 2, topLeftX, midY, midX, bottomRightY, nodeIndex, depth);
+			resetNode(firstChild + 3, midX, midY, bottomRightX, bottomRightY, nodeIndex, depth);
+		}
+		else {
+			firstChild = _pool.size();
+			allocateNode(topLeftX, topLeftY, midX, midY, nodeIndex, depth);
+			allocateNode(midX, topLeftY, bottomRightX, midY, nodeIndex, depth);
+			allocateNode(topLeftX, midY, midX, bottomRightY, nodeIndex, depth);
+			allocateNode(midX, midY, bottomRightX, bottomRightY, nodeIndex, depth);
+		}
+		_pool[nodeIndex].firstChild = firstChild;
+
+		//Push down all elements that fit into one of the new children
+		std::vector<Entry> &elements = _pool[nodeIndex].elements;
+		for(size_t i = 0; i < elements.size(); ) {
+			const size_t child = findChild(nodeIndex, elements[i].element->getAABB2D());
+			if(child == NO_NODE) {
+				++i;
+				continue;
+			}
+			_location[elements[i].element] = child;
+			_pool[child].elements.push_back(elements[i]);
+			elements[i] = elements.back();
+			elements.pop_back();
+		}
 	}
 
-private:
-	static const size_t QUAD_TREE_NODE_CAPACITY = 4;	//< Maximum number of nodes in tree before subdivision
+	/**
+	* @brief
+	*	Returns the children of the parent of the specified node to the pool if they are all
+	*	empty leaves. This is repeated up the tree.
+	**/
+	void collapse(size_t nodeIndex)
+	{
+		while(nodeIndex != ROOT) {
+			const size_t parent = _pool[nodeIndex].parent;
+			const size_t firstChild = _pool[parent].firstChild;
+			for(size_t child = firstChild; child < firstChild + 4; ++child) {
+				if(!_pool[child].elements.empty() || _pool[child].firstChild != NO_NODE) {
+					return;
+				}
+			}
+			_pool[parent].firstChild = NO_NODE;
+			_freeBlocks.push_back(firstChild);
+			nodeIndex = parent;
+		}
+	}
+
+	void find(const size_t nodeIndex, const AABB_2D &searchArea, std::vector<std::shared_ptr<T>> &result) const
+	{
+		const Node &node = _pool[nodeIndex];
+
+		//Search grid is not part of our bounds
+		if(nodeIndex != ROOT && !overlaps(nodeIndex, searchArea)) {
+			return;
+		}
+
+		//Check all elements in this node
+		for(const Entry &entry : node.elements) {
+			std::shared_ptr<T> element = entry.weakElement.lock();
+
+			//Make sure element still exists
+			if(element != nullptr && !element->isTerminated()) {
 
-	AABB_2D _bounds;									//< 2D AABB
+				//Check if element is within search area
+				if(element->getAABB2D().overlaps(searchArea)) {
+					result.push_back(element);
+				}
+			}
+		}
 
-	std::vector<std::weak_ptr<T>> _nodes;				//< List of nodes contained in this QuadTree
+		//Check subtrees (if any)
+		if(node.firstChild != NO_NODE) {
+			for(size_t child = node.firstChild; child < node.firstChild + 4; ++child) {
+				find(child, searchArea, result);
+			}
+		}
+	}
 
-	std::unique_ptr<QuadTree<T>> _northWest;
-	std::unique_ptr<QuadTree<T>> _northEast;
-	std::unique_ptr<QuadTree<T>> _southWest;
-	std::unique_ptr<QuadTree<T>> _southEast;
+private:
+	std::vector<Node> _pool;							//< All nodes, the root node is always at index 0
+	std::vector<float> _minX;							//< Cached node bounds, indexed like _pool
+	std::vector<float> _minY;
+	std::vector<float> _maxX;
+	std::vector<float> _maxY;
+	std::vector<size_t> _freeBlocks;					//< Index of the first node of unused blocks of four nodes in the pool
+	std::unordered_map<const T*, size_t> _location;		//< Node index each element is stored in
+	size_t _reinsertions;								//< Number of elements that had to be re-inserted by update()
 };
 
+template<typename T> const size_t QuadTree<T>::QUAD_TREE_NODE_CAPACITY;
+template<typename T> const size_t QuadTree<T>::QUAD_TREE_MAX_DEPTH;
+template<typename T> const size_t QuadTree<T>::ROOT;
+template<typename T> const size_t QuadTree<T>::NO_NODE;
+
 } //namespace Ego
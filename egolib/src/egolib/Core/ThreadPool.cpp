@@ -0,0 +1,188 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+/// @file   egolib/Core/ThreadPool.cpp
+/// @brief  A pool of worker threads
+
+#include "egolib/Core/ThreadPool.hpp"
+
+namespace Ego
+{
+
+ThreadPool::ThreadPool() :
+    _workers(),
+    _tasks(),
+    _mutex(),
+    _condition(),
+    _terminate(false)
+{
+    // hardware_concurrency() may return 0 if it is unknown
+    const size_t hardwareThreads = std::thread::hardware_concurrency();
+    const size_t workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+    for (size_t i = 0; i < workerCount; ++i)
+    {
+        _workers.emplace_back(&ThreadPool::run, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _terminate = true;
+        _tasks.clear();
+    }
+    _condition.notify_all();
+    for (std::thread& worker : _workers)
+    {
+        worker.join();
+    }
+}
+
+size_t ThreadPool::getWorkerCount() const
+{
+    return _workers.size();
+}
+
+void ThreadPool::run()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _condition.wait(lock, [this] { return _terminate || !_tasks.empty(); });
+            if (_terminate)
+            {
+                return;
+            }
+            task = std::move(_tasks.front());
+            _tasks.pop_front();
+        }
+        task();
+    }
+}
+
+std::future<void> ThreadPool::submit(const std::function<void()>& task)
+{
+    auto packagedTask = std::make_shared<std::packaged_task<void()>>(task);
+    std::future<void> future = packagedTask->get_future();
+
+    // Without workers, run the task right away.
+    if (_workers.empty())
+    {
+        (*packagedTask)();
+        return future;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _tasks.emplace_back([packagedTask]() { (*packagedTask)(); });
+    }
+    _condition.notify_one();
+    return future;
+}
+
+size_t ThreadPool::getChunkCount(size_t count, size_t grain) const
+{
+    if (0 == count)
+    {
+        return 0;
+    }
+    if (0 == grain)
+    {
+        grain = 1;
+    }
+    return std::min(_workers.size() + 1, (count + grain - 1) / grain);
+}
+
+void ThreadPool::parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t, size_t)>& function)
+{
+    const size_t chunkCount = getChunkCount(count, grain);
+    if (chunkCount <= 1)
+    {
+        if (count > 0)
+        {
+            function(0, count, 0);
+        }
+        return;
+    }
+
+    // The state is shared with the helper tasks, a helper which starts after all chunks are
+    // done only touches the state and not the (then possibly destroyed) function.
+    struct State
+    {
+        std::atomic<size_t> next;
+        size_t done;
+        std::exception_ptr exception;
+        std::mutex mutex;
+        std::condition_variable condition;
+    };
+    auto state = std::make_shared<State>();
+    state->next = 0;
+    state->done = 0;
+
+    const std::function<void(size_t, size_t, size_t)> *pfunction = &function;
+    auto work = [state, pfunction, count, chunkCount]()
+    {
+        for (size_t chunk = state->next++; chunk < chunkCount; chunk = state->next++)
+        {
+            const size_t begin = (count * chunk) / chunkCount;
+            const size_t end = (count * (chunk + 1)) / chunkCount;
+            std::exception_ptr exception;
+            try
+            {
+                (*pfunction)(begin, end, chunk);
+            }
+            catch (...)
+            {
+                exception = std::current_exception();
+            }
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (exception && !state->exception)
+            {
+                state->exception = exception;
+            }
+            if (++state->done == chunkCount)
+            {
+                state->condition.notify_all();
+            }
+        }
+    };
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (size_t i = 1; i < chunkCount; ++i)
+        {
+            _tasks.emplace_back(work);
+        }
+    }
+    _condition.notify_all();
+
+    // Take part and wait for the chunks taken by the workers.
+    work();
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->condition.wait(lock, [&state, chunkCount] { return state->done == chunkCount; });
+    if (state->exception)
+    {
+        std::rethrow_exception(state->exception);
+    }
+}
+
+} //Ego
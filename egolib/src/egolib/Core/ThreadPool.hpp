@@ -0,0 +1,112 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+/// @file   egolib/Core/ThreadPool.hpp
+/// @brief  A pool of worker threads
+
+#pragma once
+
+#include "egolib/platform.h"
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <thread>
+
+namespace Ego
+{
+
+/**
+* @brief
+*	A fixed set of worker threads which run tasks from a shared queue.
+* @remark
+*	The number of workers is one less than the number of hardware threads, as the main
+*	thread takes part in parallelFor(). On a single core machine there are no workers and
+*	all work is done by the calling thread.
+**/
+class ThreadPool : public Ego::Core::Singleton<ThreadPool>
+{
+protected:
+    // Befriend with the singleton to grant access to ThreadPool::~ThreadPool.
+    using TheSingleton = Ego::Core::Singleton<ThreadPool>;
+    friend TheSingleton;
+
+    /**
+    * @brief
+    *   Protected constructor, starts the worker threads
+    **/
+    ThreadPool();
+
+    /**
+    * @brief
+    *   Protected deconstructor, waits for the running tasks and stops the worker threads.
+    *   Tasks which did not start yet are discarded.
+    **/
+    virtual ~ThreadPool();
+
+public:
+    /**
+    * @return
+    *   the number of worker threads
+    **/
+    size_t getWorkerCount() const;
+
+    /**
+    * @brief
+    *   Run a task on a worker thread.
+    * @return
+    *   a future which becomes ready when the task is done and which rethrows any exception
+    *   raised by the task
+    **/
+    std::future<void> submit(const std::function<void()>& task);
+
+    /**
+    * @brief
+    *   Get the number of chunks parallelFor() splits a range into.
+    * @param count
+    *   the size of the range
+    * @param grain
+    *   the minimum number of elements per chunk
+    **/
+    size_t getChunkCount(size_t count, size_t grain) const;
+
+    /**
+    * @brief
+    *   Split the range [0, count) into getChunkCount(count, grain) contiguous chunks and call
+    *   function(begin, end, chunk) once for each chunk. The calling thread takes part and this
+    *   function returns after all chunks are done.
+    * @remark
+    *   Chunk k always covers the same elements for the same count and grain, so results
+    *   collected per chunk can be merged in chunk order to get a deterministic result.
+    * @throw
+    *   the first exception raised by the function
+    **/
+    void parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t, size_t)>& function);
+
+private:
+    /// The loop of a worker thread.
+    void run();
+
+    std::vector<std::thread> _workers;
+    std::deque<std::function<void()>> _tasks;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    bool _terminate;
+};
+
+} //Ego
@@ -0,0 +1,288 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+/// @file   egolib/FileFormats/module_bundle_file.c
+/// @brief  A binary bundle of precompiled module data, written by the bake tool
+
+#include "egolib/FileFormats/module_bundle_file.h"
+#include "egolib/vfs.h"
+#include "egolib/log.h"
+
+//--------------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------------
+
+bundle_writer_t::bundle_writer_t(std::vector<char>& buffer) :
+    buffer(buffer)
+{
+}
+
+void bundle_writer_t::writeUint32(Uint32 value)
+{
+    for (size_t i = 0; i < 4; ++i)
+    {
+        buffer.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+void bundle_writer_t::writeSint32(Sint32 value)
+{
+    writeUint32(static_cast<Uint32>(value));
+}
+
+void bundle_writer_t::writeSint64(Sint64 value)
+{
+    const Uint64 bits = static_cast<Uint64>(value);
+    writeUint32(static_cast<Uint32>(bits & 0xFFFFFFFF));
+    writeUint32(static_cast<Uint32>(bits >> 32));
+}
+
+void bundle_writer_t::writeFloat(float value)
+{
+    Uint32 bits;
+    static_assert(sizeof(bits) == sizeof(value), "float must have 32 bits");
+    memcpy(&bits, &value, sizeof(bits));
+    writeUint32(bits);
+}
+
+void bundle_writer_t::writeBytes(const void *data, size_t size)
+{
+    const char *bytes = static_cast<const char *>(data);
+    buffer.insert(buffer.end(), bytes, bytes + size);
+}
+
+//--------------------------------------------------------------------------------------------
+
+bundle_reader_t::bundle_reader_t(const char *data, size_t size) :
+    _begin(data),
+    _position(data),
+    _end(data + size),
+    _good(nullptr != data)
+{
+}
+
+Uint32 bundle_reader_t::readUint32()
+{
+    unsigned char bytes[4];
+    if (!readBytes(bytes, 4))
+    {
+        return 0;
+    }
+    return static_cast<Uint32>(bytes[0]) | (static_cast<Uint32>(bytes[1]) << 8) |
+           (static_cast<Uint32>(bytes[2]) << 16) | (static_cast<Uint32>(bytes[3]) << 24);
+}
+
+Sint32 bundle_reader_t::readSint32()
+{
+    return static_cast<Sint32>(readUint32());
+}
+
+Sint64 bundle_reader_t::readSint64()
+{
+    const Uint64 low = readUint32();
+    const Uint64 high = readUint32();
+    return static_cast<Sint64>(low | (high << 32));
+}
+
+float bundle_reader_t::readFloat()
+{
+    const Uint32 bits = readUint32();
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+bool bundle_reader_t::readBytes(void *data, size_t size)
+{
+    if (!_good || static_cast<size_t>(_end - _position) < size)
+    {
+        _good = false;
+        memset(data, 0, size);
+        return false;
+    }
+    memcpy(data, _position, size);
+    _position += size;
+    return true;
+}
+
+bool bundle_reader_t::skip(size_t size)
+{
+    if (!_good || static_cast<size_t>(_end - _position) < size)
+    {
+        _good = false;
+        return false;
+    }
+    _position += size;
+    return true;
+}
+
+size_t bundle_reader_t::getOffset() const
+{
+    return static_cast<size_t>(_position - _begin);
+}
+
+size_t bundle_reader_t::getRemaining() const
+{
+    return static_cast<size_t>(_end - _position);
+}
+
+size_t bundle_reader_t::readCount(size_t elementSize)
+{
+    const size_t count = readUint32();
+    if (elementSize > 0 && count > getRemaining() / elementSize)
+    {
+        _good = false;
+        return 0;
+    }
+    return count;
+}
+
+bool bundle_reader_t::isGood() const
+{
+    return _good;
+}
+
+bool bundle_reader_t::isAtEnd() const
+{
+    return _position == _end;
+}
+
+//--------------------------------------------------------------------------------------------
+
+module_bundle_t::module_bundle_t() :
+    _data(),
+    _entries()
+{
+}
+
+bool module_bundle_t::load(const std::string& pathname)
+{
+    _data.clear();
+    _entries.clear();
+
+    // Read the whole bundle at once.
+    char *buffer = nullptr;
+    size_t length = 0;
+    if (!vfs_readEntireFile(pathname, &buffer, &length))
+    {
+        return false;
+    }
+    std::vector<char> data(buffer, buffer + length);
+    free(buffer);
+
+    return read(std::move(data));
+}
+
+bool module_bundle_t::read(std::vector<char>&& data)
+{
+    _data = std::move(data);
+    _entries.clear();
+
+    bundle_reader_t reader(_data.data(), _data.size());
+    if (MODULE_BUNDLE_ID != reader.readUint32())
+    {
+        log_warning("%s - not a module bundle\n", __FUNCTION__);
+        _data.clear();
+        return false;
+    }
+    if (CURRENT_MODULE_BUNDLE_VERSION != reader.readUint32())
+    {
+        // An old bundle is not an error, the module is loaded from its sources until it is baked again.
+        log_info("%s - ignoring a bundle of a different version\n", __FUNCTION__);
+        _data.clear();
+        return false;
+    }
+
+    // The entries refer to the data in the buffer, the data is not copied.
+    const Uint32 entryCount = reader.readUint32();
+    for (Uint32 i = 0; i < entryCount && reader.isGood(); ++i)
+    {
+        // a corrupted length fails the reader instead of allocating the name
+        std::string name(reader.readCount(1), '\0');
+        reader.readBytes(&name[0], name.size());
+        Entry entry;
+        entry.stamp.modificationTime = reader.readSint64();
+        entry.stamp.size = reader.readSint64();
+        entry.size = reader.readUint32();
+        entry.offset = reader.getOffset();
+        if (reader.skip(entry.size))
+        {
+            _entries[name] = entry;
+        }
+    }
+
+    if (!reader.isGood())
+    {
+        log_warning("%s - the bundle is corrupted\n", __FUNCTION__);
+        _data.clear();
+        _entries.clear();
+        return false;
+    }
+
+    return true;
+}
+
+bool module_bundle_t::save(const std::string& pathname) const
+{
+    std::vector<char> buffer;
+    bundle_writer_t writer(buffer);
+    writer.writeUint32(MODULE_BUNDLE_ID);
+    writer.writeUint32(CURRENT_MODULE_BUNDLE_VERSION);
+    writer.writeUint32(static_cast<Uint32>(_entries.size()));
+    for (const auto& entry : _entries)
+    {
+        writer.writeUint32(static_cast<Uint32>(entry.first.size()));
+        writer.writeBytes(entry.first.data(), entry.first.size());
+        writer.writeSint64(entry.second.stamp.modificationTime);
+        writer.writeSint64(entry.second.stamp.size);
+        writer.writeUint32(static_cast<Uint32>(entry.second.size));
+        writer.writeBytes(_data.data() + entry.second.offset, entry.second.size);
+    }
+    return vfs_writeEntireFile(pathname, buffer.data(), buffer.size());
+}
+
+void module_bundle_t::add(const std::string& name, const Ego::VFS::FileStamp& stamp, const char *data, size_t size)
+{
+    Entry entry;
+    entry.stamp = stamp;
+    entry.offset = _data.size();
+    entry.size = size;
+    _data.insert(_data.end(), data, data + size);
+    _entries[name] = entry;
+}
+
+bool module_bundle_t::find(const std::string& name, const Ego::VFS::FileStamp& stamp, const char **data, size_t *size) const
+{
+    if (!stamp.isKnown())
+    {
+        return false;
+    }
+    auto it = _entries.find(name);
+    if (_entries.end() == it || it->second.stamp != stamp)
+    {
+        return false;
+    }
+    *data = _data.data() + it->second.offset;
+    *size = it->second.size;
+    return true;
+}
+
+size_t module_bundle_t::getEntryCount() const
+{
+    return _entries.size();
+}
@@ -0,0 +1,183 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+/// @file   egolib/FileFormats/module_bundle_file.h
+/// @brief  A binary bundle of precompiled module data, written by the bake tool
+/// @details A bundle is a header followed by named entries. Each entry stores the modification
+///          time and the size of the file it was baked from, so a loader can fall back to the source
+///          file if the entry is stale. All numbers are stored little-endian.
+///
+///          header:  Uint32 id ('EgoB'), Uint32 version, Uint32 entry count
+///          entry:   Uint32 name length, name, Sint64 modification time, Sint64 file size,
+///                   Uint32 size, size bytes of data
+///
+///          The entries are found by name, the name of the source file they were baked from, and a
+///          loader skips entries it does not look for. The bake tool only writes tris.md2 entries
+///          (see MD2Model::write()). All other module data, e.g. the AI scripts, the profiles and the
+///          mesh, is not baked and always loaded from its sources.
+
+#pragma once
+
+#include "egolib/typedef.h"
+#include "egolib/VFS/FileCache.hpp"
+
+//--------------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------------
+
+#   define MODULE_BUNDLE_ID                 0x426F6745 //'EgoB' in little-endian byte order
+
+/// The version of the bundle format. Increment it if the layout of the bundle or any baked entry
+/// (e.g. MD2Model::write()) changes, so that old bundles are ignored.
+#   define CURRENT_MODULE_BUNDLE_VERSION    2
+
+/// The name of the bundle of a module, in its gamedat directory
+#   define MODULE_BUNDLE_FILENAME           "module.bundle"
+
+//--------------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------------
+
+/// Appends little-endian numbers to a buffer.
+struct bundle_writer_t
+{
+    std::vector<char>& buffer;
+
+    bundle_writer_t(std::vector<char>& buffer);
+
+    void writeUint32(Uint32 value);
+    void writeSint32(Sint32 value);
+    void writeSint64(Sint64 value);
+    void writeFloat(float value);
+    void writeBytes(const void *data, size_t size);
+};
+
+/// Reads little-endian numbers from memory.
+/// Reading past the end fails the reader: it returns zeroes and isGood() returns @a false.
+struct bundle_reader_t
+{
+    bundle_reader_t(const char *data, size_t size);
+
+    Uint32 readUint32();
+    Sint32 readSint32();
+    Sint64 readSint64();
+    float readFloat();
+    bool readBytes(void *data, size_t size);
+    bool skip(size_t size);
+
+    /// @return the number of bytes read or skipped so far
+    size_t getOffset() const;
+
+    /// @return the number of bytes which were not read yet
+    size_t getRemaining() const;
+
+    /// Read the number of elements which follow.
+    /// If there are fewer bytes left than @a count * @a elementSize, the reader fails and zero is returned.
+    size_t readCount(size_t elementSize);
+
+    /// @return @a true if no read failed
+    bool isGood() const;
+
+    /// @return @a true if all data was read
+    bool isAtEnd() const;
+
+private:
+    const char *_begin;
+    const char *_position;
+    const char *_end;
+    bool _good;
+};
+
+//--------------------------------------------------------------------------------------------
+
+/// A bundle of precompiled module data.
+/// The data of all entries is kept in one buffer, a loaded bundle is read with a single read.
+struct module_bundle_t
+{
+    module_bundle_t();
+
+    /**
+     * @brief
+     *  Load a bundle.
+     * @param pathname
+     *  the pathname of the bundle
+     * @return
+     *  @a true on success, @a false if the file does not exist, is of a different version or is corrupted
+     */
+    bool load(const std::string& pathname);
+
+    /**
+     * @brief
+     *  Read a bundle from memory.
+     * @param data
+     *  the content of a bundle file, kept by this bundle
+     * @return
+     *  @a true on success, @a false if the data is of a different version or is corrupted
+     */
+    bool read(std::vector<char>&& data);
+
+    /**
+     * @brief
+     *  Save this bundle.
+     * @param pathname
+     *  the pathname of the bundle
+     * @return
+     *  @a true on success, @a false otherwise
+     */
+    bool save(const std::string& pathname) const;
+
+    /**
+     * @brief
+     *  Add an entry to this bundle, replacing an entry of the same name.
+     * @param name
+     *  the name of the entry, usually the pathname of the source file
+     * @param stamp
+     *  the stamp of the source file, see Ego::VFS::FileStamp::of()
+     * @param data, size
+     *  the data of the entry
+     */
+    void add(const std::string& name, const Ego::VFS::FileStamp& stamp, const char *data, size_t size);
+
+    /**
+     * @brief
+     *  Find an entry which is up to date.
+     * @param name
+     *  the name of the entry
+     * @param stamp
+     *  the stamp of the source file. If it is unknown or differs from the baked stamp,
+     *  the entry is stale and not found.
+     * @param [out] data, size
+     *  the data of the entry. The data is owned by this bundle.
+     * @return
+     *  @a true if the entry was found, @a false otherwise
+     */
+    bool find(const std::string& name, const Ego::VFS::FileStamp& stamp, const char **data, size_t *size) const;
+
+    /// @return the number of entries
+    size_t getEntryCount() const;
+
+private:
+    struct Entry
+    {
+        Ego::VFS::FileStamp stamp;
+        size_t offset;
+        size_t size;
+    };
+
+    std::vector<char> _data;
+    std::unordered_map<std::string, Entry> _entries;
+};
@@ -0,0 +1,204 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+/// @file egolib/Graphics/MD2Interpolator.cpp
+/// @brief Interpolation of the vertices between two frames of a MD2 model
+
+#include "egolib/Graphics/MD2Interpolator.hpp"
+#include "egolib/Graphics/MD2Model.hpp"
+#include "egolib/log.h"
+
+// The SIMD kernels are compiled for their instruction set even if the rest of the code is not,
+// they are only called if the CPU supports them.
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#   define MD2_INTERPOLATOR_X86
+#   include <immintrin.h>
+#endif
+
+#if defined(__GNUC__)
+#   define MD2_INTERPOLATOR_TARGET(name) __attribute__((target(name)))
+#else
+#   define MD2_INTERPOLATOR_TARGET(name)
+#endif
+
+static void interpolateScalar(char *dst, size_t stride, const MD2_FrameArrays &lst, const MD2_FrameArrays &nxt, int vmin, int vmax, float flip)
+{
+    for (int i = vmin; i <= vmax; ++i)
+    {
+        MD2_InterpolatedVertex *vertex = reinterpret_cast<MD2_InterpolatedVertex *>(dst + i * stride);
+
+        vertex->pos[kX] = lst.posX[i] + (nxt.posX[i] - lst.posX[i]) * flip;
+        vertex->pos[kY] = lst.posY[i] + (nxt.posY[i] - lst.posY[i]) * flip;
+        vertex->pos[kZ] = lst.posZ[i] + (nxt.posZ[i] - lst.posZ[i]) * flip;
+        vertex->pos[kW] = 1.0f;
+
+        vertex->nrm[kX] = lst.nrmX[i] + (nxt.nrmX[i] - lst.nrmX[i]) * flip;
+        vertex->nrm[kY] = lst.nrmY[i] + (nxt.nrmY[i] - lst.nrmY[i]) * flip;
+        vertex->nrm[kZ] = lst.nrmZ[i] + (nxt.nrmZ[i] - lst.nrmZ[i]) * flip;
+
+        vertex->env[kX] = lst.envX[i] + (nxt.envX[i] - lst.envX[i]) * flip;
+        vertex->env[kY] = 0.5f * (1.0f + vertex->nrm[kZ]);
+    }
+}
+
+#if defined(MD2_INTERPOLATOR_X86)
+
+/// Transpose 4 interpolated vertices from SoA to AoS and store them
+MD2_INTERPOLATOR_TARGET("sse")
+static inline void storeSSE(char *dst, size_t stride, __m128 px, __m128 py, __m128 pz, __m128 nx, __m128 ny, __m128 nz, __m128 ex)
+{
+    float ey[4];
+    _mm_storeu_ps(ey, _mm_mul_ps(_mm_set1_ps(0.5f), _mm_add_ps(_mm_set1_ps(1.0f), nz)));
+
+    __m128 pw = _mm_set1_ps(1.0f);
+    _MM_TRANSPOSE4_PS(px, py, pz, pw);
+    _MM_TRANSPOSE4_PS(nx, ny, nz, ex);
+
+    // pos[0..3], then nrm[0..2] and env[0] are contiguous
+    const __m128 pos[4] = {px, py, pz, pw};
+    const __m128 nrm[4] = {nx, ny, nz, ex};
+    for (int k = 0; k < 4; ++k)
+    {
+        float *vertex = reinterpret_cast<float *>(dst + k * stride);
+        _mm_storeu_ps(vertex + 0, pos[k]);
+        _mm_storeu_ps(vertex + 4, nrm[k]);
+        vertex[8] = ey[k];
+    }
+}
+
+MD2_INTERPOLATOR_TARGET("sse")
+static void interpolateSSE(char *dst, size_t stride, const MD2_FrameArrays &lst, const MD2_FrameArrays &nxt, int vmin, int vmax, float flip)
+{
+    const __m128 f = _mm_set1_ps(flip);
+    int i = vmin;
+    for (; i + 3 <= vmax; i += 4)
+    {
+#define LERP(array) _mm_add_ps(_mm_loadu_ps(&lst.array[i]), _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&nxt.array[i]), _mm_loadu_ps(&lst.array[i])), f))
+        storeSSE(dst + i * stride, stride, LERP(posX), LERP(posY), LERP(posZ), LERP(nrmX), LERP(nrmY), LERP(nrmZ), LERP(envX));
+#undef LERP
+    }
+
+    // the remaining vertices
+    interpolateScalar(dst, stride, lst, nxt, i, vmax, flip);
+}
+
+MD2_INTERPOLATOR_TARGET("avx")
+static void interpolateAVX(char *dst, size_t stride, const MD2_FrameArrays &lst, const MD2_FrameArrays &nxt, int vmin, int vmax, float flip)
+{
+    const __m256 f = _mm256_set1_ps(flip);
+    int i = vmin;
+    for (; i + 7 <= vmax; i += 8)
+    {
+#define LERP(array) _mm256_add_ps(_mm256_loadu_ps(&lst.array[i]), _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(&nxt.array[i]), _mm256_loadu_ps(&lst.array[i])), f))
+        const __m256 px = LERP(posX), py = LERP(posY), pz = LERP(posZ);
+        const __m256 nx = LERP(nrmX), ny = LERP(nrmY), nz = LERP(nrmZ);
+        const __m256 ex = LERP(envX);
+#undef LERP
+
+        // the transposition is done in two halves of 4 vertices
+#define LOW(v) _mm256_castps256_ps128(v)
+#define HIGH(v) _mm256_extractf128_ps(v, 1)
+        storeSSE(dst + i * stride, stride, LOW(px), LOW(py), LOW(pz), LOW(nx), LOW(ny), LOW(nz), LOW(ex));
+        storeSSE(dst + (i + 4) * stride, stride, HIGH(px), HIGH(py), HIGH(pz), HIGH(nx), HIGH(ny), HIGH(nz), HIGH(ex));
+#undef LOW
+#undef HIGH
+    }
+
+    // the remaining vertices
+    interpolateSSE(dst, stride, lst, nxt, i, vmax, flip);
+}
+
+#endif
+
+bool MD2Interpolator::isSupported(Kernel kernel)
+{
+    switch (kernel)
+    {
+        case Kernel::Scalar:
+            return true;
+#if defined(MD2_INTERPOLATOR_X86)
+        case Kernel::SSE:
+            return SDL_TRUE == SDL_HasSSE();
+        case Kernel::AVX:
+            return SDL_TRUE == SDL_HasAVX();
+#endif
+        default:
+            return false;
+    }
+}
+
+MD2Interpolator::Kernel MD2Interpolator::getBestKernel()
+{
+    static const Kernel best = []()
+    {
+        Kernel kernel = Kernel::Scalar;
+        if (isSupported(Kernel::AVX))
+        {
+            kernel = Kernel::AVX;
+        }
+        else if (isSupported(Kernel::SSE))
+        {
+            kernel = Kernel::SSE;
+        }
+        log_info("MD2Interpolator - using the %s kernel\n", getName(kernel));
+        return kernel;
+    }();
+    return best;
+}
+
+const char *MD2Interpolator::getName(Kernel kernel)
+{
+    switch (kernel)
+    {
+        case Kernel::Scalar: return "scalar";
+        case Kernel::SSE:    return "SSE";
+        case Kernel::AVX:    return "AVX";
+        default:             return "unknown";
+    }
+}
+
+void MD2Interpolator::interpolate(void *dst, size_t stride, const MD2_FrameArrays &lst, const MD2_FrameArrays &nxt, int vmin, int vmax, float flip)
+{
+    interpolate(getBestKernel(), dst, stride, lst, nxt, vmin, vmax, flip);
+}
+
+void MD2Interpolator::interpolate(Kernel kernel, void *dst, size_t stride, const MD2_FrameArrays &lst, const MD2_FrameArrays &nxt, int vmin, int vmax, float flip)
+{
+    // Copy a frame exactly instead of interpolating it with a flip of 0 or 1
+    if (1.0f == flip)
+    {
+        interpolate(kernel, dst, stride, nxt, nxt, vmin, vmax, 0.0f);
+        return;
+    }
+
+    char *bytes = static_cast<char *>(dst);
+    switch (kernel)
+    {
+#if defined(MD2_INTERPOLATOR_X86)
+        case Kernel::SSE:
+            interpolateSSE(bytes, stride, lst, nxt, vmin, vmax, flip);
+            break;
+        case Kernel::AVX:
+            interpolateAVX(bytes, stride, lst, nxt, vmin, vmax, flip);
+            break;
+#endif
+        default:
+            interpolateScalar(bytes, stride, lst, nxt, vmin, vmax, flip);
+            break;
+    }
+}
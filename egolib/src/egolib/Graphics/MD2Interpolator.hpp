@@ -0,0 +1,76 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+/// @file egolib/Graphics/MD2Interpolator.hpp
+/// @brief Interpolation of the vertices between two frames of a MD2 model
+#pragma once
+
+#include "egolib/typedef.h"
+
+class MD2_FrameArrays;
+
+/**
+* @brief A vertex written by MD2Interpolator. The layout matches the beginning of the vertex used by the renderer.
+**/
+struct MD2_InterpolatedVertex
+{
+    float pos[4];
+    float nrm[3];
+    float env[2];
+};
+
+/**
+* @brief Interpolates the vertices between two frames of a MD2 model
+* @details The kernels read MD2_FrameArrays. The SSE and AVX kernels are only used if the CPU supports them,
+*          the best supported kernel is selected the first time it is needed.
+**/
+class MD2Interpolator
+{
+public:
+    enum class Kernel
+    {
+        Scalar,
+        SSE,
+        AVX,
+    };
+
+    /// @return @a true if the CPU supports the kernel
+    static bool isSupported(Kernel kernel);
+
+    /// @return the fastest kernel the CPU supports
+    static Kernel getBestKernel();
+
+    /// @return the name of the kernel, e.g. for logging
+    static const char *getName(Kernel kernel);
+
+    /**
+    * @brief Interpolate the vertices vmin to vmax (inclusive) with the best kernel.
+    * @param dst the first vertex to write. Vertex @a i is written to <tt>dst + i * stride</tt> bytes.
+    * @param stride the size of a vertex in bytes, at least sizeof(MD2_InterpolatedVertex)
+    * @param lst, nxt the frames to interpolate
+    * @param flip 0 for the vertices of @a lst, 1 for the vertices of @a nxt
+    * @remark There is no bounds checking, @a vmax must be less than the vertex count of the frames.
+    **/
+    static void interpolate(void *dst, size_t stride, const MD2_FrameArrays &lst, const MD2_FrameArrays &nxt, int vmin, int vmax, float flip);
+
+    /**
+    * @brief Interpolate the vertices with a given kernel, e.g. to compare the kernels.
+    * @remark The kernel must be supported.
+    **/
+    static void interpolate(Kernel kernel, void *dst, size_t stride, const MD2_FrameArrays &lst, const MD2_FrameArrays &nxt, int vmin, int vmax, float flip);
+};
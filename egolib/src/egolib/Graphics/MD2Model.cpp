@@ -23,6 +23,7 @@
 #include "egolib/Graphics/MD2Model.hpp"
 #include "egolib/_math.h"
 #include "egolib/bbox.h"
+#include "egolib/FileFormats/module_bundle_file.h"
 
 static const float MD2_NORMALS[EGO_NORMAL_COUNT][3] =
 {
@@ -36,7 +37,8 @@ MD2Model::MD2Model() :
 	_texCoords(),
 	_triangles(),
 	_frames(),
-	_commands()
+	_commands(),
+	_triangleList()
 {
 	//ctor
 }
@@ -46,6 +48,35 @@ float MD2Model::getMD2Normal(size_t normal, size_t index)
 	return MD2_NORMALS[normal][index];
 }
 
+float MD2Model::getMD2EnviroX(size_t normal)
+{
+	return std::atan2(MD2_NORMALS[normal][1], MD2_NORMALS[normal][0]) * Ego::Math::invTwoPi<float>();
+}
+
+void MD2Model::updateFrameArrays()
+{
+    const size_t paddedCount = (_vertices + MD2_FrameArrays::PADDING - 1) / MD2_FrameArrays::PADDING * MD2_FrameArrays::PADDING;
+    for(MD2_Frame &frame : _frames)
+    {
+        MD2_FrameArrays &arrays = frame.arrays;
+        for(std::vector<float> *array : {&arrays.posX, &arrays.posY, &arrays.posZ, &arrays.nrmX, &arrays.nrmY, &arrays.nrmZ, &arrays.envX})
+        {
+            array->assign(paddedCount, 0.0f);
+        }
+        for(size_t i = 0; i < frame.vertexList.size() && i < paddedCount; ++i)
+        {
+            const MD2_Vertex &vertex = frame.vertexList[i];
+            arrays.posX[i] = vertex.pos[kX];
+            arrays.posY[i] = vertex.pos[kY];
+            arrays.posZ[i] = vertex.pos[kZ];
+            arrays.nrmX[i] = vertex.nrm[kX];
+            arrays.nrmY[i] = vertex.nrm[kY];
+            arrays.nrmZ[i] = vertex.nrm[kZ];
+            arrays.envX[i] = getMD2EnviroX(vertex.normal);
+        }
+    }
+}
+
 void MD2Model::scaleModel(const float scaleX, const float scaleY, const float scaleZ)
 {
     for(MD2_Frame &frame : _frames)
@@ -97,6 +128,53 @@ void MD2Model::scaleModel(const float scaleX, const float scaleY, const float sc
         }
 #endif
     }
+
+    updateFrameArrays();
+}
+
+void MD2Model::updateTriangleList()
+{
+    _triangleList.indices.clear();
+    _triangleList.texCoords.clear();
+
+    for(const MD2_GLCommand &command : _commands)
+    {
+        // Each strip or fan of n vertices has n - 2 triangles. Triangles with invalid vertices are left out.
+        const std::vector<id_glcmd_packed_t> &data = command.data;
+        for(size_t i = 0; i + 2 < data.size(); ++i)
+        {
+            const id_glcmd_packed_t *corners[3];
+            if(GL_TRIANGLE_FAN == command.glMode)
+            {
+                corners[0] = &data[0];
+                corners[1] = &data[i + 1];
+                corners[2] = &data[i + 2];
+            }
+            else
+            {
+                // every other triangle of a strip is flipped to keep the winding of the strip
+                corners[0] = &data[(0 == i % 2) ? i : i + 1];
+                corners[1] = &data[(0 == i % 2) ? i + 1 : i];
+                corners[2] = &data[i + 2];
+            }
+
+            bool valid = true;
+            for(const id_glcmd_packed_t *corner : corners)
+            {
+                valid = valid && corner->index >= 0 && static_cast<size_t>(corner->index) < _vertices;
+            }
+            if(!valid)
+            {
+                continue;
+            }
+
+            for(const id_glcmd_packed_t *corner : corners)
+            {
+                _triangleList.indices.push_back(static_cast<uint16_t>(corner->index));
+                _triangleList.texCoords.push_back(fvec2_t(corner->s, corner->t));
+            }
+        }
+    }
 }
 
 void MD2Model::makeEquallyLit()
@@ -108,21 +186,82 @@ void MD2Model::makeEquallyLit()
 	        vertex.normal = EGO_NORMAL_COUNT-1;
 	    }
 	}
+
+	updateFrameArrays();
 }
 
-std::shared_ptr<MD2Model> MD2Model::loadFromFile(const std::string &fileName)
+namespace
 {
-    id_md2_header_t md2Header;
 
-    // Open up the file, and make sure it's a MD2 model
-    vfs_FILE *f = vfs_openRead(fileName);
-    if(!f)
+/// Reads the raw structures of a MD2 file in memory, like vfs_seek() and vfs_read() read them from the file.
+/// Reading past the end fails the reader and yields zeroes.
+struct MD2Reader
+{
+    const char *data;
+    size_t size;
+    size_t position;
+    bool good;
+
+    MD2Reader(const char *data, size_t size) :
+        data(data), size(size), position(0), good(true)
+    {
+    }
+
+    /// @return @a true if @a count elements of @a elementSize bytes fit into the data at @a offset
+    bool fits(int offset, int count, size_t elementSize) const
+    {
+        return offset >= 0 && count >= 0 && static_cast<size_t>(offset) <= size &&
+               static_cast<size_t>(count) <= (size - offset) / elementSize;
+    }
+
+    void seek(int offset)
+    {
+        if (offset < 0 || static_cast<size_t>(offset) > size)
+        {
+            good = false;
+            return;
+        }
+        position = offset;
+    }
+
+    void read(void *buffer, size_t elementSize, size_t count)
+    {
+        const size_t length = elementSize * count;
+        if (!good || length > size - position)
+        {
+            good = false;
+            memset(buffer, 0, length);
+            return;
+        }
+        memcpy(buffer, data + position, length);
+        position += length;
+    }
+};
+
+} // anonymous namespace
+
+std::shared_ptr<MD2Model> MD2Model::loadFromFile(const std::string &fileName)
+{
+    char *data = nullptr;
+    size_t size = 0;
+    if (!vfs_readEntireFile(fileName, &data, &size))
     {
         log_warning("MD2Model::loadFromFile() - could not open model (%s)\n", fileName.c_str());
         return nullptr;
     }
 
-    vfs_read(&md2Header, sizeof(md2Header), 1, f);
+    std::shared_ptr<MD2Model> model = loadFromMemory(data, size, fileName);
+    free(data);
+    return model;
+}
+
+std::shared_ptr<MD2Model> MD2Model::loadFromMemory(const char *data, size_t size, const std::string &fileName)
+{
+    id_md2_header_t md2Header;
+
+    // Make sure it's a MD2 model
+    MD2Reader f(data, size);
+    f.read(&md2Header, sizeof(md2Header), 1);
 
     // Convert the byte ordering in the md2Header, if we need to
     md2Header.ident            = ENDIAN_TO_SYS_INT32( md2Header.ident );
@@ -143,10 +282,20 @@ std::shared_ptr<MD2Model> MD2Model::loadFromFile(const std::string &fileName)
     md2Header.offset_glcmds    = ENDIAN_TO_SYS_INT32( md2Header.offset_glcmds );
     md2Header.offset_end       = ENDIAN_TO_SYS_INT32( md2Header.offset_end );
 
-    if (md2Header.ident != MD2_MAGIC_NUMBER || md2Header.version != MD2_VERSION)
+    if (!f.good || md2Header.ident != MD2_MAGIC_NUMBER || md2Header.version != MD2_VERSION)
+    {
+        log_warning( "MD2Model::loadFromMemory() - model does not have valid header or identifier (%s)\n", fileName.c_str() );
+        return NULL;
+    }
+
+    // Make sure the arrays are in the data before they are allocated
+    if (!f.fits(md2Header.offset_st, md2Header.num_st, sizeof(id_md2_texcoord_t)) ||
+        !f.fits(md2Header.offset_tris, md2Header.num_tris, sizeof(id_md2_triangle_t)) ||
+        !f.fits(md2Header.offset_skins, md2Header.num_skins, sizeof(id_md2_skin_t)) ||
+        md2Header.num_vertices < 0 ||
+        !f.fits(md2Header.offset_frames, md2Header.num_frames, sizeof(id_md2_frame_header_t) + md2Header.num_vertices * sizeof(id_md2_vertex_t)))
     {
-        vfs_close( f );
-        log_warning( "MD2Model::loadFromFile() - model does not have valid header or identifier (%s)\n", fileName.c_str() );
+        log_warning( "MD2Model::loadFromMemory() - model is truncated (%s)\n", fileName.c_str() );
         return NULL;
     }
 
@@ -154,7 +303,7 @@ std::shared_ptr<MD2Model> MD2Model::loadFromFile(const std::string &fileName)
     std::shared_ptr<MD2Model> model = std::make_shared<MD2Model>();
     if(!model)
     {
-        log_error( "MD2Model::loadFromFile() - could create MD2Model\n" );
+        log_error( "MD2Model::loadFromMemory() - could create MD2Model\n" );
         return NULL;
     }
 
@@ -171,11 +320,11 @@ std::shared_ptr<MD2Model> MD2Model::loadFromFile(const std::string &fileName)
     }
 
     // Load the texture coordinates from the file, normalizing them as we go
-    vfs_seek(f, md2Header.offset_st);
+    f.seek(md2Header.offset_st);
     for(MD2_TexCoord& texCoord : model->_texCoords)
     {
         id_md2_texcoord_t tc;
-        vfs_read(&tc, sizeof(tc), 1, f);
+        f.read(&tc, sizeof(tc), 1);
 
         // auto-convert the byte ordering of the texture coordinates
         tc.s = ENDIAN_TO_SYS_INT16( tc.s );
@@ -187,8 +336,8 @@ std::shared_ptr<MD2Model> MD2Model::loadFromFile(const std::string &fileName)
 
     // Load triangles from the file.  I use the same memory layout as the file
     // on a little endian machine, so they can just be read directly
-    vfs_seek(f, md2Header.offset_tris);
-    vfs_read(model->_triangles.data(), sizeof(id_md2_triangle_t), md2Header.num_tris, f);
+    f.seek(md2Header.offset_tris);
+    f.read(model->_triangles.data(), sizeof(id_md2_triangle_t), md2Header.num_tris);
 
     // auto-convert the byte ordering on the triangles
     for(MD2_Triangle &tris : model->_triangles)
@@ -201,17 +350,17 @@ std::shared_ptr<MD2Model> MD2Model::loadFromFile(const std::string &fileName)
     }
 
     // Load the skin names.  Again, I can load them directly
-    vfs_seek(f, md2Header.offset_skins);
-    vfs_read(model->_skins.data(), sizeof(id_md2_skin_t), md2Header.num_skins, f);
+    f.seek(md2Header.offset_skins);
+    f.read(model->_skins.data(), sizeof(id_md2_skin_t), md2Header.num_skins);
 
     // Load the frames of animation
-    vfs_seek(f, md2Header.offset_frames);
+    f.seek(md2Header.offset_frames);
     for(MD2_Frame &frame : model->_frames)
     {
         id_md2_frame_header_t frame_header;
 
         // read the current frame
-        vfs_read(&frame_header, sizeof(frame_header), 1, f);
+        f.read(&frame_header, sizeof(frame_header), 1);
 
         // Convert the byte ordering on the scale & translate vectors, if necessary
 #if SDL_BYTEORDER != SDL_LIL_ENDIAN
@@ -232,7 +381,7 @@ std::shared_ptr<MD2Model> MD2Model::loadFromFile(const std::string &fileName)
             id_md2_vertex_t frame_vert;
 
             // read vertex_lst one-by-one. I hope this is not endian dependent, but I have no way to check it.
-            vfs_read(&frame_vert, sizeof( id_md2_vertex_t ), 1, f);
+            f.read(&frame_vert, sizeof( id_md2_vertex_t ), 1);
 
             // grab the vertex position
             vertex.pos[kX] = frame_vert.v[0] * frame_header.scale[0] + frame_header.translate[0];
@@ -274,7 +423,7 @@ std::shared_ptr<MD2Model> MD2Model::loadFromFile(const std::string &fileName)
         int32_t  cmd_size = 0;
 
         // seek to the ogl command offset
-        vfs_seek(f, md2Header.offset_glcmds);
+        f.seek(md2Header.offset_glcmds);
 
         //count the commands
         cmd_size = 0;
@@ -282,7 +431,7 @@ std::shared_ptr<MD2Model> MD2Model::loadFromFile(const std::string &fileName)
         {
             int32_t commands;
 
-            vfs_read( &commands, sizeof(int32_t), 1, f );
+            f.read( &commands, sizeof(int32_t), 1 );
             cmd_size += sizeof(int32_t) / sizeof(int32_t);
 
             // auto-convert the byte ordering
@@ -304,11 +453,18 @@ std::shared_ptr<MD2Model> MD2Model::loadFromFile(const std::string &fileName)
                 cmd.glMode = GL_TRIANGLE_FAN;
             }
 
+            // make sure the data is there before it is allocated
+            if (!f.fits(static_cast<int>(f.position), cmd.commandCount, sizeof(id_glcmd_packed_t)))
+            {
+                f.good = false;
+                break;
+            }
+
             //allocate the data
             cmd.data.resize(cmd.commandCount);
 
             //read in the data
-            vfs_read(cmd.data.data(), sizeof(id_glcmd_packed_t), cmd.commandCount, f);
+            f.read(cmd.data.data(), sizeof(id_glcmd_packed_t), cmd.commandCount);
             cmd_size += (sizeof(id_glcmd_packed_t) * cmd.commandCount) / sizeof(uint32_t);
 
             //translate the data, if necessary
@@ -330,8 +486,156 @@ std::shared_ptr<MD2Model> MD2Model::loadFromFile(const std::string &fileName)
         //model->_numCommands = cmd_cnt;
     }
 
-    // Close the file, we're done with it
-    vfs_close(f);
+    if (!f.good)
+    {
+        log_warning( "MD2Model::loadFromMemory() - model is truncated (%s)\n", fileName.c_str() );
+        return NULL;
+    }
+
+    model->updateFrameArrays();
+    model->updateTriangleList();
+
+    return model;
+}
+
+void MD2Model::write(bundle_writer_t &writer) const
+{
+    writer.writeUint32(_vertices);
+
+    writer.writeUint32(_skins.size());
+    writer.writeBytes(_skins.data(), _skins.size() * sizeof(MD2_SkinName));
+
+    writer.writeUint32(_texCoords.size());
+    for(const MD2_TexCoord &texCoord : _texCoords)
+    {
+        writer.writeFloat(texCoord.tex[SS]);
+        writer.writeFloat(texCoord.tex[TT]);
+    }
+
+    writer.writeUint32(_triangles.size());
+    for(const MD2_Triangle &triangle : _triangles)
+    {
+        for (size_t v = 0; v < 3; ++v)
+        {
+            writer.writeUint32(triangle.vertex[v]);
+            writer.writeUint32(triangle.st[v]);
+        }
+    }
+
+    // The bounding boxes are not written, read() computes them from the vertices
+    writer.writeUint32(_frames.size());
+    for(const MD2_Frame &frame : _frames)
+    {
+        writer.writeBytes(frame.name, sizeof(frame.name));
+        for(const MD2_Vertex &vertex : frame.vertexList)
+        {
+            writer.writeFloat(vertex.pos[kX]);
+            writer.writeFloat(vertex.pos[kY]);
+            writer.writeFloat(vertex.pos[kZ]);
+            writer.writeFloat(vertex.nrm[kX]);
+            writer.writeFloat(vertex.nrm[kY]);
+            writer.writeFloat(vertex.nrm[kZ]);
+            writer.writeUint32(vertex.normal);
+        }
+    }
+
+    writer.writeUint32(std::distance(_commands.begin(), _commands.end()));
+    for(const MD2_GLCommand &command : _commands)
+    {
+        writer.writeUint32(command.glMode);
+        writer.writeUint32(command.data.size());
+        for(const id_glcmd_packed_t &data : command.data)
+        {
+            writer.writeFloat(data.s);
+            writer.writeFloat(data.t);
+            writer.writeSint32(data.index);
+        }
+    }
+}
+
+std::shared_ptr<MD2Model> MD2Model::read(bundle_reader_t &reader)
+{
+    std::shared_ptr<MD2Model> model = std::make_shared<MD2Model>();
+
+    // The counts are checked against the remaining data before anything is allocated
+    model->_vertices = reader.readCount(7 * 4);
+
+    model->_skins.resize(reader.readCount(sizeof(MD2_SkinName)));
+    reader.readBytes(model->_skins.data(), model->_skins.size() * sizeof(MD2_SkinName));
+
+    model->_texCoords.resize(reader.readCount(2 * 4));
+    for(MD2_TexCoord &texCoord : model->_texCoords)
+    {
+        texCoord.tex[SS] = reader.readFloat();
+        texCoord.tex[TT] = reader.readFloat();
+    }
+
+    model->_triangles.resize(reader.readCount(6 * 4));
+    for(MD2_Triangle &triangle : model->_triangles)
+    {
+        for (size_t v = 0; v < 3; ++v)
+        {
+            triangle.vertex[v] = reader.readUint32();
+            triangle.st[v] = reader.readUint32();
+        }
+    }
+
+    model->_frames.resize(reader.readCount(sizeof(MD2_Frame::name) + model->_vertices * 7 * 4));
+    for(MD2_Frame &frame : model->_frames)
+    {
+        reader.readBytes(frame.name, sizeof(frame.name));
+        frame.vertexList.resize(model->_vertices);
+
+        bool boundingBoxFound = false;
+        for(MD2_Vertex &vertex : frame.vertexList)
+        {
+            vertex.pos[kX] = reader.readFloat();
+            vertex.pos[kY] = reader.readFloat();
+            vertex.pos[kZ] = reader.readFloat();
+            vertex.nrm[kX] = reader.readFloat();
+            vertex.nrm[kY] = reader.readFloat();
+            vertex.nrm[kZ] = reader.readFloat();
+            vertex.normal = std::min<size_t>(reader.readUint32(), MD2_MAX_NORMALS);
+
+            oct_vec_v2_t ovec;
+            ovec.ctor(vertex.pos);
+            if (!boundingBoxFound)
+            {
+                frame.bb = oct_bb_t(ovec);
+                boundingBoxFound = true;
+            }
+            else
+            {
+                frame.bb.join(ovec);
+            }
+        }
+    }
+
+    // Keep the order of the commands
+    const size_t commandCount = reader.readCount(2 * 4);
+    auto last = model->_commands.before_begin();
+    for(size_t i = 0; i < commandCount && reader.isGood(); ++i)
+    {
+        MD2_GLCommand command;
+        command.glMode = reader.readUint32();
+        command.commandCount = reader.readCount(3 * 4);
+        command.data.resize(command.commandCount);
+        for(id_glcmd_packed_t &data : command.data)
+        {
+            data.s = reader.readFloat();
+            data.t = reader.readFloat();
+            data.index = reader.readSint32();
+        }
+        last = model->_commands.insert_after(last, command);
+    }
+
+    if (!reader.isGood())
+    {
+        return nullptr;
+    }
+
+    model->updateFrameArrays();
+    model->updateTriangleList();
 
     return model;
 }
@@ -24,6 +24,9 @@
 #include "egolib/FileFormats/id_md2.h"
 #include "egolib/bbox.h"
 
+struct bundle_writer_t;
+struct bundle_reader_t;
+
 static CONSTEXPR size_t EGO_NORMAL_COUNT = MD2_MAX_NORMALS + 1;
 
 typedef id_md2_skin_t MD2_SkinName;
@@ -73,6 +76,46 @@ public:
     std::vector<id_glcmd_packed_t> 	data;
 };
 
+/**
+* @brief The GL commands of a model as a list of triangles, so that the model can be drawn with a single draw call
+**/
+class MD2_TriangleList
+{
+public:
+	MD2_TriangleList() :
+		indices(),
+		texCoords()
+	{
+		//ctor
+	}
+
+    std::vector<uint16_t> indices;  ///< the vertex of each corner, three corners per triangle
+    std::vector<fvec2_t> texCoords; ///< the texture coordinates of each corner
+};
+
+/**
+* @brief The vertices of a frame as a structure of arrays, for the kernels of MD2Interpolator
+* @remark The arrays are padded with zeroes to a multiple of PADDING vertices, so a kernel may read
+*         a whole block of vertices beyond the last vertex.
+**/
+class MD2_FrameArrays
+{
+public:
+	static CONSTEXPR size_t PADDING = 8;
+
+	MD2_FrameArrays() :
+		posX(), posY(), posZ(),
+		nrmX(), nrmY(), nrmZ(),
+		envX()
+	{
+		//ctor
+	}
+
+    std::vector<float> posX, posY, posZ;
+    std::vector<float> nrmX, nrmY, nrmZ;
+    std::vector<float> envX;    ///< the environment map coordinate of the normal, see MD2Model::getMD2EnviroX()
+};
+
 class MD2_Frame
 {
 public:
@@ -81,9 +124,8 @@ public:
 		name(),
 #endif
 		vertexList(),
-		bb(),
-		framelip(0),
-		framefx(EMPTY_BIT_FIELD)
+		arrays(),
+		bb()
 	{
 		name[0] = '\0';
 	}
@@ -91,10 +133,9 @@ public:
     char name[16];
 
     std::vector<MD2_Vertex> vertexList;
+    MD2_FrameArrays arrays;     ///< vertexList as a structure of arrays
 
     oct_bb_t bb;        ///< axis-aligned octagonal bounding box limits
-    int framelip;       ///< the position in the current animation
-    BIT_FIELD framefx;  ///< the special effects associated with this frame
 };
 
 class MD2Model
@@ -106,6 +147,7 @@ public:
 	inline std::vector<MD2_Frame>&     	  	 	   getFrames() {return _frames;}
 	inline const std::vector<MD2_Triangle>&  	   getTriangles() const {return _triangles;}
 	inline const std::forward_list<MD2_GLCommand>& getGLCommands() const {return _commands;}
+	inline const MD2_TriangleList&                 getTriangleList() const {return _triangleList;}
 	inline size_t 								   getVertexCount() const {return _vertices;}
 
 	/**
@@ -126,14 +168,49 @@ public:
 
 	static std::shared_ptr<MD2Model> loadFromFile(const std::string &fileName);
 
+	/**
+	* @brief Parse a model from the contents of a MD2 file that were already read into memory
+	* @param fileName the name of the file the data came from, used in warnings only
+	* @return the model, or nullptr if the data is not a valid or complete MD2 file
+	**/
+	static std::shared_ptr<MD2Model> loadFromMemory(const char *data, size_t size, const std::string &fileName);
+
+	/**
+	* @brief Write this model in its runtime layout, so read() does not need to unpack or scale it
+	* @remark Increment CURRENT_MODULE_BUNDLE_VERSION if the layout changes
+	**/
+	void write(bundle_writer_t &writer) const;
+
+	/**
+	* @brief Read a model which was written by write()
+	* @return the model, nullptr if the data is corrupted
+	**/
+	static std::shared_ptr<MD2Model> read(bundle_reader_t &reader);
+
 	static float getMD2Normal(size_t normal, size_t index);
 
+	/**
+	* @return the x coordinate of the environment map for a normal index
+	**/
+	static float getMD2EnviroX(size_t normal);
+
 private:
+	/**
+	* @brief Copy the vertices of all frames into MD2_Frame::arrays. Called whenever the vertices change.
+	**/
+	void updateFrameArrays();
+
+	/**
+	* @brief Convert the GL commands into _triangleList. Called whenever the commands change.
+	**/
+	void updateTriangleList();
+
 	size_t 					   	     _vertices;
     std::vector<MD2_SkinName>  	     _skins;
     std::vector<MD2_TexCoord>  	     _texCoords;
     std::vector<MD2_Triangle>  	     _triangles;
     std::vector<MD2_Frame>     	     _frames;
     std::forward_list<MD2_GLCommand> _commands;
+    MD2_TriangleList                 _triangleList;
     //size_t							 _numCommands;
 };
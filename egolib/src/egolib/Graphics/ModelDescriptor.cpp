@@ -3,6 +3,7 @@
 #include "egolib/strutil.h"
 #include "egolib/Core/StringUtilities.hpp"
 #include "egolib/fileutil.h"
+#include "egolib/FileFormats/module_bundle_file.h"
 
 namespace Ego
 {
@@ -111,13 +112,156 @@ ModelAction ModelDescriptor::stringToAction(const std::string &action) const
     return ACTION_COUNT;
 }
 
+namespace
+{
+
+/// The models of all descriptors, shared by the content of the data they were loaded from.
+/// A model is kept only while a descriptor uses it.
+struct SharedModels
+{
+    std::mutex mutex;
+    std::unordered_map<uint64_t, std::weak_ptr<MD2Model>> models;
+
+    /// The equally lit copy of a model. The source is kept to detect a reused address.
+    struct LitModel
+    {
+        std::weak_ptr<MD2Model> source;
+        std::weak_ptr<MD2Model> lit;
+    };
+    std::unordered_map<const MD2Model *, LitModel> litModels;
+
+    ModelDescriptor::SharingStats stats;
+};
+
+SharedModels& getSharedModels()
+{
+    static SharedModels sharedModels;
+    return sharedModels;
+}
+
+/// FNV-1a hash of the data, the seed tells apart data of different formats
+uint64_t hashData(const char *data, size_t size, uint64_t seed)
+{
+    uint64_t hash = 14695981039346656037ULL ^ seed;
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash ^ size;
+}
+
+const uint64_t MD2_FILE_SEED = 0;
+const uint64_t MD2_BAKED_SEED = 1;
+
+/// Get the model of the data with the given hash, or load it if no descriptor uses it.
+/// The lock is not held while loading, if two threads load the same model the first one is shared.
+std::shared_ptr<MD2Model> getSharedModel(uint64_t hash, const std::function<std::shared_ptr<MD2Model>()> &load)
+{
+    SharedModels &shared = getSharedModels();
+    {
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        auto it = shared.models.find(hash);
+        if (it != shared.models.end())
+        {
+            std::shared_ptr<MD2Model> model = it->second.lock();
+            if (model)
+            {
+                shared.stats.hits++;
+                return model;
+            }
+        }
+    }
+
+    std::shared_ptr<MD2Model> model = load();
+    if (!model)
+    {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    std::weak_ptr<MD2Model> &entry = shared.models[hash];
+    std::shared_ptr<MD2Model> other = entry.lock();
+    if (other)
+    {
+        shared.stats.hits++;
+        return other;
+    }
+    shared.stats.misses++;
+    entry = model;
+    return model;
+}
+
+std::shared_ptr<MD2Model> loadScaledMD2(const char *data, size_t size, const std::string &fileName)
+{
+    std::shared_ptr<MD2Model> md2Model = MD2Model::loadFromMemory(data, size, fileName);
+    if(!md2Model) {
+        return nullptr;
+    }
+
+    /// @details Egoboo md2 models were designed with 1 tile = 32x32 units, but internally Egoboo uses
+    ///      1 tile = 128x128 units. Previously, this was handled by sprinkling a bunch of
+    ///      commands that multiplied various quantities by 4 or by 4.125 throughout the code.
+    ///      It was very counterintuitive, and caused me no end of headaches...  Of course the
+    ///      solution is to scale the model!
+    md2Model->scaleModel(-3.5f, 3.5f, 3.5f);
+
+    return md2Model;
+}
+
+} //anonymous namespace
+
+std::shared_ptr<MD2Model> ModelDescriptor::loadMD2(const std::string &folderPath)
+{
+    const std::string fileName = folderPath + "/tris.md2";
+
+    // Hash the file to find a model loaded from the same data, e.g. by an imported character of the same class
+    char *data = nullptr;
+    size_t size = 0;
+    if (!vfs_readEntireFile(fileName, &data, &size))
+    {
+        log_warning("ModelDescriptor::loadMD2() - could not read model (%s)\n", fileName.c_str());
+        return nullptr;
+    }
+    const uint64_t hash = hashData(data, size, MD2_FILE_SEED);
+
+    // Parse the model from the bytes that were just hashed instead of reading the file again
+    std::shared_ptr<MD2Model> model = getSharedModel(hash, [data, size, &fileName]() { return loadScaledMD2(data, size, fileName); });
+    free(data);
+    return model;
+}
+
+std::shared_ptr<MD2Model> ModelDescriptor::readMD2(const char *data, size_t size)
+{
+    return getSharedModel(hashData(data, size, MD2_BAKED_SEED), [data, size]()
+    {
+        bundle_reader_t reader(data, size);
+        return MD2Model::read(reader);
+    });
+}
+
+ModelDescriptor::SharingStats ModelDescriptor::getSharingStats()
+{
+    SharedModels &shared = getSharedModels();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    return shared.stats;
+}
+
 ModelDescriptor::ModelDescriptor(const std::string &folderPath) :
+    ModelDescriptor(folderPath, loadMD2(folderPath))
+{
+    //ctor
+}
+
+ModelDescriptor::ModelDescriptor(const std::string &folderPath, const std::shared_ptr<MD2Model> &md2Model) :
     _name(folderPath),      //Make up a name for the model...  IMPORT\TEMP0000.OBJ
     _actionMap(),
     _actionValid(),
     _actionStart(),
     _actionEnd(),
-    _md2Model(nullptr)
+    _frameFX(),
+    _frameLip(),
+    _md2Model(md2Model)
 {
     // Clear out all actions and reset to invalid
     _actionMap.fill(ACTION_COUNT);
@@ -131,30 +275,19 @@ ModelDescriptor::ModelDescriptor(const std::string &folderPath) :
         }
     }
 
-    // load the model from the file
-    _md2Model = MD2Model::loadFromFile(folderPath + "/tris.md2");
     if(!_md2Model) {
         throw std::runtime_error("File not found: " + folderPath + "/tris.md2");
     }
 
-    /// @details Egoboo md2 models were designed with 1 tile = 32x32 units, but internally Egoboo uses
-    ///      1 tile = 128x128 units. Previously, this was handled by sprinkling a bunch of
-    ///      commands that multiplied various quantities by 4 or by 4.125 throughout the code.
-    ///      It was very counterintuitive, and caused me no end of headaches...  Of course the
-    ///      solution is to scale the model!
-    _md2Model->scaleModel(-3.5f, 3.5f, 3.5f);
+    // The model may be shared with other descriptors, the frame data of this descriptor is kept here
+    _frameFX.assign(_md2Model->getFrames().size(), EMPTY_BIT_FIELD);
+    _frameLip.assign(_md2Model->getFrames().size(), 0);
 
     // Create the actions table for this imad
     ripActions();
     healActions(folderPath + "/copy.txt");
 
     // Create table for doing transition from one type of walk to another...
-    // Clear 'em all to start
-    for(MD2_Frame &frame : _md2Model->getFrames())
-    {
-        frame.framelip = 0;
-    }
-
     // Need to figure out how far into action each frame is
     initializeFrameLip(ACTION_WA);
     initializeFrameLip(ACTION_WB);
@@ -226,10 +359,9 @@ BIT_FIELD ModelDescriptor::getMadFX(int action) const
 
     //Loop through all frames in animation and collect all FX bits that are set
     BIT_FIELD retval = EMPTY_BIT_FIELD;
-    const std::vector<MD2_Frame> &frames = _md2Model->getFrames();
     for (size_t cnt = _actionStart[action]; cnt <= _actionEnd[action]; cnt++)
     {
-        SET_BIT(retval, frames[cnt].framefx);
+        SET_BIT(retval, getFrameFX(cnt));
     }
 
     return retval;
@@ -380,32 +512,21 @@ void ModelDescriptor::parseFrameDescriptors(const char * cFrameName, int frame)
     int name_count;
     int cnt;
 
-    static int token_count = -1;
     static const char * tokens[] = { "I", "S", "F", "P", "A", "G", "D", "C",          /* the normal command tokens */
                                      "LA", "LG", "LD", "LC", "RA", "RG", "RD", "RC", NULL
                                    }; /* the "bad" token aliases */
+    // a constant, as models are loaded on several threads
+    static const int token_count = SDL_arraysize(tokens) - 1;
 
     // check for a valid frame number
-    if(frame >= _md2Model->getFrames().size())
+    if(frame >= _frameFX.size())
     {
         return; 
     }
 
-    MD2_Frame &pframe = _md2Model->getFrames()[frame];
-
-    // this should only be initialized the first time through
-    if (token_count < 0)
-    {
-        token_count = 0;
-        for (cnt = 0; nullptr != tokens[token_count] && cnt < 256; cnt++)
-        {
-            token_count++;
-        }
-    }
-
     // set the default values
     BIT_FIELD fx = 0;
-    pframe.framefx = fx;
+    _frameFX[frame] = fx;
 
     // check for a non-trivial frame name
     if ( !VALID_CSTR(cFrameName) ) return;
@@ -568,7 +689,7 @@ void ModelDescriptor::parseFrameDescriptors(const char * cFrameName, int frame)
         }
     }
 
-    pframe.framefx = fx;
+    _frameFX[frame] = fx;
 }
 
 void ModelDescriptor::initializeWalkFrame(int lip, ModelAction action)
@@ -611,7 +732,25 @@ void ModelDescriptor::initializeWalkFrame(int lip, ModelAction action)
 
 void ModelDescriptor::makeEquallyLit()
 {
-    _md2Model->makeEquallyLit();
+    // Other descriptors may share the model, so light a copy of it and share that instead
+    SharedModels &shared = getSharedModels();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+
+    SharedModels::LitModel &entry = shared.litModels[_md2Model.get()];
+    std::shared_ptr<MD2Model> lit = entry.lit.lock();
+    if (!lit || entry.source.lock() != _md2Model)
+    {
+        lit = std::make_shared<MD2Model>(*_md2Model);
+        lit->makeEquallyLit();
+        entry.source = _md2Model;
+        entry.lit = lit;
+
+        // Lighting an equally lit model again does not change it
+        SharedModels::LitModel &litEntry = shared.litModels[lit.get()];
+        litEntry.source = lit;
+        litEntry.lit = lit;
+    }
+    _md2Model = lit;
 }
 
 void ModelDescriptor::initializeFrameLip(ModelAction action)
@@ -629,7 +768,7 @@ void ModelDescriptor::initializeFrameLip(ModelAction action)
     for (int frame = action_stt; frame <= action_end; frame++)
     {
         // grab a valid frame
-        if (frame >= _md2Model->getFrames().size()) break;
+        if (frame >= _frameLip.size()) break;
 
         // calculate the framelip.
         // this should produce a number between 0 and FRAMELIP_COUNT-1, but
@@ -637,7 +776,7 @@ void ModelDescriptor::initializeFrameLip(ModelAction action)
         int framelip = (( frame - action_stt ) * FRAMELIP_COUNT ) / action_count;
 
         // limit the framelip to the valid range
-        _md2Model->getFrames()[frame].framelip = std::min<size_t>(framelip, FRAMELIP_COUNT - 1);
+        _frameLip[frame] = std::min<size_t>(framelip, FRAMELIP_COUNT - 1);
     }
 }
 
@@ -780,6 +919,22 @@ bool ModelDescriptor::isFrameValid(int action, int frame) const
     return true;
 }
 
+BIT_FIELD ModelDescriptor::getFrameFX(int frame) const
+{
+    if(frame < 0 || frame >= _frameFX.size()) {
+        return EMPTY_BIT_FIELD;
+    }
+    return _frameFX[frame];
+}
+
+int ModelDescriptor::getFrameLip(int frame) const
+{
+    if(frame < 0 || frame >= _frameLip.size()) {
+        return 0;
+    }
+    return _frameLip[frame];
+}
+
 int ModelDescriptor::getFrameLipToWalkFrame(int lip, int framelip) const
 {
     assert(lip >= 0 && lip < LIP_COUNT && framelip >= 0 && framelip < FRAMELIP_COUNT);
@@ -147,8 +147,39 @@ class ModelDescriptor : public Id::NonCopyable
 public:
     static const size_t FRAMELIP_COUNT = 16;
 
+    /// How often a model was shared instead of loaded
+    struct SharingStats
+    {
+        size_t hits;    ///< models shared with another descriptor
+        size_t misses;  ///< models which were loaded
+
+        SharingStats() : hits(0), misses(0) {}
+    };
+
     ModelDescriptor(const std::string &folderPath);
 
+    /**
+    * @brief Create a descriptor for a model which was already loaded by loadMD2(), e.g. from a module bundle
+    * @param folderPath the folder of the model, copy.txt is read from it
+    **/
+    ModelDescriptor(const std::string &folderPath, const std::shared_ptr<MD2Model> &md2Model);
+
+    /**
+    * @brief Load tris.md2 from a folder and scale it to the size used by the game
+    * @return the model, nullptr if it could not be loaded
+    * @remark Models are shared by the content of tris.md2. The model must not be changed, see makeEquallyLit().
+    **/
+    static std::shared_ptr<MD2Model> loadMD2(const std::string &folderPath);
+
+    /**
+    * @brief Read a model which was written by MD2Model::write(), e.g. from a module bundle
+    * @return the model, nullptr if the data is corrupted
+    * @remark Models are shared by the content of the data like loadMD2()
+    **/
+    static std::shared_ptr<MD2Model> readMD2(const char *data, size_t size);
+
+    static SharingStats getSharingStats();
+
     const std::string& getName() const;
 
     const std::shared_ptr<MD2Model>& getMD2() const;
@@ -175,8 +206,22 @@ public:
     ///               A and B being for the left hand, and C and D being for the right hand
     int randomizeAction(int action, int slot) const;
 
+    /**
+    * @brief Use an equally lit copy of the model. The copy is shared with all descriptors of the same model.
+    * @remark This changes the descriptor, do not call it on a descriptor which is shared, e.g. by the asset cache.
+    **/
     void makeEquallyLit();
 
+    /**
+    * @return the ModelFrameEffects of a frame, EMPTY_BIT_FIELD if the frame is not valid
+    **/
+    BIT_FIELD getFrameFX(int frame) const;
+
+    /**
+    * @return the position of a frame in its walk animation (0 to FRAMELIP_COUNT-1), 0 if the frame is not valid
+    **/
+    int getFrameLip(int frame) const;
+
     int getFrameLipToWalkFrame(int lip, int framelip) const;
 
     bool isFrameValid(int action, int frame) const;
@@ -240,6 +285,9 @@ private:
     std::array<int, ACTION_COUNT> _actionStart;        ///< First frame of animation
     std::array<int, ACTION_COUNT> _actionEnd;          ///< The last frame
 
+    std::vector<BIT_FIELD> _frameFX;                   ///< the special effects associated with each frame
+    std::vector<int> _frameLip;                        ///< the position of each frame in the current animation
+
     std::shared_ptr<MD2Model> _md2Model;               ///< actual MD2 model
 };
 
@@ -23,12 +23,14 @@
 #include "egolib/_math.h"
 #include "egolib/fileutil.h"
 #include "egolib/Graphics/TextureManager.hpp"
+#include "egolib/Core/ThreadPool.hpp"
+#include "egolib/egoboo_setup.h"
 
 //--------------------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------------------
 
 TextureManager::TextureManager()
-    : _lst(), _free()
+    : _lst(), _free(), _textureCache(), _decodedImages(std::make_shared<DecodedImageQueue>()), _pendingImages(), _streamingStats()
 {
     initializeErrorTextures();
     // Fill the _free set with all texture references
@@ -148,7 +150,7 @@ bool TextureManager::relinquish(const TX_REF ref)
     return true;
 }
 
-TX_REF TextureManager::load(const char *filename, const TX_REF ref, Uint32 key)
+TX_REF TextureManager::load(const char *filename, const TX_REF ref, Uint32 key, const Ego::VFS::DirectoryListing *listing)
 {
     /// @author BB
     /// @details load a texture into TxList.
@@ -164,7 +166,33 @@ TX_REF TextureManager::load(const char *filename, const TX_REF ref, Uint32 key)
     }
 
     // Otherwise load the texture.
-    Uint32 id = ego_texture_load_vfs(_lst[newRef], filename, key);
+    Uint32 id = ego_texture_load_vfs(_lst[newRef], filename, key, listing);
+    // If loading fails ...
+    if (INVALID_GL_ID == id)
+    {
+        // ... relinquish the reference and ...
+        relinquish(newRef);
+        // ... return INVALID_TX_REF.
+        return INVALID_TX_REF;
+    }
+
+    return newRef;
+}
+
+TX_REF TextureManager::load(const std::string& name, const std::shared_ptr<SDL_Surface>& surface, const TX_REF ref, Uint32 key)
+{
+    // Acquire a texture reference.
+    TX_REF newRef = acquire(ref);
+    // If no texture reference is available ...
+    if (!VALID_TX_RANGE(newRef))
+    {
+        // ... return INVALID_TX_REF.
+        return INVALID_TX_REF;
+    }
+
+    // Otherwise create the texture from the surface.
+    _lst[newRef]->release();
+    Uint32 id = _lst[newRef]->load(name, surface, key);
     // If loading fails ...
     if (INVALID_GL_ID == id)
     {
@@ -182,3 +210,123 @@ oglx_texture_t *TextureManager::get_valid_ptr(const TX_REF ref)
     oglx_texture_t *texture = LAMBDA(ref >= TEXTURES_MAX, nullptr, _lst[ref]);
     return texture;
 }
+
+std::shared_ptr<oglx_texture_t> TextureManager::loadAsync(const std::string& filename, Uint32 key)
+{
+    auto result = _textureCache.find(filename);
+    if (result != _textureCache.end())
+    {
+        return result->second;
+    }
+
+    // The texture is bound to the error texture until its image is uploaded.
+    std::shared_ptr<oglx_texture_t> texture = std::make_shared<oglx_texture_t>();
+    _textureCache[filename] = texture;
+    _streamingStats.requested++;
+    _streamingStats.pending++;
+
+    std::shared_ptr<DecodedImage> image = std::make_shared<DecodedImage>();
+    image->texture = texture;
+    image->filename = filename;
+    image->key = key;
+    image->cancelled = false;
+    image->requestTime = std::chrono::steady_clock::now();
+    _pendingImages[filename] = image;
+
+    std::shared_ptr<DecodedImageQueue> queue = _decodedImages;
+    Ego::ThreadPool::get().submit([filename, image, queue]()
+    {
+        image->surface = ego_image_load_vfs(filename.c_str(), image->fullFilename);
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        queue->images.push_back(image);
+    });
+
+    return texture;
+}
+
+std::shared_ptr<oglx_texture_t> TextureManager::loadSync(const std::string& filename, Uint32 key)
+{
+    std::shared_ptr<oglx_texture_t> texture;
+
+    auto result = _textureCache.find(filename);
+    if (result != _textureCache.end())
+    {
+        texture = result->second;
+
+        // Not waiting for its upload?
+        auto pending = _pendingImages.find(filename);
+        if (pending == _pendingImages.end())
+        {
+            return texture;
+        }
+
+        // Load it now and drop the decoded image when it arrives.
+        pending->second->cancelled = true;
+        _pendingImages.erase(pending);
+    }
+    else
+    {
+        texture = std::make_shared<oglx_texture_t>();
+        _textureCache[filename] = texture;
+    }
+
+    ego_texture_load_vfs(texture.get(), filename.c_str(), key);
+    return texture;
+}
+
+void TextureManager::updateStreaming()
+{
+    const size_t budget = egoboo_config_t::get().graphic_textureUpload_budget.getValue() * 1024;
+    size_t bytes = 0;
+
+    while (bytes < budget || 0 == bytes)
+    {
+        std::shared_ptr<DecodedImage> image;
+        {
+            std::lock_guard<std::mutex> lock(_decodedImages->mutex);
+            if (_decodedImages->images.empty())
+            {
+                break;
+            }
+            image = _decodedImages->images.front();
+            _decodedImages->images.pop_front();
+        }
+        _streamingStats.pending--;
+
+        // Skip images which were loaded by loadSync() in the meantime.
+        if (image->cancelled)
+        {
+            continue;
+        }
+        _pendingImages.erase(image->filename);
+
+        // Skip textures which were removed from the cache in the meantime.
+        std::shared_ptr<oglx_texture_t> texture = image->texture.lock();
+        if (!texture)
+        {
+            continue;
+        }
+        if (!image->surface || INVALID_GL_ID == texture->load(image->fullFilename, image->surface, image->key))
+        {
+            _streamingStats.failed++;
+            continue;
+        }
+
+        const size_t imageBytes = image->surface->h * image->surface->pitch;
+        bytes += std::max<size_t>(imageBytes, 1);
+        _streamingStats.uploadedBytes += imageBytes;
+
+        const double latency = std::chrono::duration<double>(std::chrono::steady_clock::now() - image->requestTime).count();
+        _streamingStats.averageLatency = (_streamingStats.averageLatency * _streamingStats.uploaded + latency) / (_streamingStats.uploaded + 1);
+        _streamingStats.maxLatency = std::max(_streamingStats.maxLatency, latency);
+        _streamingStats.uploaded++;
+    }
+
+    _streamingStats.frameBytes = bytes;
+    _streamingStats.maxFrameBytes = std::max(_streamingStats.maxFrameBytes, bytes);
+}
+
+const TextureManager::StreamingStats& TextureManager::getStreamingStats() const
+{
+    return _streamingStats;
+}
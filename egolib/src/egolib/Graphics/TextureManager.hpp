@@ -24,6 +24,10 @@
 
 #include "egolib/typedef.h"
 #include "egolib/Renderer/Renderer.hpp"
+#include "egolib/VFS/DirectoryListing.hpp"
+#include <chrono>
+#include <deque>
+#include <mutex>
 
 //--------------------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------------------
@@ -81,6 +85,34 @@ inline bool VALID_TX_RANGE(const TX_REF ref)
 
 struct TextureManager : public Ego::Core::Singleton <TextureManager>
 {
+public:
+
+    /**
+     * @brief
+     *  Statistics about the textures loaded by loadAsync().
+     */
+    struct StreamingStats
+    {
+        /// The number of textures requested.
+        size_t requested;
+        /// The number of textures which are decoded or wait for their upload.
+        size_t pending;
+        /// The number of textures uploaded.
+        size_t uploaded;
+        /// The number of textures which could not be decoded or uploaded.
+        size_t failed;
+        /// The number of bytes uploaded.
+        size_t uploadedBytes;
+        /// The number of bytes uploaded by the last call to updateStreaming().
+        size_t frameBytes;
+        /// The largest number of bytes uploaded by one call to updateStreaming().
+        size_t maxFrameBytes;
+        /// The average time, in seconds, from the request of a texture to its upload.
+        double averageLatency;
+        /// The longest time, in seconds, from the request of a texture to its upload.
+        double maxLatency;
+    };
+
 protected:
     // Befriend with the singleton to grant access to TextureManager::~TextureManager.
     using TheSingleton = Ego::Core::Singleton<TextureManager>;
@@ -152,11 +184,99 @@ public:
      */
     void release_all();
 
-    TX_REF load(const char *filename, const TX_REF ref, Uint32 key = INVALID_KEY);
+    /**
+     * @brief
+     *  Load a texture.
+     * @param filename
+     *  the filename of the image <em>without</em> extension
+     * @param ref
+     *  the texture reference to load into, INVALID_TX_REF to use the next free one
+     * @param listing
+     *  if not a null pointer, the listing of the directory of the image, see ego_texture_load_vfs()
+     */
+    TX_REF load(const char *filename, const TX_REF ref, Uint32 key = INVALID_KEY, const Ego::VFS::DirectoryListing *listing = nullptr);
+
+    /**
+     * @brief
+     *  Load a texture from an image which was already loaded, e.g. by ego_image_load_vfs() on a worker thread.
+     * @param name
+     *  the name of the texture
+     * @param surface
+     *  the image
+     * @param ref
+     *  the texture reference to load into, INVALID_TX_REF to use the next free one
+     */
+    TX_REF load(const std::string& name, const std::shared_ptr<SDL_Surface>& surface, const TX_REF ref, Uint32 key = INVALID_KEY);
     oglx_texture_t *get_valid_ptr(const TX_REF ref);
 
     inline std::unordered_map<std::string, std::shared_ptr<oglx_texture_t>>& getTextureCache() { return _textureCache; }
 
+    /**
+     * @brief
+     *  Get a texture of the texture cache, load it in the background if it is not in the cache.
+     * @param filename
+     *  the filename of the image <em>without</em> extension
+     * @return
+     *  the texture. Until the image is decoded and uploaded, the texture is bound to the error texture.
+     * @remark
+     *  The image is decoded on a worker thread of Ego::ThreadPool and uploaded by updateStreaming().
+     */
+    std::shared_ptr<oglx_texture_t> loadAsync(const std::string& filename, Uint32 key = INVALID_KEY);
+
+    /**
+     * @brief
+     *  Get a texture of the texture cache, load it now if it is not in the cache or not uploaded yet.
+     * @param filename
+     *  the filename of the image <em>without</em> extension
+     * @return
+     *  the texture
+     * @remark
+     *  Use this if the size of the image is needed right away, e.g. to lay out the GUI.
+     *  A pending background load of the same image is cancelled.
+     */
+    std::shared_ptr<oglx_texture_t> loadSync(const std::string& filename, Uint32 key = INVALID_KEY);
+
+    /**
+     * @brief
+     *  Upload the images decoded for loadAsync(), call once per frame on the render thread.
+     * @remark
+     *  At most egoboo_config_t::graphic_textureUpload_budget kilobytes are uploaded per call,
+     *  but at least one image, so a large image does not wait forever.
+     */
+    void updateStreaming();
+
+    /**
+     * @brief
+     *  Get the statistics about the textures loaded by loadAsync().
+     */
+    const StreamingStats& getStreamingStats() const;
+
 private:
     std::unordered_map<std::string, std::shared_ptr<oglx_texture_t>> _textureCache;
+
+    /// An image decoded for loadAsync()
+    struct DecodedImage
+    {
+        std::weak_ptr<oglx_texture_t> texture;
+        std::string filename;
+        Uint32 key;
+        /// If @a true, the image was loaded by loadSync() in the meantime and is not uploaded.
+        bool cancelled;
+        std::chrono::steady_clock::time_point requestTime;
+        std::string fullFilename;
+        std::shared_ptr<SDL_Surface> surface;
+    };
+
+    /// The images which wait for their upload.
+    /// Shared with the decoding tasks, which may finish after this texture manager was destroyed.
+    struct DecodedImageQueue
+    {
+        std::mutex mutex;
+        std::deque<std::shared_ptr<DecodedImage>> images;
+    };
+
+    std::shared_ptr<DecodedImageQueue> _decodedImages;
+    /// The images requested by loadAsync() which are not uploaded yet, by filename.
+    std::unordered_map<std::string, std::shared_ptr<DecodedImage>> _pendingImages;
+    StreamingStats _streamingStats;
 };
@@ -30,6 +30,7 @@
 #include "egolib/Audio/AudioSystem.hpp"
 #include "egolib/FileFormats/template.h"
 #include "egolib/Math/Random.hpp"
+#include "egolib/Image/ImageManager.hpp"
 
 static const SkinInfo INVALID_SKIN = SkinInfo();
 
@@ -250,7 +251,7 @@ uint32_t ObjectProfile::getXPNeededForLevel(uint8_t level) const
     return _experienceForLevel[level];
 }
 
-void ObjectProfile::loadTextures(const std::string &folderPath)
+void ObjectProfile::loadTextures(const DecodedAssets &assets)
 {
     //Clear texture references
     _texturesLoaded.clear();
@@ -259,24 +260,26 @@ void ObjectProfile::loadTextures(const std::string &folderPath)
     // Load the skins and icons
     for (int cnt = 0; cnt < SKINS_PEROBJECT_MAX; cnt++)
     {
-        STRING newloadname;
-
         // do the texture
-        snprintf( newloadname, SDL_arraysize( newloadname ), "%s/tris%d", folderPath.c_str(), cnt );
-
-		TX_REF skin = TextureManager::get().load(newloadname, INVALID_TX_REF, TRANSCOLOR);
-        if ( VALID_TX_RANGE( skin ) )
+        const DecodedAssets::Image &skinImage = assets.skins[cnt];
+        if (skinImage.surface)
         {
-            _texturesLoaded[cnt] = skin;
+            TX_REF skin = TextureManager::get().load(skinImage.fileName, skinImage.surface, INVALID_TX_REF, TRANSCOLOR);
+            if ( VALID_TX_RANGE( skin ) )
+            {
+                _texturesLoaded[cnt] = skin;
+            }
         }
 
         // do the icon
-        snprintf( newloadname, SDL_arraysize( newloadname ), "%s/icon%d", folderPath.c_str(), cnt );
-
-		TX_REF icon = TextureManager::get().load(newloadname, INVALID_TX_REF);
-        if ( VALID_TX_RANGE( icon ) )
+        const DecodedAssets::Image &iconImage = assets.icons[cnt];
+        if (iconImage.surface)
         {
-            _iconsLoaded[cnt] = icon;
+            TX_REF icon = TextureManager::get().load(iconImage.fileName, iconImage.surface, INVALID_TX_REF);
+            if ( VALID_TX_RANGE( icon ) )
+            {
+                _iconsLoaded[cnt] = icon;
+            }
         }
     }
 
@@ -1012,6 +1015,131 @@ bool ObjectProfile::hasIDSZ(IDSZ idsz) const
     return false;
 }
 
+ObjectProfile::DecodedAssets::DecodedAssets(const std::string &folderPath, const bool lightWeight) :
+    folderPath(folderPath),
+    lightWeight(lightWeight),
+    listing(folderPath),
+    bundle(nullptr),
+    model(nullptr),
+    modelKey(),
+    modelStamp{ -1, -1 },
+    particles(),
+    enchant(nullptr),
+    skins(),
+    icons()
+{
+    //ctor
+}
+
+void ObjectProfile::AssetCache::removeUnused()
+{
+    models.removeUnused();
+    particles.removeUnused();
+    enchants.removeUnused();
+    images.removeUnused();
+}
+
+ObjectProfile::AssetCache& ObjectProfile::getAssetCache()
+{
+    static AssetCache assetCache;
+    return assetCache;
+}
+
+/// Decode a skin or icon, or get it from the asset cache if its file did not change
+static ObjectProfile::DecodedAssets::Image decodeImage(const ObjectProfile::DecodedAssets &assets, const std::string &name)
+{
+    using Image = ObjectProfile::DecodedAssets::Image;
+
+    // Find the file the image is loaded from
+    for (const auto& loader : ImageManager::get())
+    {
+        const std::string fileName = name + loader.getExtension();
+        if (!assets.listing.contains(fileName)) {
+            continue;
+        }
+
+        const std::string pathname = assets.folderPath + "/" + fileName;
+        std::shared_ptr<Image> image = ObjectProfile::getAssetCache().images.get(pathname, Ego::VFS::FileStamp::of(pathname), [&assets, &name]()
+        {
+            std::shared_ptr<Image> decoded = std::make_shared<Image>();
+            decoded->surface = ego_image_load_vfs((assets.folderPath + "/" + name).c_str(), decoded->fileName, &assets.listing);
+            return decoded->surface ? decoded : nullptr;
+        });
+        return image ? *image : Image();
+    }
+
+    return Image();
+}
+
+void ObjectProfile::decodeAssets(DecodedAssets &assets)
+{
+    const std::string &folderPath = assets.folderPath;
+    AssetCache &cache = getAssetCache();
+
+    //Don't decode 3d model, enchant or particle effects for lightweight profiles
+    if(!assets.lightWeight)
+    {
+        // Decode the model for this profile, copy.txt changes the actions of the model
+        const std::string modelPath = folderPath + "/tris.md2";
+        const bool hasCopy = assets.listing.contains("copy.txt");
+        const Ego::VFS::FileStamp modelStamp = hasCopy ? Ego::VFS::FileStamp::combine(Ego::VFS::FileStamp::of(modelPath), Ego::VFS::FileStamp::of(folderPath + "/copy.txt"))
+                                                       : Ego::VFS::FileStamp::of(modelPath);
+        assets.modelKey = hasCopy ? modelPath + "+copy.txt" : modelPath;
+        assets.modelStamp = modelStamp;
+        assets.model = cache.models.get(assets.modelKey, modelStamp, [&assets, &folderPath, &modelPath]()
+        {
+            try {
+                // Use the baked model unless tris.md2 changed since it was baked
+                const char *data;
+                size_t size;
+                if (assets.bundle && assets.bundle->find(modelPath, Ego::VFS::FileStamp::of(modelPath), &data, &size)) {
+                    std::shared_ptr<MD2Model> md2Model = Ego::ModelDescriptor::readMD2(data, size);
+                    if (md2Model) {
+                        return std::make_shared<Ego::ModelDescriptor>(folderPath, md2Model);
+                    }
+                    log_warning("ObjectProfile::decodeAssets() - baked model of (%s) is corrupted\n", folderPath.c_str());
+                }
+                return std::make_shared<Ego::ModelDescriptor>(folderPath.c_str());
+            }
+            catch (const std::runtime_error &ex) {
+                return std::shared_ptr<Ego::ModelDescriptor>(nullptr);
+            }
+        });
+
+        // Read the enchantment for this profile (optional)
+        if (assets.listing.contains("enchant.txt")) {
+            const std::string enchantPath = folderPath + "/enchant.txt";
+            assets.enchant = cache.enchants.get(enchantPath, Ego::VFS::FileStamp::of(enchantPath), [&enchantPath]()
+            {
+                std::shared_ptr<eve_t> enchant = std::make_shared<eve_t>();
+                return EnchantProfileReader::read(enchant, enchantPath) ? enchant : nullptr;
+            });
+        }
+
+        // Read the particles for this profile (optional)
+        for (int cnt = 0; cnt < 30; ++cnt)
+        {
+            const std::string fileName = "part" + std::to_string(cnt) + ".txt";
+            if (!assets.listing.contains(fileName)) {
+                continue;
+            }
+            const std::string particlePath = folderPath + "/" + fileName;
+            assets.particles[cnt] = cache.particles.get(particlePath, Ego::VFS::FileStamp::of(particlePath), [&particlePath]()
+            {
+                std::shared_ptr<pip_t> particle = std::make_shared<pip_t>();
+                return ParticleProfileReader::read(particle, particlePath) ? particle : nullptr;
+            });
+        }
+    }
+
+    // Decode the skins and icons (optional)
+    for (int cnt = 0; cnt < SKINS_PEROBJECT_MAX; cnt++)
+    {
+        assets.skins[cnt] = decodeImage(assets, "tris" + std::to_string(cnt));
+        assets.icons[cnt] = decodeImage(assets, "icon" + std::to_string(cnt));
+    }
+}
+
 std::shared_ptr<ObjectProfile> ObjectProfile::loadFromFile(const std::string &folderPath, const PRO_REF slotNumber, const bool lightWeight)
 {
     //Make sure slot number is valid
@@ -1021,6 +1149,22 @@ std::shared_ptr<ObjectProfile> ObjectProfile::loadFromFile(const std::string &fo
         return nullptr;
     }
 
+    DecodedAssets assets(folderPath, lightWeight);
+    decodeAssets(assets);
+    return loadFromFile(assets, slotNumber);
+}
+
+std::shared_ptr<ObjectProfile> ObjectProfile::loadFromFile(const DecodedAssets &assets, const PRO_REF slotNumber)
+{
+    const std::string &folderPath = assets.folderPath;
+
+    //Make sure slot number is valid
+    if(slotNumber == INVALID_PRO_REF)
+    {
+        log_warning("ObjectProfile::loadFromFile() - Invalid PRO_REF (%d)\n", slotNumber);
+        return nullptr;
+    }
+
     //Allocate memory
     std::shared_ptr<ObjectProfile> profile = std::make_shared<ObjectProfile>();
 
@@ -1029,42 +1173,41 @@ std::shared_ptr<ObjectProfile> ObjectProfile::loadFromFile(const std::string &fo
     profile->_slotNumber = slotNumber;
 
     //Don't load 3d model, enchant, messages, sounds or particle effects for lightweight profiles
-    if(!lightWeight)
+    if(!assets.lightWeight)
     {
-        // Load the model for this profile
-        try {
-            profile->_model = std::make_shared<Ego::ModelDescriptor>(folderPath.c_str());
-        }
-        catch (const std::runtime_error &ex) {
+        // The model for this profile
+        profile->_model = assets.model;
+        if (!profile->_model) {
             log_warning("ObjectProfile::loadFromFile() - Unable to load model (%s)\n", folderPath.c_str());
             return nullptr;
         }
 
-        // Load the enchantment for this profile (optional)
-        STRING newloadname;
-        make_newloadname( folderPath.c_str(), "/enchant.txt", newloadname );
-        profile->_ieve = EveStack.load_one( newloadname, static_cast<EVE_REF>(slotNumber) );
+        // Store the enchantment for this profile (optional)
+        profile->_ieve = EveStack.store_one( assets.enchant, static_cast<EVE_REF>(slotNumber) );
 
         // Load the messages for this profile, do this before loading the AI script
         // to ensure any dynamic loaded messages get loaded last (optional)
         profile->loadAllMessages(folderPath + "/message.txt");
 
-        // Load the particles for this profile (optional)
-        for (LocalParticleProfileRef cnt(0); cnt.get() < 30; ++cnt) //TODO: find better way of listing files
+        // Store the particles for this profile (optional)
+        for (const auto &particle : assets.particles)
         {
-            const std::string particleName = folderPath + "/part" + std::to_string(cnt.get()) + ".txt";
-            PIP_REF particleProfile = PipStack.load_one(particleName.c_str(), INVALID_PIP_REF);
+            PIP_REF particleProfile = PipStack.store_one(particle.second, INVALID_PIP_REF);
 
             // Make sure it's referenced properly
             if(particleProfile != INVALID_PIP_REF) {
-                profile->_particleProfiles[cnt] = particleProfile; 
+                profile->_particleProfiles[LocalParticleProfileRef(particle.first)] = particleProfile; 
             }
         }
 
         // Load the waves for this iobj
-        for ( size_t cnt = 0; cnt < 30; cnt++ ) //TODO: make better search than just 30 (list files?)
+        for ( size_t cnt = 0; cnt < 30; cnt++ )
         {
-            const std::string soundName = folderPath + "/sound" + std::to_string(cnt);
+            const std::string fileName = "sound" + std::to_string(cnt);
+            if (!assets.listing.contains(fileName + ".ogg") && !assets.listing.contains(fileName + ".wav")) {
+                continue;
+            }
+            const std::string soundName = folderPath + "/" + fileName;
             SoundID soundID = AudioSystem::get().loadSound(soundName);
 
             if(soundID != INVALID_SOUND_ID) {
@@ -1074,7 +1217,7 @@ std::shared_ptr<ObjectProfile> ObjectProfile::loadFromFile(const std::string &fo
     }
 
     //Load profile graphics (optional)
-    profile->loadTextures(folderPath);
+    profile->loadTextures(assets);
 
     // Load the random naming table for this icap (optional)
     profile->_randomName.loadFromFile(folderPath + "/naming.txt");
@@ -1092,10 +1235,17 @@ std::shared_ptr<ObjectProfile> ObjectProfile::loadFromFile(const std::string &fo
         return nullptr;
     }
 
-    // Fix lighting if need be
-    if (profile->_uniformLit && egoboo_config_t::get().graphic_gouraudShading_enable.getValue())
+    // Fix lighting if need be. The cached descriptor is shared by all profiles of the model,
+    // so light a descriptor of its own, which is cached under a key of its own.
+    if (profile->_uniformLit && profile->_model && egoboo_config_t::get().graphic_gouraudShading_enable.getValue())
     {
-        profile->getModel()->makeEquallyLit();
+        const std::shared_ptr<Ego::ModelDescriptor> model = profile->_model;
+        profile->_model = getAssetCache().models.get(assets.modelKey + "+lit", assets.modelStamp, [&folderPath, &model]()
+        {
+            std::shared_ptr<Ego::ModelDescriptor> lit = std::make_shared<Ego::ModelDescriptor>(folderPath, model->getMD2());
+            lit->makeEquallyLit();
+            return lit;
+        });
     }
 
     return profile;
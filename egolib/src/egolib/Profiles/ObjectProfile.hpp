@@ -30,6 +30,9 @@
 #include "egolib/Logic/Gender.hpp"
 #include "egolib/Logic/Attribute.hpp"
 #include "egolib/Logic/Perk.hpp"
+#include "egolib/VFS/DirectoryListing.hpp"
+#include "egolib/VFS/FileCache.hpp"
+#include "egolib/FileFormats/module_bundle_file.h"
 
 //--------------------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------------------
@@ -551,6 +554,65 @@ public:
     **/
     uint16_t getBaseBlockRating() const { return _blockRating; }
 
+    /**
+    * @brief The files of a profile which are decoded without touching the particle and enchant profile
+    *        stacks, the texture manager or the audio system. This part of loading can run on a worker thread.
+    **/
+    struct DecodedAssets
+    {
+        /// A decoded skin or icon
+        struct Image
+        {
+            std::string fileName;                   ///< the filename with extension
+            std::shared_ptr<SDL_Surface> surface;   ///< the image, nullptr if there is none
+        };
+
+        /**
+        * @brief Lists the files in the folder path, the files are decoded by decodeAssets()
+        * @param lightWeight If true, then no 3D model, particle or enchant will be decoded
+        * @remark Listing a folder is not thread-safe, construct on the main thread
+        **/
+        DecodedAssets(const std::string &folderPath, const bool lightWeight);
+
+        std::string folderPath;
+        bool lightWeight;
+        Ego::VFS::DirectoryListing listing;                          ///< the files in the folder
+        std::shared_ptr<const module_bundle_t> bundle;               ///< the baked module data, may be nullptr
+        std::shared_ptr<Ego::ModelDescriptor> model;                 ///< tris.md2, nullptr if it could not be loaded
+        std::string modelKey;                                        ///< the key of the model in the asset cache
+        Ego::VFS::FileStamp modelStamp;                              ///< the stamp of the model in the asset cache
+        std::map<int, std::shared_ptr<pip_t>> particles;             ///< part*.txt by number, nullptr if reading failed
+        std::shared_ptr<eve_t> enchant;                              ///< enchant.txt, nullptr if there is none
+        std::array<Image, SKINS_PEROBJECT_MAX> skins;                ///< tris*
+        std::array<Image, SKINS_PEROBJECT_MAX> icons;                ///< icon*
+    };
+
+    /**
+    * @brief The decoded assets of the profiles of the last module, kept for the next module load
+    **/
+    struct AssetCache
+    {
+        Ego::VFS::FileCache<Ego::ModelDescriptor> models;       ///< by tris.md2, also stamped with copy.txt, "+lit" for the equally lit ones
+        Ego::VFS::FileCache<pip_t> particles;                   ///< by part*.txt
+        Ego::VFS::FileCache<eve_t> enchants;                    ///< by enchant.txt
+        Ego::VFS::FileCache<DecodedAssets::Image> images;       ///< by tris* and icon* image file
+
+        /// Remove the assets which were not used since the last call, see Ego::VFS::FileCache::removeUnused()
+        void removeUnused();
+    };
+
+    /**
+    * @return the process-wide cache of decodeAssets()
+    **/
+    static AssetCache& getAssetCache();
+
+    /**
+    * @brief Decode the model, the particle and enchant profiles and the images of a profile.
+    *        Files which did not change since they were last decoded are taken from getAssetCache().
+    * @remark This function is safe to call on a worker thread
+    **/
+    static void decodeAssets(DecodedAssets &assets);
+
     /**
     * @brief Loads a new ObjectProfile object by loading all data specified in the folder path
     * @param slotOverride Which slot number to load this profile in
@@ -558,6 +620,13 @@ public:
     **/
     static std::shared_ptr<ObjectProfile> loadFromFile(const std::string &folderPath, const PRO_REF slotOverride, const bool lightWeight = false);
 
+    /**
+    * @brief Loads a new ObjectProfile object from assets which were decoded by decodeAssets(). This stores
+    *        the particle and enchant profiles, creates the textures and loads the remaining files.
+    * @param slotOverride Which slot number to load this profile in
+    **/
+    static std::shared_ptr<ObjectProfile> loadFromFile(const DecodedAssets &assets, const PRO_REF slotOverride);
+
     /**
     * @brief Writes the contents of this character instance to a profile data.txt file
     **/
@@ -580,9 +649,9 @@ private:
     void loadAllMessages(const std::string &filePath);
 
     /**
-    * @brief load all tris*.bmp or tris*.png skin and icons
+    * @brief create the textures of all tris*.bmp or tris*.png skin and icons
     **/
-    void loadTextures(const std::string &folderPath);
+    void loadTextures(const DecodedAssets &assets);
 
     /**
     * @brief Loads profile data from a datafile (data.txt)
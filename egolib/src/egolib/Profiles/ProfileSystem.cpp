@@ -31,6 +31,7 @@
 #include "game/char.h"
 #include "game/game.h"
 #include "game/script_compile.h"
+#include "egolib/Core/ThreadPool.hpp"
 
 //Globals
 pro_import_t import_data;
@@ -172,7 +173,7 @@ std::shared_ptr<pip_t> ProfileSystem::pro_get_ppip(const PRO_REF iobj, const Loc
     return LOADED_PIP(local_pip) ? PipStack.get_ptr(local_pip) : nullptr;
 }
 
-PRO_REF ProfileSystem::loadOneProfile(const std::string &pathName, int slot_override)
+PRO_REF ProfileSystem::reserveSlot(const std::string &pathName, int slot_override)
 {
     bool required = !(slot_override < 0 || slot_override >= INVALID_PRO_REF);
 
@@ -218,7 +219,52 @@ PRO_REF ProfileSystem::loadOneProfile(const std::string &pathName, int slot_over
         }
     }
 
-    std::shared_ptr<ObjectProfile> profile = ObjectProfile::loadFromFile(pathName, iobj);
+    return iobj;
+}
+
+PRO_REF ProfileSystem::loadOneProfile(const std::string &pathName, int slot_override)
+{
+    PRO_REF iobj = reserveSlot(pathName, slot_override);
+    if (INVALID_PRO_REF == iobj)
+    {
+        return INVALID_PRO_REF;
+    }
+
+    return storeProfile(pathName, iobj, ObjectProfile::loadFromFile(pathName, iobj));
+}
+
+void ProfileSystem::loadAllProfiles(const std::vector<std::string> &pathNames, const std::shared_ptr<const module_bundle_t> &bundle)
+{
+    // List the folders on this thread, then decode the files of all profiles on the worker threads.
+    std::vector<std::shared_ptr<ObjectProfile::DecodedAssets>> assets;
+    std::vector<std::future<void>> decoded;
+    for (const std::string &pathName : pathNames)
+    {
+        auto profileAssets = std::make_shared<ObjectProfile::DecodedAssets>(pathName, false);
+        profileAssets->bundle = bundle;
+        assets.push_back(profileAssets);
+        decoded.push_back(Ego::ThreadPool::get().submit([profileAssets]() { ObjectProfile::decodeAssets(*profileAssets); }));
+    }
+
+    // Finish the profiles in order on this thread, so the slots and the references
+    // to particles, enchants and textures are the same as when loading one by one.
+    for (size_t i = 0; i < pathNames.size(); ++i)
+    {
+        decoded[i].get();
+
+        PRO_REF iobj = reserveSlot(pathNames[i], -1);
+        if (INVALID_PRO_REF != iobj)
+        {
+            storeProfile(pathNames[i], iobj, ObjectProfile::loadFromFile(*assets[i], iobj));
+        }
+
+        // Release the decoded images.
+        assets[i] = nullptr;
+    }
+}
+
+PRO_REF ProfileSystem::storeProfile(const std::string &pathName, PRO_REF iobj, const std::shared_ptr<ObjectProfile> &profile)
+{
     if (!profile)
     {
         log_warning("ProfileSystem::loadOneProfile() - Failed to load (%s) into slot number %d\n", pathName.c_str(), iobj);
@@ -32,6 +32,7 @@ class ObjectProfile;
 class ModuleProfile;
 struct pip_t;
 struct eve_t;
+struct module_bundle_t;
 class LoadPlayerElement;
 
 /// Placeholders used while importing profiles
@@ -97,6 +98,16 @@ public:
      */
     PRO_REF loadOneProfile(const std::string &folderPath, int slot_override = -1);
 
+    /**
+     * @brief
+     *  Load several objects, with the same result as calling loadOneProfile() for each of them in order.
+     * @remark
+     *  The models, particle and enchant profiles and images of the objects are decoded on the worker
+     *  threads of Ego::ThreadPool. Slots, textures and sounds are assigned on the calling thread.
+     *  Models which are up to date in the bundle are read from it instead of their source files.
+     */
+    void loadAllProfiles(const std::vector<std::string> &folderPaths, const std::shared_ptr<const module_bundle_t> &bundle = nullptr);
+
     /**
      * @brief Loads only the slot number from data.txt
      *        If slot_override is valid, then that is used indead
@@ -148,6 +159,18 @@ public:
     void loadGlobalParticleProfiles();
 
 private:
+    /**
+     * @brief Get the slot to load an object into
+     * @return the slot, INVALID_PRO_REF if the object should not be loaded
+     */
+    PRO_REF reserveSlot(const std::string &folderPath, int slot_override);
+
+    /**
+     * @brief Store a loaded object into its slot
+     * @return the slot, INVALID_PRO_REF if the object could not be loaded
+     */
+    PRO_REF storeProfile(const std::string &folderPath, PRO_REF slot, const std::shared_ptr<ObjectProfile> &profile);
+
     std::unordered_map<size_t, TX_REF> _bookIcons; //List of all book icons loaded
     std::unordered_map<PRO_REF, std::shared_ptr<ObjectProfile>> _profilesLoaded; //Maps slot numbers to ObjectProfiles
 
@@ -60,6 +60,21 @@ protected:
         return INVALIDREF;
     }
 
+    /// @brief Get the reference to load a profile into.
+    /// @return the override reference after releasing its profile if it is valid, a free reference otherwise
+    REFTYPE acquire_one(const REFTYPE _override)
+    {
+        if(isLoaded(_override)) {
+            log_warning("Loaded over existing profile\n");
+        }
+
+        if (isValidRange(_override)) {
+            release_one(_override);
+            return _override;
+        }
+        return get_free();
+    }
+
 
 public:
 
@@ -150,7 +165,8 @@ public:
         if (isValidRange(ref) && _map[ref] != nullptr) {
             auto ptr = _map[ref];
             if (ptr && ptr->_loaded) {
-                _map[ref]->reset();
+                // Drop the profile instead of resetting it, it might be shared with the asset cache.
+                _map[ref] = nullptr;
             }
         }
         return true;
@@ -160,18 +176,7 @@ public:
     /// @return a reference to the profile on sucess, INVALIDREF on failure
     REFTYPE load_one(const std::string& pathname, const REFTYPE _override)
     {
-        if(isLoaded(_override)) {
-            log_warning("Loaded over existing profile\n");
-        }
-
-        REFTYPE ref = INVALIDREF;
-        if (isValidRange(_override)) {
-            release_one(_override);
-            ref = _override;
-        } else {
-            ref = get_free();
-        }
-
+        REFTYPE ref = acquire_one(_override);
         if (!isValidRange(ref)) {
             return INVALIDREF;
         }
@@ -185,6 +190,28 @@ public:
         return ref;
     }
 
+    /// @brief Store a profile which was already read with the reader into the profile stack.
+    /// @param profile the profile, a null pointer if reading failed
+    /// @return a reference to the profile on sucess, INVALIDREF on failure
+    /// @remark The result is the same as if load_one() had read the profile. This allows for reading
+    ///         profiles on a worker thread and storing them on the main thread.
+    REFTYPE store_one(const std::shared_ptr<TYPE>& profile, const REFTYPE _override)
+    {
+        REFTYPE ref = acquire_one(_override);
+        if (!isValidRange(ref)) {
+            return INVALIDREF;
+        }
+
+        if (!profile || !profile->_loaded) {
+            return INVALIDREF;
+        }
+        // A shared profile might have been stored before, count its spawns anew.
+        profile->_spawnRequestCount = 0;
+        profile->_spawnCount = 0;
+        _map[ref] = profile;
+        return ref;
+    }
+
     void unintialize()
     {
         reset();
@@ -279,7 +306,7 @@ public:
         stats._sumSpawnCount = 0;
         for (const auto& pair : _map) {
             const auto ptr = pair.second;
-            if (ptr->_loaded) {
+            if (ptr && ptr->_loaded) {
                 stats._loadedCount++;
                 // spawn request count
                 stats._sumSpawnRequestCount += ptr->_spawnRequestCount;
@@ -326,7 +353,7 @@ public:
         os << " list of loaded profiles:" << std::endl;
         for (const auto& pair : _map) {
             const auto ptr = pair.second;
-            if (ptr->_loaded)
+            if (ptr && ptr->_loaded)
             {
                 os << " reference: " << pair.first << ","
                    << " name: " << "`" << ptr->_name << "`" << ","
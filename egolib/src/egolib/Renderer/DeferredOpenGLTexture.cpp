@@ -29,21 +29,8 @@ const oglx_texture_t& DeferredOpenGLTexture::get()
             throw std::logic_error("DeferredOpenGLTexture::get() on nullptr texture");
          }
 
-        std::unordered_map<std::string, std::shared_ptr<oglx_texture_t>> &textureCache = TextureManager::get().getTextureCache();
-
-        //Not loaded yet?
-        auto result = textureCache.find(_filePath);
-        if(result == textureCache.end()) {
-            std::shared_ptr<oglx_texture_t> loadTexture = std::make_shared<oglx_texture_t>();
-            ego_texture_load_vfs(loadTexture.get(), _filePath.c_str(), TRANSCOLOR);
-            textureCache[_filePath] = loadTexture;
-            _texture = loadTexture;
-        }
-
-        //Get cached texture
-        else {
-            _texture = (*result).second;
-        }
+        //Get the cached texture or decode it in the background, it is a placeholder until it is uploaded
+        _texture = TextureManager::get().loadAsync(_filePath, TRANSCOLOR);
 
         _loaded = true;
     }
@@ -51,6 +38,19 @@ const oglx_texture_t& DeferredOpenGLTexture::get()
     return *_texture.get();
 }
 
+const oglx_texture_t& DeferredOpenGLTexture::getLoaded()
+{
+    if(_filePath.empty()) {
+        throw std::logic_error("DeferredOpenGLTexture::getLoaded() on nullptr texture");
+    }
+
+    //Get the cached texture, load it now if it is still a placeholder
+    _texture = TextureManager::get().loadSync(_filePath, TRANSCOLOR);
+    _loaded = true;
+
+    return *_texture.get();
+}
+
 void DeferredOpenGLTexture::release()
 {
     _loaded = false;
@@ -7,7 +7,9 @@ namespace Ego
     /**
     * @brief
     *   A OpenGL texture with lazy loading. This means the texture will not
-    *   be loaded into memory before it is required for rendering
+    *   be loaded into memory before it is required for rendering. The texture
+    *   is then loaded in the background by TextureManager::loadAsync(), until it
+    *   is ready the error texture is rendered instead
     **/
     class DeferredOpenGLTexture
     {
@@ -18,6 +20,13 @@ namespace Ego
 
         const oglx_texture_t& get();
 
+        /**
+        * @return
+        *   The texture, like get(), but the image is loaded right away if it is not
+        *   uploaded yet. Use this if the size of the texture is needed.
+        **/
+        const oglx_texture_t& getLoaded();
+
         void release();
 
         void setTextureSource(const std::string &filePath);
@@ -262,6 +262,9 @@ bool IMG_test_alpha_key(SDL_Surface *surface, Uint32 key)
 //--------------------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------------------
 
+/// If textures are uploaded to OpenGL, see setTextureUploadEnabled().
+static bool _textureUploadEnabled = true;
+
 struct CErrorTexture
 {
     std::shared_ptr<SDL_Surface> _image;
@@ -270,6 +273,8 @@ struct CErrorTexture
     /// The OpenGL ID of this error texture.
     GLuint _id;
     char *_name;
+    /// If the OpenGL texture was created.
+    bool _uploaded;
     const char *getName() const
     {
         return _name;
@@ -292,7 +297,8 @@ struct CErrorTexture
     }
     // Construct this error texture.
     CErrorTexture(const char *name, GLenum target) :
-        _image(ImageManager::get().getDefaultImage())
+        _image(ImageManager::get().getDefaultImage()),
+        _uploaded(false)
     {
         _name = strdup(name);
         if (!_name)
@@ -305,6 +311,11 @@ struct CErrorTexture
             free(_name);
             throw std::invalid_argument("invalid texture target");
         }
+        if (!_textureUploadEnabled)
+        {
+            _id = 0;
+            return;
+        }
         while (GL_NO_ERROR != glGetError())
         {
             /* Nothing to do. */
@@ -354,12 +365,16 @@ struct CErrorTexture
             glDeleteTextures(1, &_id);
             throw std::runtime_error("unable to upload error image into error texture");
         }
+        _uploaded = true;
     }
     // Destruct this error texture.
     ~CErrorTexture()
     {
         free(_name);
-        glDeleteTextures(1, &_id);
+        if (_uploaded)
+        {
+            glDeleteTextures(1, &_id);
+        }
     }
 };
 
@@ -405,6 +420,11 @@ GLuint get2DErrorTextureID()
     return _errorTexture2D->_id;
 }
 
+void setTextureUploadEnabled(bool enabled)
+{
+    _textureUploadEnabled = enabled;
+}
+
 bool isErrorTextureID(GLuint id)
 {
     if(!_errorTexture1D || !_errorTexture2D) return false;
@@ -455,6 +475,16 @@ GLuint oglx_texture_t::load(const std::string& name, std::shared_ptr<SDL_Surface
         return INVALID_GL_ID;
     }
 
+    // If textures are not uploaded, keep this texture bound to the backing error texture but remember the size of the source.
+    if (!_textureUploadEnabled)
+    {
+        _type = ((1 == source->h) && (source->w > 1)) ? Ego::TextureType::_1D : Ego::TextureType::_2D;
+        _width = _sourceWidth = source->w;
+        _height = _sourceHeight = source->h;
+        _name = name;
+        return _id;
+    }
+
     // Convert the source into a format suited for OpenGL.
     std::shared_ptr<SDL_Surface> new_source;
     try
@@ -355,3 +355,13 @@ public:
     GLuint get2DErrorTextureID();
     GLuint get1DErrorTextureID();
     bool isErrorTextureID(GLuint id);
+    /**
+     * @brief
+     *  Enable or disable the upload of textures to OpenGL.
+     * @remark
+     *  If disabled, no OpenGL function is called, e.g. if there is no OpenGL context. A loaded texture remembers
+     *  the size of its image, but it is bound to the error texture, which has no OpenGL texture either.
+     * @remark
+     *  Change it only if no texture exists.
+     */
+    void setTextureUploadEnabled(bool enabled);
@@ -0,0 +1,242 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+/// @file   egolib/Scene/SweepAndPrune.cpp
+/// @brief  A sweep-and-prune broad phase for BSP leaves
+
+#include "egolib/Scene/SweepAndPrune.hpp"
+#include "egolib/geometry.h"
+#include "egolib/log.h"
+
+namespace BSP
+{
+
+SweepAndPrune::SweepAndPrune() :
+	_boxes(),
+	_freeBoxes(),
+	_index(),
+	_added(),
+	_stamp(0),
+	_endpoints(),
+	_open(),
+	_boxPairs(),
+	_pairs(),
+	_overlapBegin(),
+	_overlaps(),
+	_overlapNext(),
+	_swapCount(0)
+{
+}
+
+SweepAndPrune::~SweepAndPrune()
+{
+}
+
+void SweepAndPrune::insert(BSP_leaf_t *leaf, const aabb_t& aabb)
+{
+	if (!leaf) return;
+
+	uint32_t box;
+	auto it = _index.find(leaf);
+	if (it == _index.end())
+	{
+		if (_freeBoxes.empty())
+		{
+			box = _boxes.size();
+			_boxes.push_back(Box());
+		}
+		else
+		{
+			box = _freeBoxes.back();
+			_freeBoxes.pop_back();
+		}
+		_index.emplace(leaf, box);
+		_added.push_back(box);
+		_boxes[box].leaf = leaf;
+	}
+	else
+	{
+		box = it->second;
+	}
+
+	Box& b = _boxes[box];
+	for (size_t i = 0; i < 3; ++i)
+	{
+		b.min[i] = aabb.getMin()[i];
+		b.max[i] = aabb.getMax()[i];
+	}
+	b.stamp = _stamp;
+}
+
+void SweepAndPrune::update(PairTest& test)
+{
+	// Drop the boxes which were not added again.
+	for (uint32_t box = 0; box < _boxes.size(); ++box)
+	{
+		Box& b = _boxes[box];
+		if (b.leaf && _stamp != b.stamp)
+		{
+			_index.erase(b.leaf);
+			b.leaf = nullptr;
+			_freeBoxes.push_back(box);
+		}
+	}
+
+	// Drop their endpoints and refresh the values of the others.
+	size_t count = 0;
+	for (size_t i = 0; i < _endpoints.size(); ++i)
+	{
+		Endpoint endpoint = _endpoints[i];
+		const Box& b = _boxes[endpoint.box];
+		if (!b.leaf) continue;
+		endpoint.value = endpoint.isMax ? b.max[kX] : b.min[kX];
+		_endpoints[count++] = endpoint;
+	}
+	_endpoints.resize(count);
+
+	// Append the endpoints of the new boxes.
+	for (uint32_t box : _added)
+	{
+		_endpoints.push_back({ _boxes[box].min[kX], box, false });
+		_endpoints.push_back({ _boxes[box].max[kX], box, true });
+	}
+	_added.clear();
+
+	// Insertion sort. The order of the last update is mostly kept, so only few endpoints move.
+	_swapCount = 0;
+	for (size_t i = 1; i < _endpoints.size(); ++i)
+	{
+		Endpoint endpoint = _endpoints[i];
+		size_t j = i;
+		while (j > 0 && endpoint < _endpoints[j - 1])
+		{
+			_endpoints[j] = _endpoints[j - 1];
+			--j;
+		}
+		_endpoints[j] = endpoint;
+		_swapCount += i - j;
+	}
+
+	// Sweep. A box overlaps along the x-axis with each box which is open when its minimum is reached.
+	_boxPairs.clear();
+	_open.clear();
+	for (const Endpoint& endpoint : _endpoints)
+	{
+		Box& b = _boxes[endpoint.box];
+		if (endpoint.isMax)
+		{
+			// Close the box.
+			const uint32_t last = _open.back();
+			_open[b.open] = last;
+			_boxes[last].open = b.open;
+			_open.pop_back();
+			continue;
+		}
+		for (uint32_t other : _open)
+		{
+			const Box& o = _boxes[other];
+			if (b.min[kY] > o.max[kY] || b.max[kY] < o.min[kY]) continue;
+			if (b.min[kZ] > o.max[kZ] || b.max[kZ] < o.min[kZ]) continue;
+			if (!test(o.leaf, b.leaf)) continue;
+			_boxPairs.emplace_back(other, endpoint.box);
+		}
+		// Open the box.
+		b.open = _open.size();
+		_open.push_back(endpoint.box);
+	}
+
+	// Group the pairs by box.
+	_pairs.clear();
+	_overlapBegin.assign(_boxes.size() + 1, 0);
+	for (const auto& pair : _boxPairs)
+	{
+		_pairs.push_back({ _boxes[pair.first].leaf, _boxes[pair.second].leaf });
+		_overlapBegin[pair.first + 1]++;
+		_overlapBegin[pair.second + 1]++;
+	}
+	for (size_t box = 0; box < _boxes.size(); ++box)
+	{
+		_overlapBegin[box + 1] += _overlapBegin[box];
+	}
+	_overlaps.resize(2 * _boxPairs.size());
+	_overlapNext.assign(_overlapBegin.begin(), _overlapBegin.end() - 1);
+	for (const auto& pair : _boxPairs)
+	{
+		_overlaps[_overlapNext[pair.first]++] = pair.second;
+		_overlaps[_overlapNext[pair.second]++] = pair.first;
+	}
+
+	_stamp++;
+}
+
+const std::vector<SweepAndPrune::Pair>& SweepAndPrune::getPairs() const
+{
+	return _pairs;
+}
+
+void SweepAndPrune::getOverlaps(const BSP_leaf_t *leaf, LeafTest& test, Ego::DynamicArray<BSP_leaf_t *>& overlaps) const
+{
+	auto it = _index.find(leaf);
+	if (it == _index.end() || it->second + 1 >= _overlapBegin.size()) return;
+
+	size_t lost_leaves = 0;
+	for (size_t i = _overlapBegin[it->second]; i < _overlapBegin[it->second + 1]; ++i)
+	{
+		BSP_leaf_t *other = _boxes[_overlaps[i]].leaf;
+		if (test(other))
+		{
+			if (rv_success != overlaps.push_back(other))
+			{
+				lost_leaves++;
+			}
+		}
+	}
+	if (lost_leaves > 0)
+	{
+		log_warning("%s:%d: %" PRIuZ " leaves lost\n", __FILE__, __LINE__, lost_leaves);
+	}
+}
+
+size_t SweepAndPrune::size() const
+{
+	return _index.size();
+}
+
+size_t SweepAndPrune::getSwapCount() const
+{
+	return _swapCount;
+}
+
+size_t SweepAndPrune::removeAllLeaves()
+{
+	size_t count = _index.size();
+	_boxes.clear();
+	_freeBoxes.clear();
+	_index.clear();
+	_added.clear();
+	_endpoints.clear();
+	_open.clear();
+	_boxPairs.clear();
+	_pairs.clear();
+	_overlapBegin.clear();
+	_overlaps.clear();
+	return count;
+}
+
+} // namespace BSP
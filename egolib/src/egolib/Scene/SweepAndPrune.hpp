@@ -0,0 +1,165 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+/// @file   egolib/Scene/SweepAndPrune.hpp
+/// @brief  A sweep-and-prune broad phase for BSP leaves
+
+#pragma once
+
+#include "egolib/bsp.h"
+
+namespace BSP
+{
+	typedef bool (PairTest)(BSP_leaf_t *, BSP_leaf_t *);
+
+	/**
+	 * @brief
+	 *	A broad phase which keeps the minimum and the maximum of the box of each leaf along the x-axis
+	 *	in a persistent list of endpoints sorted by their values. A single sweep over that list finds
+	 *	all pairs of leaves whose boxes overlap.
+	 * @remark
+	 *	The endpoints are not removed and re-added in every update. Instead, the endpoints of the leaves
+	 *	which are still present keep their place in the list and the list is re-sorted with an insertion
+	 *	sort. As objects move only a little between two updates, this takes about linear time.
+	 * @remark
+	 *	The boxes are given to insert() and copied, they do not depend on the bounding boxes stored
+	 *	in the leaves or on whether the leaves are in a BSP.
+	 */
+	class SweepAndPrune : public LeafHolder
+	{
+	public:
+		/// Two leaves whose boxes overlapped in the last update.
+		struct Pair
+		{
+			BSP_leaf_t *first;
+			BSP_leaf_t *second;
+		};
+
+		SweepAndPrune();
+		virtual ~SweepAndPrune();
+
+		/**
+		 * @brief
+		 *	Add a leaf to the next update or keep a leaf which was already added in a previous update.
+		 * @param leaf
+		 *	the leaf
+		 * @param aabb
+		 *	the box of the leaf in the next update
+		 * @remark
+		 *	A leaf must be added again for each update it is supposed to be part of.
+		 */
+		void insert(BSP_leaf_t *leaf, const aabb_t& aabb);
+
+		/**
+		 * @brief
+		 *	Drop the leaves which were not added since the last update, re-sort the endpoints of the
+		 *	other leaves and sweep them for overlapping pairs.
+		 * @param test
+		 *	a test a pair of leaves with overlapping boxes has to pass to be kept
+		 */
+		void update(PairTest& test);
+
+		/**
+		 * @brief
+		 *	Get the pairs of leaves whose boxes overlapped in the last update.
+		 */
+		const std::vector<Pair>& getPairs() const;
+
+		/**
+		 * @brief
+		 *	Get the leaves whose boxes overlapped the box of a leaf in the last update.
+		 * @param leaf
+		 *	the leaf
+		 * @param test
+		 *	a leaf test any overlapping leaf has to pass in addition to get into the overlap list
+		 * @param overlaps
+		 *	the overlap list
+		 * @remark
+		 *	This only looks up the pairs of the last update. It can be called from several threads at once.
+		 */
+		void getOverlaps(const BSP_leaf_t *leaf, LeafTest& test, Ego::DynamicArray<BSP_leaf_t *>& overlaps) const;
+
+		/**
+		 * @brief
+		 *	Get the number of leaves.
+		 */
+		size_t size() const;
+
+		/**
+		 * @brief
+		 *	Get the number of times two endpoints were swapped by the last update.
+		 * @remark
+		 *	A small number means the order of the previous update was almost kept.
+		 */
+		size_t getSwapCount() const;
+
+		// Override
+		size_t removeAllLeaves() override;
+
+	private:
+		struct Box
+		{
+			/// The leaf or @a nullptr if the box is not used.
+			BSP_leaf_t *leaf;
+			float min[3];
+			float max[3];
+			/// The update in which the leaf was last added.
+			uint32_t stamp;
+			/// The index of the box in the list of open boxes during the sweep.
+			size_t open;
+		};
+
+		struct Endpoint
+		{
+			float value;
+			uint32_t box;
+			bool isMax;
+
+			/// Minima come before maxima of the same value, so boxes which only touch overlap.
+			bool operator<(const Endpoint& other) const
+			{
+				return value < other.value || (value == other.value && !isMax && other.isMax);
+			}
+		};
+
+		/// The boxes, the boxes of removed leaves are reused.
+		std::vector<Box> _boxes;
+		std::vector<uint32_t> _freeBoxes;
+		/// The box of each leaf.
+		std::unordered_map<const BSP_leaf_t *, uint32_t> _index;
+		/// The boxes added since the last update which were not present before.
+		std::vector<uint32_t> _added;
+		uint32_t _stamp;
+
+		/// The endpoints of the boxes along the x-axis, sorted.
+		std::vector<Endpoint> _endpoints;
+		/// The boxes which were opened but not closed yet during the sweep.
+		std::vector<uint32_t> _open;
+
+		/// The pairs found by the last update, as boxes and as leaves.
+		std::vector<std::pair<uint32_t, uint32_t>> _boxPairs;
+		std::vector<Pair> _pairs;
+		/// The other boxes of the pairs of each box, the ones of box i are from _overlapBegin[i] to _overlapBegin[i + 1].
+		std::vector<size_t> _overlapBegin;
+		std::vector<uint32_t> _overlaps;
+		std::vector<size_t> _overlapNext;
+
+		size_t _swapCount;
+	};
+}
@@ -40,13 +40,52 @@ template <typename _Traits = Traits<char>>
 struct TextInputFile : public TextFile<_Traits>
 {
 
+public:
+
+    /**
+     * @brief
+     *  The possible ways a text input file reads its contents.
+     */
+    enum class Access
+    {
+        /**
+         * @brief
+         *  The text input file reads one Byte at a time from the backing VFS file.
+         */
+        Stream,
+        /**
+         * @brief
+         *  The text input file reads the whole file into memory when it is constructed
+         *  and reads the characters from memory.
+         */
+        Memory,
+    };
+
 private:
 
     /**
      * @brief
-     *  The backing VFS file.
+     *  The backing VFS file if the access is Access::Stream.
      */
     vfs_FILE *_file;
+
+    /**
+     * @brief
+     *  The contents of the file if the access is Access::Memory.
+     */
+    char *_data;
+
+    /**
+     * @brief
+     *  The size, in Bytes, of the contents of the file if the access is Access::Memory.
+     */
+    size_t _size;
+
+    /**
+     * @brief
+     *  The index of the next Byte in the contents of the file if the access is Access::Memory.
+     */
+    size_t _position;
     
     typedef typename TextFile<_Traits>::Traits Traits;
 
@@ -68,13 +107,29 @@ public:
      *  That is, the current extended character is _Traits::startOfInput() and
      *  advance() must be called to advance to the first extend character. See
      *  advance() for more information.
+     * @param access
+     *  how the contents of the file are read
      */
-    TextInputFile(const string& fileName) :
+    TextInputFile(const string& fileName, Access access = Access::Stream) :
         TextFile<_Traits>(fileName, TextFile<_Traits>::Mode::Read),
         _file(nullptr),
+        _data(nullptr),
+        _size(0),
+        _position(0),
         _current(Traits::startOfInput())
     {
-        _file = vfs_openRead(fileName);
+        if (Access::Memory == access)
+        {
+            if (!vfs_readEntireFile(fileName, &_data, &_size))
+            {
+                _data = nullptr;
+                _size = 0;
+            }
+        }
+        else
+        {
+            _file = vfs_openRead(fileName);
+        }
     }
 
     /**
@@ -88,6 +143,11 @@ public:
             vfs_close(_file);
             _file = nullptr;
         }
+        if (_data)
+        {
+            free(_data);
+            _data = nullptr;
+        }
     }
 
     /**
@@ -98,7 +158,7 @@ public:
      */
     bool isOpen() const
     {
-        return nullptr != _file;
+        return nullptr != _file || nullptr != _data;
     }
 
     /**
@@ -117,17 +177,27 @@ public:
             // ... do nothing.
             return;
         }
-        // (2) If the backing VFS file is not opened ...
-        if (!_file)
+        uint8_t byte;
+        // (2) If the contents are in memory ...
+        if (_data)
+        {
+            // ... take the next Byte from memory.
+            if (_position == _size)
+            {
+                _current = Traits::endOfInput();
+                return;
+            }
+            byte = static_cast<uint8_t>(_data[_position++]);
+        }
+        // (3) If the backing VFS file is not opened ...
+        else if (!_file)
         {
             // ... raise an error.
             _current = Traits::error();
             return;
         }
-        // (3) Otherwise: Read a single Byte.
-        uint8_t byte;
-        size_t size = vfs_read(&byte, 1, 1, _file);
-        if (1 != size)
+        // (4) Otherwise: Read a single Byte.
+        else if (1 != vfs_read(&byte, 1, 1, _file))
         {
             if (vfs_error(_file))
             {
@@ -147,19 +217,19 @@ public:
                 throw runtime_error(message.str());
             }
         }
-        // (4) Verify that it is a Byte the represents the starting Byte of a UTF-8 character sequence of length 1.
+        // (5) Verify that it is a Byte the represents the starting Byte of a UTF-8 character sequence of length 1.
         if (byte > 0x7F)
         {
             _current = Traits::error();
             return;
         }
-        // (5) Verify that it is not the zero terminator.
+        // (6) Verify that it is not the zero terminator.
         if ('\0' == byte)
         {
             _current = Traits::error();
             return;
         }
-        // (6) Propage the Byte to an extended character and store it.
+        // (7) Propage the Byte to an extended character and store it.
         _current = (typename Traits::ExtendedType)byte;
     }
 
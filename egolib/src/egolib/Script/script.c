@@ -38,15 +38,22 @@
 
 //--------------------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------------------
-static bool scr_increment_pos( script_info_t * pself );
-static bool scr_set_pos( script_info_t * pself, size_t position );
+static bool scr_increment_pos( script_state_t * pstate, const script_info_t * pscript );
+static bool scr_set_pos( script_state_t * pstate, const script_info_t * pscript, size_t position );
 
-static Uint8 scr_run_function( script_state_t * pstate, ai_state_t& aiState, script_info_t *pscript );
+static Uint8 scr_run_function( script_state_t * pstate, ai_state_t& aiState, const script_info_t *pscript, Uint32 valuecode, script_function_t function );
 static void  scr_set_operand( script_state_t * pstate, Uint8 variable );
-static void  scr_run_operand( script_state_t * pstate, ai_state_t& aiState, script_info_t * pscript );
+static void  scr_run_operand( script_state_t * pstate, ai_state_t& aiState, const script_operand_t& operand, Object *pchr, Object *ptarget, Object *powner );
+static Object *scr_get_object( const CHR_REF ichr );
 
-static bool scr_run_operation( script_state_t * pstate, ai_state_t& aiState, script_info_t *pscript );
-static bool scr_run_function_call( script_state_t * pstate, ai_state_t& aiState, script_info_t *pscript );
+static bool scr_run_operation( script_state_t * pstate, ai_state_t& aiState, const script_info_t *pscript );
+static bool scr_run_function_call( script_state_t * pstate, ai_state_t& aiState, const script_info_t *pscript );
+
+static void scr_run_raw( script_state_t * pstate, ai_state_t& aiState, const script_info_t *pscript );
+static void scr_run_decoded( script_state_t * pstate, ai_state_t& aiState, const script_info_t *pscript, Object *pchr );
+static bool scr_think_decoded( script_state_t * pstate, ai_state_t& aiState, const script_info_t *pscript, Object *pchr, script_think_buffer_t& buffer );
+
+static void scr_set_latches( Object *pchr );
 
 /// A counter to measure the time of an invocation of a script function.
 /// Its window size is 1 as the duration spend in the invocation is added to an histogram (see below).
@@ -56,8 +63,31 @@ static std::shared_ptr<Ego::Time::Clock<Ego::Time::ClockPolicy::NonRecursive>> g
 static int    _script_function_calls[SCRIPT_FUNCTIONS_COUNT];
 static double _script_function_times[SCRIPT_FUNCTIONS_COUNT];
 
-static PRO_REF script_error_model = INVALID_PRO_REF;
-static const char * script_error_classname = "UNKNOWN";
+/// The script functions indexed by their function code, nullptr if a code is not handled.
+static script_function_t _script_functions[SCRIPT_FUNCTIONS_COUNT];
+
+/// How a script function may be called in the parallel think phase (see scr_think_chr_script).
+enum script_function_kind_t
+{
+    SCRIPT_FUNCTION_SERIAL = 0,  ///< Has side effects on other objects or the module, abort the parallel run
+    SCRIPT_FUNCTION_PARALLEL,    ///< Only reads the world and writes the script and the AI state, call it
+    SCRIPT_FUNCTION_DEFERRED     ///< Has side effects nothing in the script reads back, call it in the commit
+};
+
+/// The kinds of the script functions indexed by their function code.
+static Uint8 _script_function_kinds[SCRIPT_FUNCTIONS_COUNT];
+
+/// Instructions executed and time spent in the interpreter loop, for the raw (index 0)
+/// and the pre-decoded (index 1) interpreter. The time is only measured for the outermost
+/// script run as scripts may run other scripts. Like the times of the script functions,
+/// these are only measured if debug.scripts.timing.enable is set.
+static size_t _script_interpreter_instructions[2];
+static double _script_interpreter_times[2];
+static int    _script_interpreter_depth = 0;
+
+/// Number of scripts run and skipped (see scr_can_trigger).
+static size_t _script_run_count = 0;
+static size_t _script_skip_count = 0;
 
 static bool _scripting_system_initialized = false;
 
@@ -70,7 +100,465 @@ void scripting_system_begin()
 		for (size_t i = 0; i < SCRIPT_FUNCTIONS_COUNT; ++i) {
 			_script_function_calls[i] = 0;
 			_script_function_times[i] = 0.0F;
+			_script_functions[i] = nullptr;
+			_script_function_kinds[i] = SCRIPT_FUNCTION_SERIAL;
 		}
+		for (size_t i = 0; i < 2; ++i) {
+			_script_interpreter_instructions[i] = 0;
+			_script_interpreter_times[i] = 0.0;
+		}
+
+		_script_functions[FIFSPAWNED]                       = scr_Spawned;
+		_script_functions[FIFTIMEOUT]                       = scr_TimeOut;
+		_script_functions[FIFATWAYPOINT]                    = scr_AtWaypoint;
+		_script_functions[FIFATLASTWAYPOINT]                = scr_AtLastWaypoint;
+		_script_functions[FIFATTACKED]                      = scr_Attacked;
+		_script_functions[FIFBUMPED]                        = scr_Bumped;
+		_script_functions[FIFORDERED]                       = scr_Ordered;
+		_script_functions[FIFCALLEDFORHELP]                 = scr_CalledForHelp;
+		_script_functions[FSETCONTENT]                      = scr_set_Content;
+		_script_functions[FIFKILLED]                        = scr_Killed;
+		_script_functions[FIFTARGETKILLED]                  = scr_TargetKilled;
+		_script_functions[FCLEARWAYPOINTS]                  = scr_ClearWaypoints;
+		_script_functions[FADDWAYPOINT]                     = scr_AddWaypoint;
+		_script_functions[FFINDPATH]                        = scr_FindPath;
+		_script_functions[FCOMPASS]                         = scr_Compass;
+		_script_functions[FGETTARGETARMORPRICE]             = scr_get_TargetArmorPrice;
+		_script_functions[FSETTIME]                         = scr_set_Time;
+		_script_functions[FGETCONTENT]                      = scr_get_Content;
+		_script_functions[FJOINTARGETTEAM]                  = scr_JoinTargetTeam;
+		_script_functions[FSETTARGETTONEARBYENEMY]          = scr_set_TargetToNearbyEnemy;
+		_script_functions[FSETTARGETTOTARGETLEFTHAND]       = scr_set_TargetToTargetLeftHand;
+		_script_functions[FSETTARGETTOTARGETRIGHTHAND]      = scr_set_TargetToTargetRightHand;
+		_script_functions[FSETTARGETTOWHOEVERATTACKED]      = scr_set_TargetToWhoeverAttacked;
+		_script_functions[FSETTARGETTOWHOEVERBUMPED]        = scr_set_TargetToWhoeverBumped;
+		_script_functions[FSETTARGETTOWHOEVERCALLEDFORHELP] = scr_set_TargetToWhoeverCalledForHelp;
+		_script_functions[FSETTARGETTOOLDTARGET]            = scr_set_TargetToOldTarget;
+		_script_functions[FSETTURNMODETOVELOCITY]           = scr_set_TurnModeToVelocity;
+		_script_functions[FSETTURNMODETOWATCH]              = scr_set_TurnModeToWatch;
+		_script_functions[FSETTURNMODETOSPIN]               = scr_set_TurnModeToSpin;
+		_script_functions[FSETBUMPHEIGHT]                   = scr_set_BumpHeight;
+		_script_functions[FIFTARGETHASID]                   = scr_TargetHasID;
+		_script_functions[FIFTARGETHASITEMID]               = scr_TargetHasItemID;
+		_script_functions[FIFTARGETHOLDINGITEMID]           = scr_TargetHoldingItemID;
+		_script_functions[FIFTARGETHASSKILLID]              = scr_TargetHasSkillID;
+		_script_functions[FELSE]                            = scr_Else;
+		_script_functions[FRUN]                             = scr_Run;
+		_script_functions[FWALK]                            = scr_Walk;
+		_script_functions[FSNEAK]                           = scr_Sneak;
+		_script_functions[FDOACTION]                        = scr_DoAction;
+		_script_functions[FKEEPACTION]                      = scr_KeepAction;
+		_script_functions[FISSUEORDER]                      = scr_IssueOrder;
+		_script_functions[FDROPWEAPONS]                     = scr_DropWeapons;
+		_script_functions[FTARGETDOACTION]                  = scr_TargetDoAction;
+		_script_functions[FOPENPASSAGE]                     = scr_OpenPassage;
+		_script_functions[FCLOSEPASSAGE]                    = scr_ClosePassage;
+		_script_functions[FIFPASSAGEOPEN]                   = scr_PassageOpen;
+		_script_functions[FGOPOOF]                          = scr_GoPoof;
+		_script_functions[FCOSTTARGETITEMID]                = scr_CostTargetItemID;
+		_script_functions[FDOACTIONOVERRIDE]                = scr_DoActionOverride;
+		_script_functions[FIFHEALED]                        = scr_Healed;
+		_script_functions[FSENDMESSAGE]                     = scr_SendPlayerMessage;
+		_script_functions[FCALLFORHELP]                     = scr_CallForHelp;
+		_script_functions[FADDIDSZ]                         = scr_AddIDSZ;
+		_script_functions[FSETSTATE]                        = scr_set_State;
+		_script_functions[FGETSTATE]                        = scr_get_State;
+		_script_functions[FIFSTATEIS]                       = scr_StateIs;
+		_script_functions[FIFTARGETCANOPENSTUFF]            = scr_TargetCanOpenStuff;
+		_script_functions[FIFGRABBED]                       = scr_Grabbed;
+		_script_functions[FIFDROPPED]                       = scr_Dropped;
+		_script_functions[FSETTARGETTOWHOEVERISHOLDING]     = scr_set_TargetToWhoeverIsHolding;
+		_script_functions[FDAMAGETARGET]                    = scr_DamageTarget;
+		_script_functions[FIFXISLESSTHANY]                  = scr_XIsLessThanY;
+		_script_functions[FSETWEATHERTIME]                  = scr_set_WeatherTime;
+		_script_functions[FGETBUMPHEIGHT]                   = scr_get_BumpHeight;
+		_script_functions[FIFREAFFIRMED]                    = scr_Reaffirmed;
+		_script_functions[FUNKEEPACTION]                    = scr_UnkeepAction;
+		_script_functions[FIFTARGETISONOTHERTEAM]           = scr_TargetIsOnOtherTeam;
+		_script_functions[FIFTARGETISONHATEDTEAM]           = scr_TargetIsOnHatedTeam;
+		_script_functions[FPRESSLATCHBUTTON]                = scr_PressLatchButton;
+		_script_functions[FSETTARGETTOTARGETOFLEADER]       = scr_set_TargetToTargetOfLeader;
+		_script_functions[FIFLEADERKILLED]                  = scr_LeaderKilled;
+		_script_functions[FBECOMELEADER]                    = scr_BecomeLeader;
+		_script_functions[FCHANGETARGETARMOR]               = scr_ChangeTargetArmor;
+		_script_functions[FGIVEMONEYTOTARGET]               = scr_GiveMoneyToTarget;
+		_script_functions[FDROPKEYS]                        = scr_DropKeys;
+		_script_functions[FIFLEADERISALIVE]                 = scr_LeaderIsAlive;
+		_script_functions[FIFTARGETISOLDTARGET]             = scr_TargetIsOldTarget;
+		_script_functions[FSETTARGETTOLEADER]               = scr_set_TargetToLeader;
+		_script_functions[FSPAWNCHARACTER]                  = scr_SpawnCharacter;
+		_script_functions[FRESPAWNCHARACTER]                = scr_RespawnCharacter;
+		_script_functions[FCHANGETILE]                      = scr_ChangeTile;
+		_script_functions[FIFUSED]                          = scr_Used;
+		_script_functions[FDROPMONEY]                       = scr_DropMoney;
+		_script_functions[FSETOLDTARGET]                    = scr_set_OldTarget;
+		_script_functions[FDETACHFROMHOLDER]                = scr_DetachFromHolder;
+		_script_functions[FIFTARGETHASVULNERABILITYID]      = scr_TargetHasVulnerabilityID;
+		_script_functions[FCLEANUP]                         = scr_CleanUp;
+		_script_functions[FIFCLEANEDUP]                     = scr_CleanedUp;
+		_script_functions[FIFSITTING]                       = scr_Sitting;
+		_script_functions[FIFTARGETISHURT]                  = scr_TargetIsHurt;
+		_script_functions[FIFTARGETISAPLAYER]               = scr_TargetIsAPlayer;
+		_script_functions[FPLAYSOUND]                       = scr_PlaySound;
+		_script_functions[FSPAWNPARTICLE]                   = scr_SpawnParticle;
+		_script_functions[FIFTARGETISALIVE]                 = scr_TargetIsAlive;
+		_script_functions[FSTOP]                            = scr_Stop;
+		_script_functions[FDISAFFIRMCHARACTER]              = scr_DisaffirmCharacter;
+		_script_functions[FREAFFIRMCHARACTER]               = scr_ReaffirmCharacter;
+		_script_functions[FIFTARGETISSELF]                  = scr_TargetIsSelf;
+		_script_functions[FIFTARGETISMALE]                  = scr_TargetIsMale;
+		_script_functions[FIFTARGETISFEMALE]                = scr_TargetIsFemale;
+		_script_functions[FSETTARGETTOSELF]                 = scr_set_TargetToSelf;
+		_script_functions[FSETTARGETTORIDER]                = scr_set_TargetToRider;
+		_script_functions[FGETATTACKTURN]                   = scr_get_AttackTurn;
+		_script_functions[FGETDAMAGETYPE]                   = scr_get_DamageType;
+		_script_functions[FBECOMESPELL]                     = scr_BecomeSpell;
+		_script_functions[FBECOMESPELLBOOK]                 = scr_BecomeSpellbook;
+		_script_functions[FIFSCOREDAHIT]                    = scr_ScoredAHit;
+		_script_functions[FIFDISAFFIRMED]                   = scr_Disaffirmed;
+		_script_functions[FTRANSLATEORDER]                  = scr_TranslateOrder;
+		_script_functions[FSETTARGETTOWHOEVERWASHIT]        = scr_set_TargetToWhoeverWasHit;
+		_script_functions[FSETTARGETTOWIDEENEMY]            = scr_set_TargetToWideEnemy;
+		_script_functions[FIFCHANGED]                       = scr_Changed;
+		_script_functions[FIFINWATER]                       = scr_InWater;
+		_script_functions[FIFBORED]                         = scr_Bored;
+		_script_functions[FIFTOOMUCHBAGGAGE]                = scr_TooMuchBaggage;
+		_script_functions[FIFGROGGED]                       = scr_Grogged;
+		_script_functions[FIFDAZED]                         = scr_Dazed;
+		_script_functions[FIFTARGETHASSPECIALID]            = scr_TargetHasSpecialID;
+		_script_functions[FPRESSTARGETLATCHBUTTON]          = scr_PressTargetLatchButton;
+		_script_functions[FIFINVISIBLE]                     = scr_Invisible;
+		_script_functions[FIFARMORIS]                       = scr_ArmorIs;
+		_script_functions[FGETTARGETGROGTIME]               = scr_get_TargetGrogTime;
+		_script_functions[FGETTARGETDAZETIME]               = scr_get_TargetDazeTime;
+		_script_functions[FSETDAMAGETYPE]                   = scr_set_DamageType;
+		_script_functions[FSETWATERLEVEL]                   = scr_set_WaterLevel;
+		_script_functions[FENCHANTTARGET]                   = scr_EnchantTarget;
+		_script_functions[FENCHANTCHILD]                    = scr_EnchantChild;
+		_script_functions[FTELEPORTTARGET]                  = scr_TeleportTarget;
+		_script_functions[FGIVEEXPERIENCETOTARGET]          = scr_add_TargetExperience;
+		_script_functions[FINCREASEAMMO]                    = scr_IncreaseAmmo;
+		_script_functions[FUNKURSETARGET]                   = scr_UnkurseTarget;
+		_script_functions[FGIVEEXPERIENCETOTARGETTEAM]      = scr_add_TargetTeamExperience;
+		_script_functions[FIFUNARMED]                       = scr_Unarmed;
+		_script_functions[FRESTOCKTARGETAMMOIDALL]          = scr_RestockTargetAmmoIDAll;
+		_script_functions[FRESTOCKTARGETAMMOIDFIRST]        = scr_RestockTargetAmmoIDFirst;
+		_script_functions[FFLASHTARGET]                     = scr_FlashTarget;
+		_script_functions[FSETREDSHIFT]                     = scr_set_RedShift;
+		_script_functions[FSETGREENSHIFT]                   = scr_set_GreenShift;
+		_script_functions[FSETBLUESHIFT]                    = scr_set_BlueShift;
+		_script_functions[FSETLIGHT]                        = scr_set_Light;
+		_script_functions[FSETALPHA]                        = scr_set_Alpha;
+		_script_functions[FIFHITFROMBEHIND]                 = scr_HitFromBehind;
+		_script_functions[FIFHITFROMFRONT]                  = scr_HitFromFront;
+		_script_functions[FIFHITFROMLEFT]                   = scr_HitFromLeft;
+		_script_functions[FIFHITFROMRIGHT]                  = scr_HitFromRight;
+		_script_functions[FIFTARGETISONSAMETEAM]            = scr_TargetIsOnSameTeam;
+		_script_functions[FKILLTARGET]                      = scr_KillTarget;
+		_script_functions[FUNDOENCHANT]                     = scr_UndoEnchant;
+		_script_functions[FGETWATERLEVEL]                   = scr_get_WaterLevel;
+		_script_functions[FCOSTTARGETMANA]                  = scr_CostTargetMana;
+		_script_functions[FIFTARGETHASANYID]                = scr_TargetHasAnyID;
+		_script_functions[FSETBUMPSIZE]                     = scr_set_BumpSize;
+		_script_functions[FIFNOTDROPPED]                    = scr_NotDropped;
+		_script_functions[FIFYISLESSTHANX]                  = scr_YIsLessThanX;
+		_script_functions[FSETFLYHEIGHT]                    = scr_set_FlyHeight;
+		_script_functions[FIFBLOCKED]                       = scr_Blocked;
+		_script_functions[FIFTARGETISDEFENDING]             = scr_TargetIsDefending;
+		_script_functions[FIFTARGETISATTACKING]             = scr_TargetIsAttacking;
+		_script_functions[FIFSTATEIS0]                      = scr_StateIs0;
+		_script_functions[FIFSTATEIS1]                      = scr_StateIs1;
+		_script_functions[FIFSTATEIS2]                      = scr_StateIs2;
+		_script_functions[FIFSTATEIS3]                      = scr_StateIs3;
+		_script_functions[FIFSTATEIS4]                      = scr_StateIs4;
+		_script_functions[FIFSTATEIS5]                      = scr_StateIs5;
+		_script_functions[FIFSTATEIS6]                      = scr_StateIs6;
+		_script_functions[FIFSTATEIS7]                      = scr_StateIs7;
+		_script_functions[FIFCONTENTIS]                     = scr_ContentIs;
+		_script_functions[FSETTURNMODETOWATCHTARGET]        = scr_set_TurnModeToWatchTarget;
+		_script_functions[FIFSTATEISNOT]                    = scr_StateIsNot;
+		_script_functions[FIFXISEQUALTOY]                   = scr_XIsEqualToY;
+		_script_functions[FDEBUGMESSAGE]                    = scr_DebugMessage;
+		_script_functions[FBLACKTARGET]                     = scr_BlackTarget;
+		_script_functions[FSENDMESSAGENEAR]                 = scr_SendMessageNear;
+		_script_functions[FIFHITGROUND]                     = scr_HitGround;
+		_script_functions[FIFNAMEISKNOWN]                   = scr_NameIsKnown;
+		_script_functions[FIFUSAGEISKNOWN]                  = scr_UsageIsKnown;
+		_script_functions[FIFHOLDINGITEMID]                 = scr_HoldingItemID;
+		_script_functions[FIFHOLDINGRANGEDWEAPON]           = scr_HoldingRangedWeapon;
+		_script_functions[FIFHOLDINGMELEEWEAPON]            = scr_HoldingMeleeWeapon;
+		_script_functions[FIFHOLDINGSHIELD]                 = scr_HoldingShield;
+		_script_functions[FIFKURSED]                        = scr_Kursed;
+		_script_functions[FIFTARGETISKURSED]                = scr_TargetIsKursed;
+		_script_functions[FIFTARGETISDRESSEDUP]             = scr_TargetIsDressedUp;
+		_script_functions[FIFOVERWATER]                     = scr_OverWater;
+		_script_functions[FIFTHROWN]                        = scr_Thrown;
+		_script_functions[FMAKENAMEKNOWN]                   = scr_MakeNameKnown;
+		_script_functions[FMAKEUSAGEKNOWN]                  = scr_MakeUsageKnown;
+		_script_functions[FSTOPTARGETMOVEMENT]              = scr_StopTargetMovement;
+		_script_functions[FSETXY]                           = scr_set_XY;
+		_script_functions[FGETXY]                           = scr_get_XY;
+		_script_functions[FADDXY]                           = scr_AddXY;
+		_script_functions[FMAKEAMMOKNOWN]                   = scr_MakeAmmoKnown;
+		_script_functions[FSPAWNATTACHEDPARTICLE]           = scr_SpawnAttachedParticle;
+		_script_functions[FSPAWNEXACTPARTICLE]              = scr_SpawnExactParticle;
+		_script_functions[FACCELERATETARGET]                = scr_AccelerateTarget;
+		_script_functions[FIFDISTANCEISMORETHANTURN]        = scr_distanceIsMoreThanTurn;
+		_script_functions[FIFCRUSHED]                       = scr_Crushed;
+		_script_functions[FMAKECRUSHVALID]                  = scr_MakeCrushValid;
+		_script_functions[FSETTARGETTOLOWESTTARGET]         = scr_set_TargetToLowestTarget;
+		_script_functions[FIFNOTPUTAWAY]                    = scr_NotPutAway;
+		_script_functions[FIFTAKENOUT]                      = scr_TakenOut;
+		_script_functions[FIFAMMOOUT]                       = scr_AmmoOut;
+		_script_functions[FPLAYSOUNDLOOPED]                 = scr_PlaySoundLooped;
+		_script_functions[FSTOPSOUND]                       = scr_StopSound;
+		_script_functions[FHEALSELF]                        = scr_HealSelf;
+		_script_functions[FEQUIP]                           = scr_Equip;
+		_script_functions[FIFTARGETHASITEMIDEQUIPPED]       = scr_TargetHasItemIDEquipped;
+		_script_functions[FSETOWNERTOTARGET]                = scr_set_OwnerToTarget;
+		_script_functions[FSETTARGETTOOWNER]                = scr_set_TargetToOwner;
+		_script_functions[FSETFRAME]                        = scr_set_Frame;
+		_script_functions[FBREAKPASSAGE]                    = scr_BreakPassage;
+		_script_functions[FSETRELOADTIME]                   = scr_set_ReloadTime;
+		_script_functions[FSETTARGETTOWIDEBLAHID]           = scr_set_TargetToWideBlahID;
+		_script_functions[FPOOFTARGET]                      = scr_PoofTarget;
+		_script_functions[FCHILDDOACTIONOVERRIDE]           = scr_ChildDoActionOverride;
+		_script_functions[FSPAWNPOOF]                       = scr_SpawnPoof;
+		_script_functions[FSETSPEEDPERCENT]                 = scr_set_SpeedPercent;
+		_script_functions[FSETCHILDSTATE]                   = scr_set_ChildState;
+		_script_functions[FSPAWNATTACHEDSIZEDPARTICLE]      = scr_SpawnAttachedSizedParticle;
+		_script_functions[FCHANGEARMOR]                     = scr_ChangeArmor;
+		_script_functions[FSHOWTIMER]                       = scr_ShowTimer;
+		_script_functions[FIFFACINGTARGET]                  = scr_FacingTarget;
+		_script_functions[FPLAYSOUNDVOLUME]                 = scr_PlaySoundVolume;
+		_script_functions[FSPAWNATTACHEDFACEDPARTICLE]      = scr_SpawnAttachedFacedParticle;
+		_script_functions[FIFSTATEISODD]                    = scr_StateIsOdd;
+		_script_functions[FSETTARGETTODISTANTENEMY]         = scr_set_TargetToDistantEnemy;
+		_script_functions[FTELEPORT]                        = scr_Teleport;
+		_script_functions[FGIVESTRENGTHTOTARGET]            = scr_add_TargetStrength;
+		_script_functions[FGIVEINTELLECTTOTARGET]           = scr_add_TargetIntelligence;
+		_script_functions[FGIVEINTELLIGENCETOTARGET]        = scr_add_TargetIntelligence;
+		_script_functions[FGIVEDEXTERITYTOTARGET]           = scr_add_TargetDexterity;
+		_script_functions[FGIVELIFETOTARGET]                = scr_add_TargetLife;
+		_script_functions[FGIVEMANATOTARGET]                = scr_add_TargetMana;
+		_script_functions[FSHOWMAP]                         = scr_ShowMap;
+		_script_functions[FSHOWYOUAREHERE]                  = scr_ShowYouAreHere;
+		_script_functions[FSHOWBLIPXY]                      = scr_ShowBlipXY;
+		_script_functions[FHEALTARGET]                      = scr_HealTarget;
+		_script_functions[FPUMPTARGET]                      = scr_PumpTarget;
+		_script_functions[FCOSTAMMO]                        = scr_CostAmmo;
+		_script_functions[FMAKESIMILARNAMESKNOWN]           = scr_MakeSimilarNamesKnown;
+		_script_functions[FSPAWNATTACHEDHOLDERPARTICLE]     = scr_SpawnAttachedHolderParticle;
+		_script_functions[FSETTARGETRELOADTIME]             = scr_set_TargetReloadTime;
+		_script_functions[FSETFOGLEVEL]                     = scr_set_FogLevel;
+		_script_functions[FGETFOGLEVEL]                     = scr_get_FogLevel;
+		_script_functions[FSETFOGTAD]                       = scr_set_FogTAD;
+		_script_functions[FSETFOGBOTTOMLEVEL]               = scr_set_FogBottomLevel;
+		_script_functions[FGETFOGBOTTOMLEVEL]               = scr_get_FogBottomLevel;
+		_script_functions[FCORRECTACTIONFORHAND]            = scr_CorrectActionForHand;
+		_script_functions[FIFTARGETISMOUNTED]               = scr_TargetIsMounted;
+		_script_functions[FSPARKLEICON]                     = scr_SparkleIcon;
+		_script_functions[FUNSPARKLEICON]                   = scr_UnsparkleIcon;
+		_script_functions[FGETTILEXY]                       = scr_get_TileXY;
+		_script_functions[FSETTILEXY]                       = scr_set_TileXY;
+		_script_functions[FSETSHADOWSIZE]                   = scr_set_ShadowSize;
+		_script_functions[FORDERTARGET]                     = scr_OrderTarget;
+		_script_functions[FSETTARGETTOWHOEVERISINPASSAGE]   = scr_set_TargetToWhoeverIsInPassage;
+		_script_functions[FIFCHARACTERWASABOOK]             = scr_CharacterWasABook;
+		_script_functions[FSETENCHANTBOOSTVALUES]           = scr_set_EnchantBoostValues;
+		_script_functions[FSPAWNCHARACTERXYZ]               = scr_SpawnCharacterXYZ;
+		_script_functions[FSPAWNEXACTCHARACTERXYZ]          = scr_SpawnExactCharacterXYZ;
+		_script_functions[FCHANGETARGETCLASS]               = scr_ChangeTargetClass;
+		_script_functions[FPLAYFULLSOUND]                   = scr_PlayFullSound;
+		_script_functions[FSPAWNEXACTCHASEPARTICLE]         = scr_SpawnExactChaseParticle;
+		_script_functions[FCREATEORDER]                     = scr_CreateOrder;
+		_script_functions[FORDERSPECIALID]                  = scr_OrderSpecialID;
+		_script_functions[FUNKURSETARGETINVENTORY]          = scr_UnkurseTargetInventory;
+		_script_functions[FIFTARGETISSNEAKING]              = scr_TargetIsSneaking;
+		_script_functions[FDROPITEMS]                       = scr_DropItems;
+		_script_functions[FRESPAWNTARGET]                   = scr_RespawnTarget;
+		_script_functions[FTARGETDOACTIONSETFRAME]          = scr_TargetDoActionSetFrame;
+		_script_functions[FIFTARGETCANSEEINVISIBLE]         = scr_TargetCanSeeInvisible;
+		_script_functions[FSETTARGETTONEARESTBLAHID]        = scr_set_TargetToNearestBlahID;
+		_script_functions[FSETTARGETTONEARESTENEMY]         = scr_set_TargetToNearestEnemy;
+		_script_functions[FSETTARGETTONEARESTFRIEND]        = scr_set_TargetToNearestFriend;
+		_script_functions[FSETTARGETTONEARESTLIFEFORM]      = scr_set_TargetToNearestLifeform;
+		_script_functions[FFLASHPASSAGE]                    = scr_FlashPassage;
+		_script_functions[FFINDTILEINPASSAGE]               = scr_FindTileInPassage;
+		_script_functions[FIFHELDINLEFTHAND]                = scr_HeldInLeftHand;
+		_script_functions[FNOTANITEM]                       = scr_NotAnItem;
+		_script_functions[FSETCHILDAMMO]                    = scr_set_ChildAmmo;
+		_script_functions[FIFHITVULNERABLE]                 = scr_HitVulnerable;
+		_script_functions[FIFTARGETISFLYING]                = scr_TargetIsFlying;
+		_script_functions[FIDENTIFYTARGET]                  = scr_IdentifyTarget;
+		_script_functions[FBEATMODULE]                      = scr_BeatModule;
+		_script_functions[FENDMODULE]                       = scr_EndModule;
+		_script_functions[FDISABLEEXPORT]                   = scr_DisableExport;
+		_script_functions[FENABLEEXPORT]                    = scr_EnableExport;
+		_script_functions[FGETTARGETSTATE]                  = scr_get_TargetState;
+		_script_functions[FIFEQUIPPED]                      = scr_Equipped;
+		_script_functions[FDROPTARGETMONEY]                 = scr_DropTargetMoney;
+		_script_functions[FGETTARGETCONTENT]                = scr_get_TargetContent;
+		_script_functions[FDROPTARGETKEYS]                  = scr_DropTargetKeys;
+		_script_functions[FJOINTEAM]                        = scr_JoinTeam;
+		_script_functions[FTARGETJOINTEAM]                  = scr_TargetJoinTeam;
+		_script_functions[FCLEARMUSICPASSAGE]               = scr_ClearMusicPassage;
+		_script_functions[FCLEARENDMESSAGE]                 = scr_ClearEndMessage;
+		_script_functions[FADDENDMESSAGE]                   = scr_AddEndMessage;
+		_script_functions[FPLAYMUSIC]                       = scr_PlayMusic;
+		_script_functions[FSETMUSICPASSAGE]                 = scr_set_MusicPassage;
+		_script_functions[FMAKECRUSHINVALID]                = scr_MakeCrushInvalid;
+		_script_functions[FSTOPMUSIC]                       = scr_StopMusic;
+		_script_functions[FFLASHVARIABLE]                   = scr_FlashVariable;
+		_script_functions[FACCELERATEUP]                    = scr_AccelerateUp;
+		_script_functions[FFLASHVARIABLEHEIGHT]             = scr_FlashVariableHeight;
+		_script_functions[FSETDAMAGETIME]                   = scr_set_DamageTime;
+		_script_functions[FIFSTATEIS8]                      = scr_StateIs8;
+		_script_functions[FIFSTATEIS9]                      = scr_StateIs9;
+		_script_functions[FIFSTATEIS10]                     = scr_StateIs10;
+		_script_functions[FIFSTATEIS11]                     = scr_StateIs11;
+		_script_functions[FIFSTATEIS12]                     = scr_StateIs12;
+		_script_functions[FIFSTATEIS13]                     = scr_StateIs13;
+		_script_functions[FIFSTATEIS14]                     = scr_StateIs14;
+		_script_functions[FIFSTATEIS15]                     = scr_StateIs15;
+		_script_functions[FIFTARGETISAMOUNT]                = scr_TargetIsAMount;
+		_script_functions[FIFTARGETISAPLATFORM]             = scr_TargetIsAPlatform;
+		_script_functions[FADDSTAT]                         = scr_AddStat;
+		_script_functions[FDISENCHANTTARGET]                = scr_DisenchantTarget;
+		_script_functions[FDISENCHANTALL]                   = scr_DisenchantAll;
+		_script_functions[FSETVOLUMENEARESTTEAMMATE]        = scr_set_VolumeNearestTeammate;
+		_script_functions[FADDSHOPPASSAGE]                  = scr_AddShopPassage;
+		_script_functions[FTARGETPAYFORARMOR]               = scr_TargetPayForArmor;
+		_script_functions[FJOINEVILTEAM]                    = scr_JoinEvilTeam;
+		_script_functions[FJOINNULLTEAM]                    = scr_JoinNullTeam;
+		_script_functions[FJOINGOODTEAM]                    = scr_JoinGoodTeam;
+		_script_functions[FPITSKILL]                        = scr_PitsKill;
+		_script_functions[FSETTARGETTOPASSAGEID]            = scr_set_TargetToPassageID;
+		_script_functions[FMAKENAMEUNKNOWN]                 = scr_MakeNameUnknown;
+		_script_functions[FSPAWNEXACTPARTICLEENDSPAWN]      = scr_SpawnExactParticleEndSpawn;
+		_script_functions[FSPAWNPOOFSPEEDSPACINGDAMAGE]     = scr_SpawnPoofSpeedSpacingDamage;
+		_script_functions[FGIVEEXPERIENCETOGOODTEAM]        = scr_add_GoodTeamExperience;
+		_script_functions[FDONOTHING]                       = scr_DoNothing;
+		_script_functions[FGROGTARGET]                      = scr_GrogTarget;
+		_script_functions[FDAZETARGET]                      = scr_DazeTarget;
+		_script_functions[FENABLERESPAWN]                   = scr_EnableRespawn;
+		_script_functions[FDISABLERESPAWN]                  = scr_DisableRespawn;
+		_script_functions[FDISPELTARGETENCHANTID]           = scr_DispelTargetEnchantID;
+		_script_functions[FIFHOLDERBLOCKED]                 = scr_HolderBlocked;
+
+		_script_functions[FIFTARGETHASNOTFULLMANA]          = scr_TargetHasNotFullMana;
+		_script_functions[FENABLELISTENSKILL]               = scr_EnableListenSkill;
+		_script_functions[FSETTARGETTOLASTITEMUSED]         = scr_set_TargetToLastItemUsed;
+		_script_functions[FFOLLOWLINK]                      = scr_FollowLink;
+		_script_functions[FIFOPERATORISLINUX]               = scr_OperatorIsLinux;
+		_script_functions[FIFTARGETISAWEAPON]               = scr_TargetIsAWeapon;
+		_script_functions[FIFSOMEONEISSTEALING]             = scr_SomeoneIsStealing;
+		_script_functions[FIFTARGETISASPELL]                = scr_TargetIsASpell;
+		_script_functions[FIFBACKSTABBED]                   = scr_Backstabbed;
+		_script_functions[FGETTARGETDAMAGETYPE]             = scr_get_TargetDamageType;
+		_script_functions[FADDQUEST]                        = scr_AddQuest;
+		_script_functions[FBEATQUESTALLPLAYERS]             = scr_BeatQuestAllPlayers;
+		_script_functions[FIFTARGETHASQUEST]                = scr_TargetHasQuest;
+		_script_functions[FSETQUESTLEVEL]                   = scr_set_QuestLevel;
+		_script_functions[FADDQUESTALLPLAYERS]              = scr_AddQuestAllPlayers;
+		_script_functions[FADDBLIPALLENEMIES]               = scr_AddBlipAllEnemies;
+		_script_functions[FPITSFALL]                        = scr_PitsFall;
+		_script_functions[FIFTARGETISOWNER]                 = scr_TargetIsOwner;
+		_script_functions[FEND]                             = scr_End;
+
+		_script_functions[FSETSPEECH]                       = scr_set_Speech;
+		_script_functions[FSETMOVESPEECH]                   = scr_set_MoveSpeech;
+		_script_functions[FSETSECONDMOVESPEECH]             = scr_set_SecondMoveSpeech;
+		_script_functions[FSETATTACKSPEECH]                 = scr_set_AttackSpeech;
+		_script_functions[FSETASSISTSPEECH]                 = scr_set_AssistSpeech;
+		_script_functions[FSETTERRAINSPEECH]                = scr_set_TerrainSpeech;
+		_script_functions[FSETSELECTSPEECH]                 = scr_set_SelectSpeech;
+
+		_script_functions[FTAKEPICTURE]                     = scr_TakePicture;
+		_script_functions[FIFOPERATORISMACINTOSH]           = scr_OperatorIsMacintosh;
+		_script_functions[FIFMODULEHASIDSZ]                 = scr_ModuleHasIDSZ;
+		_script_functions[FMORPHTOTARGET]                   = scr_MorphToTarget;
+		_script_functions[FGIVEMANAFLOWTOTARGET]            = scr_add_TargetManaFlow;
+		_script_functions[FGIVEMANARETURNTOTARGET]          = scr_add_TargetManaReturn;
+		_script_functions[FSETMONEY]                        = scr_set_Money;
+		_script_functions[FIFTARGETCANSEEKURSES]            = scr_TargetCanSeeKurses;
+		_script_functions[FSPAWNATTACHEDCHARACTER]          = scr_SpawnAttachedCharacter;
+		_script_functions[FKURSETARGET]                     = scr_KurseTarget;
+		_script_functions[FSETCHILDCONTENT]                 = scr_set_ChildContent;
+		_script_functions[FSETTARGETTOCHILD]                = scr_set_TargetToChild;
+		_script_functions[FSETDAMAGETHRESHOLD]              = scr_set_DamageThreshold;
+		_script_functions[FACCELERATETARGETUP]              = scr_AccelerateTargetUp;
+		_script_functions[FSETTARGETAMMO]                   = scr_set_TargetAmmo;
+		_script_functions[FENABLEINVICTUS]                  = scr_EnableInvictus;
+		_script_functions[FDISABLEINVICTUS]                 = scr_DisableInvictus;
+		_script_functions[FTARGETDAMAGESELF]                = scr_TargetDamageSelf;
+		_script_functions[FSETTARGETSIZE]                   = scr_set_TargetSize;
+		_script_functions[FIFTARGETISFACINGSELF]            = scr_TargetIsFacingSelf;
+
+		_script_functions[FDRAWBILLBOARD]                   = scr_DrawBillboard;
+		_script_functions[FSETTARGETTOFIRSTBLAHINPASSAGE]   = scr_set_TargetToBlahInPassage;
+		_script_functions[FIFLEVELUP]                       = scr_LevelUp;
+		_script_functions[FGIVESKILLTOTARGET]               = scr_add_TargetSkill;
+		_script_functions[FSETTARGETTONEARBYMELEEWEAPON]    = scr_set_TargetToNearbyMeleeWeapon;
+
+		// Functions which only read the world and write the script state and the AI state of the object.
+		static const Uint32 parallelFunctions[] =
+		{
+			FIFSPAWNED, FIFTIMEOUT, FIFATWAYPOINT, FIFATLASTWAYPOINT, FIFATTACKED, FIFBUMPED, FIFORDERED,
+			FIFCALLEDFORHELP, FSETCONTENT, FIFKILLED, FIFTARGETKILLED, FCLEARWAYPOINTS, FADDWAYPOINT, FCOMPASS,
+			FGETTARGETARMORPRICE, FSETTIME, FGETCONTENT, FSETTARGETTONEARBYENEMY, FSETTARGETTOTARGETLEFTHAND,
+			FSETTARGETTOTARGETRIGHTHAND, FSETTARGETTOWHOEVERATTACKED, FSETTARGETTOWHOEVERBUMPED,
+			FSETTARGETTOWHOEVERCALLEDFORHELP, FSETTARGETTOOLDTARGET, FIFTARGETHASID, FIFTARGETHASITEMID,
+			FIFTARGETHOLDINGITEMID, FIFTARGETHASSKILLID, FELSE, FIFPASSAGEOPEN, FGOPOOF, FIFHEALED, FGETSTATE,
+			FIFSTATEIS, FIFTARGETCANOPENSTUFF, FIFGRABBED, FIFDROPPED, FSETTARGETTOWHOEVERISHOLDING,
+			FIFXISLESSTHANY, FGETBUMPHEIGHT, FIFREAFFIRMED, FIFTARGETISONOTHERTEAM, FIFTARGETISONHATEDTEAM,
+			FSETTARGETTOTARGETOFLEADER, FIFLEADERKILLED, FIFLEADERISALIVE, FIFTARGETISOLDTARGET,
+			FSETTARGETTOLEADER, FIFUSED, FSETOLDTARGET, FIFTARGETHASVULNERABILITYID, FIFCLEANEDUP, FIFSITTING,
+			FIFTARGETISHURT, FIFTARGETISAPLAYER, FIFTARGETISALIVE, FIFTARGETISSELF, FIFTARGETISMALE,
+			FIFTARGETISFEMALE, FSETTARGETTOSELF, FSETTARGETTORIDER, FGETATTACKTURN, FGETDAMAGETYPE,
+			FIFSCOREDAHIT, FIFDISAFFIRMED, FTRANSLATEORDER, FSETTARGETTOWHOEVERWASHIT, FSETTARGETTOWIDEENEMY,
+			FIFCHANGED, FIFINWATER, FIFBORED, FIFTOOMUCHBAGGAGE, FIFGROGGED, FIFDAZED, FIFTARGETHASSPECIALID,
+			FIFINVISIBLE, FIFARMORIS, FGETTARGETGROGTIME, FGETTARGETDAZETIME, FIFHITFROMBEHIND,
+			FIFHITFROMFRONT, FIFHITFROMLEFT, FIFHITFROMRIGHT, FIFTARGETISONSAMETEAM, FGETWATERLEVEL,
+			FIFTARGETHASANYID, FIFNOTDROPPED, FIFYISLESSTHANX, FIFBLOCKED, FIFTARGETISDEFENDING,
+			FIFTARGETISATTACKING, FIFSTATEIS0, FIFSTATEIS1, FIFSTATEIS2, FIFSTATEIS3, FIFSTATEIS4, FIFSTATEIS5,
+			FIFSTATEIS6, FIFSTATEIS7, FIFSTATEIS8, FIFSTATEIS9, FIFSTATEIS10, FIFSTATEIS11, FIFSTATEIS12,
+			FIFSTATEIS13, FIFSTATEIS14, FIFSTATEIS15, FIFCONTENTIS, FIFSTATEISNOT, FIFXISEQUALTOY,
+			FIFHITGROUND, FIFNAMEISKNOWN, FIFUSAGEISKNOWN, FIFHOLDINGITEMID, FIFHOLDINGMELEEWEAPON,
+			FIFHOLDINGSHIELD, FIFKURSED, FIFTARGETISKURSED, FIFTARGETISDRESSEDUP, FIFOVERWATER, FIFTHROWN,
+			FSETXY, FGETXY, FADDXY, FIFDISTANCEISMORETHANTURN, FIFCRUSHED, FSETTARGETTOLOWESTTARGET,
+			FIFNOTPUTAWAY, FIFTAKENOUT, FIFAMMOOUT, FIFTARGETHASITEMIDEQUIPPED, FSETOWNERTOTARGET,
+			FSETTARGETTOOWNER, FSETTARGETTOWIDEBLAHID, FIFFACINGTARGET, FIFSTATEISODD,
+			FSETTARGETTODISTANTENEMY, FGETFOGLEVEL, FGETFOGBOTTOMLEVEL, FIFTARGETISMOUNTED, FGETTILEXY,
+			FSETTARGETTOWHOEVERISINPASSAGE, FIFCHARACTERWASABOOK, FCREATEORDER, FIFTARGETISSNEAKING,
+			FIFTARGETCANSEEINVISIBLE, FSETTARGETTONEARESTBLAHID, FSETTARGETTONEARESTENEMY,
+			FSETTARGETTONEARESTFRIEND, FSETTARGETTONEARESTLIFEFORM, FFINDTILEINPASSAGE, FIFHELDINLEFTHAND,
+			FIFHITVULNERABLE, FIFTARGETISFLYING, FGETTARGETSTATE, FIFEQUIPPED, FGETTARGETCONTENT,
+			FIFTARGETISAMOUNT, FIFTARGETISAPLATFORM, FSETTARGETTOPASSAGEID, FDONOTHING, FIFHOLDERBLOCKED,
+			FIFTARGETHASNOTFULLMANA, FSETTARGETTOLASTITEMUSED, FIFOPERATORISLINUX, FIFTARGETISAWEAPON,
+			FIFSOMEONEISSTEALING, FIFTARGETISASPELL, FIFBACKSTABBED, FGETTARGETDAMAGETYPE, FIFTARGETHASQUEST,
+			FIFTARGETISOWNER, FSETTARGETTOCHILD, FEND, FIFOPERATORISMACINTOSH, FIFTARGETCANSEEKURSES,
+			FSETTARGETTOFIRSTBLAHINPASSAGE, FIFTARGETISFACINGSELF, FIFLEVELUP
+		};
+		for (Uint32 code : parallelFunctions) {
+			_script_function_kinds[code] = SCRIPT_FUNCTION_PARALLEL;
+		}
+
+		// Functions whose side effects are not read back by the script: Sounds, particles and the
+		// movement, animation and latch buttons of the object itself.
+		static const Uint32 deferredFunctions[] =
+		{
+			FPLAYSOUND, FPLAYFULLSOUND, FPLAYSOUNDLOOPED, FSTOPSOUND, FPLAYSOUNDVOLUME, FSPAWNPARTICLE,
+			FSPAWNATTACHEDPARTICLE, FSPAWNEXACTPARTICLE, FSPAWNATTACHEDSIZEDPARTICLE,
+			FSPAWNATTACHEDFACEDPARTICLE, FSPAWNATTACHEDHOLDERPARTICLE, FSPAWNEXACTCHASEPARTICLE,
+			FSPAWNEXACTPARTICLEENDSPAWN, FSPAWNPOOF, FSETTURNMODETOVELOCITY, FSETTURNMODETOWATCH,
+			FSETTURNMODETOSPIN, FSETTURNMODETOWATCHTARGET, FRUN, FWALK, FSNEAK, FSTOP, FSETSPEEDPERCENT,
+			FKEEPACTION, FUNKEEPACTION, FDOACTION, FDOACTIONOVERRIDE, FPRESSLATCHBUTTON
+		};
+		for (Uint32 code : deferredFunctions) {
+			_script_function_kinds[code] = SCRIPT_FUNCTION_DEFERRED;
+		}
+
 		_scripting_system_initialized = true;
 	}
 }
@@ -86,6 +574,14 @@ void scripting_system_end()
 						       static_cast<int>(i), script_function_names[i], _script_function_calls[i], _script_function_times[i]);
                 }
             }
+            static const char *interpreterNames[2] = { "raw", "pre-decoded" };
+            for (size_t i = 0; i < 2; ++i) {
+                if (_script_interpreter_instructions[i] > 0) {
+                    vfs_printf(target, "interpreter == \"%s\"\tinstructions == %" PRIuZ "\ttime == %lf\tns/instruction == %lf\n",
+                               interpreterNames[i], _script_interpreter_instructions[i], _script_interpreter_times[i],
+                               _script_interpreter_times[i] * 1.0e9 / _script_interpreter_instructions[i]);
+                }
+            }
             vfs_close(target);
         }
 		g_scriptFunctionClock = nullptr;
@@ -105,7 +601,7 @@ void scr_run_chr_script(Object *pchr) {
 		return;
 	}
 	ai_state_t& aiState = pchr->ai;
-	script_info_t *pscript = &pchr->getProfile()->getAIScript();
+	const script_info_t *pscript = &pchr->getProfile()->getAIScript();
 
 	// Has the time for this character to die come and gone?
 	if (aiState.poof_time >= 0 && aiState.poof_time <= (Sint32)update_wld) {
@@ -126,19 +622,11 @@ void scr_run_chr_script(Object *pchr) {
 	// target_old is set to the target every time the script is run
 	aiState.target_old = aiState.target;
 
-	// Make life easier
-	script_error_classname = "UNKNOWN";
-	script_error_model = pchr->profile_ref;
-	if (script_error_model < INVALID_PRO_REF)
-	{
-		script_error_classname = ProfileSystem::get().getProfile(script_error_model)->getClassName().c_str();
-	}
-
 	if (debug_scripts && debug_script_file) {
 		vfs_FILE * scr_file = debug_script_file;
 
 		vfs_printf(scr_file, "\n\n--------\n%s\n", pscript->name);
-		vfs_printf(scr_file, "%d - %s\n", REF_TO_INT(script_error_model), script_error_classname);
+		vfs_printf(scr_file, "%d - %s\n", REF_TO_INT(pchr->profile_ref), pchr->getProfile()->getClassName().c_str());
 
 		// who are we related to?
 		vfs_printf(scr_file, "\tindex  == %d\n", REF_TO_INT(aiState.index));
@@ -179,7 +667,7 @@ void scr_run_chr_script(Object *pchr) {
 	// Reset the target if it can't be seen.
 	if (aiState.target != aiState.index) {
 		const std::shared_ptr<Object> &target = _currentModule->getObjectHandler()[aiState.target];
-		if (target && !pchr->canSeeObject(target)) {
+		if (target && !pchr->canSeeObject(*target)) {
 			aiState.target = aiState.index;
 		}
 	}
@@ -190,29 +678,46 @@ void scr_run_chr_script(Object *pchr) {
 
 	// Reset the ai.
 	aiState.terminate = false;
-	pscript->indent = 0;
 
 	// Run the AI Script.
-	scr_set_pos(pscript, 0);
-	while (!aiState.terminate && pscript->position < pscript->length) {
-		// This is used by the Else function
-		// it only keeps track of functions.
-		pscript->indent_last = pscript->indent;
-		pscript->indent = GET_DATA_BITS(pscript->data[pscript->position]);
-
-		// Was it a function.
-		if (HAS_SOME_BITS(pscript->data[pscript->position], FUNCTION_BIT)) {
-			if (!scr_run_function_call(&my_state, aiState, pscript)) {
-				break;
+	// The execution cursor lives in the script state, the compiled script itself is shared
+	// by all objects of this profile and is not modified.
+	// Scripts which can not react to the current alerts and timer are skipped.
+	if (!scr_can_trigger(*pscript, aiState)) {
+		_script_skip_count++;
+	} else {
+		_script_run_count++;
+
+		const bool decoded = egoboo_config_t::get().debug_scripts_predecoded_enable.getValue()
+			              && !pscript->instructions.empty();
+		if (my_state.timing) {
+			Ego::Time::Stopwatch stopwatch;
+			if (0 == _script_interpreter_depth++) {
+				stopwatch.start();
 			}
-		}
-		else {
-			if (!scr_run_operation(&my_state, aiState, pscript)) {
-				break;
+			if (decoded) {
+				scr_run_decoded(&my_state, aiState, pscript, pchr);
+			} else {
+				scr_run_raw(&my_state, aiState, pscript);
+			}
+			if (0 == --_script_interpreter_depth) {
+				stopwatch.stop();
+				_script_interpreter_times[decoded ? 1 : 0] += stopwatch.elapsed();
 			}
+		} else if (decoded) {
+			scr_run_decoded(&my_state, aiState, pscript, pchr);
+		} else {
+			scr_run_raw(&my_state, aiState, pscript);
 		}
 	}
 
+	scr_set_latches(pchr);
+}
+
+void scr_set_latches(Object *pchr)
+{
+	ai_state_t& aiState = pchr->ai;
+
 	// Set latches
 	if (!VALID_PLA(pchr->is_which_player)) {
 		float latch2;
@@ -246,6 +751,7 @@ void scr_run_chr_script(Object *pchr) {
 	// Clear alerts for next time around
 	RESET_BIT_FIELD(aiState.alert);
 }
+
 void scr_run_chr_script( const CHR_REF character )
 {
     /// @author ZZ
@@ -262,7 +768,277 @@ void scr_run_chr_script( const CHR_REF character )
 }
 
 //--------------------------------------------------------------------------------------------
-bool scr_run_function_call( script_state_t * pstate, ai_state_t& aiState, script_info_t *pscript )
+void script_think_buffer_t::clear()
+{
+	results.clear();
+	calls.clear();
+	serial.clear();
+	runs = 0;
+	skips = 0;
+}
+
+bool scr_can_think_parallel()
+{
+	// Make sure that this module is initialized.
+	scripting_system_begin();
+
+	const egoboo_config_t& config = egoboo_config_t::get();
+	return config.debug_scripts_parallel_enable.getValue()
+		&& config.debug_scripts_predecoded_enable.getValue()
+		&& !config.debug_scripts_timing_enable.getValue()
+		&& !debug_scripts;
+}
+
+void scr_think_chr_script(Object *pchr, script_think_buffer_t& buffer)
+{
+	/// @details This is scr_run_chr_script() on a copy of the AI state. Resetting the button
+	///          latches is left to scr_commit_think_buffer(), the AI clock is not measured.
+
+	if (pchr->isTerminated()) {
+		return;
+	}
+	const script_info_t *pscript = &pchr->getProfile()->getAIScript();
+
+	// Has the time for this character to die come and gone?
+	if (pchr->ai.poof_time >= 0 && pchr->ai.poof_time <= (Sint32)update_wld) {
+		return;
+	}
+
+	// Only pre-decoded scripts can run in parallel.
+	if (pscript->instructions.empty()) {
+		buffer.serial.push_back(pchr);
+		return;
+	}
+
+	script_think_result_t result;
+	result.object = pchr;
+	result.ai = pchr->ai;
+	result.call_first = buffer.calls.size();
+	ai_state_t& aiState = result.ai;
+
+	// Grab the "changed" value from the last time the script was run.
+	if (aiState.changed) {
+		SET_BIT(aiState.alert, ALERTIF_CHANGED);
+		aiState.changed = false;
+	}
+
+	// target_old is set to the target every time the script is run
+	aiState.target_old = aiState.target;
+
+	// Reset the target if it can't be seen.
+	if (aiState.target != aiState.index) {
+		const Object *target = scr_get_object(aiState.target);
+		if (nullptr != target && !pchr->canSeeObject(*target)) {
+			aiState.target = aiState.index;
+		}
+	}
+
+	// Reset the script state.
+	script_state_t my_state;
+	script_state_init(my_state);
+
+	// Reset the ai.
+	aiState.terminate = false;
+
+	if (!scr_can_trigger(*pscript, aiState)) {
+		buffer.skips++;
+	} else if (scr_think_decoded(&my_state, aiState, pscript, pchr, buffer)) {
+		buffer.runs++;
+	} else {
+		// Discard the run, the script must run in the serial phase.
+		buffer.calls.resize(result.call_first);
+		buffer.serial.push_back(pchr);
+		return;
+	}
+
+	result.call_count = buffer.calls.size() - result.call_first;
+	buffer.results.push_back(result);
+}
+
+void scr_commit_think_buffer(script_think_buffer_t& buffer)
+{
+	_script_run_count += buffer.runs;
+	_script_skip_count += buffer.skips;
+
+	for (script_think_result_t& result : buffer.results) {
+		Object *pchr = result.object;
+		pchr->ai = result.ai;
+
+		// Clear the button latches.
+		if (!VALID_PLA(pchr->is_which_player)) {
+			RESET_BIT_FIELD(pchr->latch.b);
+		}
+
+		for (size_t i = result.call_first; i < result.call_first + result.call_count; ++i) {
+			script_deferred_call_t& call = buffer.calls[i];
+			call.function(&call.state, &call.ai);
+		}
+
+		scr_set_latches(pchr);
+	}
+}
+
+//--------------------------------------------------------------------------------------------
+void scr_run_raw( script_state_t * pstate, ai_state_t& aiState, const script_info_t *pscript )
+{
+	/// @details Interpret the compiled words of the script directly.
+
+	scr_set_pos(pstate, pscript, 0);
+	while (!aiState.terminate && pstate->position < pscript->length) {
+		// This is used by the Else function
+		// it only keeps track of functions.
+		pstate->indent_last = pstate->indent;
+		pstate->indent = GET_DATA_BITS(pscript->data[pstate->position]);
+		if (pstate->timing) {
+			_script_interpreter_instructions[0]++;
+		}
+
+		// Was it a function.
+		if (HAS_SOME_BITS(pscript->data[pstate->position], FUNCTION_BIT)) {
+			if (!scr_run_function_call(pstate, aiState, pscript)) {
+				break;
+			}
+		}
+		else {
+			if (!scr_run_operation(pstate, aiState, pscript)) {
+				break;
+			}
+		}
+	}
+}
+
+//--------------------------------------------------------------------------------------------
+void scr_run_decoded( script_state_t * pstate, ai_state_t& aiState, const script_info_t *pscript, Object *pchr )
+{
+	/// @details Run the pre-decoded instruction stream of the script (see scr_decode_script).
+	///          Function calls go through the resolved function pointers, jumps are
+	///          instruction indices and operands need no bit twiddling.
+
+	const script_instruction_t *instructions = pscript->instructions.data();
+	const script_operand_t *operands = pscript->operands.data();
+	const size_t count = pscript->instructions.size();
+
+	size_t pc = 0;
+	while (!aiState.terminate && pc < count) {
+		const script_instruction_t& instruction = instructions[pc];
+
+		// This is used by the Else function
+		// it only keeps track of functions.
+		pstate->indent_last = pstate->indent;
+		pstate->indent = instruction.indent;
+		if (pstate->timing) {
+			_script_interpreter_instructions[1]++;
+		}
+
+		if (instruction.isFunction) {
+			if (scr_run_function(pstate, aiState, pscript, instruction.code, instruction.function)) {
+				pc++;
+			} else {
+				pc = instruction.jump;
+			}
+		} else {
+			if (debug_scripts && debug_script_file) {
+				for (Uint32 i = 0; i < pstate->indent; i++) { vfs_printf(debug_script_file, "  "); }
+				vfs_printf(debug_script_file, "%d = ", instruction.code);
+			}
+
+			// Operands of a terminated object are ignored, as by the raw interpreter.
+			// Target and owner can only change in between two instructions.
+			pstate->operationsum = 0;
+			if (!pchr->isTerminated()) {
+				Object *ptarget = scr_get_object(aiState.target);
+				Object *powner = scr_get_object(aiState.owner);
+				for (size_t i = 0; i < instruction.operand_count; ++i) {
+					scr_run_operand(pstate, aiState, operands[instruction.operand_first + i], pchr, ptarget, powner);
+				}
+			}
+
+			if (debug_scripts && debug_script_file) {
+				vfs_printf(debug_script_file, " == %d \n", pstate->operationsum);
+			}
+
+			// Save the results in the register that called the arithmetic
+			scr_set_operand(pstate, instruction.code);
+			pc++;
+		}
+	}
+}
+
+//--------------------------------------------------------------------------------------------
+bool scr_think_decoded( script_state_t * pstate, ai_state_t& aiState, const script_info_t *pscript, Object *pchr, script_think_buffer_t& buffer )
+{
+	/// @details Run the pre-decoded instruction stream like scr_run_decoded(), but only call
+	///          the functions which can run in parallel and defer the calls of the functions
+	///          whose result is not used (the call does not jump). Anything else aborts the run.
+	/// @return @a false if the run was aborted
+
+	const script_instruction_t *instructions = pscript->instructions.data();
+	const script_operand_t *operands = pscript->operands.data();
+	const size_t count = pscript->instructions.size();
+	const size_t call_first = buffer.calls.size();
+
+	size_t pc = 0;
+	while (!aiState.terminate && pc < count) {
+		const script_instruction_t& instruction = instructions[pc];
+
+		// This is used by the Else function
+		// it only keeps track of functions.
+		pstate->indent_last = pstate->indent;
+		pstate->indent = instruction.indent;
+
+		if (instruction.isFunction) {
+			const Uint8 kind = (instruction.code < SCRIPT_FUNCTIONS_COUNT && nullptr != instruction.function)
+				             ? _script_function_kinds[instruction.code] : SCRIPT_FUNCTION_SERIAL;
+			if (SCRIPT_FUNCTION_PARALLEL == kind) {
+				if (instruction.function(pstate, &aiState)) {
+					pc++;
+				} else {
+					pc = instruction.jump;
+				}
+			} else if (SCRIPT_FUNCTION_DEFERRED == kind && instruction.jump == pc + 1) {
+				script_deferred_call_t call;
+				call.function = instruction.function;
+				call.state = *pstate;
+				call.ai = aiState;
+				buffer.calls.push_back(call);
+				pc++;
+			} else {
+				return false;
+			}
+		} else {
+			if (instruction.code > VARTMPARGUMENT) {
+				return false;
+			}
+
+			// Random numbers must be drawn in order and deferred particles can not be counted.
+			for (size_t i = 0; i < instruction.operand_count; ++i) {
+				const script_operand_t& operand = operands[instruction.operand_first + i];
+				if (operand.constant) continue;
+				if (VARRAND == operand.value) return false;
+				if (VARSELFATTACHED == operand.value && buffer.calls.size() > call_first) return false;
+			}
+
+			// Operands of a terminated object are ignored, as by the raw interpreter.
+			pstate->operationsum = 0;
+			if (!pchr->isTerminated()) {
+				Object *ptarget = scr_get_object(aiState.target);
+				Object *powner = scr_get_object(aiState.owner);
+				for (size_t i = 0; i < instruction.operand_count; ++i) {
+					scr_run_operand(pstate, aiState, operands[instruction.operand_first + i], pchr, ptarget, powner);
+				}
+			}
+
+			// Save the results in the register that called the arithmetic
+			scr_set_operand(pstate, instruction.code);
+			pc++;
+		}
+	}
+
+	return true;
+}
+
+//--------------------------------------------------------------------------------------------
+bool scr_run_function_call( script_state_t * pstate, ai_state_t& aiState, const script_info_t *pscript )
 {
     Uint8  functionreturn;
 
@@ -270,35 +1046,36 @@ bool scr_run_function_call( script_state_t * pstate, ai_state_t& aiState, script
     if ( NULL == pstate) return false;
 
     // check for valid execution pointer
-    if ( pscript->position >= pscript->length ) return false;
+    if ( pstate->position >= pscript->length ) return false;
 
     // Run the function
-	functionreturn = scr_run_function(pstate, aiState, pscript);
+	Uint32 valuecode = pscript->data[pstate->position] & VALUE_BITS;
+	functionreturn = scr_run_function(pstate, aiState, pscript, valuecode, valuecode < SCRIPT_FUNCTIONS_COUNT ? _script_functions[valuecode] : nullptr);
 
     // move the execution pointer to the jump code
-    scr_increment_pos( pscript );
+    scr_increment_pos( pstate, pscript );
     if ( functionreturn )
     {
         // move the execution pointer to the next opcode
-        scr_increment_pos( pscript );
+        scr_increment_pos( pstate, pscript );
     }
     else
     {
         // use the jump code to jump to the right location
-        size_t new_index = pscript->data[pscript->position];
+        size_t new_index = pscript->data[pstate->position];
 
         // make sure the value is valid
         EGOBOO_ASSERT( new_index <= pscript->length );
 
         // actually do the jump
-        scr_set_pos( pscript, new_index );
+        scr_set_pos( pstate, pscript, new_index );
     }
 
     return true;
 }
 
 //--------------------------------------------------------------------------------------------
-bool scr_run_operation( script_state_t * pstate, ai_state_t& aiState, script_info_t * pscript )
+bool scr_run_operation( script_state_t * pstate, ai_state_t& aiState, const script_info_t * pscript )
 {
     const char * variable;
     Uint32 var_value, operand_count, i;
@@ -307,16 +1084,16 @@ bool scr_run_operation( script_state_t * pstate, ai_state_t& aiState, script_inf
     if ( NULL == pstate || NULL == pscript ) return false;
 
     // check for valid execution pointer
-    if ( pscript->position >= pscript->length ) return false;
+    if ( pstate->position >= pscript->length ) return false;
 
-    var_value = pscript->data[pscript->position] & VALUE_BITS;
+    var_value = pscript->data[pstate->position] & VALUE_BITS;
 
     // debug stuff
     variable = "UNKNOWN";
     if ( debug_scripts && debug_script_file )
     {
 
-        for ( i = 0; i < pscript->indent; i++ ) { vfs_printf( debug_script_file, "  " ); }
+        for ( i = 0; i < pstate->indent; i++ ) { vfs_printf( debug_script_file, "  " ); }
 
         for ( i = 0; i < MAX_OPCODE; i++ )
         {
@@ -331,15 +1108,24 @@ bool scr_run_operation( script_state_t * pstate, ai_state_t& aiState, script_inf
     }
 
     // Get the number of operands
-    scr_increment_pos( pscript );
-    operand_count = pscript->data[pscript->position];
+    scr_increment_pos( pstate, pscript );
+    operand_count = pscript->data[pstate->position];
 
     // Now run the operation
     pstate->operationsum = 0;
-    for ( i = 0; i < operand_count && pscript->position < pscript->length; i++ )
+    for ( i = 0; i < operand_count && pstate->position < pscript->length; i++ )
     {
-        scr_increment_pos( pscript );
-		scr_run_operand(pstate, aiState, pscript);
+        scr_increment_pos( pstate, pscript );
+
+        Object *pchr = scr_get_object( aiState.index );
+        if ( NULL == pchr ) continue;
+
+        // decode the operand
+        script_operand_t operand;
+        operand.operation = GET_DATA_BITS( pscript->data[pstate->position] );
+        operand.constant = HAS_SOME_BITS( pscript->data[pstate->position], FUNCTION_BIT );
+        operand.value = pscript->data[pstate->position] & VALUE_BITS;
+		scr_run_operand(pstate, aiState, operand, pchr, scr_get_object(aiState.target), scr_get_object(aiState.owner));
     }
     if ( debug_scripts && debug_script_file )
     {
@@ -350,25 +1136,22 @@ bool scr_run_operation( script_state_t * pstate, ai_state_t& aiState, script_inf
     scr_set_operand( pstate, var_value );
 
     // go to the next opcode
-    scr_increment_pos( pscript );
+    scr_increment_pos( pstate, pscript );
 
     return true;
 }
 
 //--------------------------------------------------------------------------------------------
-Uint8 scr_run_function( script_state_t * pstate, ai_state_t& aiState, script_info_t * pscript )
+Uint8 scr_run_function( script_state_t * pstate, ai_state_t& aiState, const script_info_t * pscript, Uint32 valuecode, script_function_t function )
 {
     /// @author BB
     /// @details This is about half-way to what is needed for Lua integration
 
-    // Mask out the indentation
-    Uint32 valuecode = pscript->data[pscript->position] & VALUE_BITS;
-
     // Assume that the function will pass, as most do
     Uint8 returncode = true;
     if ( MAX_OPCODE == valuecode )
     {
-        log_message( "SCRIPT ERROR: scr_run_function() - model == %d, class name == \"%s\" - Unknown opcode found!\n", REF_TO_INT( script_error_model ), script_error_classname );
+        log_message( "SCRIPT ERROR: scr_run_function() - ai script \"%s\" - Unknown opcode found!\n", pscript->name );
         return false;
     }
 
@@ -377,7 +1160,7 @@ Uint8 scr_run_function( script_state_t * pstate, ai_state_t& aiState, script_inf
     {
         Uint32 i;
 
-        for ( i = 0; i < pscript->indent; i++ ) { vfs_printf( debug_script_file,  "  " ); }
+        for ( i = 0; i < pstate->indent; i++ ) { vfs_printf( debug_script_file,  "  " ); }
 
         for ( i = 0; i < MAX_OPCODE; i++ )
         {
@@ -389,421 +1172,28 @@ Uint8 scr_run_function( script_state_t * pstate, ai_state_t& aiState, script_inf
         }
     }
 
-    if ( valuecode > SCRIPT_FUNCTIONS_COUNT )
+    if ( valuecode < SCRIPT_FUNCTIONS_COUNT )
     {
-    }
-    else
-    {
-		
-		{ 
-			Ego::Time::ClockScope<Ego::Time::ClockPolicy::NonRecursive> scope(*g_scriptFunctionClock);
-            // Figure out which function to run
-            switch ( valuecode )
+        if ( nullptr == function )
+        {
+            // if there is no function for this code, skip the line and log an error
+            log_message( "SCRIPT ERROR: scr_run_function() - ai script \"%s\" - unhandled script function %d\n", pscript->name, valuecode );
+            returncode = false;
+        }
+        else if ( pstate->timing )
+        {
             {
-				case FIFSPAWNED: returncode = scr_Spawned(pstate, &aiState); break;
-				case FIFTIMEOUT: returncode = scr_TimeOut(pstate, &aiState); break;
-				case FIFATWAYPOINT: returncode = scr_AtWaypoint(pstate, &aiState); break;
-				case FIFATLASTWAYPOINT: returncode = scr_AtLastWaypoint(pstate, &aiState); break;
-				case FIFATTACKED: returncode = scr_Attacked(pstate, &aiState); break;
-				case FIFBUMPED: returncode = scr_Bumped(pstate, &aiState); break;
-				case FIFORDERED: returncode = scr_Ordered(pstate, &aiState); break;
-				case FIFCALLEDFORHELP: returncode = scr_CalledForHelp(pstate, &aiState); break;
-				case FSETCONTENT: returncode = scr_set_Content(pstate, &aiState); break;
-				case FIFKILLED: returncode = scr_Killed(pstate, &aiState); break;
-				case FIFTARGETKILLED: returncode = scr_TargetKilled(pstate, &aiState); break;
-				case FCLEARWAYPOINTS: returncode = scr_ClearWaypoints(pstate, &aiState); break;
-				case FADDWAYPOINT: returncode = scr_AddWaypoint(pstate, &aiState); break;
-				case FFINDPATH: returncode = scr_FindPath(pstate, &aiState); break;
-				case FCOMPASS: returncode = scr_Compass(pstate, &aiState); break;
-				case FGETTARGETARMORPRICE: returncode = scr_get_TargetArmorPrice(pstate, &aiState); break;
-				case FSETTIME: returncode = scr_set_Time(pstate, &aiState); break;
-				case FGETCONTENT: returncode = scr_get_Content(pstate, &aiState); break;
-				case FJOINTARGETTEAM: returncode = scr_JoinTargetTeam(pstate, &aiState); break;
-				case FSETTARGETTONEARBYENEMY: returncode = scr_set_TargetToNearbyEnemy(pstate, &aiState); break;
-				case FSETTARGETTOTARGETLEFTHAND: returncode = scr_set_TargetToTargetLeftHand(pstate, &aiState); break;
-				case FSETTARGETTOTARGETRIGHTHAND: returncode = scr_set_TargetToTargetRightHand(pstate, &aiState); break;
-				case FSETTARGETTOWHOEVERATTACKED: returncode = scr_set_TargetToWhoeverAttacked(pstate, &aiState); break;
-				case FSETTARGETTOWHOEVERBUMPED: returncode = scr_set_TargetToWhoeverBumped(pstate, &aiState); break;
-				case FSETTARGETTOWHOEVERCALLEDFORHELP: returncode = scr_set_TargetToWhoeverCalledForHelp(pstate, &aiState); break;
-				case FSETTARGETTOOLDTARGET: returncode = scr_set_TargetToOldTarget(pstate, &aiState); break;
-				case FSETTURNMODETOVELOCITY: returncode = scr_set_TurnModeToVelocity(pstate, &aiState); break;
-				case FSETTURNMODETOWATCH: returncode = scr_set_TurnModeToWatch(pstate, &aiState); break;
-				case FSETTURNMODETOSPIN: returncode = scr_set_TurnModeToSpin(pstate, &aiState); break;
-				case FSETBUMPHEIGHT: returncode = scr_set_BumpHeight(pstate, &aiState); break;
-				case FIFTARGETHASID: returncode = scr_TargetHasID(pstate, &aiState); break;
-				case FIFTARGETHASITEMID: returncode = scr_TargetHasItemID(pstate, &aiState); break;
-				case FIFTARGETHOLDINGITEMID: returncode = scr_TargetHoldingItemID(pstate, &aiState); break;
-				case FIFTARGETHASSKILLID: returncode = scr_TargetHasSkillID(pstate, &aiState); break;
-				case FELSE: returncode = scr_Else(pstate, &aiState); break;
-				case FRUN: returncode = scr_Run(pstate, &aiState); break;
-				case FWALK: returncode = scr_Walk(pstate, &aiState); break;
-				case FSNEAK: returncode = scr_Sneak(pstate, &aiState); break;
-				case FDOACTION: returncode = scr_DoAction(pstate, &aiState); break;
-				case FKEEPACTION: returncode = scr_KeepAction(pstate, &aiState); break;
-				case FISSUEORDER: returncode = scr_IssueOrder(pstate, &aiState); break;
-				case FDROPWEAPONS: returncode = scr_DropWeapons(pstate, &aiState); break;
-				case FTARGETDOACTION: returncode = scr_TargetDoAction(pstate, &aiState); break;
-				case FOPENPASSAGE: returncode = scr_OpenPassage(pstate, &aiState); break;
-				case FCLOSEPASSAGE: returncode = scr_ClosePassage(pstate, &aiState); break;
-				case FIFPASSAGEOPEN: returncode = scr_PassageOpen(pstate, &aiState); break;
-				case FGOPOOF: returncode = scr_GoPoof(pstate, &aiState); break;
-				case FCOSTTARGETITEMID: returncode = scr_CostTargetItemID(pstate, &aiState); break;
-				case FDOACTIONOVERRIDE: returncode = scr_DoActionOverride(pstate, &aiState); break;
-				case FIFHEALED: returncode = scr_Healed(pstate, &aiState); break;
-				case FSENDMESSAGE: returncode = scr_SendPlayerMessage(pstate, &aiState); break;
-				case FCALLFORHELP: returncode = scr_CallForHelp(pstate, &aiState); break;
-				case FADDIDSZ: returncode = scr_AddIDSZ(pstate, &aiState); break;
-				case FSETSTATE: returncode = scr_set_State(pstate, &aiState); break;
-				case FGETSTATE: returncode = scr_get_State(pstate, &aiState); break;
-				case FIFSTATEIS: returncode = scr_StateIs(pstate, &aiState); break;
-				case FIFTARGETCANOPENSTUFF: returncode = scr_TargetCanOpenStuff(pstate, &aiState); break;
-				case FIFGRABBED: returncode = scr_Grabbed(pstate, &aiState); break;
-				case FIFDROPPED: returncode = scr_Dropped(pstate, &aiState); break;
-				case FSETTARGETTOWHOEVERISHOLDING: returncode = scr_set_TargetToWhoeverIsHolding(pstate, &aiState); break;
-				case FDAMAGETARGET: returncode = scr_DamageTarget(pstate, &aiState); break;
-				case FIFXISLESSTHANY: returncode = scr_XIsLessThanY(pstate, &aiState); break;
-				case FSETWEATHERTIME: returncode = scr_set_WeatherTime(pstate, &aiState); break;
-				case FGETBUMPHEIGHT: returncode = scr_get_BumpHeight(pstate, &aiState); break;
-				case FIFREAFFIRMED: returncode = scr_Reaffirmed(pstate, &aiState); break;
-				case FUNKEEPACTION: returncode = scr_UnkeepAction(pstate, &aiState); break;
-				case FIFTARGETISONOTHERTEAM: returncode = scr_TargetIsOnOtherTeam(pstate, &aiState); break;
-				case FIFTARGETISONHATEDTEAM: returncode = scr_TargetIsOnHatedTeam(pstate, &aiState); break;
-				case FPRESSLATCHBUTTON: returncode = scr_PressLatchButton(pstate, &aiState); break;
-				case FSETTARGETTOTARGETOFLEADER: returncode = scr_set_TargetToTargetOfLeader(pstate, &aiState); break;
-				case FIFLEADERKILLED: returncode = scr_LeaderKilled(pstate, &aiState); break;
-				case FBECOMELEADER: returncode = scr_BecomeLeader(pstate, &aiState); break;
-				case FCHANGETARGETARMOR: returncode = scr_ChangeTargetArmor(pstate, &aiState); break;
-				case FGIVEMONEYTOTARGET: returncode = scr_GiveMoneyToTarget(pstate, &aiState); break;
-				case FDROPKEYS: returncode = scr_DropKeys(pstate, &aiState); break;
-				case FIFLEADERISALIVE: returncode = scr_LeaderIsAlive(pstate, &aiState); break;
-				case FIFTARGETISOLDTARGET: returncode = scr_TargetIsOldTarget(pstate, &aiState); break;
-				case FSETTARGETTOLEADER: returncode = scr_set_TargetToLeader(pstate, &aiState); break;
-				case FSPAWNCHARACTER: returncode = scr_SpawnCharacter(pstate, &aiState); break;
-				case FRESPAWNCHARACTER: returncode = scr_RespawnCharacter(pstate, &aiState); break;
-				case FCHANGETILE: returncode = scr_ChangeTile(pstate, &aiState); break;
-				case FIFUSED: returncode = scr_Used(pstate, &aiState); break;
-				case FDROPMONEY: returncode = scr_DropMoney(pstate, &aiState); break;
-				case FSETOLDTARGET: returncode = scr_set_OldTarget(pstate, &aiState); break;
-				case FDETACHFROMHOLDER: returncode = scr_DetachFromHolder(pstate, &aiState); break;
-				case FIFTARGETHASVULNERABILITYID: returncode = scr_TargetHasVulnerabilityID(pstate, &aiState); break;
-				case FCLEANUP: returncode = scr_CleanUp(pstate, &aiState); break;
-				case FIFCLEANEDUP: returncode = scr_CleanedUp(pstate, &aiState); break;
-				case FIFSITTING: returncode = scr_Sitting(pstate, &aiState); break;
-				case FIFTARGETISHURT: returncode = scr_TargetIsHurt(pstate, &aiState); break;
-				case FIFTARGETISAPLAYER: returncode = scr_TargetIsAPlayer(pstate, &aiState); break;
-				case FPLAYSOUND: returncode = scr_PlaySound(pstate, &aiState); break;
-				case FSPAWNPARTICLE: returncode = scr_SpawnParticle(pstate, &aiState); break;
-				case FIFTARGETISALIVE: returncode = scr_TargetIsAlive(pstate, &aiState); break;
-				case FSTOP: returncode = scr_Stop(pstate, &aiState); break;
-				case FDISAFFIRMCHARACTER: returncode = scr_DisaffirmCharacter(pstate, &aiState); break;
-				case FREAFFIRMCHARACTER: returncode = scr_ReaffirmCharacter(pstate, &aiState); break;
-				case FIFTARGETISSELF: returncode = scr_TargetIsSelf(pstate, &aiState); break;
-				case FIFTARGETISMALE: returncode = scr_TargetIsMale(pstate, &aiState); break;
-				case FIFTARGETISFEMALE: returncode = scr_TargetIsFemale(pstate, &aiState); break;
-				case FSETTARGETTOSELF: returncode = scr_set_TargetToSelf(pstate, &aiState); break;
-				case FSETTARGETTORIDER: returncode = scr_set_TargetToRider(pstate, &aiState); break;
-				case FGETATTACKTURN: returncode = scr_get_AttackTurn(pstate, &aiState); break;
-				case FGETDAMAGETYPE: returncode = scr_get_DamageType(pstate, &aiState); break;
-				case FBECOMESPELL: returncode = scr_BecomeSpell(pstate, &aiState); break;
-				case FBECOMESPELLBOOK: returncode = scr_BecomeSpellbook(pstate, &aiState); break;
-				case FIFSCOREDAHIT: returncode = scr_ScoredAHit(pstate, &aiState); break;
-				case FIFDISAFFIRMED: returncode = scr_Disaffirmed(pstate, &aiState); break;
-				case FTRANSLATEORDER: returncode = scr_TranslateOrder(pstate, &aiState); break;
-				case FSETTARGETTOWHOEVERWASHIT: returncode = scr_set_TargetToWhoeverWasHit(pstate, &aiState); break;
-				case FSETTARGETTOWIDEENEMY: returncode = scr_set_TargetToWideEnemy(pstate, &aiState); break;
-				case FIFCHANGED: returncode = scr_Changed(pstate, &aiState); break;
-				case FIFINWATER: returncode = scr_InWater(pstate, &aiState); break;
-				case FIFBORED: returncode = scr_Bored(pstate, &aiState); break;
-				case FIFTOOMUCHBAGGAGE: returncode = scr_TooMuchBaggage(pstate, &aiState); break;
-				case FIFGROGGED: returncode = scr_Grogged(pstate, &aiState); break;
-				case FIFDAZED: returncode = scr_Dazed(pstate, &aiState); break;
-				case FIFTARGETHASSPECIALID: returncode = scr_TargetHasSpecialID(pstate, &aiState); break;
-				case FPRESSTARGETLATCHBUTTON: returncode = scr_PressTargetLatchButton(pstate, &aiState); break;
-				case FIFINVISIBLE: returncode = scr_Invisible(pstate, &aiState); break;
-				case FIFARMORIS: returncode = scr_ArmorIs(pstate, &aiState); break;
-				case FGETTARGETGROGTIME: returncode = scr_get_TargetGrogTime(pstate, &aiState); break;
-				case FGETTARGETDAZETIME: returncode = scr_get_TargetDazeTime(pstate, &aiState); break;
-				case FSETDAMAGETYPE: returncode = scr_set_DamageType(pstate, &aiState); break;
-				case FSETWATERLEVEL: returncode = scr_set_WaterLevel(pstate, &aiState); break;
-				case FENCHANTTARGET: returncode = scr_EnchantTarget(pstate, &aiState); break;
-				case FENCHANTCHILD: returncode = scr_EnchantChild(pstate, &aiState); break;
-				case FTELEPORTTARGET: returncode = scr_TeleportTarget(pstate, &aiState); break;
-				case FGIVEEXPERIENCETOTARGET: returncode = scr_add_TargetExperience(pstate, &aiState); break;
-				case FINCREASEAMMO: returncode = scr_IncreaseAmmo(pstate, &aiState); break;
-				case FUNKURSETARGET: returncode = scr_UnkurseTarget(pstate, &aiState); break;
-				case FGIVEEXPERIENCETOTARGETTEAM: returncode = scr_add_TargetTeamExperience(pstate, &aiState); break;
-				case FIFUNARMED: returncode = scr_Unarmed(pstate, &aiState); break;
-				case FRESTOCKTARGETAMMOIDALL: returncode = scr_RestockTargetAmmoIDAll(pstate, &aiState); break;
-				case FRESTOCKTARGETAMMOIDFIRST: returncode = scr_RestockTargetAmmoIDFirst(pstate, &aiState); break;
-				case FFLASHTARGET: returncode = scr_FlashTarget(pstate, &aiState); break;
-				case FSETREDSHIFT: returncode = scr_set_RedShift(pstate, &aiState); break;
-				case FSETGREENSHIFT: returncode = scr_set_GreenShift(pstate, &aiState); break;
-				case FSETBLUESHIFT: returncode = scr_set_BlueShift(pstate, &aiState); break;
-				case FSETLIGHT: returncode = scr_set_Light(pstate, &aiState); break;
-				case FSETALPHA: returncode = scr_set_Alpha(pstate, &aiState); break;
-				case FIFHITFROMBEHIND: returncode = scr_HitFromBehind(pstate, &aiState); break;
-				case FIFHITFROMFRONT: returncode = scr_HitFromFront(pstate, &aiState); break;
-				case FIFHITFROMLEFT: returncode = scr_HitFromLeft(pstate, &aiState); break;
-				case FIFHITFROMRIGHT: returncode = scr_HitFromRight(pstate, &aiState); break;
-				case FIFTARGETISONSAMETEAM: returncode = scr_TargetIsOnSameTeam(pstate, &aiState); break;
-				case FKILLTARGET: returncode = scr_KillTarget(pstate, &aiState); break;
-				case FUNDOENCHANT: returncode = scr_UndoEnchant(pstate, &aiState); break;
-				case FGETWATERLEVEL: returncode = scr_get_WaterLevel(pstate, &aiState); break;
-				case FCOSTTARGETMANA: returncode = scr_CostTargetMana(pstate, &aiState); break;
-				case FIFTARGETHASANYID: returncode = scr_TargetHasAnyID(pstate, &aiState); break;
-				case FSETBUMPSIZE: returncode = scr_set_BumpSize(pstate, &aiState); break;
-				case FIFNOTDROPPED: returncode = scr_NotDropped(pstate, &aiState); break;
-				case FIFYISLESSTHANX: returncode = scr_YIsLessThanX(pstate, &aiState); break;
-				case FSETFLYHEIGHT: returncode = scr_set_FlyHeight(pstate, &aiState); break;
-				case FIFBLOCKED: returncode = scr_Blocked(pstate, &aiState); break;
-				case FIFTARGETISDEFENDING: returncode = scr_TargetIsDefending(pstate, &aiState); break;
-				case FIFTARGETISATTACKING: returncode = scr_TargetIsAttacking(pstate, &aiState); break;
-				case FIFSTATEIS0: returncode = scr_StateIs0(pstate, &aiState); break;
-				case FIFSTATEIS1: returncode = scr_StateIs1(pstate, &aiState); break;
-				case FIFSTATEIS2: returncode = scr_StateIs2(pstate, &aiState); break;
-				case FIFSTATEIS3: returncode = scr_StateIs3(pstate, &aiState); break;
-				case FIFSTATEIS4: returncode = scr_StateIs4(pstate, &aiState); break;
-				case FIFSTATEIS5: returncode = scr_StateIs5(pstate, &aiState); break;
-				case FIFSTATEIS6: returncode = scr_StateIs6(pstate, &aiState); break;
-				case FIFSTATEIS7: returncode = scr_StateIs7(pstate, &aiState); break;
-				case FIFCONTENTIS: returncode = scr_ContentIs(pstate, &aiState); break;
-				case FSETTURNMODETOWATCHTARGET: returncode = scr_set_TurnModeToWatchTarget(pstate, &aiState); break;
-				case FIFSTATEISNOT: returncode = scr_StateIsNot(pstate, &aiState); break;
-				case FIFXISEQUALTOY: returncode = scr_XIsEqualToY(pstate, &aiState); break;
-				case FDEBUGMESSAGE: returncode = scr_DebugMessage(pstate, &aiState); break;
-				case FBLACKTARGET: returncode = scr_BlackTarget(pstate, &aiState); break;
-				case FSENDMESSAGENEAR: returncode = scr_SendMessageNear(pstate, &aiState); break;
-				case FIFHITGROUND: returncode = scr_HitGround(pstate, &aiState); break;
-				case FIFNAMEISKNOWN: returncode = scr_NameIsKnown(pstate, &aiState); break;
-				case FIFUSAGEISKNOWN: returncode = scr_UsageIsKnown(pstate, &aiState); break;
-				case FIFHOLDINGITEMID: returncode = scr_HoldingItemID(pstate, &aiState); break;
-				case FIFHOLDINGRANGEDWEAPON: returncode = scr_HoldingRangedWeapon(pstate, &aiState); break;
-				case FIFHOLDINGMELEEWEAPON: returncode = scr_HoldingMeleeWeapon(pstate, &aiState); break;
-				case FIFHOLDINGSHIELD: returncode = scr_HoldingShield(pstate, &aiState); break;
-				case FIFKURSED: returncode = scr_Kursed(pstate, &aiState); break;
-				case FIFTARGETISKURSED: returncode = scr_TargetIsKursed(pstate, &aiState); break;
-				case FIFTARGETISDRESSEDUP: returncode = scr_TargetIsDressedUp(pstate, &aiState); break;
-				case FIFOVERWATER: returncode = scr_OverWater(pstate, &aiState); break;
-				case FIFTHROWN: returncode = scr_Thrown(pstate, &aiState); break;
-				case FMAKENAMEKNOWN: returncode = scr_MakeNameKnown(pstate, &aiState); break;
-				case FMAKEUSAGEKNOWN: returncode = scr_MakeUsageKnown(pstate, &aiState); break;
-				case FSTOPTARGETMOVEMENT: returncode = scr_StopTargetMovement(pstate, &aiState); break;
-				case FSETXY: returncode = scr_set_XY(pstate, &aiState); break;
-				case FGETXY: returncode = scr_get_XY(pstate, &aiState); break;
-				case FADDXY: returncode = scr_AddXY(pstate, &aiState); break;
-				case FMAKEAMMOKNOWN: returncode = scr_MakeAmmoKnown(pstate, &aiState); break;
-				case FSPAWNATTACHEDPARTICLE: returncode = scr_SpawnAttachedParticle(pstate, &aiState); break;
-				case FSPAWNEXACTPARTICLE: returncode = scr_SpawnExactParticle(pstate, &aiState); break;
-				case FACCELERATETARGET: returncode = scr_AccelerateTarget(pstate, &aiState); break;
-				case FIFDISTANCEISMORETHANTURN: returncode = scr_distanceIsMoreThanTurn(pstate, &aiState); break;
-				case FIFCRUSHED: returncode = scr_Crushed(pstate, &aiState); break;
-				case FMAKECRUSHVALID: returncode = scr_MakeCrushValid(pstate, &aiState); break;
-				case FSETTARGETTOLOWESTTARGET: returncode = scr_set_TargetToLowestTarget(pstate, &aiState); break;
-				case FIFNOTPUTAWAY: returncode = scr_NotPutAway(pstate, &aiState); break;
-				case FIFTAKENOUT: returncode = scr_TakenOut(pstate, &aiState); break;
-				case FIFAMMOOUT: returncode = scr_AmmoOut(pstate, &aiState); break;
-				case FPLAYSOUNDLOOPED: returncode = scr_PlaySoundLooped(pstate, &aiState); break;
-				case FSTOPSOUND: returncode = scr_StopSound(pstate, &aiState); break;
-				case FHEALSELF: returncode = scr_HealSelf(pstate, &aiState); break;
-				case FEQUIP: returncode = scr_Equip(pstate, &aiState); break;
-				case FIFTARGETHASITEMIDEQUIPPED: returncode = scr_TargetHasItemIDEquipped(pstate, &aiState); break;
-				case FSETOWNERTOTARGET: returncode = scr_set_OwnerToTarget(pstate, &aiState); break;
-				case FSETTARGETTOOWNER: returncode = scr_set_TargetToOwner(pstate, &aiState); break;
-				case FSETFRAME: returncode = scr_set_Frame(pstate, &aiState); break;
-				case FBREAKPASSAGE: returncode = scr_BreakPassage(pstate, &aiState); break;
-				case FSETRELOADTIME: returncode = scr_set_ReloadTime(pstate, &aiState); break;
-				case FSETTARGETTOWIDEBLAHID: returncode = scr_set_TargetToWideBlahID(pstate, &aiState); break;
-				case FPOOFTARGET: returncode = scr_PoofTarget(pstate, &aiState); break;
-				case FCHILDDOACTIONOVERRIDE: returncode = scr_ChildDoActionOverride(pstate, &aiState); break;
-				case FSPAWNPOOF: returncode = scr_SpawnPoof(pstate, &aiState); break;
-				case FSETSPEEDPERCENT: returncode = scr_set_SpeedPercent(pstate, &aiState); break;
-				case FSETCHILDSTATE: returncode = scr_set_ChildState(pstate, &aiState); break;
-				case FSPAWNATTACHEDSIZEDPARTICLE: returncode = scr_SpawnAttachedSizedParticle(pstate, &aiState); break;
-				case FCHANGEARMOR: returncode = scr_ChangeArmor(pstate, &aiState); break;
-				case FSHOWTIMER: returncode = scr_ShowTimer(pstate, &aiState); break;
-				case FIFFACINGTARGET: returncode = scr_FacingTarget(pstate, &aiState); break;
-				case FPLAYSOUNDVOLUME: returncode = scr_PlaySoundVolume(pstate, &aiState); break;
-				case FSPAWNATTACHEDFACEDPARTICLE: returncode = scr_SpawnAttachedFacedParticle(pstate, &aiState); break;
-				case FIFSTATEISODD: returncode = scr_StateIsOdd(pstate, &aiState); break;
-				case FSETTARGETTODISTANTENEMY: returncode = scr_set_TargetToDistantEnemy(pstate, &aiState); break;
-				case FTELEPORT: returncode = scr_Teleport(pstate, &aiState); break;
-				case FGIVESTRENGTHTOTARGET: returncode = scr_add_TargetStrength(pstate, &aiState); break;
-				case FGIVEINTELLECTTOTARGET:
-				case FGIVEINTELLIGENCETOTARGET: returncode = scr_add_TargetIntelligence(pstate, &aiState); break;
-				case FGIVEDEXTERITYTOTARGET: returncode = scr_add_TargetDexterity(pstate, &aiState); break;
-				case FGIVELIFETOTARGET: returncode = scr_add_TargetLife(pstate, &aiState); break;
-				case FGIVEMANATOTARGET: returncode = scr_add_TargetMana(pstate, &aiState); break;
-				case FSHOWMAP: returncode = scr_ShowMap(pstate, &aiState); break;
-				case FSHOWYOUAREHERE: returncode = scr_ShowYouAreHere(pstate, &aiState); break;
-				case FSHOWBLIPXY: returncode = scr_ShowBlipXY(pstate, &aiState); break;
-				case FHEALTARGET: returncode = scr_HealTarget(pstate, &aiState); break;
-				case FPUMPTARGET: returncode = scr_PumpTarget(pstate, &aiState); break;
-				case FCOSTAMMO: returncode = scr_CostAmmo(pstate, &aiState); break;
-				case FMAKESIMILARNAMESKNOWN: returncode = scr_MakeSimilarNamesKnown(pstate, &aiState); break;
-				case FSPAWNATTACHEDHOLDERPARTICLE: returncode = scr_SpawnAttachedHolderParticle(pstate, &aiState); break;
-				case FSETTARGETRELOADTIME: returncode = scr_set_TargetReloadTime(pstate, &aiState); break;
-				case FSETFOGLEVEL: returncode = scr_set_FogLevel(pstate, &aiState); break;
-				case FGETFOGLEVEL: returncode = scr_get_FogLevel(pstate, &aiState); break;
-				case FSETFOGTAD: returncode = scr_set_FogTAD(pstate, &aiState); break;
-				case FSETFOGBOTTOMLEVEL: returncode = scr_set_FogBottomLevel(pstate, &aiState); break;
-				case FGETFOGBOTTOMLEVEL: returncode = scr_get_FogBottomLevel(pstate, &aiState); break;
-				case FCORRECTACTIONFORHAND: returncode = scr_CorrectActionForHand(pstate, &aiState); break;
-				case FIFTARGETISMOUNTED: returncode = scr_TargetIsMounted(pstate, &aiState); break;
-				case FSPARKLEICON: returncode = scr_SparkleIcon(pstate, &aiState); break;
-				case FUNSPARKLEICON: returncode = scr_UnsparkleIcon(pstate, &aiState); break;
-				case FGETTILEXY: returncode = scr_get_TileXY(pstate, &aiState); break;
-				case FSETTILEXY: returncode = scr_set_TileXY(pstate, &aiState); break;
-				case FSETSHADOWSIZE: returncode = scr_set_ShadowSize(pstate, &aiState); break;
-				case FORDERTARGET: returncode = scr_OrderTarget(pstate, &aiState); break;
-				case FSETTARGETTOWHOEVERISINPASSAGE: returncode = scr_set_TargetToWhoeverIsInPassage(pstate, &aiState); break;
-				case FIFCHARACTERWASABOOK: returncode = scr_CharacterWasABook(pstate, &aiState); break;
-				case FSETENCHANTBOOSTVALUES: returncode = scr_set_EnchantBoostValues(pstate, &aiState); break;
-				case FSPAWNCHARACTERXYZ: returncode = scr_SpawnCharacterXYZ(pstate, &aiState); break;
-				case FSPAWNEXACTCHARACTERXYZ: returncode = scr_SpawnExactCharacterXYZ(pstate, &aiState); break;
-				case FCHANGETARGETCLASS: returncode = scr_ChangeTargetClass(pstate, &aiState); break;
-				case FPLAYFULLSOUND: returncode = scr_PlayFullSound(pstate, &aiState); break;
-				case FSPAWNEXACTCHASEPARTICLE: returncode = scr_SpawnExactChaseParticle(pstate, &aiState); break;
-				case FCREATEORDER: returncode = scr_CreateOrder(pstate, &aiState); break;
-				case FORDERSPECIALID: returncode = scr_OrderSpecialID(pstate, &aiState); break;
-				case FUNKURSETARGETINVENTORY: returncode = scr_UnkurseTargetInventory(pstate, &aiState); break;
-				case FIFTARGETISSNEAKING: returncode = scr_TargetIsSneaking(pstate, &aiState); break;
-				case FDROPITEMS: returncode = scr_DropItems(pstate, &aiState); break;
-				case FRESPAWNTARGET: returncode = scr_RespawnTarget(pstate, &aiState); break;
-				case FTARGETDOACTIONSETFRAME: returncode = scr_TargetDoActionSetFrame(pstate, &aiState); break;
-				case FIFTARGETCANSEEINVISIBLE: returncode = scr_TargetCanSeeInvisible(pstate, &aiState); break;
-				case FSETTARGETTONEARESTBLAHID: returncode = scr_set_TargetToNearestBlahID(pstate, &aiState); break;
-				case FSETTARGETTONEARESTENEMY: returncode = scr_set_TargetToNearestEnemy(pstate, &aiState); break;
-				case FSETTARGETTONEARESTFRIEND: returncode = scr_set_TargetToNearestFriend(pstate, &aiState); break;
-				case FSETTARGETTONEARESTLIFEFORM: returncode = scr_set_TargetToNearestLifeform(pstate, &aiState); break;
-				case FFLASHPASSAGE: returncode = scr_FlashPassage(pstate, &aiState); break;
-				case FFINDTILEINPASSAGE: returncode = scr_FindTileInPassage(pstate, &aiState); break;
-				case FIFHELDINLEFTHAND: returncode = scr_HeldInLeftHand(pstate, &aiState); break;
-				case FNOTANITEM: returncode = scr_NotAnItem(pstate, &aiState); break;
-				case FSETCHILDAMMO: returncode = scr_set_ChildAmmo(pstate, &aiState); break;
-				case FIFHITVULNERABLE: returncode = scr_HitVulnerable(pstate, &aiState); break;
-				case FIFTARGETISFLYING: returncode = scr_TargetIsFlying(pstate, &aiState); break;
-				case FIDENTIFYTARGET: returncode = scr_IdentifyTarget(pstate, &aiState); break;
-				case FBEATMODULE: returncode = scr_BeatModule(pstate, &aiState); break;
-				case FENDMODULE: returncode = scr_EndModule(pstate, &aiState); break;
-				case FDISABLEEXPORT: returncode = scr_DisableExport(pstate, &aiState); break;
-				case FENABLEEXPORT: returncode = scr_EnableExport(pstate, &aiState); break;
-				case FGETTARGETSTATE: returncode = scr_get_TargetState(pstate, &aiState); break;
-				case FIFEQUIPPED: returncode = scr_Equipped(pstate, &aiState); break;
-				case FDROPTARGETMONEY: returncode = scr_DropTargetMoney(pstate, &aiState); break;
-				case FGETTARGETCONTENT: returncode = scr_get_TargetContent(pstate, &aiState); break;
-				case FDROPTARGETKEYS: returncode = scr_DropTargetKeys(pstate, &aiState); break;
-				case FJOINTEAM: returncode = scr_JoinTeam(pstate, &aiState); break;
-				case FTARGETJOINTEAM: returncode = scr_TargetJoinTeam(pstate, &aiState); break;
-				case FCLEARMUSICPASSAGE: returncode = scr_ClearMusicPassage(pstate, &aiState); break;
-				case FCLEARENDMESSAGE: returncode = scr_ClearEndMessage(pstate, &aiState); break;
-				case FADDENDMESSAGE: returncode = scr_AddEndMessage(pstate, &aiState); break;
-				case FPLAYMUSIC: returncode = scr_PlayMusic(pstate, &aiState); break;
-				case FSETMUSICPASSAGE: returncode = scr_set_MusicPassage(pstate, &aiState); break;
-				case FMAKECRUSHINVALID: returncode = scr_MakeCrushInvalid(pstate, &aiState); break;
-				case FSTOPMUSIC: returncode = scr_StopMusic(pstate, &aiState); break;
-				case FFLASHVARIABLE: returncode = scr_FlashVariable(pstate, &aiState); break;
-				case FACCELERATEUP: returncode = scr_AccelerateUp(pstate, &aiState); break;
-				case FFLASHVARIABLEHEIGHT: returncode = scr_FlashVariableHeight(pstate, &aiState); break;
-				case FSETDAMAGETIME: returncode = scr_set_DamageTime(pstate, &aiState); break;
-				case FIFSTATEIS8: returncode = scr_StateIs8(pstate, &aiState); break;
-				case FIFSTATEIS9: returncode = scr_StateIs9(pstate, &aiState); break;
-				case FIFSTATEIS10: returncode = scr_StateIs10(pstate, &aiState); break;
-				case FIFSTATEIS11: returncode = scr_StateIs11(pstate, &aiState); break;
-				case FIFSTATEIS12: returncode = scr_StateIs12(pstate, &aiState); break;
-				case FIFSTATEIS13: returncode = scr_StateIs13(pstate, &aiState); break;
-				case FIFSTATEIS14: returncode = scr_StateIs14(pstate, &aiState); break;
-				case FIFSTATEIS15: returncode = scr_StateIs15(pstate, &aiState); break;
-				case FIFTARGETISAMOUNT: returncode = scr_TargetIsAMount(pstate, &aiState); break;
-				case FIFTARGETISAPLATFORM: returncode = scr_TargetIsAPlatform(pstate, &aiState); break;
-				case FADDSTAT: returncode = scr_AddStat(pstate, &aiState); break;
-				case FDISENCHANTTARGET: returncode = scr_DisenchantTarget(pstate, &aiState); break;
-				case FDISENCHANTALL: returncode = scr_DisenchantAll(pstate, &aiState); break;
-				case FSETVOLUMENEARESTTEAMMATE: returncode = scr_set_VolumeNearestTeammate(pstate, &aiState); break;
-				case FADDSHOPPASSAGE: returncode = scr_AddShopPassage(pstate, &aiState); break;
-				case FTARGETPAYFORARMOR: returncode = scr_TargetPayForArmor(pstate, &aiState); break;
-				case FJOINEVILTEAM: returncode = scr_JoinEvilTeam(pstate, &aiState); break;
-				case FJOINNULLTEAM: returncode = scr_JoinNullTeam(pstate, &aiState); break;
-				case FJOINGOODTEAM: returncode = scr_JoinGoodTeam(pstate, &aiState); break;
-				case FPITSKILL: returncode = scr_PitsKill(pstate, &aiState); break;
-				case FSETTARGETTOPASSAGEID: returncode = scr_set_TargetToPassageID(pstate, &aiState); break;
-				case FMAKENAMEUNKNOWN: returncode = scr_MakeNameUnknown(pstate, &aiState); break;
-				case FSPAWNEXACTPARTICLEENDSPAWN: returncode = scr_SpawnExactParticleEndSpawn(pstate, &aiState); break;
-				case FSPAWNPOOFSPEEDSPACINGDAMAGE: returncode = scr_SpawnPoofSpeedSpacingDamage(pstate, &aiState); break;
-				case FGIVEEXPERIENCETOGOODTEAM: returncode = scr_add_GoodTeamExperience(pstate, &aiState); break;
-				case FDONOTHING: returncode = scr_DoNothing(pstate, &aiState); break;
-				case FGROGTARGET: returncode = scr_GrogTarget(pstate, &aiState); break;
-				case FDAZETARGET: returncode = scr_DazeTarget(pstate, &aiState); break;
-				case FENABLERESPAWN: returncode = scr_EnableRespawn(pstate, &aiState); break;
-				case FDISABLERESPAWN: returncode = scr_DisableRespawn(pstate, &aiState); break;
-				case FDISPELTARGETENCHANTID: returncode = scr_DispelTargetEnchantID(pstate, &aiState); break;
-				case FIFHOLDERBLOCKED: returncode = scr_HolderBlocked(pstate, &aiState); break;
-
-				case FIFTARGETHASNOTFULLMANA: returncode = scr_TargetHasNotFullMana(pstate, &aiState); break;
-				case FENABLELISTENSKILL: returncode = scr_EnableListenSkill(pstate, &aiState); break;
-				case FSETTARGETTOLASTITEMUSED: returncode = scr_set_TargetToLastItemUsed(pstate, &aiState); break;
-				case FFOLLOWLINK: returncode = scr_FollowLink(pstate, &aiState); break;
-				case FIFOPERATORISLINUX: returncode = scr_OperatorIsLinux(pstate, &aiState); break;
-				case FIFTARGETISAWEAPON: returncode = scr_TargetIsAWeapon(pstate, &aiState); break;
-				case FIFSOMEONEISSTEALING: returncode = scr_SomeoneIsStealing(pstate, &aiState); break;
-				case FIFTARGETISASPELL: returncode = scr_TargetIsASpell(pstate, &aiState); break;
-				case FIFBACKSTABBED: returncode = scr_Backstabbed(pstate, &aiState); break;
-				case FGETTARGETDAMAGETYPE: returncode = scr_get_TargetDamageType(pstate, &aiState); break;
-				case FADDQUEST: returncode = scr_AddQuest(pstate, &aiState); break;
-				case FBEATQUESTALLPLAYERS: returncode = scr_BeatQuestAllPlayers(pstate, &aiState); break;
-				case FIFTARGETHASQUEST: returncode = scr_TargetHasQuest(pstate, &aiState); break;
-				case FSETQUESTLEVEL: returncode = scr_set_QuestLevel(pstate, &aiState); break;
-				case FADDQUESTALLPLAYERS: returncode = scr_AddQuestAllPlayers(pstate, &aiState); break;
-				case FADDBLIPALLENEMIES: returncode = scr_AddBlipAllEnemies(pstate, &aiState); break;
-				case FPITSFALL: returncode = scr_PitsFall(pstate, &aiState); break;
-				case FIFTARGETISOWNER: returncode = scr_TargetIsOwner(pstate, &aiState); break;
-				case FEND: returncode = scr_End(pstate, &aiState); break;
-
-				case FSETSPEECH:           returncode = scr_set_Speech(pstate, &aiState);           break;
-				case FSETMOVESPEECH:       returncode = scr_set_MoveSpeech(pstate, &aiState);       break;
-				case FSETSECONDMOVESPEECH: returncode = scr_set_SecondMoveSpeech(pstate, &aiState); break;
-				case FSETATTACKSPEECH:     returncode = scr_set_AttackSpeech(pstate, &aiState);     break;
-				case FSETASSISTSPEECH:     returncode = scr_set_AssistSpeech(pstate, &aiState);     break;
-				case FSETTERRAINSPEECH:    returncode = scr_set_TerrainSpeech(pstate, &aiState);    break;
-				case FSETSELECTSPEECH:     returncode = scr_set_SelectSpeech(pstate, &aiState);     break;
-
-				case FTAKEPICTURE:           returncode = scr_TakePicture(pstate, &aiState);         break;
-				case FIFOPERATORISMACINTOSH: returncode = scr_OperatorIsMacintosh(pstate, &aiState); break;
-				case FIFMODULEHASIDSZ:       returncode = scr_ModuleHasIDSZ(pstate, &aiState);       break;
-				case FMORPHTOTARGET:         returncode = scr_MorphToTarget(pstate, &aiState);       break;
-				case FGIVEMANAFLOWTOTARGET:  returncode = scr_add_TargetManaFlow(pstate, &aiState); break;
-				case FGIVEMANARETURNTOTARGET:returncode = scr_add_TargetManaReturn(pstate, &aiState); break;
-				case FSETMONEY:              returncode = scr_set_Money(pstate, &aiState);           break;
-				case FIFTARGETCANSEEKURSES:  returncode = scr_TargetCanSeeKurses(pstate, &aiState);  break;
-				case FSPAWNATTACHEDCHARACTER:returncode = scr_SpawnAttachedCharacter(pstate, &aiState); break;
-				case FKURSETARGET:           returncode = scr_KurseTarget(pstate, &aiState);            break;
-				case FSETCHILDCONTENT:       returncode = scr_set_ChildContent(pstate, &aiState);    break;
-				case FSETTARGETTOCHILD:      returncode = scr_set_TargetToChild(pstate, &aiState);   break;
-				case FSETDAMAGETHRESHOLD:     returncode = scr_set_DamageThreshold(pstate, &aiState);   break;
-				case FACCELERATETARGETUP:    returncode = scr_AccelerateTargetUp(pstate, &aiState); break;
-				case FSETTARGETAMMO:         returncode = scr_set_TargetAmmo(pstate, &aiState); break;
-				case FENABLEINVICTUS:        returncode = scr_EnableInvictus(pstate, &aiState); break;
-				case FDISABLEINVICTUS:       returncode = scr_DisableInvictus(pstate, &aiState); break;
-				case FTARGETDAMAGESELF:      returncode = scr_TargetDamageSelf(pstate, &aiState); break;
-				case FSETTARGETSIZE:         returncode = scr_set_TargetSize(pstate, &aiState); break;
-				case FIFTARGETISFACINGSELF:  returncode = scr_TargetIsFacingSelf(pstate, &aiState); break;
-
-				case FDRAWBILLBOARD:                 returncode = scr_DrawBillboard(pstate, &aiState); break;
-				case FSETTARGETTOFIRSTBLAHINPASSAGE: returncode = scr_set_TargetToBlahInPassage(pstate, &aiState); break;
-				case FIFLEVELUP:                     returncode = scr_LevelUp(pstate, &aiState); break;
-				case FGIVESKILLTOTARGET:             returncode = scr_add_TargetSkill(pstate, &aiState); break;
-				case FSETTARGETTONEARBYMELEEWEAPON:  returncode = scr_set_TargetToNearbyMeleeWeapon(pstate, &aiState); break;
-
-                    // if none of the above, skip the line and log an error
-                default:
-                    log_message( "SCRIPT ERROR: scr_run_function() - ai script \"%s\" - unhandled script function %d\n", pscript->name, valuecode );
-                    returncode = false;
-                    break;
+                Ego::Time::ClockScope<Ego::Time::ClockPolicy::NonRecursive> scope(*g_scriptFunctionClock);
+                returncode = function( pstate, &aiState );
             }
 
+            _script_function_calls[valuecode] += 1;
+            _script_function_times[valuecode] += g_scriptFunctionClock->lst();
+        }
+        else
+        {
+            returncode = function( pstate, &aiState );
         }
-
-        _script_function_calls[valuecode] += 1;
-        _script_function_times[valuecode] += g_scriptFunctionClock->lst();
     }
 
     return returncode;
@@ -843,7 +1233,7 @@ void scr_set_operand( script_state_t * pstate, Uint8 variable )
 }
 
 //--------------------------------------------------------------------------------------------
-void scr_run_operand( script_state_t * pstate, ai_state_t& aiState, script_info_t * pscript )
+void scr_run_operand( script_state_t * pstate, ai_state_t& aiState, const script_operand_t& operand, Object *pchr, Object *ptarget, Object *powner )
 {
     /// @author ZZ
     /// @details This function does the scripted arithmetic in OPERATOR, OPERAND pscriptrs
@@ -856,35 +1246,20 @@ void scr_run_operand( script_state_t * pstate, ai_state_t& aiState, script_info_
 
     Uint32 iTmp;
 
-    Object * pchr = NULL, * ptarget = NULL, * powner = NULL;
-
-	if (!_currentModule->getObjectHandler().exists(aiState.index)) return;
-	pchr = _currentModule->getObjectHandler().get(aiState.index);
-
-	if (_currentModule->getObjectHandler().exists(aiState.target))
-    {
-		ptarget = _currentModule->getObjectHandler().get(aiState.target);
-    }
-
-	if (_currentModule->getObjectHandler().exists(aiState.owner))
-    {
-		powner = _currentModule->getObjectHandler().get(aiState.owner);
-    }
-
     // get the operator
     iTmp      = 0;
     varname   = buffer;
-    operation = GET_DATA_BITS( pscript->data[pscript->position] );
-    if ( HAS_SOME_BITS( pscript->data[pscript->position], FUNCTION_BIT ) )
+    operation = operand.operation;
+    if ( operand.constant )
     {
         // Get the working opcode from a constant, constants are all but high 5 bits
-        iTmp = pscript->data[pscript->position] & VALUE_BITS;
+        iTmp = operand.value;
         if ( debug_scripts ) snprintf( buffer, SDL_arraysize( buffer ), "%d", iTmp );
     }
     else
     {
         // Get the variable opcode from a register
-        variable = pscript->data[pscript->position] & VALUE_BITS;
+        variable = operand.value;
 
         switch ( variable )
         {
@@ -1416,7 +1791,7 @@ void scr_run_operand( script_state_t * pstate, ai_state_t& aiState, script_info_
                 break;
 
             default:
-                log_message( "SCRIPT ERROR: scr_run_operand() - model == %d, class name == \"%s\" - Unknown variable found!\n", REF_TO_INT( script_error_model ), script_error_classname );
+                log_message( "SCRIPT ERROR: scr_run_operand() - model == %d, class name == \"%s\" - Unknown variable found!\n", REF_TO_INT( pchr->profile_ref ), pchr->getProfile()->getClassName().c_str() );
                 break;
         }
     }
@@ -1463,7 +1838,7 @@ void scr_run_operand( script_state_t * pstate, ai_state_t& aiState, script_info_
             }
             else
             {
-                log_message( "SCRIPT ERROR: scr_run_operand() - model == %d, class name == \"%s\" - Cannot divide by zero!\n", REF_TO_INT( script_error_model ), script_error_classname );
+                log_message( "SCRIPT ERROR: scr_run_operand() - model == %d, class name == \"%s\" - Cannot divide by zero!\n", REF_TO_INT( pchr->profile_ref ), pchr->getProfile()->getClassName().c_str() );
             }
             break;
 
@@ -1475,12 +1850,12 @@ void scr_run_operand( script_state_t * pstate, ai_state_t& aiState, script_info_
             }
             else
             {
-                log_message( "SCRIPT ERROR: scr_run_operand() - model == %d, class name == \"%s\" - Cannot modulo by zero!\n", REF_TO_INT( script_error_model ), script_error_classname );
+                log_message( "SCRIPT ERROR: scr_run_operand() - model == %d, class name == \"%s\" - Cannot modulo by zero!\n", REF_TO_INT( pchr->profile_ref ), pchr->getProfile()->getClassName().c_str() );
             }
             break;
 
         default:
-            log_message( "SCRIPT ERROR: scr_run_operand() - model == %d, class name == \"%s\" - unknown op\n", REF_TO_INT( script_error_model ), script_error_classname );
+            log_message( "SCRIPT ERROR: scr_run_operand() - model == %d, class name == \"%s\" - unknown op\n", REF_TO_INT( pchr->profile_ref ), pchr->getProfile()->getClassName().c_str() );
             break;
     }
 
@@ -1491,23 +1866,165 @@ void scr_run_operand( script_state_t * pstate, ai_state_t& aiState, script_info_
 }
 
 //--------------------------------------------------------------------------------------------
-bool scr_increment_pos( script_info_t * pscript )
+bool scr_can_trigger( const script_info_t& script, const ai_state_t& aiState )
 {
-    if ( NULL == pscript ) return false;
-    if ( pscript->position >= pscript->length ) return false;
+    if ( script.has_unconditional ) return true;
+    if ( HAS_SOME_BITS( aiState.alert, script.alert_sensitivity ) ) return true;
+
+    // same condition as IfTimeOut
+    if ( script.timer_sensitive && update_wld > aiState.timer ) return true;
+
+    return false;
+}
+
+//--------------------------------------------------------------------------------------------
+size_t scr_get_run_count()
+{
+    return _script_run_count;
+}
+
+size_t scr_get_skip_count()
+{
+    return _script_skip_count;
+}
+
+void scr_reset_run_counts()
+{
+    _script_run_count = 0;
+    _script_skip_count = 0;
+}
+
+//--------------------------------------------------------------------------------------------
+void scr_get_interpreter_stats( bool decoded, size_t& instructions, double& seconds )
+{
+    instructions = _script_interpreter_instructions[decoded ? 1 : 0];
+    seconds = _script_interpreter_times[decoded ? 1 : 0];
+}
+
+void scr_reset_interpreter_stats()
+{
+    for ( size_t i = 0; i < 2; ++i )
+    {
+        _script_interpreter_instructions[i] = 0;
+        _script_interpreter_times[i] = 0.0;
+    }
+}
+
+//--------------------------------------------------------------------------------------------
+Object *scr_get_object( const CHR_REF ichr )
+{
+    if ( !_currentModule->getObjectHandler().exists( ichr ) ) return NULL;
+
+    return _currentModule->getObjectHandler().get( ichr );
+}
 
-    pscript->position++;
+//--------------------------------------------------------------------------------------------
+bool scr_increment_pos( script_state_t * pstate, const script_info_t * pscript )
+{
+    if ( NULL == pstate || NULL == pscript ) return false;
+    if ( pstate->position >= pscript->length ) return false;
+
+    pstate->position++;
 
     return true;
 }
 
 //--------------------------------------------------------------------------------------------
-bool scr_set_pos( script_info_t * pscript, size_t position )
+bool scr_set_pos( script_state_t * pstate, const script_info_t * pscript, size_t position )
 {
-    if ( NULL == pscript ) return false;
+    if ( NULL == pstate || NULL == pscript ) return false;
     if ( position >= pscript->length ) return false;
 
-    pscript->position = position;
+    pstate->position = position;
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------
+bool scr_decode_script( script_info_t * pscript )
+{
+    /// @details Turn the compiled words into instructions which can be run without any decoding.
+    ///          Jump targets are converted from word positions into instruction indices.
+
+    static const size_t NO_INSTRUCTION = std::numeric_limits<size_t>::max();
+
+    if ( NULL == pscript ) return false;
+
+    // the function table is filled in here
+    scripting_system_begin();
+
+    pscript->instructions.clear();
+    pscript->operands.clear();
+
+    std::vector<size_t> instructionAt( pscript->length + 1, NO_INSTRUCTION );
+
+    size_t position = 0;
+    while ( position < pscript->length )
+    {
+        const Uint32 word = pscript->data[position];
+
+        // every instruction is followed by a jump or count word
+        if ( position + 1 >= pscript->length ) break;
+
+        script_instruction_t instruction;
+        instruction.isFunction    = HAS_SOME_BITS( word, FUNCTION_BIT );
+        instruction.indent        = GET_DATA_BITS( word );
+        instruction.code          = word & VALUE_BITS;
+        instruction.function      = nullptr;
+        instruction.jump          = pscript->data[position + 1];
+        instruction.operand_first = pscript->operands.size();
+        instruction.operand_count = 0;
+
+        instructionAt[position] = pscript->instructions.size();
+
+        if ( instruction.isFunction )
+        {
+            if ( instruction.code < SCRIPT_FUNCTIONS_COUNT )
+            {
+                instruction.function = _script_functions[instruction.code];
+            }
+            position += 2;
+        }
+        else
+        {
+            const size_t operand_count = pscript->data[position + 1];
+            position += 2;
+            for ( size_t i = 0; i < operand_count && position < pscript->length; ++i, ++position )
+            {
+                script_operand_t operand;
+                operand.operation = GET_DATA_BITS( pscript->data[position] );
+                operand.constant  = HAS_SOME_BITS( pscript->data[position], FUNCTION_BIT );
+                operand.value     = pscript->data[position] & VALUE_BITS;
+                pscript->operands.push_back( operand );
+                instruction.operand_count++;
+            }
+        }
+
+        pscript->instructions.push_back( instruction );
+    }
+    instructionAt[pscript->length] = pscript->instructions.size();
+
+    // resolve the jumps
+    for ( script_instruction_t& instruction : pscript->instructions )
+    {
+        if ( !instruction.isFunction ) continue;
+
+        if ( instruction.jump >= pscript->length )
+        {
+            instruction.jump = pscript->instructions.size();
+        }
+        else if ( NO_INSTRUCTION == instructionAt[instruction.jump] )
+        {
+            log_warning( "%s - ai script \"%s\" jumps into the middle of an instruction, it will not be pre-decoded\n", __FUNCTION__, pscript->name );
+            pscript->instructions.clear();
+            pscript->operands.clear();
+            return false;
+        }
+        else
+        {
+            instruction.jump = instructionAt[instruction.jump];
+        }
+    }
 
     return true;
 }
@@ -1836,4 +2353,8 @@ void script_state_init(script_state_t& self)
 	self.distance = 0;
 	self.argument = 0;
 	self.operationsum = 0;
+	self.position = 0;
+	self.indent = 0;
+	self.indent_last = 0;
+	self.timing = egoboo_config_t::get().debug_scripts_timing_enable.getValue();
 }
@@ -115,6 +115,35 @@ enum chr_alert_bits
 #   define STOR_AND            (STOR_COUNT - 1)        ///< Storage data bitmask
 #endif
 
+//--------------------------------------------------------------------------------------------
+// pre-decoded scripts
+//--------------------------------------------------------------------------------------------
+
+/// A script function (see game/script_functions.h)
+typedef Uint8 (*script_function_t)(script_state_t *pstate, ai_state_t *pself);
+
+/// A single operand of an arithmetic operation, decoded from a compiled word
+struct script_operand_t
+{
+    Uint8           operation;                       ///< OPADD, OPSUB, ...
+    bool            constant;                        ///< Is value a constant or a VAR* register?
+    Uint32          value;                           ///< The constant or the VAR* register
+};
+
+/// A single decoded instruction of a script.
+/// A function call carries its resolved function pointer and the instruction index to jump to
+/// if it fails, an operation carries its target register and a range in script_info_t::operands.
+struct script_instruction_t
+{
+    bool              isFunction;                    ///< Function call or arithmetic operation?
+    Uint32            indent;                        ///< Indentation of this instruction (used by Else)
+    Uint32            code;                          ///< The F* function code or the VAR* register
+    script_function_t function;                      ///< The function to call or nullptr
+    size_t            jump;                          ///< Instruction to go to if the function fails
+    size_t            operand_first;                 ///< Index of the first operand
+    size_t            operand_count;                 ///< Number of operands
+};
+
 //--------------------------------------------------------------------------------------------
 // struct script_info_t
 //--------------------------------------------------------------------------------------------
@@ -123,11 +152,13 @@ struct script_info_t
 public:
     script_info_t() :
         name(),
-        indent(0),
-        indent_last(0),
         length(0),
-        position(0),
-        data{}
+        data{},
+        instructions(),
+        operands(),
+        alert_sensitivity(ALERT_NONE),
+        timer_sensitive(false),
+        has_unconditional(true)
     {
         //ctor
     }
@@ -135,15 +166,58 @@ public:
 public:
     STRING          name;                            // Name of the script file
 
-    uint32_t        indent;
-    uint32_t        indent_last;
-
     uint32_t        length;                          // Actual length of the compiled ai buffer
-    size_t          position;                        // Our current position in the script
 
     uint32_t        data[MAXAICOMPILESIZE];          // Compiled script data
+
+    std::vector<script_instruction_t> instructions;  // Pre-decoded instructions (see scr_decode_script)
+    std::vector<script_operand_t>     operands;      // Pre-decoded operands of all operations
+
+    // What can trigger this script? Computed by the script compiler from the top level
+    // instructions: If all of them are alert or timer checks, the script can only do something
+    // if one of these alerts is set or if the timer ran out.
+    BIT_FIELD       alert_sensitivity;               // ALERTIF_* bits checked at the top level
+    bool            timer_sensitive;                 // IfTimeOut at the top level?
+    bool            has_unconditional;               // Any other code at the top level?
 };
 
+/**
+ * @brief
+ *  Can running this script have any effect for the given AI state?
+ * @return
+ *  @a false if the script only reacts to alerts and timers and none of them is set,
+ *  @a true otherwise
+ */
+bool scr_can_trigger(const script_info_t& script, const ai_state_t& aiState);
+
+/**
+ * @brief
+ *  Get the number of scripts which were run and skipped since the last call to
+ *  scr_reset_run_counts().
+ */
+size_t scr_get_run_count();
+size_t scr_get_skip_count();
+void scr_reset_run_counts();
+
+/**
+ * @brief
+ *  Get the number of instructions run and the time, in seconds, spent by the raw or the
+ *  pre-decoded interpreter since the last call to scr_reset_interpreter_stats().
+ * @remark
+ *  These are only measured if debug.scripts.timing.enable is set.
+ */
+void scr_get_interpreter_stats(bool decoded, size_t& instructions, double& seconds);
+void scr_reset_interpreter_stats();
+
+/**
+ * @brief
+ *  Decode the compiled words of a script into its instruction stream.
+ *  Must be called whenever script_info_t::data was (re-)compiled.
+ * @return
+ *  @a true on success, @a false if the compiled data was malformed
+ */
+bool scr_decode_script(script_info_t *pscript);
+
 //--------------------------------------------------------------------------------------------
 // struct ai_state_t
 //--------------------------------------------------------------------------------------------
@@ -212,7 +286,9 @@ void ai_state_spawn(ai_state_t *self, const CHR_REF index, const PRO_REF iobj, U
 //--------------------------------------------------------------------------------------------
 
 /// The state of the scripting system
-/// @details It is not persistent between one evaluation of a script and another
+/// @details It is not persistent between one evaluation of a script and another.
+///          It also holds the execution cursor, so a script_info_t is never modified while
+///          it is run and several objects sharing a profile may run the same script.
 struct script_state_t
 {
     int     x;
@@ -221,6 +297,12 @@ struct script_state_t
     int     distance;
     int     argument;
     int     operationsum;
+
+    size_t   position;          ///< Our current position in the script
+    uint32_t indent;            ///< Indentation of the current function
+    uint32_t indent_last;       ///< Indentation of the previous function (used by Else)
+
+    bool     timing;            ///< Measure the time spent in this run? (see debug.scripts.timing.enable)
 };
 
 void script_state_init(script_state_t& self);
@@ -232,6 +314,72 @@ void script_state_init(script_state_t& self);
 void scr_run_chr_script(Object *pchr);
 void scr_run_chr_script(const CHR_REF character);
 
+//--------------------------------------------------------------------------------------------
+// parallel think phase
+//--------------------------------------------------------------------------------------------
+
+/// A call of a script function with side effects, deferred to the commit of the think phase
+struct script_deferred_call_t
+{
+    script_function_t function;      ///< The function to call
+    script_state_t    state;         ///< The script state at the time of the call
+    ai_state_t        ai;            ///< The AI state at the time of the call
+};
+
+/// The outcome of running the script of an object in the parallel think phase
+struct script_think_result_t
+{
+    Object     *object;              ///< The object
+    ai_state_t  ai;                  ///< The new AI state of the object
+    size_t      call_first;          ///< Index of the first deferred call in script_think_buffer_t::calls
+    size_t      call_count;          ///< Number of deferred calls
+};
+
+/// The outcomes of one chunk of the parallel think phase
+struct script_think_buffer_t
+{
+    std::vector<script_think_result_t>  results;
+    std::vector<script_deferred_call_t> calls;
+    std::vector<Object *>               serial;   ///< Objects whose script must run in the serial phase
+    size_t                              runs;     ///< Number of scripts run
+    size_t                              skips;    ///< Number of scripts skipped (see scr_can_trigger)
+
+    script_think_buffer_t() : results(), calls(), serial(), runs(0), skips(0) {}
+    void clear();
+};
+
+/**
+ * @brief
+ *  Can the scripts run in the parallel think phase?
+ * @return
+ *  @a true if debug.scripts.parallel.enable and the pre-decoded scripts are enabled
+ *  and the scripts are neither timed nor debugged
+ */
+bool scr_can_think_parallel();
+
+/**
+ * @brief
+ *  Run the script of an object without changing any object.
+ *  This function may be called from a worker thread, the objects must not be modified concurrently.
+ * @details
+ *  The script runs on a copy of the AI state of the object. Functions with side effects nothing
+ *  in the script reads back are recorded as deferred calls. If the script calls a function with
+ *  other side effects or reads a random number, the run is discarded and the object is appended
+ *  to script_think_buffer_t::serial: Its script must be run by scr_run_chr_script() after the
+ *  buffers were committed.
+ */
+void scr_think_chr_script(Object *pchr, script_think_buffer_t& buffer);
+
+/**
+ * @brief
+ *  Commit the outcomes of a chunk of the parallel think phase in order:
+ *  Store the new AI states, make the deferred calls and set the latches.
+ * @remark
+ *  Deferred calls take effect after the parallel runs, so their effects can not be seen by
+ *  other scripts of the parallel phase in this update.
+ */
+void scr_commit_think_buffer(script_think_buffer_t& buffer);
+
 void issue_order( const CHR_REF character, Uint32 order );
 void issue_special_order( Uint32 order, IDSZ idsz );
 void set_alerts( const CHR_REF character );
@@ -0,0 +1,60 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+/// @file   egolib/VFS/DirectoryListing.cpp
+/// @brief  The names of the files in a directory of the virtual file system
+
+#include "egolib/VFS/DirectoryListing.hpp"
+#include "egolib/vfs.h"
+
+namespace Ego {
+namespace VFS {
+
+static std::string toLower(const std::string& string) {
+    std::string result = string;
+    std::transform(result.begin(), result.end(), result.begin(), [](char c) { return static_cast<char>(::tolower(static_cast<unsigned char>(c))); });
+    return result;
+}
+
+DirectoryListing::DirectoryListing(const std::string& directory)
+    : _directory(directory), _fileNames() {
+    char **list = vfs_enumerateFiles(directory.c_str());
+    if (!list) {
+        return;
+    }
+    for (char **name = list; nullptr != *name; ++name) {
+        _fileNames.insert(toLower(*name));
+    }
+    vfs_freeList(list);
+}
+
+const std::string& DirectoryListing::getDirectory() const {
+    return _directory;
+}
+
+bool DirectoryListing::contains(const std::string& fileName) const {
+    return _fileNames.end() != _fileNames.find(toLower(fileName));
+}
+
+size_t DirectoryListing::size() const {
+    return _fileNames.size();
+}
+
+} // namespace VFS
+} // namespace Ego
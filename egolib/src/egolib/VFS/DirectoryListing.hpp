@@ -0,0 +1,97 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+/// @file   egolib/VFS/DirectoryListing.hpp
+/// @brief  The names of the files in a directory of the virtual file system
+
+#pragma once
+
+#include "egolib/platform.h"
+
+namespace Ego {
+namespace VFS {
+
+/**
+ * @brief
+ *  The names of the files in a directory of the virtual file system.
+ *  The directory is enumerated once on construction, afterwards a loader can ask if a file
+ *  exists without touching the file system.
+ * @remark
+ *  The names are compared case-insensitively. On a case-sensitive file system a file might be
+ *  reported as present and fail to open, but a file which could be opened is never reported as
+ *  missing.
+ */
+struct DirectoryListing {
+
+private:
+
+    /**
+     * @brief
+     *  The pathname of the directory.
+     */
+    std::string _directory;
+
+    /**
+     * @brief
+     *  The lower-case names of the files in the directory.
+     */
+    std::unordered_set<std::string> _fileNames;
+
+public:
+
+    /**
+     * @brief
+     *  Construct this listing with the files of a directory.
+     * @param directory
+     *  the pathname of the directory
+     * @remark
+     *  If the directory does not exist, the listing is empty.
+     */
+    DirectoryListing(const std::string& directory);
+
+    /**
+     * @brief
+     *  Get the pathname of the directory.
+     * @return
+     *  the pathname of the directory
+     */
+    const std::string& getDirectory() const;
+
+    /**
+     * @brief
+     *  Get if the directory contains a file.
+     * @param fileName
+     *  the name of the file, without the directory
+     * @return
+     *  @a true if the directory contains the file, @a false otherwise
+     */
+    bool contains(const std::string& fileName) const;
+
+    /**
+     * @brief
+     *  Get the number of files in the directory.
+     * @return
+     *  the number of files in the directory
+     */
+    size_t size() const;
+
+};
+
+} // namespace VFS
+} // namespace Ego
@@ -0,0 +1,207 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+/// @file   egolib/VFS/FileCache.hpp
+/// @brief  A cache of values decoded from files of the virtual file system
+
+#pragma once
+
+#include "egolib/platform.h"
+#include "egolib/vfs.h"
+#include <mutex>
+
+namespace Ego {
+namespace VFS {
+
+/**
+ * @brief
+ *  A stamp of a file: its modification time and its size. A file is assumed not to have
+ *  changed if both are the same, e.g. a file copied over with its modification time kept
+ *  is still detected if its size changed.
+ */
+struct FileStamp {
+    /// The modification time in seconds since the epoch, see vfs_getLastModTime(), negative if unknown.
+    int64_t modificationTime;
+    /// The size in bytes, see vfs_getFileSize(), negative if unknown.
+    int64_t size;
+
+    /**
+     * @brief
+     *  Get the stamp of a file.
+     * @param pathname
+     *  the pathname of the file
+     */
+    static FileStamp of(const std::string& pathname) {
+        return FileStamp{ vfs_getLastModTime(pathname), vfs_getFileSize(pathname) };
+    }
+
+    /**
+     * @brief
+     *  Get the stamp of a value decoded from two files.
+     * @return
+     *  a stamp with the newer modification time and both sizes, which are assumed to be less than 4 GiB
+     */
+    static FileStamp combine(const FileStamp& first, const FileStamp& second) {
+        if (!first.isKnown() || !second.isKnown()) {
+            return FileStamp{ -1, -1 };
+        }
+        return FileStamp{ std::max(first.modificationTime, second.modificationTime), first.size ^ (second.size << 32) };
+    }
+
+    /// @return @a true if the modification time and the size are known
+    bool isKnown() const {
+        return modificationTime >= 0 && size >= 0;
+    }
+
+    bool operator==(const FileStamp& other) const {
+        return modificationTime == other.modificationTime && size == other.size;
+    }
+
+    bool operator!=(const FileStamp& other) const {
+        return !(*this == other);
+    }
+};
+
+/**
+ * @brief
+ *  A cache of values decoded from files, keyed by the pathname and the stamp of the files.
+ *  A value is decoded again if the stamp of its file has changed.
+ * @remark
+ *  This cache is thread-safe. The values are shared by all users and must not be modified.
+ */
+template <typename Type>
+class FileCache : public Id::NonCopyable {
+
+public:
+
+    /**
+     * @brief
+     *  Statistics about a cache.
+     */
+    struct Stats {
+        /// The number of values which were found in the cache.
+        size_t hits;
+        /// The number of values which were decoded.
+        size_t misses;
+        /// The number of values in the cache.
+        size_t size;
+    };
+
+private:
+
+    struct Entry {
+        FileStamp stamp;
+        std::shared_ptr<Type> value;
+        /// The generation in which the value was last got.
+        size_t generation;
+    };
+
+    mutable std::mutex _mutex;
+    std::unordered_map<std::string, Entry> _entries;
+    size_t _hits;
+    size_t _misses;
+    /// Incremented by removeUnused().
+    size_t _generation;
+
+public:
+
+    /**
+     * @brief
+     *  Construct this cache.
+     */
+    FileCache()
+        : _mutex(), _entries(), _hits(0), _misses(0), _generation(0) {
+    }
+
+    /**
+     * @brief
+     *  Get a value from this cache or decode it.
+     * @param pathname
+     *  the pathname of the file
+     * @param stamp
+     *  the stamp of the file. If the stamp is not known, the value is always decoded and not cached.
+     * @param decode
+     *  a function without arguments returning a std::shared_ptr<Type>, the decoded value or a null pointer.
+     *  It is called without holding the lock of this cache, so values can be decoded in parallel.
+     * @return
+     *  the value, a null pointer if decoding failed
+     * @remark
+     *  A null pointer is not cached.
+     */
+    template <typename Decode>
+    std::shared_ptr<Type> get(const std::string& pathname, const FileStamp& stamp, Decode decode) {
+        if (stamp.isKnown()) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto it = _entries.find(pathname);
+            if (it != _entries.end() && it->second.stamp == stamp) {
+                _hits++;
+                it->second.generation = _generation;
+                return it->second.value;
+            }
+        }
+        std::shared_ptr<Type> value = decode();
+        std::lock_guard<std::mutex> lock(_mutex);
+        _misses++;
+        if (value && stamp.isKnown()) {
+            _entries[pathname] = Entry{ stamp, value, _generation };
+        } else {
+            _entries.erase(pathname);
+        }
+        return value;
+    }
+
+    /**
+     * @brief
+     *  Remove the values which were not got since the last call to this function,
+     *  e.g. after a module was loaded to keep only the values used by that module.
+     */
+    void removeUnused() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (auto it = _entries.begin(); it != _entries.end();) {
+            if (it->second.generation != _generation) {
+                it = _entries.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        _generation++;
+    }
+
+    /**
+     * @brief
+     *  Remove all values from this cache.
+     */
+    void clear() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _entries.clear();
+    }
+
+    /**
+     * @brief
+     *  Get the statistics of this cache.
+     */
+    Stats getStats() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return Stats{ _hits, _misses, _entries.size() };
+    }
+
+};
+
+} // namespace VFS
+} // namespace Ego
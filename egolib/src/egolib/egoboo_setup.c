@@ -24,6 +24,7 @@
 #include "egolib/egoboo_setup.h"
 
 #include "egolib/_math.h"
+#include "egolib/AI/AStar.h"
 #include "game/Graphics/Camera.hpp"
 #include "game/renderer_2d.h"
 
@@ -84,6 +85,7 @@ egoboo_config_t::egoboo_config_t() :
     graphic_simultaneousDynamicLights_max(32, "graphic.simultaneousDynamicLights.max", "inclusive upper bound of simultaneous dynamic lights"),
     graphic_framesPerSecond_max(30, "graphic.framesPerSecond.max", "inclusive upper bound of frames per second"),
     graphic_simultaneousParticles_max(768, "graphic.simultaneousParticles.max", "inclusive upper bound of simultaneous particles"),
+    graphic_textureUpload_budget(4096, "graphic.textureUpload.budget", "inclusive upper bound of the kilobytes of streamed textures uploaded per frame"),
     // Sound configuration section.
     sound_effects_enable(true, "sound.effects.enable", "enable/disable effects"),
     sound_effects_volume(90, "sound.effects.volume", "effects volume"),
@@ -108,6 +110,7 @@ egoboo_config_t::egoboo_config_t() :
         { "Normal", Ego::GameDifficulty::Normal },
         { "Hard", Ego::GameDifficulty::Hard },
     }),
+    game_pathfinding_nodeBudget(DEFAULT_ASTAR_NODE_BUDGET, "game.pathfinding.nodeBudget", "inclusive upper bound of the nodes a pathfinding search may explore"),
     // Camera configuration section.
     camera_control(CameraTurnMode::Auto, "camera.control", "type of camera control",
     {
@@ -132,7 +135,23 @@ egoboo_config_t::egoboo_config_t() :
     debug_hideMouse(true,"debug.hideMouse","show/hide mouse"),
     debug_grabMouse(true,"debug.grabMouse","grab/don't grab mouse"),
     debug_developerMode_enable(false,"debug.developerMode.enable","enable/disable developer mode"),
-    debug_sdlImage_enable(true,"debug.SDL_Image.enable","enable/disable advanced SDL_image function")
+    debug_sdlImage_enable(true,"debug.SDL_Image.enable","enable/disable advanced SDL_image function"),
+    debug_scripts_predecoded_enable(true,"debug.scripts.predecoded.enable","enable/disable running AI scripts from pre-decoded instructions"),
+    debug_scripts_timing_enable(false,"debug.scripts.timing.enable","enable/disable measuring the time spent in AI script functions and interpreters"),
+    debug_scripts_parallel_enable(true,"debug.scripts.parallel.enable","enable/disable running the AI scripts in a parallel think phase"),
+    debug_collision_broadPhase(Ego::CollisionBroadPhase::Tree, "debug.collision.broadPhase", "data structure used to find potential collisions",
+    {
+        { "Tree",          Ego::CollisionBroadPhase::Tree },
+        { "SweepAndPrune", Ego::CollisionBroadPhase::SweepAndPrune },
+    }),
+    debug_textFiles_inMemory_enable(true,"debug.textFiles.inMemory.enable","enable/disable reading text files into memory before parsing them"),
+    debug_inputRecording_mode(Ego::InputRecording::Off, "debug.inputRecording.mode", "record the input of the players or replay a recording",
+    {
+        { "Off",    Ego::InputRecording::Off },
+        { "Record", Ego::InputRecording::Record },
+        { "Replay", Ego::InputRecording::Replay },
+    }),
+    debug_inputRecording_file("/debug/input.rec", "debug.inputRecording.file", "virtual pathname of the input recording")
 {}
 
 egoboo_config_t::~egoboo_config_t()
@@ -167,6 +186,7 @@ egoboo_config_t& egoboo_config_t::operator=(const egoboo_config_t& other)
     graphic_simultaneousDynamicLights_max = other.graphic_simultaneousDynamicLights_max;
     graphic_framesPerSecond_max = other.graphic_framesPerSecond_max;
     graphic_simultaneousParticles_max = other.graphic_simultaneousParticles_max;
+    graphic_textureUpload_budget = other.graphic_textureUpload_budget;
 
     // Sound configuration section.
     sound_effects_enable = other.sound_effects_enable;
@@ -190,6 +210,7 @@ egoboo_config_t& egoboo_config_t::operator=(const egoboo_config_t& other)
 
     // Game configuration section.
     game_difficulty = other.game_difficulty;
+    game_pathfinding_nodeBudget = other.game_pathfinding_nodeBudget;
     
     // HUD configuration section.
     hud_displayGameTime = other.hud_displayGameTime;
@@ -205,6 +226,13 @@ egoboo_config_t& egoboo_config_t::operator=(const egoboo_config_t& other)
     debug_grabMouse = other.debug_grabMouse;
     debug_developerMode_enable = other.debug_developerMode_enable;
     debug_sdlImage_enable = other.debug_sdlImage_enable;
+    debug_scripts_predecoded_enable = other.debug_scripts_predecoded_enable;
+    debug_scripts_timing_enable = other.debug_scripts_timing_enable;
+    debug_scripts_parallel_enable = other.debug_scripts_parallel_enable;
+    debug_collision_broadPhase = other.debug_collision_broadPhase;
+    debug_textFiles_inMemory_enable = other.debug_textFiles_inMemory_enable;
+    debug_inputRecording_mode = other.debug_inputRecording_mode;
+    debug_inputRecording_file = other.debug_inputRecording_file;
 
     return *this;
 }
@@ -68,6 +68,32 @@ namespace Ego
 
 }
 
+namespace Ego
+{
+    // The data structures for finding potential collisions.
+    enum class CollisionBroadPhase
+    {
+        // Query the character and particle BSP trees.
+        Tree = 0,
+        // Sweep persistent endpoint lists sorted along the x-axis for overlapping pairs.
+        SweepAndPrune,
+    };
+}
+
+namespace Ego
+{
+    // Recording and replaying the input of the players.
+    enum class InputRecording
+    {
+        // Neither record nor replay.
+        Off = 0,
+        // Record the input of every module played.
+        Record,
+        // Replay a recording instead of reading the input devices.
+        Replay,
+    };
+}
+
 namespace Ego
 {
 namespace Configuration
@@ -534,6 +560,7 @@ public:
             graphic_simultaneousDynamicLights_max,
             graphic_framesPerSecond_max,
             graphic_simultaneousParticles_max,
+            graphic_textureUpload_budget,
             //
             sound_effects_enable,
             sound_effects_volume,
@@ -550,6 +577,7 @@ public:
             network_playerName,
             //
             game_difficulty,
+            game_pathfinding_nodeBudget,
             //
             camera_control,
             //
@@ -564,7 +592,14 @@ public:
             debug_hideMouse,
             debug_grabMouse,
             debug_developerMode_enable,
-            debug_sdlImage_enable
+            debug_sdlImage_enable,
+            debug_scripts_predecoded_enable,
+            debug_scripts_timing_enable,
+            debug_scripts_parallel_enable,
+            debug_collision_broadPhase,
+            debug_textFiles_inMemory_enable,
+            debug_inputRecording_mode,
+            debug_inputRecording_file
             );
         for_each(variables, f);
     }
@@ -795,6 +830,14 @@ public:
      */
     StandardVariable<uint16_t> graphic_simultaneousParticles_max;
 
+    /**
+     * @brief
+     *  Inclusive upper bound of the kilobytes of streamed textures uploaded per frame.
+     * @remark
+     *  Default value is @a 4096.
+     */
+    StandardVariable<uint16_t> graphic_textureUpload_budget;
+
     // Sound configuration section.
 
     /**
@@ -935,6 +978,14 @@ public:
      */
     EnumVariable<Ego::GameDifficulty> game_difficulty;
 
+    /**
+     * @brief
+     *  Inclusive upper bound of the nodes a pathfinding search may explore before it fails.
+     * @remark
+     *  Default value is @a 4096.
+     */
+    StandardVariable<uint32_t> game_pathfinding_nodeBudget;
+
     // HUD configuration section.
 
     /**
@@ -1032,6 +1083,67 @@ public:
      */
     StandardVariable<bool> debug_sdlImage_enable;
 
+    /**
+     * @brief
+     *  Enable/disable running AI scripts from their pre-decoded instruction stream.
+     *  If disabled, the raw compiled words are interpreted (slower, for comparison).
+     * @remark
+     *  Default value is @a true.
+     */
+    StandardVariable<bool> debug_scripts_predecoded_enable;
+
+    /**
+     * @brief
+     *  Enable/disable measuring the time spent in AI script functions and interpreters.
+     *  The times are written to <tt>/debug/script_function_timing.txt</tt>.
+     * @remark
+     *  Default value is @a false.
+     */
+    StandardVariable<bool> debug_scripts_timing_enable;
+
+    /**
+     * @brief
+     *  Enable/disable running the AI scripts in a parallel think phase.
+     *  Scripts which call functions with side effects on other objects fall back to the serial phase.
+     *  The parallel phase is not used while timing or debugging scripts.
+     * @remark
+     *  Default value is @a true.
+     */
+    StandardVariable<bool> debug_scripts_parallel_enable;
+
+    /**
+     * @brief
+     *  The data structure used to find potential collisions.
+     * @remark
+     *  Default value is @a Ego::CollisionBroadPhase::Tree.
+     */
+    EnumVariable<Ego::CollisionBroadPhase> debug_collision_broadPhase;
+
+    /**
+     * @brief
+     *  Enable/disable reading text files (e.g. <tt>data.txt</tt>) into memory as a whole before parsing them.
+     *  If disabled, the parsers read one Byte at a time from the file (slower, for comparison).
+     * @remark
+     *  Default value is @a true.
+     */
+    StandardVariable<bool> debug_textFiles_inMemory_enable;
+
+    /**
+     * @brief
+     *  Record the input of the players or replay a recording, see game/replay.h.
+     * @remark
+     *  Default value is @a Ego::InputRecording::Off.
+     */
+    EnumVariable<Ego::InputRecording> debug_inputRecording_mode;
+
+    /**
+     * @brief
+     *  The virtual pathname of the recording.
+     * @remark
+     *  Default value is @a "/debug/input.rec".
+     */
+    StandardVariable<std::string> debug_inputRecording_file;
+
 public:
 
     /**
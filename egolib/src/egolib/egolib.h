@@ -84,6 +84,7 @@
 #include "egolib/FileFormats/id_md2.h"
 #include "egolib/FileFormats/map_file.h"
 #include "egolib/FileFormats/map_tile_dictionary.h"
+#include "egolib/FileFormats/module_bundle_file.h"
 #include "egolib/FileFormats/quest_file.h"
 #include "egolib/FileFormats/scancode_file.h"
 #include "egolib/FileFormats/spawn_file.h"
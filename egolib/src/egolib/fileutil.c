@@ -35,11 +35,19 @@
 //--------------------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------------------
 
+/// Get how a ReadContext reads its file.
+static Ego::Script::TextInputFile<ReadContext::Traits>::Access getReadContextAccess()
+{
+    return egoboo_config_t::get().debug_textFiles_inMemory_enable.getValue()
+         ? Ego::Script::TextInputFile<ReadContext::Traits>::Access::Memory
+         : Ego::Script::TextInputFile<ReadContext::Traits>::Access::Stream;
+}
+
 ReadContext::ReadContext(const std::string& loadName) :
     AbstractReader(5012),
     _loadName(loadName)
 {
-    _source = std::make_shared<Ego::Script::TextInputFile<Traits>>(loadName);
+    _source = std::make_shared<Ego::Script::TextInputFile<Traits>>(loadName, getReadContextAccess());
 }
 
 ReadContext::~ReadContext()
@@ -100,7 +108,7 @@ bool ReadContext::ensureOpen()
 {
     if (!_source || !_source->isOpen())
     {
-        _source = std::make_shared<Ego::Script::TextInputFile<Traits>>(_loadName);
+        _source = std::make_shared<Ego::Script::TextInputFile<Traits>>(_loadName, getReadContextAccess());
         _lineNumber = 1;
     }
     return _source->isOpen();
@@ -1617,20 +1625,22 @@ bool vfs_get_next_bool(ReadContext& ctxt) {
 
 //--------------------------------------------------------------------------------------------
 
-Uint32  ego_texture_load_vfs(oglx_texture_t *texture, const char *filename, Uint32 key)
+std::shared_ptr<SDL_Surface> ego_image_load_vfs(const char *filename, std::string& fullFilename, const Ego::VFS::DirectoryListing *listing)
 {
-    // Get rid of any old data.
-    texture->release();
-
-    // Load the image.
-    GLuint retval = INVALID_GL_ID;
+    // The name of the image within its directory.
+    const char *baseName = strrchr(filename, '/');
+    baseName = (nullptr == baseName) ? filename : baseName + 1;
 
     // Try all different formats.
     for (const auto& loader : ImageManager::get())
     {
-        texture->release();
+        // Skip formats which are not in the directory.
+        if (listing && !listing->contains(baseName + loader.getExtension()))
+        {
+            continue;
+        }
         // Build the full file name.
-        std::string fullFilename = filename + loader.getExtension();
+        fullFilename = filename + loader.getExtension();
         // Open the file.
         vfs_FILE *file = vfs_openRead(fullFilename);
         if (!file)
@@ -1649,19 +1659,32 @@ Uint32  ego_texture_load_vfs(oglx_texture_t *texture, const char *filename, Uint
             continue;
         }
         vfs_close(file);
-        if (!surface)
+        if (surface)
         {
-            continue;
-        }
-        // Create the texture from the surface.
-        retval = texture->load(fullFilename.c_str(), surface, key);
-        if (INVALID_GL_ID != retval)
-        {
-            break;
+            return surface;
         }
     }
 
-    return retval;
+    fullFilename.clear();
+    return nullptr;
+}
+
+//--------------------------------------------------------------------------------------------
+Uint32  ego_texture_load_vfs(oglx_texture_t *texture, const char *filename, Uint32 key, const Ego::VFS::DirectoryListing *listing)
+{
+    // Get rid of any old data.
+    texture->release();
+
+    // Load the image.
+    std::string fullFilename;
+    std::shared_ptr<SDL_Surface> surface = ego_image_load_vfs(filename, fullFilename, listing);
+    if (!surface)
+    {
+        return INVALID_GL_ID;
+    }
+
+    // Create the texture from the surface.
+    return texture->load(fullFilename.c_str(), surface, key);
 }
 
 //--------------------------------------------------------------------------------------------
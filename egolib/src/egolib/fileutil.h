@@ -32,6 +32,7 @@
 #include "egolib/Logic/Gender.hpp"
 #include "egolib/Profiles/LocalParticleProfileRef.hpp"
 #include "egolib/Renderer/Renderer.hpp"
+#include "egolib/VFS/DirectoryListing.hpp"
 
 //--------------------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------------------
@@ -467,6 +468,24 @@ bool copy_line_vfs(vfs_FILE * fileread, vfs_FILE * filewrite);
 char vfs_get_first_letter(ReadContext& ctxt);
 char * copy_to_delimiter_mem(char * pmem, char * pmem_end, vfs_FILE * filewrite, int delim, char * user_buffer, size_t user_buffer_len);
 bool copy_to_delimiter_vfs(vfs_FILE * fileread, vfs_FILE * filewrite, int delim, char * buffer, size_t bufflen);
+/**
+ * @brief
+ *  Load an image.
+ * @param filename
+ *  the filename of the image <em>without</em> extension.
+ * @param [out] fullFilename
+ *  the filename of the image <em>with</em> extension if loading succeeds, the empty string otherwise
+ * @param listing
+ *  if not a null pointer, the listing of the directory of the image.
+ *  Extensions of files which are not in the listing are skipped without opening them.
+ * @return
+ *  the image on success, a null pointer on failure
+ * @remark
+ *  The extensions are tried in the same order as by ego_texture_load_vfs().
+ *  This function does not touch the graphics system and may be called from a worker thread.
+ */
+std::shared_ptr<SDL_Surface> ego_image_load_vfs(const char *filename, std::string& fullFilename, const Ego::VFS::DirectoryListing *listing = nullptr);
+
 /**
  * @brief
  *  Load an image into a texture.
@@ -482,8 +501,11 @@ bool copy_to_delimiter_vfs(vfs_FILE * fileread, vfs_FILE * filewrite, int delim,
  *  filename concatenated with supported file extensions until one combination
  *  succeeds (i.e. the image was successfully loaded into the texture) or all
  *  combinations failed.
+ * @param listing
+ *  if not a null pointer, the listing of the directory of the image.
+ *  Combinations which are not in the listing are skipped without opening them.
  */
-Uint32 ego_texture_load_vfs(oglx_texture_t *texture, const char *filename, Uint32 key = INVALID_KEY);
+Uint32 ego_texture_load_vfs(oglx_texture_t *texture, const char *filename, Uint32 key = INVALID_KEY, const Ego::VFS::DirectoryListing *listing = nullptr);
 
 /* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 // Stuff to encapsulte in a WriterContext.
@@ -29,6 +29,8 @@
 #include "egolib/platform.h"
 #include "egolib/vfs.h"
 
+#include <mutex>
+
 #ifdef __WINDOWS__
 #include <windows.h>
 #endif
@@ -39,6 +41,7 @@ static vfs_FILE *logFile = nullptr;             ///< Log file.
 static LogLevel _logLevel = LOG_WARNING;        ///< Default log level.
 
 static bool _atexit_registered = false;
+static std::mutex _logMutex;                   ///< Keeps messages from worker threads apart.
 
 enum ConsoleColor
 {
@@ -110,6 +113,7 @@ static void setConsoleColor(ConsoleColor color)
 static void writeLogMessage(LogLevel logLevel, const char *format, va_list args)
 {
     char logBuffer[MAX_LOG_MESSAGE] = EMPTY_CSTR;
+    std::lock_guard<std::mutex> lock(_logMutex);
 
     // Add prefix
     const char *prefix;
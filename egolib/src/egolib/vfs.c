@@ -21,6 +21,7 @@
 /// @brief Implementation of the Egoboo virtual file system
 /// @details
 
+#include <atomic>
 #include <physfs.h>
 
 #include "egolib/vfs.h"
@@ -71,6 +72,9 @@ typedef char VFS_PATH[VFS_MAX_PATH];
 
 #define MAX_MOUNTINFO 128
 
+/// The size of the read-ahead buffer of a PhysFS file opened for reading
+#define VFS_READ_BUFFER_SIZE 4096
+
 /// The following flags set in vfs_file::flags provide information about the state of a file.
 typedef enum vfs_file_flags
 {
@@ -105,12 +109,25 @@ typedef union vfs_fileptr_t
     PHYSFS_File *p;
 } vfs_file_ptr_t;
 
+/// A read-ahead buffer for a PhysFS file opened for reading.
+/// The buffer holds the bytes [start, start + size) of the file, so the position of the PhysFS file is always start + size.
+typedef struct vfs_read_buffer_t
+{
+    unsigned char data[VFS_READ_BUFFER_SIZE];
+    PHYSFS_sint64 start;          ///< The offset in the file of the first byte in data
+    size_t size;                  ///< The number of bytes in data
+    size_t position;              ///< The index of the next byte to read in data
+    bool has_unget;               ///< Was a byte pushed back which is not the byte before position?
+    unsigned char unget;          ///< The byte pushed back
+} vfs_read_buffer_t;
+
 /// A container holding either a FILE * or a PHYSFS_File *, and translated error states
 struct vsf_file
 {
     BIT_FIELD flags;
     vfs_file_type type;
     vfs_fileptr_t ptr;
+    vfs_read_buffer_t buffer;     ///< Only used by PhysFS files opened for reading
 };
 
 /// A container for holding all the data for a search
@@ -145,6 +162,9 @@ static bool _vfs_atexit_registered = false;
 
 static bool _vfs_initialized = false;
 
+/// The number of files which could not be opened for reading.
+static std::atomic<size_t> _vfs_failed_open_count(0);
+
 //--------------------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------------------
 //static int _vfs_vfscanf(FILE * file, const char * format, va_list args);
@@ -157,6 +177,15 @@ static int _vfs_ensure_write_directory(const char *filename, bool is_directory);
 
 static void _vfs_translate_error(vfs_FILE *file);
 
+static bool _vfs_buffer_isUsed(const vfs_FILE *file);
+static size_t _vfs_buffer_pending(const vfs_FILE *file);
+static int _vfs_buffer_fill(vfs_FILE *file);
+static PHYSFS_sint64 _vfs_buffer_read(vfs_FILE *file, void *buffer, size_t size, size_t count);
+static int _vfs_buffer_getc(vfs_FILE *file);
+static int _vfs_buffer_ungetc(vfs_FILE *file, int c);
+static PHYSFS_sint64 _vfs_buffer_tell(vfs_FILE *file);
+static int _vfs_buffer_seek(vfs_FILE *file, PHYSFS_sint64 offset);
+
 static bool _vfs_mount_info_add(const char *mount_point, const char *root_path, const char *relative_path);
 static int _vfs_mount_info_matches(const char *mount_point, const char *local_path);
 static bool _vfs_mount_info_remove(int cnt);
@@ -290,6 +319,7 @@ vfs_FILE *vfs_openRead(const std::string& pathname)
     PHYSFS_File *ftmp = PHYSFS_openRead(temporary.c_str());
     if (!ftmp)
     {
+        _vfs_failed_open_count++;
     #if defined(_DEBUG) && defined(_VFS_DEBUG)
         log_warning("unable to open file `%s` for reading - reason: %s\n", pathname.c_str(), PHYSFS_getLastError());
     #endif
@@ -777,6 +807,196 @@ bool _vfs_ensure_destination_file(const char * filename)
 }
 #endif
 
+//--------------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------------
+bool _vfs_buffer_isUsed(const vfs_FILE *file)
+{
+    return VFS_FILE_TYPE_PHYSFS == file->type && 0 != (file->flags & VFS_FILE_FLAG_READING);
+}
+
+size_t _vfs_buffer_pending(const vfs_FILE *file)
+{
+    if (!_vfs_buffer_isUsed(file))
+    {
+        return 0;
+    }
+    return (file->buffer.size - file->buffer.position) + (file->buffer.has_unget ? 1 : 0);
+}
+
+int _vfs_buffer_fill(vfs_FILE *file)
+{
+    /// @details Read the next block of the file if all buffered bytes were read.
+    ///          Returns 1 on success, 0 at the end of the file and -1 on an error.
+
+    vfs_read_buffer_t *buffer = &(file->buffer);
+    if (buffer->position < buffer->size)
+    {
+        return 1;
+    }
+
+    buffer->start += buffer->size;
+    buffer->size = 0;
+    buffer->position = 0;
+
+    PHYSFS_sint64 length = PHYSFS_read(file->ptr.p, buffer->data, 1, VFS_READ_BUFFER_SIZE);
+    if (length < 0)
+    {
+        file->flags |= VFS_FILE_FLAG_ERROR;
+        return -1;
+    }
+    if (0 == length)
+    {
+        file->flags |= VFS_FILE_FLAG_EOF;
+        return 0;
+    }
+    buffer->size = (size_t)length;
+
+    return 1;
+}
+
+PHYSFS_sint64 _vfs_buffer_read(vfs_FILE *file, void *buffer, size_t size, size_t count)
+{
+    /// @details Same as PHYSFS_read(), but reads through the buffer of the file.
+
+    if (!_vfs_buffer_isUsed(file))
+    {
+        return PHYSFS_read(file->ptr.p, buffer, size, count);
+    }
+
+    vfs_read_buffer_t *rbuf = &(file->buffer);
+    unsigned char *dst = (unsigned char *)buffer;
+    size_t total = size * count, copied = 0;
+
+    if (total > 0 && rbuf->has_unget)
+    {
+        dst[copied++] = rbuf->unget;
+        rbuf->has_unget = false;
+    }
+
+    while (copied < total)
+    {
+        size_t available = rbuf->size - rbuf->position;
+        if (0 == available)
+        {
+            // read large blocks directly instead of copying them through the buffer
+            if (total - copied >= VFS_READ_BUFFER_SIZE)
+            {
+                rbuf->start += rbuf->size;
+                rbuf->size = 0;
+                rbuf->position = 0;
+
+                size_t wanted = total - copied;
+                PHYSFS_sint64 length = PHYSFS_read(file->ptr.p, dst + copied, 1, wanted);
+                if (length < 0)
+                {
+                    file->flags |= VFS_FILE_FLAG_ERROR;
+                    return -1;
+                }
+                rbuf->start += length;
+                copied += (size_t)length;
+                if ((size_t)length < wanted)
+                {
+                    file->flags |= VFS_FILE_FLAG_EOF;
+                }
+                break;
+            }
+
+            int filled = _vfs_buffer_fill(file);
+            if (filled < 0) return -1;
+            if (0 == filled) break;
+            available = rbuf->size;
+        }
+
+        size_t length = std::min(available, total - copied);
+        memcpy(dst + copied, rbuf->data + rbuf->position, length);
+        rbuf->position += length;
+        copied += length;
+    }
+
+    return (0 == size) ? 0 : (PHYSFS_sint64)(copied / size);
+}
+
+int _vfs_buffer_getc(vfs_FILE *file)
+{
+    vfs_read_buffer_t *buffer = &(file->buffer);
+
+    if (buffer->has_unget)
+    {
+        buffer->has_unget = false;
+        return buffer->unget;
+    }
+    if (buffer->position == buffer->size && _vfs_buffer_fill(file) <= 0)
+    {
+        return EOF;
+    }
+    return buffer->data[buffer->position++];
+}
+
+int _vfs_buffer_ungetc(vfs_FILE *file, int c)
+{
+    /// @details Push back one byte. The byte before the read position is just re-used if it is the
+    ///          same byte, so pushing back the byte just read never needs the unget slot.
+
+    vfs_read_buffer_t *buffer = &(file->buffer);
+
+    if (EOF == c || buffer->has_unget)
+    {
+        return EOF;
+    }
+
+    unsigned char ch = (unsigned char)c;
+    if (buffer->position > 0 && buffer->data[buffer->position - 1] == ch)
+    {
+        buffer->position--;
+    }
+    else
+    {
+        buffer->unget = ch;
+        buffer->has_unget = true;
+    }
+    file->flags &= ~VFS_FILE_FLAG_EOF;
+
+    return ch;
+}
+
+PHYSFS_sint64 _vfs_buffer_tell(vfs_FILE *file)
+{
+    if (!_vfs_buffer_isUsed(file))
+    {
+        return PHYSFS_tell(file->ptr.p);
+    }
+    return file->buffer.start + (PHYSFS_sint64)file->buffer.position - (file->buffer.has_unget ? 1 : 0);
+}
+
+int _vfs_buffer_seek(vfs_FILE *file, PHYSFS_sint64 offset)
+{
+    /// @details Same as PHYSFS_seek(). A seek into the buffered bytes does not touch the PhysFS file.
+
+    if (!_vfs_buffer_isUsed(file))
+    {
+        return PHYSFS_seek(file->ptr.p, offset);
+    }
+
+    vfs_read_buffer_t *buffer = &(file->buffer);
+    buffer->has_unget = false;
+    if (offset >= buffer->start && offset <= buffer->start + (PHYSFS_sint64)buffer->size)
+    {
+        buffer->position = (size_t)(offset - buffer->start);
+        return 1;
+    }
+
+    if (0 == PHYSFS_seek(file->ptr.p, offset))
+    {
+        return 0;
+    }
+    buffer->start = offset;
+    buffer->size = 0;
+    buffer->position = 0;
+
+    return 1;
+}
+
+//--------------------------------------------------------------------------------------------
 int vfs_isReading(vfs_FILE *file)
 {
     if (!file)
@@ -873,7 +1093,8 @@ int vfs_eof( vfs_FILE * pfile )
     }
     else if ( VFS_FILE_TYPE_PHYSFS == pfile->type )
     {
-        retval = PHYSFS_eof( pfile->ptr.p );
+        // the end of the PhysFS file is not the end if there are buffered bytes left
+        retval = ( 0 == _vfs_buffer_pending( pfile ) ) ? PHYSFS_eof( pfile->ptr.p ) : 0;
     }
 
     if ( 0 != retval )
@@ -923,7 +1144,7 @@ long vfs_tell( vfs_FILE * pfile )
     }
     else if ( VFS_FILE_TYPE_PHYSFS == pfile->type )
     {
-        retval = PHYSFS_tell( pfile->ptr.p );
+        retval = _vfs_buffer_tell( pfile );
     }
 
     return retval;
@@ -952,8 +1173,9 @@ int vfs_seek( vfs_FILE * pfile, long offset )
         // reset the flags
         pfile->flags &= ~(VFS_FILE_FLAG_EOF | VFS_FILE_FLAG_ERROR);
 
-        retval = PHYSFS_seek( pfile->ptr.p, offset );
-        if (retval == 0) pfile->flags &= ~VFS_FILE_FLAG_ERROR;
+        // PHYSFS_seek() returns non-zero on success
+        retval = _vfs_buffer_seek( pfile, offset );
+        if (retval != 0) pfile->flags &= ~VFS_FILE_FLAG_ERROR;
         else             pfile->flags |= VFS_FILE_FLAG_ERROR;
     }
 
@@ -1047,6 +1269,30 @@ bool vfs_isDirectory(const std::string& pathname) {
     return 0 != PHYSFS_isDirectory(temporary.c_str());
 }
 
+int64_t vfs_getLastModTime(const std::string& pathname) {
+    BAIL_IF_NOT_INIT();
+    std::string temporary;
+    if (!validate(pathname, temporary)) {
+        return -1;
+    }
+    return PHYSFS_getLastModTime(temporary.c_str());
+}
+
+int64_t vfs_getFileSize(const std::string& pathname) {
+    BAIL_IF_NOT_INIT();
+    std::string temporary;
+    if (!validate(pathname, temporary)) {
+        return -1;
+    }
+    PHYSFS_File *file = PHYSFS_openRead(temporary.c_str());
+    if (!file) {
+        return -1;
+    }
+    int64_t size = PHYSFS_fileLength(file);
+    PHYSFS_close(file);
+    return size;
+}
+
 //--------------------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------------------
 size_t vfs_read( void * buffer, size_t size, size_t count, vfs_FILE * pfile )
@@ -1067,7 +1313,7 @@ size_t vfs_read( void * buffer, size_t size, size_t count, vfs_FILE * pfile )
     else if ( VFS_FILE_TYPE_PHYSFS == pfile->type )
     {
         pfile->flags &= ~VFS_FILE_FLAG_ERROR;
-        PHYSFS_sint64 retval = PHYSFS_read( pfile->ptr.p, buffer, size, count );
+        PHYSFS_sint64 retval = _vfs_buffer_read( pfile, buffer, size, count );
 
         if ( retval < 0 ) { error = true; pfile->flags |= VFS_FILE_FLAG_ERROR; }
 
@@ -1128,7 +1374,7 @@ int vfs_read_Sint8( vfs_FILE * pfile, Sint8 * val )
     }
     else if ( VFS_FILE_TYPE_PHYSFS == pfile->type )
     {
-        retval = PHYSFS_read(pfile->ptr.p, val, 1, sizeof(Sint8));
+        retval = _vfs_buffer_read(pfile, val, 1, sizeof(Sint8));
         
         error = ( 1 != retval );
         
@@ -1160,7 +1406,7 @@ int vfs_read_Uint8( vfs_FILE * pfile, Uint8 * val )
     }
     else if ( VFS_FILE_TYPE_PHYSFS == pfile->type )
     {
-        retval = PHYSFS_read(pfile->ptr.p, val, 1, sizeof(Sint8));
+        retval = _vfs_buffer_read(pfile, val, 1, sizeof(Sint8));
         
         error = ( 1 != retval );
         
@@ -1195,7 +1441,9 @@ int vfs_read_Sint16( vfs_FILE * pfile, Sint16 * val )
     }
     else if ( VFS_FILE_TYPE_PHYSFS == pfile->type )
     {
-        retval = PHYSFS_readSLE16( pfile->ptr.p, val );
+        Sint16 itmp;
+        retval = ( 1 == _vfs_buffer_read( pfile, &itmp, sizeof( Sint16 ), 1 ) ) ? 1 : 0;
+        if ( 0 != retval ) *val = ENDIAN_TO_SYS_INT16( itmp );
 
         error = ( 0 == retval );
         
@@ -1230,7 +1478,9 @@ int vfs_read_Uint16( vfs_FILE * pfile, Uint16 * val )
     }
     else if ( VFS_FILE_TYPE_PHYSFS == pfile->type )
     {
-        retval = PHYSFS_readULE16( pfile->ptr.p, val );
+        Uint16 itmp;
+        retval = ( 1 == _vfs_buffer_read( pfile, &itmp, sizeof( Uint16 ), 1 ) ) ? 1 : 0;
+        if ( 0 != retval ) *val = ENDIAN_TO_SYS_INT16( itmp );
 
         error = ( 0 == retval );
         
@@ -1265,7 +1515,9 @@ int vfs_read_Sint32( vfs_FILE * pfile, Sint32 * val )
     }
     else if ( VFS_FILE_TYPE_PHYSFS == pfile->type )
     {
-        retval = PHYSFS_readSLE32( pfile->ptr.p, val );
+        Sint32 itmp;
+        retval = ( 1 == _vfs_buffer_read( pfile, &itmp, sizeof( Sint32 ), 1 ) ) ? 1 : 0;
+        if ( 0 != retval ) *val = ENDIAN_TO_SYS_INT32( itmp );
 
         error = ( 0 == retval );
         
@@ -1300,7 +1552,9 @@ int vfs_read_Uint32( vfs_FILE * pfile, Uint32 * val )
     }
     else if ( VFS_FILE_TYPE_PHYSFS == pfile->type )
     {
-        retval = PHYSFS_readULE32( pfile->ptr.p, val );
+        Uint32 itmp;
+        retval = ( 1 == _vfs_buffer_read( pfile, &itmp, sizeof( Uint32 ), 1 ) ) ? 1 : 0;
+        if ( 0 != retval ) *val = ENDIAN_TO_SYS_INT32( itmp );
 
         error = ( 0 == retval );
         
@@ -1335,7 +1589,9 @@ int vfs_read_Sint64( vfs_FILE * pfile, Sint64 * val )
     }
     else if ( VFS_FILE_TYPE_PHYSFS == pfile->type )
     {
-        retval = PHYSFS_readSLE64( pfile->ptr.p, (PHYSFS_sint64*)val );
+        Sint64 itmp;
+        retval = ( 1 == _vfs_buffer_read( pfile, &itmp, sizeof( Sint64 ), 1 ) ) ? 1 : 0;
+        if ( 0 != retval ) *val = ENDIAN_TO_SYS_INT64( itmp );
 
         error = ( 0 == retval );
         
@@ -1370,7 +1626,9 @@ int vfs_read_Uint64( vfs_FILE * pfile, Uint64 * val )
     }
     else if ( VFS_FILE_TYPE_PHYSFS == pfile->type )
     {
-        retval = PHYSFS_readULE64( pfile->ptr.p, (PHYSFS_uint64 *)val );
+        Uint64 itmp;
+        retval = ( 1 == _vfs_buffer_read( pfile, &itmp, sizeof( Uint64 ), 1 ) ) ? 1 : 0;
+        if ( 0 != retval ) *val = ENDIAN_TO_SYS_INT64( itmp );
 
         error = ( 0 == retval );
         
@@ -1406,13 +1664,15 @@ int vfs_read_float( vfs_FILE * pfile, float * val )
     else if ( VFS_FILE_TYPE_PHYSFS == pfile->type )
     {
         union { float f; Uint32 i; } convert;
-        retval = PHYSFS_readULE32( pfile->ptr.p, &( convert.i ) );
+        Uint32 itmp;
+        retval = ( 1 == _vfs_buffer_read( pfile, &itmp, sizeof( Uint32 ), 1 ) ) ? 1 : 0;
 
         error = ( 0 == retval );
         
         if (error) pfile->flags |= VFS_FILE_FLAG_ERROR;
         else       pfile->flags &= ~VFS_FILE_FLAG_ERROR;
 
+        convert.i = ENDIAN_TO_SYS_INT32( itmp );
         *val = convert.f;
     }
 
@@ -1720,33 +1980,30 @@ int vfs_write_float( vfs_FILE * pfile, const float val )
 
 //--------------------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------------------
-static int fake_physfs_vscanf_read_char( PHYSFS_File * pfile )
+static int fake_physfs_vscanf_read_char( vfs_FILE * pfile )
 {
-    unsigned char ch;
-    int retval = PHYSFS_read( pfile, &ch, sizeof( unsigned char ), 1);
-	if (1 != retval) return -1;
-	return ch;
+    return _vfs_buffer_getc( pfile );
 }
 
-static void fake_physfs_vscanf_eat_whitespace( PHYSFS_File * pfile )
+static void fake_physfs_vscanf_eat_whitespace( vfs_FILE * pfile )
 {
     int ch;
     do
     {
         ch = fake_physfs_vscanf_read_char( pfile );
-    } while ( ch == -1 || isspace( ch ) );
-    PHYSFS_seek( pfile, PHYSFS_tell( pfile ) - 1 );
+    } while ( EOF != ch && isspace( ch ) );
+    _vfs_buffer_ungetc( pfile, ch );
 }
 
-static void fake_physfs_vscanf_read_word( PHYSFS_File * pfile, char * buffer, const int max_length )
+static void fake_physfs_vscanf_read_word( vfs_FILE * pfile, char * buffer, const int max_length )
 {
     int length = 0;
     while ( max_length <= 0 || length < max_length )
     {
         int ch = fake_physfs_vscanf_read_char( pfile );
-        if ( ch == -1 || isspace( ch ) )
+        if ( EOF == ch || isspace( ch ) )
         {
-            PHYSFS_seek( pfile, PHYSFS_tell( pfile ) - 1 );
+            _vfs_buffer_ungetc( pfile, ch );
             break;
         }
         buffer[length] = (char)(ch);
@@ -1755,7 +2012,7 @@ static void fake_physfs_vscanf_read_word( PHYSFS_File * pfile, char * buffer, co
     buffer[length] = CSTR_END;
 }
 
-int fake_physfs_vscanf( PHYSFS_File * pfile, const char *format, va_list args )
+static int fake_physfs_vscanf( vfs_FILE * pfile, const char *format, va_list args )
 {
     int argcount = 0;
     const char * format_start = format;
@@ -1869,7 +2126,7 @@ int fake_physfs_vscanf( PHYSFS_File * pfile, const char *format, va_list args )
                     fake_physfs_vscanf_read_word( pfile, buffer, sizeof(buffer) );
                     buffer_size = strlen( buffer );
                     arg = strtol( buffer, &buffer_end, 10 );
-                    PHYSFS_seek( pfile, PHYSFS_tell( pfile ) - (buffer_size - (buffer_end - buffer)) );
+                    _vfs_buffer_seek( pfile, _vfs_buffer_tell( pfile ) - (buffer_size - (buffer_end - buffer)) );
                     if ( !ignore_argument )
                     {
                         int * arg_ptr = va_arg( args, int * );
@@ -1884,7 +2141,7 @@ int fake_physfs_vscanf( PHYSFS_File * pfile, const char *format, va_list args )
                     fake_physfs_vscanf_read_word( pfile, buffer, sizeof(buffer) );
                     buffer_size = strlen( buffer );
                     arg = strtof( buffer, &buffer_end );
-                    PHYSFS_seek( pfile, PHYSFS_tell( pfile ) - (buffer_size - (buffer_end - buffer)) );
+                    _vfs_buffer_seek( pfile, _vfs_buffer_tell( pfile ) - (buffer_size - (buffer_end - buffer)) );
                     if ( !ignore_argument )
                     {
                         float * arg_ptr = va_arg( args, float * );
@@ -1972,7 +2229,7 @@ int vfs_scanf( vfs_FILE * pfile, const char *format, ... )
     }
     else if( VFS_FILE_TYPE_PHYSFS == pfile->type )
     {
-        retval = fake_physfs_vscanf( pfile->ptr.p, format, args );
+        retval = fake_physfs_vscanf( pfile, format, args );
     }
     va_end( args );
 
@@ -1988,6 +2245,18 @@ char ** vfs_enumerateFiles( const char * dir_name )
     return PHYSFS_enumerateFiles( vfs_convert_fname( dir_name ) );
 }
 
+//--------------------------------------------------------------------------------------------
+size_t vfs_getFailedOpenCount()
+{
+    return _vfs_failed_open_count;
+}
+
+//--------------------------------------------------------------------------------------------
+void vfs_resetFailedOpenCount()
+{
+    _vfs_failed_open_count = 0;
+}
+
 //--------------------------------------------------------------------------------------------
 void    vfs_freeList( void * listVar )
 {
@@ -2409,12 +2678,7 @@ int vfs_ungetc( int c, vfs_FILE * pfile )
     }
     else if ( VFS_FILE_TYPE_PHYSFS == pfile->type )
     {
-        // fake it
-        int seeked = PHYSFS_seek(pfile->ptr.p, PHYSFS_tell(pfile->ptr.p) - 1);
-        retval = c;
-        
-        if (!seeked) pfile->flags |= VFS_FILE_FLAG_ERROR;
-        else         pfile->flags &= ~VFS_FILE_FLAG_ERROR;
+        retval = _vfs_buffer_ungetc(pfile, c);
     }
 
     return retval;
@@ -2443,23 +2707,8 @@ int vfs_getc(vfs_FILE *file)
     }
     else if (VFS_FILE_TYPE_PHYSFS == file->type)
     {
-        unsigned char cTmp;
-        retval = PHYSFS_read(file->ptr.p, &cTmp, sizeof(cTmp), 1);
-
-        if (-1 == retval)
-        {
-            file->flags |= VFS_FILE_FLAG_ERROR;
-            retval = EOF; // MH: Set this explicitly - EOF can be defined as -1, but it does not have.
-        }
-        else if (0 == retval)
-        {
-            file->flags |= VFS_FILE_FLAG_EOF;
-            retval = EOF;
-        }
-        else
-        {
-            retval = cTmp;
-        }
+        // sets the end-of-file and the error flag
+        retval = _vfs_buffer_getc(file);
     }
 
     return retval;
@@ -2552,37 +2801,24 @@ char * vfs_gets(char *buffer, int buffer_size, vfs_FILE *file)
         char *str_ptr = buffer;
         char *str_end = buffer + buffer_size;
 
-        int cTmp;
-        int iTmp = PHYSFS_read(file->ptr.p, &cTmp, 1, sizeof(cTmp));
-        if (-1 == iTmp)
-        {
-            file->flags |= VFS_FILE_FLAG_ERROR;
-            return NULL;
-        }
-        if (0 == iTmp)
-        {
-            file->flags |= VFS_FILE_FLAG_EOF;
-            return NULL;
-        }
-        while (iTmp && (str_ptr < str_end - 1) && CSTR_END != cTmp && 0 == (file->flags & (VFS_FILE_FLAG_EOF | VFS_FILE_FLAG_ERROR)))
+        while (str_ptr < str_end - 1)
         {
+            int cTmp = _vfs_buffer_getc(file);
+            if (EOF == cTmp)
+            {
+                // Nothing read or an error.
+                if (str_ptr == buffer || 0 != (file->flags & VFS_FILE_FLAG_ERROR))
+                {
+                    return NULL;
+                }
+                break;
+            }
+            if (CSTR_END == cTmp) break;
+
             *str_ptr = cTmp;
             str_ptr++;
 
             if (C_LINEFEED_CHAR == cTmp || C_CARRIAGE_RETURN_CHAR == cTmp) break;
-
-            iTmp = PHYSFS_read(file->ptr.p, &cTmp, 1, sizeof(cTmp));
-
-            if (-1 == iTmp)
-            {
-                file->flags |= VFS_FILE_FLAG_ERROR;
-                return NULL;
-            }
-            if (0 == iTmp)
-            {
-                file->flags |= VFS_FILE_FLAG_EOF;
-                return buffer;
-            }
         }
         *str_ptr = CSTR_END;
 
@@ -2643,7 +2879,7 @@ void _vfs_translate_error(vfs_FILE *file)
     }
     else if (VFS_FILE_TYPE_PHYSFS == file->type)
     {
-        if (PHYSFS_eof(file->ptr.p))
+        if (0 == _vfs_buffer_pending(file) && PHYSFS_eof(file->ptr.p))
         {
             SET_BIT(file->flags, VFS_FILE_FLAG_EOF);
         }
@@ -3072,8 +3308,8 @@ bool vfs_readEntireFile(const std::string& pathname, char **data, size_t *length
                 return false;
             }
             if (vfs_eof(file)) break;
-            if (0 == read) continue;
-            char *newBuffer = (char *)realloc(buffer, pos + 1024);
+            if (pos < bufferSize) continue;
+            char *newBuffer = (char *)realloc(buffer, bufferSize + 1024);
             if (newBuffer == nullptr)
             {
                 free(buffer);
@@ -3081,6 +3317,7 @@ bool vfs_readEntireFile(const std::string& pathname, char **data, size_t *length
                 return false;
             }
             buffer = newBuffer;
+            bufferSize += 1024;
         }
         *data = buffer;
         *length = pos;
@@ -3088,7 +3325,8 @@ bool vfs_readEntireFile(const std::string& pathname, char **data, size_t *length
     else
     {
         size_t pos = 0;
-        char *buffer = (char *) malloc(fileLen);
+        // allocate at least one Byte, such that an empty file yields a valid pointer
+        char *buffer = (char *) malloc(fileLen > 0 ? fileLen : 1);
         if (buffer == nullptr)
         {
             vfs_close(file);
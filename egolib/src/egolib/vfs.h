@@ -162,6 +162,22 @@ int vfs_init(const char *argv0, const char *root_dir);
  */
 vfs_FILE *vfs_openRead(const std::string& pathname);
 
+/**
+ * @brief
+ *  Get the number of files which could not be opened by vfs_openRead() since the last reset.
+ * @return
+ *  the number of failed opens
+ * @remark
+ *  Each failed open is a file system lookup, loaders should avoid probing for files which do not exist.
+ */
+size_t vfs_getFailedOpenCount();
+
+/**
+ * @brief
+ *  Reset the number of failed opens to zero.
+ */
+void vfs_resetFailedOpenCount();
+
 /**
  * @brief
  *  Open a file for writing in binary mode, using PhysFS.
@@ -226,6 +242,10 @@ bool vfs_delete_file(const std::string& pathname);
 bool vfs_exists(const std::string& pathname);
 /** @return @a true if the pathname refers to an existing directory file, @a false otherwise */
 bool vfs_isDirectory(const std::string& pathname);
+/** @return the last modification time of the file in seconds since the epoch, @a -1 if it can not be determined */
+int64_t vfs_getLastModTime(const std::string& pathname);
+/** @return the size of the file in bytes, @a -1 if it can not be determined */
+int64_t vfs_getFileSize(const std::string& pathname);
 
 // binary reading and writing
 size_t vfs_read(void *buffer, size_t size, size_t count, vfs_FILE *file);
@@ -0,0 +1,122 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+#include "EgoTest/EgoTest.hpp"
+#include "egolib/egolib.h"
+#include "egolib/VFS/FileCache.hpp"
+
+EgoTest_DeclareTestCase(FileCache)
+EgoTest_EndDeclaration()
+
+EgoTest_BeginTestCase(FileCache)
+
+EgoTest_Test(hitsAndMisses)
+{
+    using Ego::VFS::FileStamp;
+    Ego::VFS::FileCache<int> cache;
+    int decodeCount = 0;
+    auto decode = [&decodeCount]() { decodeCount++; return std::make_shared<int>(decodeCount); };
+
+    // the first get decodes, the second one hits
+    std::shared_ptr<int> first = cache.get("a.txt", FileStamp{ 10, 100 }, decode);
+    std::shared_ptr<int> second = cache.get("a.txt", FileStamp{ 10, 100 }, decode);
+    EgoTest_Assert(1 == decodeCount);
+    EgoTest_Assert(first == second);
+
+    // a changed modification time decodes again
+    std::shared_ptr<int> third = cache.get("a.txt", FileStamp{ 11, 100 }, decode);
+    EgoTest_Assert(2 == decodeCount);
+    EgoTest_Assert(2 == *third);
+
+    // a changed size with the same modification time decodes again
+    std::shared_ptr<int> fourth = cache.get("a.txt", FileStamp{ 11, 101 }, decode);
+    EgoTest_Assert(3 == decodeCount);
+    EgoTest_Assert(3 == *fourth);
+
+    // another file decodes
+    cache.get("b.txt", FileStamp{ 11, 100 }, decode);
+    EgoTest_Assert(4 == decodeCount);
+
+    auto stats = cache.getStats();
+    EgoTest_Assert(1 == stats.hits);
+    EgoTest_Assert(4 == stats.misses);
+    EgoTest_Assert(2 == stats.size);
+
+    cache.clear();
+    EgoTest_Assert(0 == cache.getStats().size);
+}
+
+EgoTest_Test(notCached)
+{
+    using Ego::VFS::FileStamp;
+    Ego::VFS::FileCache<int> cache;
+    int decodeCount = 0;
+    auto decode = [&decodeCount]() { decodeCount++; return std::make_shared<int>(decodeCount); };
+    auto fail = [&decodeCount]() { decodeCount++; return std::shared_ptr<int>(nullptr); };
+
+    // an unknown stamp always decodes
+    cache.get("a.txt", FileStamp{ -1, 100 }, decode);
+    cache.get("a.txt", FileStamp{ 10, -1 }, decode);
+    EgoTest_Assert(2 == decodeCount);
+    EgoTest_Assert(0 == cache.getStats().size);
+
+    // a failure is not cached and removes the old value
+    cache.get("b.txt", FileStamp{ 1, 100 }, decode);
+    EgoTest_Assert(nullptr == cache.get("b.txt", FileStamp{ 2, 100 }, fail));
+    EgoTest_Assert(nullptr == cache.get("b.txt", FileStamp{ 2, 100 }, fail));
+    EgoTest_Assert(5 == decodeCount);
+    EgoTest_Assert(0 == cache.getStats().size);
+}
+
+EgoTest_Test(removeUnused)
+{
+    using Ego::VFS::FileStamp;
+    Ego::VFS::FileCache<int> cache;
+    int decodeCount = 0;
+    auto decode = [&decodeCount]() { decodeCount++; return std::make_shared<int>(decodeCount); };
+
+    // the values got before the first call are kept
+    cache.get("a.txt", FileStamp{ 1, 100 }, decode);
+    cache.get("b.txt", FileStamp{ 1, 100 }, decode);
+    cache.removeUnused();
+    EgoTest_Assert(2 == cache.getStats().size);
+
+    // a value which was not got since then is removed, a hit keeps its value
+    cache.get("a.txt", FileStamp{ 1, 100 }, decode);
+    cache.removeUnused();
+    EgoTest_Assert(1 == cache.getStats().size);
+    cache.get("a.txt", FileStamp{ 1, 100 }, decode);
+    cache.get("b.txt", FileStamp{ 1, 100 }, decode);
+    EgoTest_Assert(3 == decodeCount);
+}
+
+EgoTest_Test(combinedStamps)
+{
+    using Ego::VFS::FileStamp;
+
+    // the newer modification time, and a change of either size changes the stamp
+    const FileStamp stamp = FileStamp::combine(FileStamp{ 10, 100 }, FileStamp{ 20, 5 });
+    EgoTest_Assert(20 == stamp.modificationTime);
+    EgoTest_Assert(stamp != FileStamp::combine(FileStamp{ 10, 101 }, FileStamp{ 20, 5 }));
+    EgoTest_Assert(stamp != FileStamp::combine(FileStamp{ 10, 100 }, FileStamp{ 20, 6 }));
+    EgoTest_Assert(stamp != FileStamp::combine(FileStamp{ 10, 5 }, FileStamp{ 20, 100 }));
+    EgoTest_Assert(!FileStamp::combine(FileStamp{ 10, 100 }, FileStamp{ -1, 5 }).isKnown());
+}
+
+EgoTest_EndTestCase()
@@ -0,0 +1,104 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+#include "EgoTest/EgoTest.hpp"
+#include "egolib/egolib.h"
+#include "egolib/Graphics/MD2Model.hpp"
+#include "egolib/Graphics/MD2Interpolator.hpp"
+
+EgoTest_DeclareTestCase(MD2InterpolatorTest)
+EgoTest_EndDeclaration()
+
+EgoTest_BeginTestCase(MD2InterpolatorTest)
+
+/// A frame with an odd number of vertices, so that the kernels have to handle the remaining vertices
+static MD2_FrameArrays makeFrame(size_t vertexCount, float seed)
+{
+    MD2_FrameArrays frame;
+    for (std::vector<float> *array : {&frame.posX, &frame.posY, &frame.posZ, &frame.nrmX, &frame.nrmY, &frame.nrmZ, &frame.envX})
+    {
+        array->resize((vertexCount + MD2_FrameArrays::PADDING - 1) / MD2_FrameArrays::PADDING * MD2_FrameArrays::PADDING, 0.0f);
+        for (size_t i = 0; i < vertexCount; ++i)
+        {
+            (*array)[i] = seed + 0.37f * i;
+            seed = -seed * 0.5f + 1.25f;
+        }
+    }
+    return frame;
+}
+
+/// A vertex with padding like the vertex of the renderer, to test the stride
+struct PaddedVertex
+{
+    MD2_InterpolatedVertex vertex;
+    float padding[7];
+};
+
+EgoTest_Test(kernelsMatchScalar)
+{
+    const int vertexCount = 37;
+    const MD2_FrameArrays lst = makeFrame(vertexCount, 3.0f);
+    const MD2_FrameArrays nxt = makeFrame(vertexCount, -11.0f);
+
+    const MD2Interpolator::Kernel kernels[] = {MD2Interpolator::Kernel::SSE, MD2Interpolator::Kernel::AVX};
+    for (MD2Interpolator::Kernel kernel : kernels)
+    {
+        if (!MD2Interpolator::isSupported(kernel)) continue;
+
+        for (float flip : {0.0f, 0.25f, 0.5f, 0.75f, 1.0f})
+        {
+            // a range which does not start at a multiple of the block size
+            const int vmin = 3, vmax = vertexCount - 2;
+
+            std::vector<PaddedVertex> expected(vertexCount), actual(vertexCount);
+            memset(expected.data(), 0, expected.size() * sizeof(PaddedVertex));
+            memset(actual.data(), 0, actual.size() * sizeof(PaddedVertex));
+            MD2Interpolator::interpolate(MD2Interpolator::Kernel::Scalar, expected.data(), sizeof(PaddedVertex), lst, nxt, vmin, vmax, flip);
+            MD2Interpolator::interpolate(kernel, actual.data(), sizeof(PaddedVertex), lst, nxt, vmin, vmax, flip);
+
+            // the vertices outside of the range and the padding are not written
+            EgoTest_Assert(0 == memcmp(expected.data(), actual.data(), expected.size() * sizeof(PaddedVertex)));
+            EgoTest_Assert(0.0f == actual[vmin - 1].vertex.pos[kW] && 0.0f == actual[vmax + 1].vertex.pos[kW]);
+            EgoTest_Assert(1.0f == actual[vmin].vertex.pos[kW] && 1.0f == actual[vmax].vertex.pos[kW]);
+        }
+    }
+}
+
+EgoTest_Test(exactFrames)
+{
+    const int vertexCount = 9;
+    const MD2_FrameArrays lst = makeFrame(vertexCount, 0.1f);
+    const MD2_FrameArrays nxt = makeFrame(vertexCount, 7.3f);
+
+    MD2_InterpolatedVertex vertices[vertexCount];
+    MD2Interpolator::interpolate(vertices, sizeof(MD2_InterpolatedVertex), lst, nxt, 0, vertexCount - 1, 0.0f);
+    for (int i = 0; i < vertexCount; ++i)
+    {
+        EgoTest_Assert(lst.posX[i] == vertices[i].pos[kX] && lst.nrmZ[i] == vertices[i].nrm[kZ] && lst.envX[i] == vertices[i].env[kX]);
+        EgoTest_Assert(0.5f * (1.0f + lst.nrmZ[i]) == vertices[i].env[kY]);
+    }
+
+    MD2Interpolator::interpolate(vertices, sizeof(MD2_InterpolatedVertex), lst, nxt, 0, vertexCount - 1, 1.0f);
+    for (int i = 0; i < vertexCount; ++i)
+    {
+        EgoTest_Assert(nxt.posY[i] == vertices[i].pos[kY] && nxt.nrmX[i] == vertices[i].nrm[kX] && nxt.envX[i] == vertices[i].env[kX]);
+    }
+}
+
+EgoTest_EndTestCase()
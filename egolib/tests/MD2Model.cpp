@@ -0,0 +1,152 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+#include "EgoTest/EgoTest.hpp"
+#include "egolib/egolib.h"
+#include "egolib/Graphics/MD2Model.hpp"
+#include "egolib/FileFormats/module_bundle_file.h"
+
+EgoTest_DeclareTestCase(MD2ModelTest)
+EgoTest_EndDeclaration()
+
+EgoTest_BeginTestCase(MD2ModelTest)
+
+/// A model of four vertices in two frames with one strip and one fan, in the layout of MD2Model::write()
+static std::vector<char> makeModel()
+{
+    const Uint32 vertexCount = 4;
+
+    std::vector<char> buffer;
+    bundle_writer_t writer(buffer);
+    writer.writeUint32(vertexCount);
+
+    // one skin
+    char skin[64] = "tris0.bmp";
+    writer.writeUint32(1);
+    writer.writeBytes(skin, sizeof(skin));
+
+    // the texture coordinates
+    writer.writeUint32(vertexCount);
+    for (Uint32 i = 0; i < vertexCount; ++i)
+    {
+        writer.writeFloat(0.25f * i);
+        writer.writeFloat(1.0f - 0.25f * i);
+    }
+
+    // two triangles
+    writer.writeUint32(2);
+    for (Uint32 triangle = 0; triangle < 2; ++triangle)
+    {
+        for (Uint32 v = 0; v < 3; ++v)
+        {
+            writer.writeUint32(triangle + v);
+            writer.writeUint32(triangle + v);
+        }
+    }
+
+    // two frames
+    writer.writeUint32(2);
+    for (Uint32 frame = 0; frame < 2; ++frame)
+    {
+        char name[16] = "stand";
+        name[5] = static_cast<char>('1' + frame);
+        writer.writeBytes(name, sizeof(name));
+        for (Uint32 i = 0; i < vertexCount; ++i)
+        {
+            writer.writeFloat(1.0f * i + frame);
+            writer.writeFloat(-2.0f * i);
+            writer.writeFloat(0.5f * frame);
+            writer.writeFloat(0.0f);
+            writer.writeFloat(0.0f);
+            writer.writeFloat(1.0f);
+            writer.writeUint32(i + frame);
+        }
+    }
+
+    // a strip of four vertices and a fan of three vertices
+    writer.writeUint32(2);
+    writer.writeUint32(GL_TRIANGLE_STRIP);
+    writer.writeUint32(4);
+    for (Sint32 i = 0; i < 4; ++i)
+    {
+        writer.writeFloat(0.1f * i);
+        writer.writeFloat(0.2f * i);
+        writer.writeSint32(i);
+    }
+    writer.writeUint32(GL_TRIANGLE_FAN);
+    writer.writeUint32(3);
+    for (Sint32 i = 0; i < 3; ++i)
+    {
+        writer.writeFloat(0.3f * i);
+        writer.writeFloat(0.4f * i);
+        writer.writeSint32(3 - i);
+    }
+
+    return buffer;
+}
+
+EgoTest_Test(readWrite)
+{
+    const std::vector<char> buffer = makeModel();
+    bundle_reader_t reader(buffer.data(), buffer.size());
+    std::shared_ptr<MD2Model> model = MD2Model::read(reader);
+    EgoTest_Assert(nullptr != model);
+    EgoTest_Assert(reader.isGood() && reader.isAtEnd());
+
+    // the vertices of the frames
+    EgoTest_Assert(4 == model->getVertexCount());
+    EgoTest_Assert(1 == model->getSkins().size());
+    EgoTest_Assert(2 == model->getTriangles().size());
+    std::vector<MD2_Frame>& frames = model->getFrames();
+    EgoTest_Assert(2 == frames.size());
+    EgoTest_Assert(0 == strcmp("stand2", frames[1].name));
+    EgoTest_Assert(4 == frames[1].vertexList.size());
+    EgoTest_Assert(4.0f == frames[1].vertexList[3].pos[kX]);
+    EgoTest_Assert(-6.0f == frames[1].vertexList[3].pos[kY]);
+    EgoTest_Assert(4 == frames[1].vertexList[3].normal);
+    EgoTest_Assert(4.0f == frames[1].arrays.posX[3] && 0.0f == frames[1].arrays.posX[4]);
+
+    // the GL commands in their order, and the triangles made of them
+    const std::forward_list<MD2_GLCommand>& commands = model->getGLCommands();
+    EgoTest_Assert(2 == std::distance(commands.begin(), commands.end()));
+    EgoTest_Assert(GL_TRIANGLE_STRIP == commands.front().glMode);
+    EgoTest_Assert(4 == commands.front().data.size());
+    EgoTest_Assert(GL_TRIANGLE_FAN == std::next(commands.begin())->glMode);
+    EgoTest_Assert(1 == std::next(commands.begin())->data[2].index);
+    EgoTest_Assert(3 * 3 == model->getTriangleList().indices.size());
+
+    // writing the model again gives the same bytes
+    std::vector<char> written;
+    bundle_writer_t writer(written);
+    model->write(writer);
+    EgoTest_Assert(buffer == written);
+}
+
+EgoTest_Test(readTruncated)
+{
+    // a model cut off anywhere is rejected
+    const std::vector<char> buffer = makeModel();
+    for (size_t size = 0; size < buffer.size(); ++size)
+    {
+        bundle_reader_t reader(buffer.data(), size);
+        EgoTest_Assert(nullptr == MD2Model::read(reader));
+    }
+}
+
+EgoTest_EndTestCase()
@@ -0,0 +1,133 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+#include "EgoTest/EgoTest.hpp"
+#include "egolib/egolib.h"
+#include "egolib/FileFormats/module_bundle_file.h"
+
+EgoTest_DeclareTestCase(ModuleBundle)
+EgoTest_EndDeclaration()
+
+EgoTest_BeginTestCase(ModuleBundle)
+
+EgoTest_Test(readWrite)
+{
+    std::vector<char> buffer;
+    bundle_writer_t writer(buffer);
+    writer.writeUint32(0x01020304);
+    writer.writeSint32(-5);
+    writer.writeSint64(-1234567890123LL);
+    writer.writeFloat(3.5f);
+    writer.writeBytes("abc", 3);
+
+    // the numbers are little-endian on every platform
+    EgoTest_Assert(23 == buffer.size());
+    EgoTest_Assert(0x04 == buffer[0] && 0x01 == buffer[3]);
+
+    bundle_reader_t reader(buffer.data(), buffer.size());
+    EgoTest_Assert(0x01020304 == reader.readUint32());
+    EgoTest_Assert(-5 == reader.readSint32());
+    EgoTest_Assert(-1234567890123LL == reader.readSint64());
+    EgoTest_Assert(3.5f == reader.readFloat());
+    char bytes[3];
+    EgoTest_Assert(reader.readBytes(bytes, 3) && 'c' == bytes[2]);
+    EgoTest_Assert(reader.isGood() && reader.isAtEnd());
+
+    // reading past the end fails the reader
+    EgoTest_Assert(0 == reader.readUint32());
+    EgoTest_Assert(!reader.isGood());
+}
+
+EgoTest_Test(readCount)
+{
+    std::vector<char> buffer;
+    bundle_writer_t writer(buffer);
+    writer.writeUint32(2);
+    writer.writeUint32(7);
+    writer.writeUint32(8);
+
+    bundle_reader_t reader(buffer.data(), buffer.size());
+    EgoTest_Assert(2 == reader.readCount(4));
+    EgoTest_Assert(7 == reader.readUint32() && 8 == reader.readUint32());
+    EgoTest_Assert(reader.isGood() && reader.isAtEnd());
+
+    // a count larger than the remaining data is corrupted
+    bundle_reader_t corrupted(buffer.data(), buffer.size());
+    EgoTest_Assert(0 == corrupted.readCount(8));
+    EgoTest_Assert(!corrupted.isGood());
+}
+
+EgoTest_Test(findEntries)
+{
+    const Ego::VFS::FileStamp a{ 10, 100 }, b{ 20, 200 };
+    module_bundle_t bundle;
+    bundle.add("a/tris.md2", a, "first", 5);
+    bundle.add("b/tris.md2", b, "second", 6);
+    EgoTest_Assert(2 == bundle.getEntryCount());
+
+    const char *data;
+    size_t size;
+    EgoTest_Assert(bundle.find("a/tris.md2", a, &data, &size));
+    EgoTest_Assert(5 == size && 0 == memcmp(data, "first", 5));
+
+    // a stale or unknown entry is not found
+    EgoTest_Assert(!bundle.find("a/tris.md2", Ego::VFS::FileStamp{ 11, 100 }, &data, &size));
+    EgoTest_Assert(!bundle.find("a/tris.md2", Ego::VFS::FileStamp{ 10, 101 }, &data, &size));
+    EgoTest_Assert(!bundle.find("a/tris.md2", Ego::VFS::FileStamp{ -1, -1 }, &data, &size));
+    EgoTest_Assert(!bundle.find("c/tris.md2", a, &data, &size));
+
+    // an entry is replaced by an entry of the same name
+    bundle.add("a/tris.md2", Ego::VFS::FileStamp{ 11, 100 }, "third", 5);
+    EgoTest_Assert(2 == bundle.getEntryCount());
+    EgoTest_Assert(bundle.find("a/tris.md2", Ego::VFS::FileStamp{ 11, 100 }, &data, &size));
+    EgoTest_Assert(0 == memcmp(data, "third", 5));
+}
+
+/// A bundle with one entry whose name has the given length, but only a short name follows
+static std::vector<char> makeBundle(Uint32 nameLength)
+{
+    std::vector<char> buffer;
+    bundle_writer_t writer(buffer);
+    writer.writeUint32(MODULE_BUNDLE_ID);
+    writer.writeUint32(CURRENT_MODULE_BUNDLE_VERSION);
+    writer.writeUint32(1);
+    writer.writeUint32(nameLength);
+    writer.writeBytes("a/tris.md2", 10);
+    writer.writeSint64(10);
+    writer.writeSint64(100);
+    writer.writeUint32(5);
+    writer.writeBytes("first", 5);
+    return buffer;
+}
+
+EgoTest_Test(readBundle)
+{
+    module_bundle_t bundle;
+    EgoTest_Assert(bundle.read(makeBundle(10)));
+    const char *data;
+    size_t size;
+    EgoTest_Assert(bundle.find("a/tris.md2", Ego::VFS::FileStamp{ 10, 100 }, &data, &size));
+    EgoTest_Assert(5 == size && 0 == memcmp(data, "first", 5));
+
+    // a corrupted name length is rejected without allocating the name
+    EgoTest_Assert(!bundle.read(makeBundle(0xFFFFFFF0)));
+    EgoTest_Assert(0 == bundle.getEntryCount());
+}
+
+EgoTest_EndTestCase()
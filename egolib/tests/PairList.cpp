@@ -0,0 +1,136 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+#include "EgoTest/EgoTest.hpp"
+#include "egolib/egolib.h"
+#include "egolib/Core/PairList.hpp"
+
+#include <chrono>
+#include <iostream>
+
+EgoTest_DeclareTestCase(PairList)
+EgoTest_EndDeclaration()
+
+EgoTest_BeginTestCase(PairList)
+
+EgoTest_Test(unique)
+{
+    Ego::PairList<int> list;
+
+    EgoTest_Assert(Ego::PairList<int>::makeKey(1, 2) == Ego::PairList<int>::makeKey(2, 1));
+    EgoTest_Assert(list.insert(Ego::PairList<int>::makeKey(1, 2), 0.5f, 12));
+    EgoTest_Assert(!list.insert(Ego::PairList<int>::makeKey(2, 1), 0.25f, 21));
+    EgoTest_Assert(list.insert(Ego::PairList<int>::makeKey(1, 3), 0.25f, 13));
+    EgoTest_Assert(2 == list.size());
+    EgoTest_Assert(list.contains(Ego::PairList<int>::makeKey(3, 1)));
+
+    list.clear();
+    EgoTest_Assert(list.empty());
+    EgoTest_Assert(!list.contains(Ego::PairList<int>::makeKey(1, 2)));
+    EgoTest_Assert(list.insert(Ego::PairList<int>::makeKey(2, 1), 0.25f, 21));
+}
+
+EgoTest_Test(sort)
+{
+    Ego::PairList<int> list;
+    const float times[] = { 0.5f, -1.0f, 0.0f, 0.5f, 2.0f, -0.25f, 0.5f, 1.0e-6f };
+
+    for (int i = 0; i < 8; ++i)
+    {
+        EgoTest_Assert(list.insert(Ego::PairList<int>::makeKey(i, 100), times[i], i));
+    }
+    list.sort();
+
+    // sorted by time, equal times keep their insertion order
+    const int expected[] = { 1, 5, 2, 7, 0, 3, 6, 4 };
+    for (int i = 0; i < 8; ++i)
+    {
+        EgoTest_Assert(expected[i] == list[i]);
+    }
+
+    // the list still rejects duplicates after sorting
+    EgoTest_Assert(!list.insert(Ego::PairList<int>::makeKey(100, 4), 0.0f, 4));
+}
+
+EgoTest_Test(grow)
+{
+    Ego::PairList<int> list;
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        EgoTest_Assert(list.insert(Ego::PairList<int>::makeKey(i, i + 1), static_cast<float>(10000 - i), i));
+    }
+    for (int i = 0; i < 10000; ++i)
+    {
+        EgoTest_Assert(!list.insert(Ego::PairList<int>::makeKey(i + 1, i), 0.0f, i));
+    }
+    list.sort();
+    for (int i = 0; i < 10000; ++i)
+    {
+        EgoTest_Assert(9999 - i == list[i]);
+    }
+}
+
+EgoTest_Test(stress)
+{
+    // PARTICLES_MAX particles around 200 characters: every character touches its neighbours
+    // (found twice, once from each side) and every particle touches two characters.
+    static const uint32_t CHARACTERS = 200;
+    static const uint32_t TICKS = 100;
+    static const uint32_t PARTICLE_BIT = 0x80000000u;
+
+    Ego::PairList<uint64_t> list;
+    uint32_t seed = 1;
+    auto random = [&seed]() { seed = seed * 1664525u + 1013904223u; return seed >> 8; };
+
+    size_t pairs = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (uint32_t tick = 0; tick < TICKS; ++tick)
+    {
+        list.clear();
+        for (uint32_t a = 0; a < CHARACTERS; ++a)
+        {
+            for (uint32_t n = 1; n <= 4; ++n)
+            {
+                uint64_t key = Ego::PairList<uint64_t>::makeKey(a, (a + n) % CHARACTERS);
+                list.insert(key, (random() & 0xFFFF) / 65536.0f, key);
+                key = Ego::PairList<uint64_t>::makeKey((a + n) % CHARACTERS, a);
+                list.insert(key, (random() & 0xFFFF) / 65536.0f, key);
+            }
+        }
+        for (uint32_t p = 0; p < PARTICLES_MAX; ++p)
+        {
+            for (uint32_t n = 0; n < 2; ++n)
+            {
+                uint64_t key = Ego::PairList<uint64_t>::makeKey(random() % CHARACTERS, PARTICLE_BIT | p);
+                list.insert(key, (random() & 0xFFFF) / 65536.0f, key);
+            }
+        }
+        list.sort();
+        pairs += list.size();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    EgoTest_Assert(pairs > TICKS * CHARACTERS * 4);
+    std::cout << "PairList: " << (pairs / TICKS) << " pairs per tick, "
+              << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / TICKS
+              << " us per tick" << std::endl;
+}
+
+EgoTest_EndTestCase()
@@ -0,0 +1,207 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+#include "EgoTest/EgoTest.hpp"
+#include "egolib/egolib.h"
+#include "egolib/Core/QuadTree.hpp"
+#include "egolib/Math/Random.hpp"
+
+#include <chrono>
+#include <iostream>
+
+namespace
+{
+
+class QuadTreeElement
+{
+public:
+    QuadTreeElement(float x, float y, float size) : _bounds(Vector2f(x-size, y-size), Vector2f(x+size, y+size))
+    {
+        //ctor
+    }
+
+    AABB_2D& getAABB2D() { return _bounds; }
+
+    bool isTerminated() { return false; }
+
+private:
+    AABB_2D _bounds;
+};
+
+} // namespace
+
+EgoTest_DeclareTestCase(QuadTree)
+EgoTest_EndDeclaration()
+
+EgoTest_BeginTestCase(QuadTree)
+
+EgoTest_Test(rebuild)
+{
+    Ego::QuadTree<QuadTreeElement> quadTree;
+    std::vector<std::shared_ptr<QuadTreeElement>> elements;
+
+    // a fat element in the middle of the tree and one element in each corner
+    elements.push_back(std::make_shared<QuadTreeElement>(128, 128, 20));
+    elements.push_back(std::make_shared<QuadTreeElement>(0, 0, 5));
+    elements.push_back(std::make_shared<QuadTreeElement>(256, 0, 5));
+    elements.push_back(std::make_shared<QuadTreeElement>(0, 256, 5));
+    elements.push_back(std::make_shared<QuadTreeElement>(256, 256, 5));
+
+    quadTree.clear(0, 0, 256, 256);
+    for (const std::shared_ptr<QuadTreeElement> &element : elements)
+    {
+        quadTree.insert(element);
+    }
+
+    // searching outside the tree produces no results
+    EgoTest_Assert(quadTree.find(-50, -50, 20).empty());
+
+    // searching around each corner finds one element
+    EgoTest_Assert(1 == quadTree.find(0, 0, 50).size());
+    EgoTest_Assert(1 == quadTree.find(256, 0, 50).size());
+    EgoTest_Assert(1 == quadTree.find(0, 256, 50).size());
+    EgoTest_Assert(1 == quadTree.find(256, 256, 50).size());
+
+    // searching in the middle finds exactly one element
+    EgoTest_Assert(1 == quadTree.find(128, 128, 50).size());
+
+    // searching the whole tree finds all elements
+    EgoTest_Assert(elements.size() == quadTree.find(128, 128, 128).size());
+
+    // move all elements into the bottom right corner and rebuild the tree
+    for (const std::shared_ptr<QuadTreeElement> &element : elements)
+    {
+        float x = Random::next(128, 246);
+        float y = Random::next(128, 246);
+        element->getAABB2D()._min = Vector2f(x, y);
+        element->getAABB2D()._max = Vector2f(x + 10, y + 10);
+    }
+    quadTree.clear(0, 0, 256, 256);
+    for (const std::shared_ptr<QuadTreeElement> &element : elements)
+    {
+        quadTree.insert(element);
+    }
+
+    std::vector<std::shared_ptr<QuadTreeElement>> result;
+    quadTree.find(AABB_2D(Vector2f(128, 128), Vector2f(256, 256)), result);
+    EgoTest_Assert(elements.size() == result.size());
+
+    result.clear();
+    quadTree.find(AABB_2D(Vector2f(0, 0), Vector2f(256, 127)), result);
+    EgoTest_Assert(result.empty());
+}
+
+EgoTest_Test(update)
+{
+    Ego::QuadTree<QuadTreeElement> quadTree;
+    std::vector<std::shared_ptr<QuadTreeElement>> elements;
+
+    quadTree.clear(0, 0, 256, 256);
+
+    // fill one quadrant so the tree has to subdivide
+    for (int i = 0; i < 32; ++i)
+    {
+        elements.push_back(std::make_shared<QuadTreeElement>(Random::next(10, 110), Random::next(10, 110), 2));
+        quadTree.insert(elements.back());
+    }
+    EgoTest_Assert(elements.size() == quadTree.size());
+    EgoTest_Assert(elements.size() == quadTree.find(64, 64, 64).size());
+
+    // updating elements that did not move does not re-insert anything
+    quadTree.resetReinsertionCount();
+    for (const std::shared_ptr<QuadTreeElement> &element : elements)
+    {
+        EgoTest_Assert(!quadTree.update(element));
+    }
+    EgoTest_Assert(0 == quadTree.getReinsertionCount());
+
+    // move every element to the opposite quadrant and update it in place
+    for (const std::shared_ptr<QuadTreeElement> &element : elements)
+    {
+        element->getAABB2D()._min += Vector2f(128, 128);
+        element->getAABB2D()._max += Vector2f(128, 128);
+        EgoTest_Assert(quadTree.update(element));
+    }
+    EgoTest_Assert(elements.size() == quadTree.getReinsertionCount());
+    EgoTest_Assert(quadTree.find(64, 64, 63).empty());
+    EgoTest_Assert(elements.size() == quadTree.find(192, 192, 64).size());
+
+    // removing the elements hands the nodes back to the pool
+    for (const std::shared_ptr<QuadTreeElement> &element : elements)
+    {
+        EgoTest_Assert(quadTree.remove(element.get()));
+        EgoTest_Assert(!quadTree.contains(element.get()));
+    }
+    EgoTest_Assert(0 == quadTree.size());
+    EgoTest_Assert(1 == quadTree.getNodeCount());
+    EgoTest_Assert(quadTree.find(128, 128, 128).empty());
+}
+
+EgoTest_Test(query)
+{
+    // compare the allocation-free visitor against find() on the same search points
+    static const size_t QUERIES = 10000;
+    static const float SIZE = 4096.0f;
+
+    for (size_t count : { 100, 1000, 10000 })
+    {
+        Ego::QuadTree<QuadTreeElement> quadTree;
+        std::vector<std::shared_ptr<QuadTreeElement>> elements;
+
+        quadTree.clear(0, 0, SIZE, SIZE);
+        for (size_t i = 0; i < count; ++i)
+        {
+            elements.push_back(std::make_shared<QuadTreeElement>(Random::next(0, static_cast<int>(SIZE)), Random::next(0, static_cast<int>(SIZE)), Random::next(5, 50)));
+            quadTree.insert(elements.back());
+        }
+
+        std::vector<Vector2f> searchPoints;
+        for (size_t i = 0; i < QUERIES; ++i)
+        {
+            searchPoints.push_back(Vector2f(Random::next(0, static_cast<int>(SIZE)), Random::next(0, static_cast<int>(SIZE))));
+        }
+
+        // a new vector of shared pointers per query
+        size_t foundShared = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (const Vector2f &point : searchPoints)
+        {
+            foundShared += quadTree.find(point[kX], point[kY], 256.0f).size();
+        }
+        auto sharedTime = std::chrono::high_resolution_clock::now() - start;
+
+        // a visitor without any allocations or reference counting
+        size_t foundVisitor = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (const Vector2f &point : searchPoints)
+        {
+            AABB_2D searchArea = AABB_2D(Vector2f(point[kX] - 256.0f, point[kY] - 256.0f), Vector2f(point[kX] + 256.0f, point[kY] + 256.0f));
+            quadTree.query(searchArea, [&foundVisitor](QuadTreeElement&) { foundVisitor++; });
+        }
+        auto visitorTime = std::chrono::high_resolution_clock::now() - start;
+
+        EgoTest_Assert(foundShared == foundVisitor);
+
+        std::cout << "QuadTree " << count << " elements: "
+                  << std::chrono::duration_cast<std::chrono::nanoseconds>(sharedTime).count() / QUERIES << " ns/find(), "
+                  << std::chrono::duration_cast<std::chrono::nanoseconds>(visitorTime).count() / QUERIES << " ns/query()" << std::endl;
+    }
+}
+
+EgoTest_EndTestCase()
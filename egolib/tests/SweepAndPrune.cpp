@@ -0,0 +1,121 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+#include "EgoTest/EgoTest.hpp"
+#include "egolib/egolib.h"
+#include "egolib/Scene/SweepAndPrune.hpp"
+
+EgoTest_DeclareTestCase(SweepAndPrune)
+EgoTest_EndDeclaration()
+
+EgoTest_BeginTestCase(SweepAndPrune)
+
+/// Keep all pairs but the ones of two particles.
+static bool notTwoParticles(BSP_leaf_t *first, BSP_leaf_t *second)
+{
+    return BSP_LEAF_PRT != first->_type || BSP_LEAF_PRT != second->_type;
+}
+
+static bool anyLeaf(BSP_leaf_t *leaf)
+{
+    return true;
+}
+
+EgoTest_Test(pairs)
+{
+    // Boxes of different sizes drift around, some of them disappear and come back.
+    // Every update must find the same pairs as a brute force test.
+    static const size_t LEAVES = 300;
+    static const size_t UPDATES = 50;
+
+    uint32_t seed = 1;
+    auto random = [&seed]() { seed = seed * 1664525u + 1013904223u; return (seed >> 8) / 16777216.0f; };
+
+    std::vector<BSP_leaf_t> leaves(LEAVES);
+    std::vector<fvec3_t> positions(LEAVES), sizes(LEAVES);
+    for (size_t i = 0; i < LEAVES; ++i)
+    {
+        positions[i] = fvec3_t(random() * 1000.0f, random() * 1000.0f, random() * 100.0f);
+        sizes[i] = fvec3_t(5.0f + random() * 40.0f, 5.0f + random() * 40.0f, 5.0f + random() * 40.0f);
+        leaves[i].set(&leaves[i], 0 == i % 2 ? BSP_LEAF_CHR : BSP_LEAF_PRT, i);
+    }
+
+    BSP::SweepAndPrune sweepAndPrune;
+    Ego::DynamicArray<BSP_leaf_t *> overlaps;
+    overlaps.ctor(LEAVES);
+
+    std::vector<aabb_t> boxes(LEAVES);
+    for (size_t update = 0; update < UPDATES; ++update)
+    {
+        std::vector<bool> present(LEAVES);
+        for (size_t i = 0; i < LEAVES; ++i)
+        {
+            positions[i] += fvec3_t(random() * 10.0f - 5.0f, random() * 10.0f - 5.0f, 0.0f);
+            boxes[i] = aabb_t(positions[i] - sizes[i], positions[i] + sizes[i]);
+            present[i] = random() < 0.9f;
+            if (present[i])
+            {
+                sweepAndPrune.insert(&leaves[i], boxes[i]);
+            }
+        }
+        sweepAndPrune.update(notTwoParticles);
+
+        size_t presentCount = 0;
+        for (size_t i = 0; i < LEAVES; ++i)
+        {
+            if (present[i]) presentCount++;
+        }
+        EgoTest_Assert(presentCount == sweepAndPrune.size());
+
+        // each pair once
+        std::vector<std::vector<bool>> found(LEAVES, std::vector<bool>(LEAVES));
+        for (const BSP::SweepAndPrune::Pair& pair : sweepAndPrune.getPairs())
+        {
+            size_t i = pair.first->_index, j = pair.second->_index;
+            EgoTest_Assert(!found[i][j] && !found[j][i]);
+            found[i][j] = found[j][i] = true;
+        }
+
+        for (size_t i = 0; i < LEAVES; ++i)
+        {
+            overlaps.clear();
+            sweepAndPrune.getOverlaps(&leaves[i], anyLeaf, overlaps);
+
+            std::vector<bool> overlapping(LEAVES);
+            for (size_t j = 0; j < overlaps.size(); ++j)
+            {
+                overlapping[overlaps.ary[j]->_index] = true;
+            }
+            for (size_t j = 0; j < LEAVES; ++j)
+            {
+                bool expected = i != j && present[i] && present[j] && notTwoParticles(&leaves[i], &leaves[j]) &&
+                                aabb_intersects_aabb(boxes[i], boxes[j]) > Ego::Math::Relation::outside;
+                EgoTest_Assert(expected == found[i][j]);
+                EgoTest_Assert(expected == overlapping[j]);
+            }
+        }
+    }
+
+    sweepAndPrune.removeAllLeaves();
+    EgoTest_Assert(0 == sweepAndPrune.size());
+    EgoTest_Assert(sweepAndPrune.getPairs().empty());
+    overlaps.dtor();
+}
+
+EgoTest_EndTestCase()
@@ -0,0 +1,101 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+#include "EgoTest/EgoTest.hpp"
+#include "egolib/egolib.h"
+#include "egolib/Core/ThreadPool.hpp"
+
+EgoTest_DeclareTestCase(ThreadPool)
+EgoTest_EndDeclaration()
+
+EgoTest_BeginTestCase(ThreadPool)
+
+EgoTest_Test(parallelFor)
+{
+    Ego::ThreadPool::initialize();
+    Ego::ThreadPool& pool = Ego::ThreadPool::get();
+
+    static const size_t COUNT = 10000;
+    std::vector<int> visits(COUNT, 0);
+    const size_t chunkCount = pool.getChunkCount(COUNT, 16);
+    std::vector<size_t> chunkSizes(chunkCount, 0);
+
+    pool.parallelFor(COUNT, 16, [&visits, &chunkSizes](size_t begin, size_t end, size_t chunk)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            visits[i]++;
+        }
+        chunkSizes[chunk] = end - begin;
+    });
+
+    // every element is visited exactly once
+    for (size_t i = 0; i < COUNT; ++i)
+    {
+        EgoTest_Assert(1 == visits[i]);
+    }
+    size_t total = 0;
+    for (size_t size : chunkSizes)
+    {
+        EgoTest_Assert(size >= 16);
+        total += size;
+    }
+    EgoTest_Assert(COUNT == total);
+
+    // nothing to do
+    pool.parallelFor(0, 16, [](size_t, size_t, size_t) { throw std::runtime_error("called for an empty range"); });
+
+    Ego::ThreadPool::uninitialize();
+}
+
+EgoTest_Test(exceptions)
+{
+    Ego::ThreadPool::initialize();
+    Ego::ThreadPool& pool = Ego::ThreadPool::get();
+
+    bool caught = false;
+    try
+    {
+        pool.parallelFor(1000, 1, [](size_t begin, size_t end, size_t chunk)
+        {
+            if (0 == chunk) throw std::runtime_error("chunk failed");
+        });
+    }
+    catch (std::runtime_error&)
+    {
+        caught = true;
+    }
+    EgoTest_Assert(caught);
+
+    std::future<void> future = pool.submit([]() { throw std::runtime_error("task failed"); });
+    caught = false;
+    try
+    {
+        future.get();
+    }
+    catch (std::runtime_error&)
+    {
+        caught = true;
+    }
+    EgoTest_Assert(caught);
+
+    Ego::ThreadPool::uninitialize();
+}
+
+EgoTest_EndTestCase()
@@ -29,7 +29,13 @@
 #include "game/renderer_2d.h"
 #include "game/game.h"
 #include "game/collision.h"
+#include "egolib/Core/ThreadPool.hpp"
 #include "game/Entities/_Include.hpp"
+#include "game/graphic_billboard.h"
+#include "game/link.h"
+#include "game/bsp.h"
+#include "game/replay.h"
+#include <physfs.h>
 
 //Global singelton
 std::unique_ptr<GameEngine> _gameEngine;
@@ -43,12 +49,17 @@ const uint32_t GameEngine::DELAY_PER_UPDATE_FRAME;
 
 const uint32_t GameEngine::MAX_FRAMESKIP;
 
+const uint32_t GameEngine::DEFAULT_HEADLESS_UPDATES;
+
+const uint32_t GameEngine::DEFAULT_SCRIPT_BENCHMARK_UPDATES;
+
 const std::string GameEngine::GAME_VERSION = "2.9.0";
 
 GameEngine::GameEngine() :
     _startupTimestamp(),
 	_isInitialized(false),
 	_terminateRequested(false),
+	_headless(false),
 	_updateTimeout(0),
 	_renderTimeout(0),
 	_gameStateStack(),
@@ -136,6 +147,271 @@ void GameEngine::start()
     uninitialize();
 }
 
+bool GameEngine::runHeadless(const std::string& moduleName, uint32_t updates)
+{
+    _headless = true;
+    initialize();
+    _startupTimestamp = std::chrono::high_resolution_clock::now();
+
+    const bool loaded = loadHeadlessModule(moduleName);
+    if (loaded)
+    {
+        // Update as fast as possible, without the timers of start().
+        // A replay runs up to its last recorded update instead of the given number of updates.
+        const bool replaying = replay_is_replaying();
+        game_reset_update_times();
+        Ego::Time::Stopwatch stopwatch;
+        stopwatch.start();
+        uint32_t done = 0;
+        while (replaying ? !replay_is_finished() : done < updates)
+        {
+            update_game();
+            done++;
+        }
+        stopwatch.stop();
+
+        printHeadlessReport(moduleName, done, stopwatch.elapsed());
+        game_quit_module();
+    }
+
+    uninitialize();
+    return loaded;
+}
+
+bool GameEngine::runScriptBenchmark(const std::string& moduleName, uint32_t updates)
+{
+    _headless = true;
+    initialize();
+    _startupTimestamp = std::chrono::high_resolution_clock::now();
+
+    std::vector<std::string> moduleNames;
+    if (moduleName == "all")
+    {
+        for (const std::shared_ptr<ModuleProfile> &profile : ProfileSystem::get().getModuleProfiles())
+        {
+            moduleNames.push_back(profile->getFolderName());
+        }
+    }
+    else
+    {
+        moduleNames.push_back(moduleName);
+    }
+
+    // The interpreters only count their instructions if the script timing is enabled.
+    egoboo_config_t& config = egoboo_config_t::get();
+    const bool predecoded = config.debug_scripts_predecoded_enable.getValue();
+    const bool timing = config.debug_scripts_timing_enable.getValue();
+    config.debug_scripts_timing_enable.setValue(true);
+
+    static const char *interpreterNames[2] = { "raw", "pre-decoded" };
+    size_t totalInstructions[2] = { 0, 0 };
+    double totalSeconds[2] = { 0.0, 0.0 };
+    bool success = true;
+    for (const std::string& name : moduleNames)
+    {
+        size_t instructions[2] = { 0, 0 };
+        double seconds[2] = { 0.0, 0.0 };
+        bool loaded = true;
+        for (size_t decoded = 0; decoded < 2 && loaded; ++decoded)
+        {
+            config.debug_scripts_predecoded_enable.setValue(1 == decoded);
+            loaded = loadHeadlessModule(name);
+            if (!loaded) break;
+
+            scr_reset_interpreter_stats();
+            for (uint32_t i = 0; i < updates; ++i)
+            {
+                update_game();
+            }
+            scr_get_interpreter_stats(1 == decoded, instructions[decoded], seconds[decoded]);
+            game_quit_module();
+        }
+        if (!loaded)
+        {
+            success = false;
+            continue;
+        }
+
+        printf("%s:\n", name.c_str());
+        for (size_t decoded = 0; decoded < 2; ++decoded)
+        {
+            printf("    %-12s %12" PRIuZ " instructions %8.2f ns per instruction\n", interpreterNames[decoded], instructions[decoded],
+                   instructions[decoded] > 0 ? seconds[decoded] * 1.0e9 / instructions[decoded] : 0.0);
+            totalInstructions[decoded] += instructions[decoded];
+            totalSeconds[decoded] += seconds[decoded];
+        }
+    }
+    if (moduleNames.size() > 1)
+    {
+        printf("all modules:\n");
+        for (size_t decoded = 0; decoded < 2; ++decoded)
+        {
+            printf("    %-12s %12" PRIuZ " instructions %8.2f ns per instruction\n", interpreterNames[decoded], totalInstructions[decoded],
+                   totalInstructions[decoded] > 0 ? totalSeconds[decoded] * 1.0e9 / totalInstructions[decoded] : 0.0);
+        }
+    }
+    fflush(stdout);
+
+    config.debug_scripts_predecoded_enable.setValue(predecoded);
+    config.debug_scripts_timing_enable.setValue(timing);
+
+    uninitialize();
+    return success;
+}
+
+//Collect all .txt files below a directory of the virtual file system, for runVfsBenchmark()
+static void findTextFiles(const std::string& directory, std::vector<std::string>& files)
+{
+    char **list = vfs_enumerateFiles(directory.c_str());
+    if (!list)
+    {
+        return;
+    }
+
+    for (char **name = list; nullptr != *name; ++name)
+    {
+        std::string path = directory.empty() ? std::string(*name) : directory + "/" + *name;
+        if (vfs_isDirectory(path))
+        {
+            findTextFiles(path, files);
+        }
+        else if (path.size() > 4 && 0 == path.compare(path.size() - 4, 4, ".txt"))
+        {
+            files.push_back(path);
+        }
+    }
+
+    vfs_freeList(list);
+}
+
+bool GameEngine::runVfsBenchmark()
+{
+    std::vector<std::string> files;
+    findTextFiles("", files);
+
+    //Old path: one library call per byte
+    size_t bytesUnbuffered = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (const std::string& file : files)
+    {
+        PHYSFS_File *pfile = PHYSFS_openRead(file.c_str());
+        if (!pfile) continue;
+        unsigned char byte;
+        while (1 == PHYSFS_read(pfile, &byte, 1, 1))
+        {
+            bytesUnbuffered++;
+        }
+        PHYSFS_close(pfile);
+    }
+    const double unbufferedSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+    //New path: read through the buffer of the vfs_FILE
+    size_t bytesBuffered = 0;
+    start = std::chrono::high_resolution_clock::now();
+    for (const std::string& file : files)
+    {
+        vfs_FILE *vfile = vfs_openRead(file);
+        if (!vfile) continue;
+        unsigned char byte;
+        while (1 == vfs_read(&byte, 1, 1, vfile))
+        {
+            bytesBuffered++;
+        }
+        vfs_close(vfile);
+    }
+    const double bufferedSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+    //Both paths must read the same bytes
+    if (bytesUnbuffered != bytesBuffered)
+    {
+        printf("vfs benchmark: %" PRIuZ " bytes unbuffered, but %" PRIuZ " bytes buffered\n", bytesUnbuffered, bytesBuffered);
+        return false;
+    }
+
+    printf("vfs benchmark: %" PRIuZ " files, %" PRIuZ " bytes\n", files.size(), bytesBuffered);
+    printf("    %-12s %14.0f bytes/s\n", "PHYSFS_read", unbufferedSeconds > 0.0 ? bytesUnbuffered / unbufferedSeconds : 0.0);
+    printf("    %-12s %14.0f bytes/s\n", "vfs_read", bufferedSeconds > 0.0 ? bytesBuffered / bufferedSeconds : 0.0);
+    fflush(stdout);
+
+    return true;
+}
+
+bool GameEngine::loadHeadlessModule(const std::string& moduleName)
+{
+    std::shared_ptr<ModuleProfile> module = nullptr;
+    for (const std::shared_ptr<ModuleProfile> &profile : ProfileSystem::get().getModuleProfiles())
+    {
+        if (profile->getFolderName() == moduleName)
+        {
+            module = profile;
+            break;
+        }
+    }
+    if (!module)
+    {
+        log_warning("%s - there is no module \"%s\"\n", __FUNCTION__, moduleName.c_str());
+        return false;
+    }
+
+    // The same as LoadingState::loadModuleData(), without players.
+    game_quit_module();
+    BillboardSystem::get()._billboardList.reset();
+    make_turntosin();
+    link_build_vfs("mp_data/link.txt", LinkList);
+    CollisionSystem::get()->reset();
+    DisplayMsg_reset();
+    ProfileSystem::get().reset();
+    gfx_system_make_enviro();
+
+    if (!game_begin_module(module))
+    {
+        log_warning("%s - failed to load module \"%s\"\n", __FUNCTION__, moduleName.c_str());
+        return false;
+    }
+
+    std::shared_ptr<CameraSystem> cameraSystem = CameraSystem::request(local_stats.player_count);
+    obj_BSP_system_begin(getMeshBSP());
+
+    // Scripts expect a PlayingState, e.g. for the mini map. It is not begun, there is no window to grab the mouse.
+    _gameStateStack.clear();
+    _currentGameState = std::make_shared<PlayingState>(cameraSystem);
+    _gameStateStack.push_front(_currentGameState);
+
+    return true;
+}
+
+void GameEngine::printHeadlessReport(const std::string& moduleName, uint32_t updates, double seconds) const
+{
+    const struct
+    {
+        const char *name;
+        double time;
+    } parts[] =
+    {
+        { "scripts",   update_times.scripts },
+        { "movement",  update_times.movement },
+        { "collision", update_times.collision },
+        { "particles", update_times.particles },
+        { "enchants",  update_times.enchants },
+    };
+
+    double other = seconds;
+    for (const auto& part : parts)
+    {
+        other -= part.time;
+    }
+
+    const double updatesPerSecond = seconds > 0.0 ? updates / seconds : 0.0;
+    printf("%s: %u updates in %.3f seconds, %.1f updates per second\n", moduleName.c_str(), updates, seconds, updatesPerSecond);
+    log_info("%s: %u updates in %.3f seconds, %.1f updates per second\n", moduleName.c_str(), updates, seconds, updatesPerSecond);
+    for (const auto& part : parts)
+    {
+        printf("    %-10s %8.3f ms per update %6.1f%%\n", part.name, 1000.0 * part.time / std::max<uint32_t>(updates, 1), seconds > 0.0 ? 100.0 * part.time / seconds : 0.0);
+    }
+    printf("    %-10s %8.3f ms per update %6.1f%%\n", "other", 1000.0 * other / std::max<uint32_t>(updates, 1), seconds > 0.0 ? 100.0 * other / seconds : 0.0);
+    fflush(stdout);
+}
+
 void GameEngine::estimateFrameRate()
 {
     const float dt = (SDL_GetTicks()-_lastFrameEstimation) * 0.001f;
@@ -202,6 +478,9 @@ void GameEngine::renderOneFrame()
     gfx_request_clear_screen();
     gfx_do_clear_screen();
 
+    // upload the textures which were decoded in the background
+    TextureManager::get().updateStreaming();
+
     _currentGameState->drawAll();
     game_frame_all++;
 
@@ -240,6 +519,12 @@ void GameEngine::renderPreloadText(const std::string &text)
 {
     static std::string preloadText("");
 
+    if (_headless)
+    {
+        log_info("%s\n", text.c_str());
+        return;
+    }
+
     preloadText += text + "\n";
     
     gfx_request_clear_screen();
@@ -286,9 +571,17 @@ bool GameEngine::initialize()
     ImageManager::initialize();
 
     // Initialize GFX system.
-    GFX::initialize();
-    gfx_system_init_all_graphics();
-    gfx_do_clear_screen();
+    if (_headless)
+    {
+        GFX::initializeHeadless();
+        gfx_system_init_all_graphics();
+    }
+    else
+    {
+        GFX::initialize();
+        gfx_system_init_all_graphics();
+        gfx_do_clear_screen();
+    }
 
     // setup the system gui
     _uiManager = std::unique_ptr<UIManager>(new UIManager());
@@ -308,8 +601,11 @@ bool GameEngine::initialize()
     renderPreloadText("Loading audio...");
     AudioSystem::initialize();
     auto& audioSystem = AudioSystem::get();
-    audioSystem.loadAllMusic();
-    audioSystem.playMusic(AudioSystem::MENU_SONG);
+    if (!_headless)
+    {
+        audioSystem.loadAllMusic();
+        audioSystem.playMusic(AudioSystem::MENU_SONG);
+    }
     audioSystem.loadGlobalSounds();
 
     // synchronize the config values with the various game subsystems
@@ -330,6 +626,9 @@ bool GameEngine::initialize()
     // Initialize Perks
     Ego::Perks::PerkHandler::initialize();
 
+    // Initialize the thread pool.
+    Ego::ThreadPool::initialize();
+
     // Initialize the profile system.
     Ego::Core::Singleton<ParticleProfileSystem>::initialize(); //explicit static member call to avoid ambigious call
     ProfileSystem::initialize();
@@ -350,7 +649,10 @@ bool GameEngine::initialize()
     vfs_empty_temp_directories();
 
     //Start the main menu
-    pushGameState(std::make_shared<MainMenuState>());
+    if (!_headless)
+    {
+        pushGameState(std::make_shared<MainMenuState>());
+    }
 
     return true;
 }
@@ -363,14 +665,17 @@ void GameEngine::uninitialize()
     _currentGameState.reset();
     _currentModule.release();
 
-    // synchronize the config values with the various game subsystems
-    config_synch(&egoboo_config_t::get(), true, true);
+    // synchronize the config values with the various game subsystems, a headless run does not change them
+    config_synch(&egoboo_config_t::get(), true, !_headless);
 
     // delete all the graphics allocated by SDL and OpenGL
     gfx_system_delete_all_graphics();
 
     // make sure that the current control configuration is written
-    input_settings_save_vfs("controls.txt", -1);
+    if (!_headless)
+    {
+        input_settings_save_vfs("controls.txt", -1);
+    }
 
     // @todo This should be 'UIManager::uninitialize'.
     _uiManager.reset(nullptr);
@@ -384,6 +689,9 @@ void GameEngine::uninitialize()
     // Uninitialize the profile system.
     ProfileSystem::uninitialize();
 
+    // Uninitialize the thread pool.
+    Ego::ThreadPool::uninitialize();
+
     // Uninitialize the console.
     egolib_console_handler_t::uninitialize();
 
@@ -391,7 +699,14 @@ void GameEngine::uninitialize()
     AudioSystem::uninitialize();
 
     // Uninitialize the GFX system.
-    GFX::uninitialize();
+    if (_headless)
+    {
+        GFX::uninitializeHeadless();
+    }
+    else
+    {
+        GFX::uninitialize();
+    }
 
     // Uninitialize the image manager.
     ImageManager::uninitialize();
@@ -408,6 +723,12 @@ void GameEngine::setGameState(std::shared_ptr<GameState> gameState)
 
 void GameEngine::pushGameState(std::shared_ptr<GameState> gameState)
 {
+    // A headless run has no menus, e.g. a victory screen, it stays in its PlayingState.
+    if (_headless && _currentGameState)
+    {
+        return;
+    }
+
     _gameStateStack.push_front(gameState);
     _currentGameState = _gameStateStack.front();
     _currentGameState->beginState();
@@ -531,17 +852,51 @@ std::shared_ptr<PlayingState> GameEngine::getActivePlayingState() const
  *  the command-line arguments (a static constant array of @a argc pointers to static constant zero-terminated strings)
  * @return
  *  EXIT_SUCCESS upon regular termination, EXIT_FAILURE otherwise
+ * @remark
+ *  <tt>--headless module [updates]</tt> runs a module without a window, see GameEngine::runHeadless().
+ *  <tt>--script-benchmark [module|all] [updates]</tt> compares the AI script interpreters, see GameEngine::runScriptBenchmark().
+ *  <tt>--vfs-benchmark</tt> compares buffered and unbuffered reads of the data files, see GameEngine::runVfsBenchmark().
  */
 int SDL_main(int argc, char **argv)
 {
+    const bool headless = argc >= 3 && 0 == strcmp(argv[1], "--headless");
+    const bool scriptBenchmark = argc >= 2 && 0 == strcmp(argv[1], "--script-benchmark");
+    const bool vfsBenchmark = argc >= 2 && 0 == strcmp(argv[1], "--vfs-benchmark");
+    bool success = true;
+    if (headless || scriptBenchmark)
+    {
+        // SDL must not open a window or an audio device.
+        SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+        SDL_setenv("SDL_AUDIODRIVER", "dummy", 1);
+    }
+
     try
     {
         Ego::Core::System::initialize(argv[0],nullptr);
+        if (vfsBenchmark)
+        {
+            success = GameEngine::runVfsBenchmark();
+            Ego::Core::System::uninitialize();
+            return success ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
         try
         {
             _gameEngine = std::unique_ptr<GameEngine>(new GameEngine());
 
-            _gameEngine->start();
+            if (headless)
+            {
+                const uint32_t updates = argc >= 4 ? strtoul(argv[3], nullptr, 10) : GameEngine::DEFAULT_HEADLESS_UPDATES;
+                success = _gameEngine->runHeadless(argv[2], updates);
+            }
+            else if (scriptBenchmark)
+            {
+                const uint32_t updates = argc >= 4 ? strtoul(argv[3], nullptr, 10) : GameEngine::DEFAULT_SCRIPT_BENCHMARK_UPDATES;
+                success = _gameEngine->runScriptBenchmark(argc >= 3 ? argv[2] : "all", updates);
+            }
+            else
+            {
+                _gameEngine->start();
+            }
         }
         catch (...)
         {
@@ -566,5 +921,5 @@ int SDL_main(int argc, char **argv)
         std::cerr << "unhandled exception" << std::endl;
         return EXIT_FAILURE;
     }
-    return EXIT_SUCCESS;
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
 }
@@ -46,6 +46,9 @@ public:
 
     static const std::string GAME_VERSION;		///< Version of the game
 
+    static const uint32_t DEFAULT_HEADLESS_UPDATES = 60 * GAME_TARGET_UPS;	///< Updates of runHeadless() if none are given, one minute of game time
+    static const uint32_t DEFAULT_SCRIPT_BENCHMARK_UPDATES = 10 * GAME_TARGET_UPS;	///< Updates of runScriptBenchmark() if none are given, ten seconds of game time
+
     /**
     * @brief
     *	Default constructor of a GameEngine. Actual initialization, allocation and loading is
@@ -61,6 +64,46 @@ public:
     **/
     void start();
 
+    /**
+    * @brief
+    *	A blocking function like start() which runs a module without a window, an OpenGL context or audio output,
+    *	e.g. to measure the throughput of the simulation. The module is loaded without players and updated
+    *	as fast as possible. The updates per second and the time spent in the parts of update_game() are
+    *	printed when the updates are done.
+    * @param moduleName
+    *	the folder name of the module, e.g. "adventurer.mod"
+    * @param updates
+    *	the number of updates. If the module is replayed, see debug.inputRecording.mode, it is updated up to
+    *	the last recorded update instead.
+    * @return
+    *	true if the module was loaded and updated, false otherwise
+    **/
+    bool runHeadless(const std::string& moduleName, uint32_t updates);
+
+    /**
+    * @brief
+    *	Like runHeadless(), but compares the AI script interpreters. Each module is loaded and updated twice,
+    *	once interpreting the compiled words of the scripts and once running their pre-decoded instructions.
+    *	The instructions run and the nanoseconds per instruction of both interpreters are printed.
+    * @param moduleName
+    *	the folder name of the module or "all" for every module
+    * @param updates
+    *	the number of updates per run
+    * @return
+    *	true if all modules were loaded and updated, false otherwise
+    **/
+    bool runScriptBenchmark(const std::string& moduleName, uint32_t updates);
+
+    /**
+    * @brief
+    *	Compare the reads of the virtual file system with and without its read buffer. All .txt files of the
+    *	data directory are read one byte at a time, as ReadContext does, once with PHYSFS_read() and once with
+    *	vfs_read(). The bytes per second of both are printed. Needs no GameEngine, only the virtual file system.
+    * @return
+    *	true if both reads read the same bytes, false otherwise
+    **/
+    static bool runVfsBenchmark();
+
     /**
     * @return
     *	true if the GameEngine is currently running and is not terminated
@@ -209,10 +252,23 @@ private:
     **/
     void renderPreloadText(const std::string &text);
 
+    /**
+    * @brief
+    *	Load a module without players like the LoadingState does and make it the PlayingState, for runHeadless().
+    **/
+    bool loadHeadlessModule(const std::string& moduleName);
+
+    /**
+    * @brief
+    *	Print the updates per second and the time spent in the parts of update_game(), for runHeadless().
+    **/
+    void printHeadlessReport(const std::string& moduleName, uint32_t updates, double seconds) const;
+
 private:
     std::chrono::high_resolution_clock::time_point _startupTimestamp;
     bool _isInitialized;
     bool _terminateRequested;		///< true if the GameEngine should deinitialize and shutdown
+    bool _headless;				///< true if the GameEngine runs without a window, see runHeadless()
     uint32_t _updateTimeout;		///< Timestamp when updateOneFrame() should be run again
     uint32_t _renderTimeout;		///< Timestamp when renderOneFrame() should be run again
     
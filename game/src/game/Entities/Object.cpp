@@ -166,7 +166,8 @@ Object::Object(const PRO_REF profile, const CHR_REF id) :
     _baseAttribute(),
     _inventory(),
     _perks(),
-    _hasBeenKilled(false)
+    _hasBeenKilled(false),
+    _firstAttachedParticle(nullptr)
 {
     // Grip info
     holdingwhich.fill(INVALID_CHR_REF);
@@ -227,6 +228,12 @@ Object::~Object()
         disaffirm_attached_particles( getCharacterID() );    
     }
 
+    // the particles still attached must not refer to this object anymore
+    while ( nullptr != _firstAttachedParticle )
+    {
+        _firstAttachedParticle->unlinkAttached();
+    }
+
     chr_instance_t::dtor(inst);
 
     EGOBOO_ASSERT( nullptr == inst.vrt_lst );    
@@ -1200,7 +1207,7 @@ const std::shared_ptr<Object>& Object::getRightHandItem() const
     return _currentModule->getObjectHandler()[holdingwhich[SLOT_RIGHT]];
 }
 
-bool Object::canSeeObject(const std::shared_ptr<Object> &target) const
+bool Object::canSeeObject(const Object &target) const
 {
     /// @note ZF@> Invictus characters can always see through darkness (spells, items, quest handlers, etc.)
     // Scenery, spells and quest objects can always see through darkness
@@ -1211,8 +1218,8 @@ bool Object::canSeeObject(const std::shared_ptr<Object> &target) const
     }
 
     //Too Dark?
-    int enviro_light = ( target->inst.alpha * target->inst.max_light ) * INV_FF;
-    int self_light   = ( target->inst.light == 255 ) ? 0 : target->inst.light;
+    int enviro_light = ( target.inst.alpha * target.inst.max_light ) * INV_FF;
+    int self_light   = ( target.inst.light == 255 ) ? 0 : target.inst.light;
     int light        = std::max(enviro_light, self_light);
     if (0 != darkvision_level) {
         light *= expf(0.32f * static_cast<float>(darkvision_level));
@@ -1222,7 +1229,7 @@ bool Object::canSeeObject(const std::shared_ptr<Object> &target) const
     }
 
     //Too invisible?
-    int alpha = target->inst.alpha;
+    int alpha = target.inst.alpha;
     if (canSeeInvisible())
     {
         alpha = get_alpha(alpha, expf(0.32f * static_cast<float>(see_invisible_level)));
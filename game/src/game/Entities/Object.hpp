@@ -413,7 +413,7 @@ public:
     * @return
     *   true if this Object has line of sight and can see the specified Object
     **/
-    bool canSeeObject(const std::shared_ptr<Object> &target) const;
+    bool canSeeObject(const Object &target) const;
 
     /**
     * @brief Set the fat value of a character.
@@ -582,6 +582,13 @@ public:
     **/
     Inventory& getInventory();
 
+    /**
+    * @return
+    *   the first of the particles attached to this Object (or nullptr if there are none).
+    *   The other particles are found with Ego::Particle::getNextAttachedParticle().
+    **/
+    Ego::Particle* getFirstAttachedParticle() const { return _firstAttachedParticle; }
+
     uint16_t getAmmo() const { return ammo; }
 
     /**
@@ -812,6 +819,8 @@ private:
     Inventory _inventory;
     std::bitset<Ego::Perks::NR_OF_PERKS> _perks;         ///< Perks known (super-efficient bool array)
     bool _hasBeenKilled;                                 ///< If this Object has been killed at least once this module (many can respawn)
+    Ego::Particle *_firstAttachedParticle;               ///< Head of the list of attached, non-terminated particles
 
     friend class ObjectHandler;
+    friend class Ego::Particle;
 };
@@ -44,7 +44,8 @@ ObjectHandler::ObjectHandler() :
     _semaphore(0),
     _deletedCharacters(0),
     _totalCharactersSpawned(0),
-    _dynamicObjects()
+    _dynamicObjects(),
+    _teamObjects()
 {
 	_internalCharacterList.reserve(OBJECTS_MAX);
     _iteratorList.reserve(OBJECTS_MAX);
@@ -184,6 +185,10 @@ const std::shared_ptr<Object>& ObjectHandler::operator[] (const CHR_REF index)
 void ObjectHandler::clear()
 {
     while(!_unusedChrRefs.empty()) _unusedChrRefs.pop();
+    _dynamicObjects.clear();
+    for(std::vector<CHR_REF> &teamObjects : _teamObjects) {
+        teamObjects.clear();
+    }
 	_internalCharacterList.clear();
 	_iteratorList.clear();
     _deletedCharacters = 0;
@@ -259,6 +264,7 @@ void ObjectHandler::maybeRunDeferred()
                 {
                     //Delete this character
                     _unusedChrRefs.push(element->getCharacterID());
+                    _dynamicObjects.remove(element.get());
                     _deletedCharacters--;
 
                     // Make sure everyone knows it died
@@ -319,15 +325,37 @@ size_t ObjectHandler::getObjectCount() const
 
 void ObjectHandler::updateQuadTree(float minX, float minY, float maxX, float maxY)
 {
-    //Reset quad-tree
-    _dynamicObjects.clear(minX, minY, maxX, maxY);
+    //Only rebuild the quad-tree from scratch if the level size changed
+    const AABB_2D &bounds = _dynamicObjects.getBounds();
+    if(bounds.getMin()[kX] != minX || bounds.getMin()[kY] != minY || bounds.getMax()[kX] != maxX || bounds.getMax()[kY] != maxY) {
+        _dynamicObjects.clear(minX, minY, maxX, maxY);
+    }
 
-    //Rebuild quad-tree
+    //Move objects that have left their cell and sort the objects by team
+    _dynamicObjects.resetReinsertionCount();
+    for(std::vector<CHR_REF> &teamObjects : _teamObjects) {
+        teamObjects.clear();
+    }
     for(const std::shared_ptr<Object> &object : _iteratorList) {
-        _dynamicObjects.insert(object);
+        if(object->isTerminated()) {
+            _dynamicObjects.remove(object.get());
+        }
+        else {
+            _dynamicObjects.update(object);
+            if(object->team < Team::TEAM_MAX) {
+                _teamObjects[object->team].push_back(object->getCharacterID());
+            }
+        }
     }
 }
 
-std::vector<std::shared_ptr<Object>> ObjectHandler::findObjects(const float x, const float y, const float distance) const { 
-    return _dynamicObjects.find(x, y, distance);
+const std::vector<CHR_REF>& ObjectHandler::getTeamObjects(const TEAM_REF team) const
+{
+    return _teamObjects[team];
 }
+
+size_t ObjectHandler::getQuadTreeReinsertions() const
+{
+    return _dynamicObjects.getReinsertionCount();
+}
+
@@ -28,6 +28,7 @@
 
 #include "game/egoboo_typedef.h"
 #include "egolib/Core/QuadTree.hpp"
+#include "egolib/Logic/Team.hpp"
 
 //Forward declarations
 class Object;
@@ -154,17 +155,52 @@ public:
 	 */
 	Object* get(const CHR_REF index) const;
 
-	std::vector<std::shared_ptr<Object>> findObjects(const float x, const float y, const float distance) const;
+	/**
+	* @brief
+	*	Visit all objects within range of a point using the quad tree. This neither allocates
+	*	memory nor touches any reference counts.
+	* @param x, y
+	*	position of point to search from
+	* @param distance
+	*	range of search from point
+	* @param visitor
+	*	Callable invoked as visitor(Object&) for each object found
+	**/
+	template<typename Visitor>
+	void findObjects(const float x, const float y, const float distance, Visitor &&visitor) const
+	{
+		_dynamicObjects.query(AABB_2D(Vector2f(x-distance, y-distance), Vector2f(x+distance, y+distance)), std::forward<Visitor>(visitor));
+	}
 
 	/**
 	* @brief
-	* 	Clear and rebuild the quad tree for this update frame
+	* 	Update the quad tree for this update frame. Only objects that have left their
+	*	cell are re-inserted, the tree is only rebuilt if the bounds changed.
 	*	This function is NOT thread-safe
 	* @param minX, minY, maxX, maxY
 	*	Sets the bounds of this quad tree (size of the entire current level)
 	**/
 	void updateQuadTree(float minX, float minY, float maxX, float maxY);
 
+	/**
+	* @return
+	*	Number of objects that had to be re-inserted by the last updateQuadTree()
+	**/
+	size_t getQuadTreeReinsertions() const;
+
+	/**
+	* @brief
+	*	Get the objects which were on a team when updateQuadTree() was called last.
+	* @remark
+	*	Objects which were terminated or changed their team since then are still in the list,
+	*	so the caller must check them.
+	* @param team
+	*	the team
+	* @return
+	*	the references of the objects of the team
+	**/
+	const std::vector<CHR_REF>& getTeamObjects(const TEAM_REF team) const;
+
 	/**
 	* @return
 	*	All objects contained in this ObjectHandler
@@ -200,6 +236,7 @@ private:
 
 private:
 	Ego::QuadTree<Object> _dynamicObjects;
+	std::array<std::vector<CHR_REF>, Team::TEAM_MAX> _teamObjects;	///< The objects of each team, updated by updateQuadTree()
 
     std::vector<std::shared_ptr<Object>> _internalCharacterList;        ///< Indexes in this character list match CHR_REF
 	std::vector<std::shared_ptr<Object>> _iteratorList;					///< For iterating, contains only valid objects (unsorted)
@@ -39,6 +39,9 @@ Particle::Particle() :
     _bspLeaf(this, BSP_LEAF_PRT, INVALID_PRT_REF),
     _collidedObjects(),
     _attachedTo(INVALID_CHR_REF),
+    _attachedList(nullptr),
+    _attachedPrev(nullptr),
+    _attachedNext(nullptr),
     _particleProfileID(INVALID_PIP_REF),
     _particleProfile(nullptr),
     _isTerminated(true),
@@ -49,6 +52,11 @@ Particle::Particle() :
     reset(INVALID_PRT_REF);
 }
 
+Particle::~Particle()
+{
+    unlinkAttached();
+}
+
 void Particle::reset(PRT_REF ref) 
 {
     //We are terminated until we are initialized()
@@ -62,7 +70,7 @@ void Particle::reset(PRT_REF ref)
     _particleProfileID = INVALID_PIP_REF;
     _particleProfile = nullptr;
 
-    _attachedTo = INVALID_CHR_REF;
+    setAttachedTo(INVALID_CHR_REF);
     owner_ref = INVALID_CHR_REF;
     _target = INVALID_CHR_REF;
     parent_ref = INVALID_PRT_REF;
@@ -138,6 +146,50 @@ const std::shared_ptr<Object>& Particle::getAttachedObject() const
     return _currentModule->getObjectHandler()[_attachedTo];
 }
 
+void Particle::setAttachedTo(const CHR_REF attach)
+{
+    _attachedTo = attach;
+
+    Object *object = _isTerminated ? nullptr : _currentModule->getObjectHandler().get(attach);
+    if (object == _attachedList) {
+        return;
+    }
+    unlinkAttached();
+    if (!object) {
+        return;
+    }
+
+    // Add to the front of the list of the new Object
+    _attachedList = object;
+    _attachedPrev = nullptr;
+    _attachedNext = object->_firstAttachedParticle;
+    if (_attachedNext) {
+        _attachedNext->_attachedPrev = this;
+    }
+    object->_firstAttachedParticle = this;
+}
+
+void Particle::unlinkAttached()
+{
+    if (!_attachedList) {
+        return;
+    }
+
+    if (_attachedPrev) {
+        _attachedPrev->_attachedNext = _attachedNext;
+    }
+    else {
+        _attachedList->_firstAttachedParticle = _attachedNext;
+    }
+    if (_attachedNext) {
+        _attachedNext->_attachedPrev = _attachedPrev;
+    }
+
+    _attachedList = nullptr;
+    _attachedPrev = nullptr;
+    _attachedNext = nullptr;
+}
+
 
 bool Particle::setPosition(const fvec3_t& position)
 {
@@ -322,6 +374,9 @@ void Particle::setSize(int size)
 void Particle::requestTerminate()
 {
     _isTerminated = true;
+
+    //Terminated particles no longer count as attached
+    unlinkAttached();
 }
 
 void Particle::setElevation(const float level)
@@ -381,7 +436,7 @@ void Particle::update()
 
     //Clear invalid attachements incase Object have been removed from the game
     if(!isAttached()) {
-        _attachedTo = INVALID_CHR_REF;
+        setAttachedTo(INVALID_CHR_REF);
     }
 
     // Determine if a "homing" particle still has something to "home":
@@ -875,7 +930,7 @@ bool Particle::initialize(const PRT_REF particleID, const fvec3_t& spawnPos, con
     }
 
     // Set character attachments ( pdata->chr_attach == INVALID_CHR_REF means none )
-    _attachedTo = spawnAttach;
+    setAttachedTo(spawnAttach);
     attachedto_vrt_off = vrt_offset;
 
     // Correct loc_facing
@@ -1221,7 +1276,7 @@ bool Particle::attach(const CHR_REF attach)
         return false;
     }
 
-    _attachedTo = attach;
+    setAttachedTo(attach);
 
     if(!placeAtVertex(pchr, attachedto_vrt_off)) {
         return false;
@@ -92,6 +92,12 @@ class Particle : public PhysicsData, public Id::NonCopyable
 {
 public:
     Particle();
+
+    /**
+     * @brief
+     *  Destructor, removes this particle from the attached particles of its Object.
+     */
+    ~Particle();
     
     /**
      * @brief
@@ -190,6 +196,14 @@ public:
     **/
     const std::shared_ptr<Object>& getAttachedObject() const;
 
+    /**
+    * @return
+    *   the next particle attached to the same Object (or nullptr if this is the last one)
+    * @see
+    *   Object::getFirstAttachedParticle()
+    **/
+    Particle* getNextAttachedParticle() const { return _attachedNext; }
+
     /**
     * @return
     *   true if this Particle has been terminated and will be removed from the game soon
@@ -328,6 +342,20 @@ private:
     **/
     void reset(PRT_REF ref);  
 
+    /**
+    * @brief
+    *   Set the Object this Particle is attached to and move this Particle
+    *   from the attached particles of the old Object to those of the new one.
+    **/
+    void setAttachedTo(const CHR_REF attach);
+
+    /**
+    * @brief
+    *   Remove this Particle from the attached particles of its Object.
+    *   The Object stored in _attachedTo is kept.
+    **/
+    void unlinkAttached();
+
 public:
     static const std::shared_ptr<Particle> INVALID_PARTICLE;
 
@@ -460,6 +488,15 @@ private:
      */
     CHR_REF _attachedTo;
 
+    /**
+     * @brief
+     *  The intrusive list of the particles attached to an Object.
+     *  A particle is in the list of _attachedList if it is attached and not terminated.
+     */
+    Object *_attachedList;
+    Particle *_attachedPrev;
+    Particle *_attachedNext;
+
     /**
      * @brief
      *  The object targeted by this particle.
@@ -475,6 +512,8 @@ private:
 
     // motion effects
     bool _isHoming;             ///< Is the particle in control of its motion?
+
+    friend class ::Object;
 };
 
 } //Ego
\ No newline at end of file
@@ -49,13 +49,13 @@ void Image::setImage(const std::string &filePath)
 int Image::getTextureWidth() 
 { 
     if(_image) return _image->getSourceWidth(); 
-    return _texture.get().getSourceWidth();
+    return _texture.getLoaded().getSourceWidth();
 }
 
 int Image::getTextureHeight() 
 { 
     if(_image) return _image->getSourceHeight(); 
-    return _texture.get().getSourceHeight();
+    return _texture.getLoaded().getSourceHeight();
 }
 
 void Image::setTint(const Ego::Math::Colour4f &colour)
@@ -33,6 +33,7 @@
 #include "game/graphic.h"
 #include "game/renderer_2d.h"
 #include "game/player.h"
+#include "game/replay.h"
 
 //For cheats
 #include "game/Entities/_Include.hpp"
@@ -119,6 +120,13 @@ void PlayingState::update()
 {
     update_game();
 
+    // A replay ends the module after its last recorded update, like the script function EndModule()
+    if (replay_is_finished())
+    {
+        _gameEngine->pushGameState(std::make_shared<VictoryScreen>(nullptr, true));
+        return;
+    }
+
     //Calculate position of all status bars
     updateStatusBarPosition();
 }
@@ -527,8 +527,7 @@ float set_character_animation_rate( Object * pchr )
         {
             if ( pinst.action_which != tmp_action )
             {
-                const MD2_Frame &nextFrame  = chr_instance_t::get_frame_nxt(pchr->inst);
-                chr_set_anim( pchr, tmp_action, pmad->getFrameLipToWalkFrame(lip, nextFrame.framelip), true, true );
+                chr_set_anim( pchr, tmp_action, pmad->getFrameLipToWalkFrame(lip, pinst.imad->getFrameLip(pinst.frame_nxt)), true, true );
             }
 
             // "loop" the action
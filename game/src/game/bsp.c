@@ -93,6 +93,12 @@ static obj_BSP_t *chr_BSP_root = NULL;
  */
 static obj_BSP_t *prt_BSP_root = NULL;
 
+/**
+ * @brief
+ *	Global sweep-and-prune broad phase for the characters and the particles.
+ */
+static BSP::SweepAndPrune *obj_SAP_root = NULL;
+
 obj_BSP_t *getChrBSP()
 {
 	EGOBOO_ASSERT(true == _obj_BSP_system_initialized && NULL != chr_BSP_root);
@@ -105,6 +111,12 @@ obj_BSP_t *getPrtBSP()
 	return prt_BSP_root;
 }
 
+BSP::SweepAndPrune *getObjSweepAndPrune()
+{
+	EGOBOO_ASSERT(true == _obj_BSP_system_initialized && NULL != obj_SAP_root);
+	return obj_SAP_root;
+}
+
 bool obj_BSP_system_begin(mesh_BSP_t *mesh_bsp)
 {
 	if (_obj_BSP_system_initialized)
@@ -125,6 +137,7 @@ bool obj_BSP_system_begin(mesh_BSP_t *mesh_bsp)
 		chr_BSP_root = nullptr;
 		return false;
 	}
+	obj_SAP_root = new BSP::SweepAndPrune();
 	// Let the code know that everything is initialized.
 	_obj_BSP_system_initialized = true;
 	return true;
@@ -143,6 +156,8 @@ void obj_BSP_system_end()
 		chr_BSP_root = nullptr;
 		delete prt_BSP_root;
 		prt_BSP_root = nullptr;
+		delete obj_SAP_root;
+		obj_SAP_root = nullptr;
 
 		_obj_BSP_system_initialized = false;
 	}
@@ -153,6 +168,34 @@ bool obj_BSP_system_started()
 	return _obj_BSP_system_initialized;
 }
 
+//--------------------------------------------------------------------------------------------
+static BSP_leaf_t *chr_heal_leaf(Object *pchr)
+{
+	BSP_leaf_t *pleaf = &pchr->bsp_leaf;
+	if (pchr != (Object *)(pleaf->_data))
+	{
+		// some kind of error. re-initialize the data.
+		pleaf->_data = pchr;
+		pleaf->_index = GET_INDEX_PCHR(pchr);
+		pleaf->_type = BSP_LEAF_CHR;
+	}
+	return pleaf;
+}
+
+//--------------------------------------------------------------------------------------------
+static BSP_leaf_t *prt_heal_leaf(Ego::Particle *pprt)
+{
+	BSP_leaf_t *pleaf = &pprt->getBSPLeaf();
+	if (pprt != (Ego::Particle *)(pleaf->_data))
+	{
+		// some kind of error. re-initialize the data.
+		pleaf->_data = pprt;
+		pleaf->_index = pprt->getParticleID();
+		pleaf->_type = BSP_LEAF_PRT;
+	}
+	return pleaf;
+}
+
 //--------------------------------------------------------------------------------------------
 bool prt_BSP_insert(prt_bundle_t * pbdl_prt)
 {
@@ -172,14 +215,7 @@ bool prt_BSP_insert(prt_bundle_t * pbdl_prt)
 	if (loc_pprt == nullptr || loc_pprt->isTerminated() || loc_pprt->isHidden()) return false;
 
 	// heal the leaf if necessary
-	BSP_leaf_t *pleaf = &loc_pprt->getBSPLeaf();
-	if (loc_pprt != (Ego::Particle *)(pleaf->_data))
-	{
-		// some kind of error. re-initialize the data.
-		pleaf->_data = loc_pprt;
-		pleaf->_index = loc_pprt->getParticleID();
-		pleaf->_type = BSP_LEAF_PRT;
-	};
+	BSP_leaf_t *pleaf = prt_heal_leaf(loc_pprt);
 
 	// use the object velocity to figure out where the volume that the object will occupy during this
 	// update
@@ -244,14 +280,7 @@ bool chr_BSP_insert(Object * pchr)
 	if (pchr->is_hidden) return false;
 
 	// heal the leaf if it needs it
-	pleaf = &pchr->bsp_leaf;
-	if (pchr != (Object *)(pleaf->_data))
-	{
-		// some kind of error. re-initialize the data.
-		pleaf->_data = pchr;
-		pleaf->_index = GET_INDEX_PCHR(pchr);
-		pleaf->_type = BSP_LEAF_CHR;
-	}
+	pleaf = chr_heal_leaf(pchr);
 
 	// do the insert
 	retval = false;
@@ -321,3 +350,40 @@ bool prt_BSP_fill()
 
 	return true;
 }
+
+//--------------------------------------------------------------------------------------------
+static bool obj_SAP_can_overlap(BSP_leaf_t *first, BSP_leaf_t *second)
+{
+	// particles do not interact with each other
+	return BSP_LEAF_PRT != first->_type || BSP_LEAF_PRT != second->_type;
+}
+
+//--------------------------------------------------------------------------------------------
+bool obj_SAP_fill()
+{
+	oct_bb_t tmp_oct;
+
+	// insert the characters which can collide, whether they are in the character BSP or not
+	for (const std::shared_ptr<Object> &pchr : _currentModule->getObjectHandler().iterator())
+	{
+		if (!ACTIVE_PCHR(pchr.get()) || pchr->is_hidden || oct_bb_empty(pchr->chr_max_cv)) continue;
+
+		// use the object velocity to figure out where the volume that the object will occupy during this
+		// update
+		phys_expand_chr_bb(pchr.get(), 0.0f, 1.0f, tmp_oct);
+		obj_SAP_root->insert(chr_heal_leaf(pchr.get()), tmp_oct.toAABB());
+	}
+
+	// insert the particles, the hidden ones are needed for end-bumping and reaffirming
+	for (const std::shared_ptr<Ego::Particle> &particle : ParticleHandler::get().iterator())
+	{
+		if (particle->isTerminated()) continue;
+
+		phys_expand_prt_bb(particle.get(), 0.0f, 1.0f, tmp_oct);
+		obj_SAP_root->insert(prt_heal_leaf(particle.get()), tmp_oct.toAABB());
+	}
+
+	obj_SAP_root->update(obj_SAP_can_overlap);
+
+	return true;
+}
@@ -23,6 +23,7 @@
 
 #include "game/obj_BSP.h"
 #include "game/mesh_BSP.h"
+#include "egolib/Scene/SweepAndPrune.hpp"
 
 /**
  * @brief
@@ -116,6 +117,26 @@ void obj_BSP_system_end();
  */
 bool obj_BSP_system_started();
 
+/**
+ * @brief
+ *	Get the global sweep-and-prune broad phase for the characters and the particles.
+ * @return
+ *	the broad phase
+ * @pre
+ *	the global object BSPs were initialized
+ * @remark
+ *	The broad phase contains the characters and particles which can collide after obj_SAP_fill(),
+ *	independent of the object BSPs.
+ */
+BSP::SweepAndPrune *getObjSweepAndPrune();
+
+/**
+ * @brief
+ *	Insert the characters and the particles with their boxes for this update into the global
+ *	sweep-and-prune broad phase and find the overlapping pairs.
+ */
+bool obj_SAP_fill();
+
 
 bool chr_BSP_insert(Object * pchr);
 bool chr_BSP_fill();
@@ -69,7 +69,7 @@ struct grab_data_t
         //ctor
     }
 
-    std::shared_ptr<Object> object;
+    Object *object;
     float horizontalDistance;
     float verticalDistance;
     bool visible;
@@ -771,35 +771,35 @@ bool character_grab_stuff( const CHR_REF ichr_a, grip_offset_t grip_off, bool gr
 	slot_pos += pchr_a->getPosition();
 
     // Go through all characters to find the best match
-    std::vector<std::shared_ptr<Object>> nearbyObjects = _currentModule->getObjectHandler().findObjects(slot_pos[kX], slot_pos[kY], MAX_SEARCH_DIST);
-    for(const std::shared_ptr<Object> &pchr_c : nearbyObjects)
+    _currentModule->getObjectHandler().findObjects(slot_pos[kX], slot_pos[kY], MAX_SEARCH_DIST, [&](Object &object)
     {
+        Object *pchr_c = &object;
         grab_data_t grabData;
         bool canGrab = true;
 
         //Skip invalid objects
         if(pchr_c->isTerminated()) {
-            continue;
+            return;
         }
 
         // do nothing to yourself
-        if (pchr_a == pchr_c) continue;
+        if (pchr_a.get() == pchr_c) return;
 
         // Dont do hidden objects
-        if ( pchr_c->is_hidden ) continue;
+        if ( pchr_c->is_hidden ) return;
 
         // pickpocket not allowed yet
-        if ( _currentModule->getObjectHandler().exists( pchr_c->inwhich_inventory ) ) continue;
+        if ( _currentModule->getObjectHandler().exists( pchr_c->inwhich_inventory ) ) return;
 
         // disarm not allowed yet
-        if ( INVALID_CHR_REF != pchr_c->attachedto ) continue;
+        if ( INVALID_CHR_REF != pchr_c->attachedto ) return;
 
         // do not pick up your mount
         if ( pchr_c->holdingwhich[SLOT_LEFT] == ichr_a ||
-             pchr_c->holdingwhich[SLOT_RIGHT] == ichr_a ) continue;
+             pchr_c->holdingwhich[SLOT_RIGHT] == ichr_a ) return;
 
         // do not notice completely broken items?
-        if ( pchr_c->isitem && !pchr_c->isAlive() ) continue;
+        if ( pchr_c->isitem && !pchr_c->isAlive() ) return;
 
         // reasonable carrying capacity
         if ( pchr_c->phys.weight > pchr_a->phys.weight + FLOAT_TO_FP8(pchr_a->getAttribute(Ego::Attribute::MIGHT)) * INV_FF )
@@ -815,7 +815,7 @@ bool character_grab_stuff( const CHR_REF ichr_a, grip_offset_t grip_off, bool gr
         }
 
         // is the object visible
-        grabData.visible = pchr_a->canSeeObject(pchr_c);
+        grabData.visible = pchr_a->canSeeObject(*pchr_c);
 
         // calculate the distance
         grabData.horizontalDistance = (pchr_c->getPosition() - slot_pos).length();
@@ -825,7 +825,7 @@ bool character_grab_stuff( const CHR_REF ichr_a, grip_offset_t grip_off, bool gr
         grabData.isFacingObject = pchr_a->isFacingLocation(pchr_c->getPosX(), pchr_c->getPosY());
 
         // Is it too far away to interact with?
-        if (grabData.horizontalDistance > MAX_SEARCH_DIST || grabData.verticalDistance > MAX_SEARCH_DIST) continue;
+        if (grabData.horizontalDistance > MAX_SEARCH_DIST || grabData.verticalDistance > MAX_SEARCH_DIST) return;
 
         // visibility affects the max grab distance.
         // if it is not visible then we have to be touching it.
@@ -890,7 +890,7 @@ bool character_grab_stuff( const CHR_REF ichr_a, grip_offset_t grip_off, bool gr
         {
             ungrabList.push_back(grabData);
         }
-    }
+    });
 
     // sort the grab list
     if (!grabList.empty())
@@ -33,13 +33,17 @@
 #include "game/Module/Module.hpp"
 #include "egolib/Profiles/_Include.hpp"
 #include "egolib/Graphics/ModelDescriptor.hpp"
+#include "egolib/Core/ThreadPool.hpp"
 
 CollisionSystem *CollisionSystem::_singleton = nullptr;
 
 //--------------------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------------------
 
-#define MAKE_HASH(AA,BB)         CLIP_TO_08BITS( ((AA) * 0x0111 + 0x006E) + ((BB) * 0x0111 + 0x006E) )
+/// Tags of the object identifiers used in CoNode_t::generate_key()
+#define CO_KEY_CHR               0x40000000
+#define CO_KEY_PRT               0x80000000
+#define CO_KEY_TILE              0xC0000000
 
 
 
@@ -152,17 +156,21 @@ struct bumplist_t
 //--------------------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------------------
 static bool detect_chr_chr_interaction_valid( const CHR_REF ichr_a, const CHR_REF ichr_b );
-static bool detect_chr_prt_interaction_valid( const CHR_REF ichr_a, const PRT_REF iprt_b );
+static bool detect_chr_prt_interaction_valid( const Object *pchr_a, const Ego::Particle *pprt_b );
 
 static bool do_chr_platform_detection( const CHR_REF ichr_a, const CHR_REF ichr_b );
 static bool do_prt_platform_detection( const CHR_REF ichr_a, const PRT_REF iprt_b );
 
-static bool fill_interaction_list(CoHashList_t *coHashList, CollisionSystem::CollNodeAry& collNodeAry, CollisionSystem::HashNodeAry& hashNodeAry);
+static bool use_sweep_and_prune();
+static void broadphase_collide(const BSP::Collider& tree, const BSP_leaf_t *leaf, const aabb_t& aabb, BSP::LeafTest& test, CollisionSystem::DetectionBuffer& buffer);
+static void detect_chr_interactions(Object *pchr_a, CollisionSystem::DetectionBuffer& buffer);
+static void detect_prt_interactions(Ego::Particle *particle, const int reaffirmation_list[], CollisionSystem::DetectionBuffer& buffer);
+static bool fill_interaction_list(CollisionSystem::CoNodeList& coNodeList);
 static bool fill_bumplists();
 
-static bool bump_all_platforms( Ego::DynamicArray<CoNode_t> *pcn_ary );
-static bool bump_all_mounts( Ego::DynamicArray<CoNode_t> *pcn_ary );
-static bool bump_all_collisions( Ego::DynamicArray<CoNode_t> *pcn_ary );
+static bool bump_all_platforms( CollisionSystem::CoNodeList *pcn_ary );
+static bool bump_all_mounts( CollisionSystem::CoNodeList *pcn_ary );
+static bool bump_all_collisions( CollisionSystem::CoNodeList *pcn_ary );
 
 static bool bump_one_mount( const CHR_REF ichr_a, const CHR_REF ichr_b );
 static bool do_chr_platform_physics( Object * pitem, Object * pplat );
@@ -179,47 +187,36 @@ static bool do_chr_prt_collision_get_details( CoNode_t * d, chr_prt_collision_da
 
 //--------------------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------------------
-CollisionSystem::CollisionSystem() :
-    _hn_ary_2(), 
-    _cn_ary_2(),
-    _hash(nullptr),
-    _coll_leaf_lst(),
-    _coll_node_lst()
+CollisionSystem::DetectionBuffer::DetectionBuffer() :
+    leaves(),
+    candidates(),
+    pairs(0),
+    time(0.0)
 {
-    if (!_coll_leaf_lst.ctor(COLLISION_LIST_SIZE))
-    {
-        goto Fail;
-    }
-    if (!_coll_node_lst.ctor(COLLISION_LIST_SIZE))
-    {
-        _coll_leaf_lst.dtor();
-        goto Fail;
-    }
-    try
-    {
-        _hash = new CoHashList_t(512); /** @todo Why is this not factored out to a named constant? */
-    }
-    catch (std::bad_alloc& ex)
+    if (!leaves.ctor(COLLISION_LIST_SIZE))
     {
-        _coll_node_lst.dtor();
-        _coll_leaf_lst.dtor();
-        goto Fail;
+        throw std::runtime_error("unable to initialize collision system\n");
     }
-    return;
-Fail:
-    throw std::runtime_error("unable to initialize collision system\n");
+}
+
+CollisionSystem::DetectionBuffer::~DetectionBuffer()
+{
+    leaves.dtor();
+}
+
+CollisionSystem::CollisionSystem() :
+    _detection_buffers(),
+    _detection_objects(),
+    _detection_particles(),
+    _coll_node_lst(),
+    _broadphase_pairs(0),
+    _broadphase_time(0.0)
+{
 }
 
 CollisionSystem::~CollisionSystem()
 {
     reset();
-    if (_hash)
-    {
-        delete _hash;
-        _hash = nullptr;
-    }
-    _coll_leaf_lst.dtor();
-    _coll_node_lst.dtor();
 }
 
 bool CollisionSystem::initialize()
@@ -258,15 +255,6 @@ void CollisionSystem::reset()
         log_warning("%s:%d: collision system not initialized - ignoring\n", __FILE__, __LINE__);
         return;
     }
-    // Reset the collision node magazine.
-    _cn_ary_2.reset();
-
-    // Reset the hash node magazine.
-    _hn_ary_2.reset();
-
-    // Clear the collision hash.
-    _hash->clear();
-
     // Clear the collisions.
     _coll_node_lst.clear();
 }
@@ -308,53 +296,36 @@ CoNode_t *CoNode_t::ctor(CoNode_t *self)
 }
 
 //--------------------------------------------------------------------------------------------
-Uint8 CoNode_t::generate_hash(const CoNode_t *self)
+uint64_t CoNode_t::generate_key(const CoNode_t *self)
 {
     Uint32 AA, BB;
 
-    AA = UINT32_MAX;
+    AA = 0;
     if ( VALID_CHR_RANGE( self->chra ) )
     {
-        AA = REF_TO_INT( self->chra );
+        AA = CO_KEY_CHR | REF_TO_INT( self->chra );
     }
     else if ( self->prta != INVALID_PRT_REF )
     {
-        AA = REF_TO_INT( self->prta );
+        AA = CO_KEY_PRT | REF_TO_INT( self->prta );
     }
 
-    BB = UINT32_MAX;
+    BB = 0;
     if ( VALID_CHR_RANGE( self->chrb ) )
     {
-        BB = REF_TO_INT( self->chrb );
+        BB = CO_KEY_CHR | REF_TO_INT( self->chrb );
     }
     else if ( self->prtb != INVALID_PRT_REF )
     {
-        BB = REF_TO_INT( self->prtb );
+        BB = CO_KEY_PRT | REF_TO_INT( self->prtb );
     }
     else if ( MAP_FANOFF != self->tileb )
     {
-        BB = self->tileb;
+        BB = CO_KEY_TILE | self->tileb;
     }
 
-    return MAKE_HASH( AA, BB );
-}
-
-//--------------------------------------------------------------------------------------------
-int CoNode_t::cmp(const CoNode_t *self, const CoNode_t *other)
-{
-    float ftmp;
-
-    // Sort by initial time first.
-    ftmp = self->tmin - other->tmin;
-    if (ftmp <= 0.0f) return -1;
-    else if (ftmp >= 0.0f) return 1;
-
-    // Sort by final time second.
-    ftmp = self->tmax - other->tmax;
-    if (ftmp <= 0.0f) return -1;
-    else if (ftmp >= 0.0f) return 1;
-
-    return CoNode_t::cmp_unique(self, other);
+    // (A,B) and (B,A) are the same collision, see CoNode_t::matches()
+    return CollisionSystem::CoNodeList::makeKey( AA, BB );
 }
 
 //--------------------------------------------------------------------------------------------
@@ -406,66 +377,15 @@ int CoNode_t::matches(const CoNode_t *self, const CoNode_t *other)
 //--------------------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------------------
-bool CoHashList_insert_unique(CoHashList_t *coHashList, CoNode_t *data, CollisionSystem::CollNodeAry& collNodeAry, CollisionSystem::HashNodeAry& hashNodeAry)
+bool CoNodeList_insert_unique(CollisionSystem::CoNodeList& coNodeList, const CoNode_t *coNode)
 {
-	if (NULL == coHashList || NULL == data)
-	{
-		return false;
-	}
-    // Compute the hash for this collision.
-	Uint32 hash = CoNode_t::generate_hash(data);
-    if (hash >= coHashList->getCapacity())
+    if (NULL == coNode)
     {
-        throw std::runtime_error("hash out of bounds");
-    }
-	// Get the number of entries in this bucket.
-    size_t bucketSize = hash_list_t::get_count(coHashList,hash);
-    // If the bucket is not empty ...
-	if (bucketSize > 0)
-    {
-		// ... search the bucket for an entry for this collision.
-        for (hash_node_t *node = coHashList->sublist[hash]; nullptr != node; node = node->next)
-        {
-            if (CoNode_t::matches((CoNode_t *)(node->data), data))
-            {
-                return false;
-            }
-        }
-    }
-
-    // If no entry for this collision was found ...
-    {
-		// ... add it:
-        // Pick a free collision data ...
-        CoNode_t *cnode = collNodeAry.acquire();
-        if (!cnode)
-        {
-            throw std::runtime_error("no more free collision nodes");
-        }
-		// ... and store the data in that.
-		*cnode = *data;
-
-        // Generate a new hash node.
-		hash_node_t *hnode = hashNodeAry.acquire();
-        if (!hnode)
-        {
-            throw std::runtime_error("no more free hash nodes");
-        }
-
-        // link the hash node to the free CoNode
-        hnode->data = cnode;
-
-        // insert the node at the front of the collision list for this hash
-        hash_node_t *old_head = hash_list_get_node(coHashList, hash);
-        hash_node_t *new_head = hash_node_insert_before(old_head, hnode);
-        hash_list_set_node(coHashList, hash, new_head);
-
-        // add 1 to the count at this hash
-        size_t old_count = hash_list_t::get_count(coHashList, hash);
-        hash_list_set_count(coHashList, hash, old_count + 1);
+        return false;
     }
 
-    return true;
+    // The list rejects the collision if it was already found, possibly with the objects reversed.
+    return coNodeList.insert(CoNode_t::generate_key(coNode), coNode->tmin, *coNode);
 }
 
 //--------------------------------------------------------------------------------------------
@@ -649,23 +569,23 @@ bool detect_chr_chr_interaction_valid( const CHR_REF ichr_a, const CHR_REF ichr_
 }
 
 //--------------------------------------------------------------------------------------------
-bool detect_chr_prt_interaction_valid( const CHR_REF ichr_a, const PRT_REF iprt_b )
+bool detect_chr_prt_interaction_valid( const Object *pchr_a, const Ego::Particle *pprt_b )
 {
+    /// @note This is called from the worker threads of fill_interaction_list(), so it must
+    ///       not use ParticleHandler::operator[] which might modify the particle map.
 
     // Ignore invalid characters
-    const std::shared_ptr<Object> &pchr_a = _currentModule->getObjectHandler()[ichr_a];
-    if ( !pchr_a ) return false;
+    if ( nullptr == pchr_a ) return false;
 
     // Ignore invalid particles
-    const std::shared_ptr<Ego::Particle> &pprt_b = ParticleHandler::get()[iprt_b];
-    if(pprt_b == nullptr || pprt_b->isTerminated()) return false;
+    if ( nullptr == pprt_b || pprt_b->isTerminated() ) return false;
 
     // reject characters that are hidden
     if ( pchr_a->is_hidden || pprt_b->isHidden() ) return false;
 
     // particles don't "collide" with anything they are attached to.
     // that only happes through doing bump particle damamge
-    if ( pchr_a == pprt_b->getAttachedObject() ) return false;
+    if ( pchr_a == pprt_b->getAttachedObject().get() ) return false;
 
     // don't interact if there is no interaction...
     // the particles and characters should not have been added to the list unless they
@@ -675,317 +595,353 @@ bool detect_chr_prt_interaction_valid( const CHR_REF ichr_a, const PRT_REF iprt_
 }
 
 //--------------------------------------------------------------------------------------------
-bool fill_interaction_list(CoHashList_t *coHashList, CollisionSystem::CollNodeAry& collNodeAry, CollisionSystem::HashNodeAry& hashNodeAry)
+bool use_sweep_and_prune()
 {
-    int              cnt;
-    int              reaffirmation_count;
-    int              reaffirmation_list[DAMAGE_COUNT];
-    aabb_t           tmp_aabb;
+    return Ego::CollisionBroadPhase::SweepAndPrune == egoboo_config_t::get().debug_collision_broadPhase.getValue();
+}
 
-    if ( NULL == coHashList) return false;
+//--------------------------------------------------------------------------------------------
+void broadphase_collide(const BSP::Collider& tree, const BSP_leaf_t *leaf, const aabb_t& aabb, BSP::LeafTest& test, CollisionSystem::DetectionBuffer& buffer)
+{
+    /// @details Find the leaves which might collide with the leaf of an object and pass the test.
+    ///          The sweep-and-prune broad phase only looks up the pairs found by its last update,
+    ///          a tree is queried with the volume the object occupies during this update.
 
-    // Clear the collision hash.
-	coHashList->clear();
+    Ego::Time::Stopwatch stopwatch;
+    stopwatch.start();
 
-    // initialize the reaffirmation counters
-    reaffirmation_count = 0;
-    for ( cnt = 0; cnt < DAMAGE_COUNT; cnt++ )
+    buffer.leaves.clear();
+    if (use_sweep_and_prune())
     {
-        reaffirmation_list[cnt] = 0;
+        getObjSweepAndPrune()->getOverlaps(leaf, test, buffer.leaves);
+    }
+    else
+    {
+        tree.collide(aabb, test, buffer.leaves);
     }
 
-    //---- find the character/particle interactions
+    stopwatch.stop();
+    buffer.pairs += buffer.leaves.size();
+    buffer.time += stopwatch.elapsed();
+}
 
-    // Find the character-character interactions. Use the ChrList.used_ref, for a change
-    for(const std::shared_ptr<Object> &pchr_a : _currentModule->getObjectHandler().iterator())
-    {
-        oct_bb_t   tmp_oct;
+//--------------------------------------------------------------------------------------------
+void detect_chr_interactions(Object *pchr_a, CollisionSystem::DetectionBuffer& buffer)
+{
+    /// @details Find the character-character and the character-particle interactions of a character.
+    ///          Nothing but the buffer is modified, so this can run in parallel for different characters.
 
-        // ignore in-accessible objects
-        if ( _currentModule->getObjectHandler().exists( pchr_a->inwhich_inventory ) || pchr_a->is_hidden ) continue;
+    oct_bb_t   tmp_oct;
+    aabb_t     tmp_aabb;
 
-        // keep track of how many objects use reaffirmation, and what kinds of reaffirmation
-        if ( pchr_a->reaffirm_damagetype < DAMAGE_COUNT )
-        {
-            if ( pchr_a->getProfile()->getAttachedParticleAmount() > 0 )
-            {
-                // we COULD use number_of_attached_particles() to determin if the
-                // character is full of particles, BUT since it scans through the
-                // entire particle list I don't think it's worth it
+    // use the object velocity to figure out where the volume that the object will occupy during this
+    // update
+    phys_expand_chr_bb(pchr_a, 0.0f, 1.0f, tmp_oct);
 
-                reaffirmation_count++;
-                reaffirmation_list[pchr_a->reaffirm_damagetype]++;
-            }
-        }
+    // convert the oct_bb_t to a correct BSP_aabb_t
+    tmp_aabb = tmp_oct.toAABB();
 
-        // use the object velocity to figure out where the volume that the object will occupy during this
-        // update
-        phys_expand_chr_bb(pchr_a.get(), 0.0f, 1.0f, tmp_oct);
+    // find all collisions with other characters and particles
+    broadphase_collide(*getChrBSP(), &pchr_a->bsp_leaf, tmp_aabb, chr_BSP_can_collide, buffer);
 
-        // convert the oct_bb_t to a correct BSP_aabb_t
-        tmp_aabb = tmp_oct.toAABB();
+    // transfer valid leaves to the candidates
+    for (size_t j = 0; j < buffer.leaves.size(); j++)
+    {
+        CoNode_t    tmp_codata;
+        BIT_FIELD   test_platform;
 
-        // find all collisions with other characters and particles
-        CollisionSystem::get()->_coll_leaf_lst.clear();
-        getChrBSP()->collide(tmp_aabb, chr_BSP_can_collide, CollisionSystem::get()->_coll_leaf_lst);
+        BSP_leaf_t *pleaf = buffer.leaves.ary[j];
+        if ( NULL == pleaf ) continue;
 
-        // transfer valid _coll_leaf_lst entries to pchlst entries
-        // and sort them by their initial times
-        if (!CollisionSystem::get()->_coll_leaf_lst.empty())
+        if ( BSP_LEAF_CHR != pleaf->_type )
         {
-            for (size_t j = 0; j < CollisionSystem::get()->_coll_leaf_lst.size(); j++)
-            {
-                BSP_leaf_t * pleaf;
-                CoNode_t    tmp_codata;
-                bool      do_insert;
-                BIT_FIELD   test_platform;
+            // how did we get here?
+            log_warning( "fill_interaction_list() - found non-character in the character BSP\n" );
+            continue;
+        }
 
-                pleaf = CollisionSystem::get()->_coll_leaf_lst.ary[j];
-                if ( NULL == pleaf ) continue;
+        // collided with a character
+        CHR_REF ichr_b = ( CHR_REF )( pleaf->_index );
 
-                do_insert = false;
+        // do some logic on this to determine whether the collision is valid
+        if ( !detect_chr_chr_interaction_valid( pchr_a->getCharacterID(), ichr_b ) ) continue;
 
-                if ( BSP_LEAF_CHR == pleaf->_type )
-                {
-                    // collided with a character
-                    CHR_REF ichr_b = ( CHR_REF )( pleaf->_index );
+        Object * pchr_b = _currentModule->getObjectHandler().get( ichr_b );
 
-                    // do some logic on this to determine whether the collision is valid
-                    if ( detect_chr_chr_interaction_valid( pchr_a->getCharacterID(), ichr_b ) )
-                    {
-                        Object * pchr_b = _currentModule->getObjectHandler().get( ichr_b );
+        CoNode_t::ctor( &tmp_codata );
 
-                        CoNode_t::ctor( &tmp_codata );
+        // do a simple test, since I do not want to resolve the ObjectPRofile for these objects here
+        test_platform = EMPTY_BIT_FIELD;
+        if ( pchr_a->platform && pchr_b->canuseplatforms ) SET_BIT( test_platform, PHYS_PLATFORM_OBJ1 );
+        if ( pchr_b->platform && pchr_a->canuseplatforms ) SET_BIT( test_platform, PHYS_PLATFORM_OBJ2 );
 
-                        // do a simple test, since I do not want to resolve the ObjectPRofile for these objects here
-                        test_platform = EMPTY_BIT_FIELD;
-                        if ( pchr_a->platform && pchr_b->canuseplatforms ) SET_BIT( test_platform, PHYS_PLATFORM_OBJ1 );
-                        if ( pchr_b->platform && pchr_a->canuseplatforms ) SET_BIT( test_platform, PHYS_PLATFORM_OBJ2 );
+        // detect a when the possible collision occurred
+        if (phys_intersect_oct_bb(pchr_a->chr_max_cv, pchr_a->getPosition(), pchr_a->vel, pchr_b->chr_max_cv, pchr_b->getPosition(), pchr_b->vel, test_platform, tmp_codata.cv, &(tmp_codata.tmin), &(tmp_codata.tmax)))
+        {
+            tmp_codata.chra = pchr_a->getCharacterID();
+            tmp_codata.chrb = ichr_b;
 
-                        // detect a when the possible collision occurred
-                        if (phys_intersect_oct_bb(pchr_a->chr_max_cv, pchr_a->getPosition(), pchr_a->vel, pchr_b->chr_max_cv, pchr_b->getPosition(), pchr_b->vel, test_platform, tmp_codata.cv, &(tmp_codata.tmin), &(tmp_codata.tmax)))
-                        {
-                            tmp_codata.chra = pchr_a->getCharacterID();
-                            tmp_codata.chrb = ichr_b;
+            buffer.candidates.push_back(tmp_codata);
+        }
+    }
 
-                            do_insert = true;
-                        }
-                    }
-                }
-                else
-                {
-                    // how did we get here?
-                    log_warning( "fill_interaction_list() - found non-character in the character BSP\n" );
-                }
+    broadphase_collide(*getPrtBSP(), &pchr_a->bsp_leaf, tmp_aabb, prt_BSP_can_collide, buffer);
+    for (size_t j = 0; j < buffer.leaves.size(); j++)
+    {
+        CoNode_t    tmp_codata;
+        BIT_FIELD   test_platform;
 
-                if ( do_insert )
-                {
-					CoHashList_insert_unique(coHashList, &tmp_codata, collNodeAry, hashNodeAry);
-                }
-            }
-        }
+        BSP_leaf_t *pleaf = buffer.leaves.ary[j];
+        if ( NULL == pleaf ) continue;
 
-        CollisionSystem::get()->_coll_leaf_lst.clear();
-        getPrtBSP()->collide(tmp_aabb, prt_BSP_can_collide, CollisionSystem::get()->_coll_leaf_lst);
-        if (!CollisionSystem::get()->_coll_leaf_lst.empty())
+        if ( BSP_LEAF_PRT != pleaf->_type )
         {
-            for (size_t j = 0; j < CollisionSystem::get()->_coll_leaf_lst.size(); j++)
-            {
-                BSP_leaf_t * pleaf;
-                CoNode_t    tmp_codata;
-                bool      do_insert;
-                BIT_FIELD   test_platform;
+            // how did we get here?
+            log_warning( "fill_interaction_list() - found non-particle in the particle BSP\n" );
+            continue;
+        }
 
-                pleaf = CollisionSystem::get()->_coll_leaf_lst.ary[j];
-                if ( NULL == pleaf ) continue;
+        // collided with a particle
+        const Ego::Particle *pprt_b = static_cast<const Ego::Particle *>( pleaf->_data );
 
-                do_insert = false;
+        // do some logic on this to determine whether the collision is valid
+        if ( !detect_chr_prt_interaction_valid( pchr_a, pprt_b ) ) continue;
 
-                if ( BSP_LEAF_PRT == pleaf->_type )
-                {
-                    // collided with a particle
-                    PRT_REF iprt_b = ( PRT_REF )( pleaf->_index );
+        CoNode_t::ctor( &tmp_codata );
 
-                    // do some logic on this to determine whether the collision is valid
-                    if ( detect_chr_prt_interaction_valid( pchr_a->getCharacterID(), iprt_b ) )
-                    {
-                        const std::shared_ptr<Ego::Particle> &pprt_b = ParticleHandler::get()[iprt_b];
+        // do a simple test, since I do not want to resolve the ObjectProfile for these objects here
+        test_platform = pchr_a->platform ? PHYS_PLATFORM_OBJ1 : 0;
 
-                        CoNode_t::ctor( &tmp_codata );
+        // detect a when the possible collision occurred
+        if (phys_intersect_oct_bb(pchr_a->chr_max_cv, pchr_a->getPosition(), pchr_a->vel, pprt_b->prt_max_cv, pprt_b->getPosition(), pprt_b->vel, test_platform, tmp_codata.cv, &(tmp_codata.tmin), &(tmp_codata.tmax)))
+        {
+            tmp_codata.chra = pchr_a->getCharacterID();
+            tmp_codata.prtb = ( PRT_REF )( pleaf->_index );
 
-                        // do a simple test, since I do not want to resolve the ObjectProfile for these objects here
-                        test_platform = pchr_a->platform ? PHYS_PLATFORM_OBJ1 : 0;
+            buffer.candidates.push_back(tmp_codata);
+        }
+    }
+}
 
-                        // detect a when the possible collision occurred
-                        if (phys_intersect_oct_bb(pchr_a->chr_max_cv, pchr_a->getPosition(), pchr_a->vel, pprt_b->prt_max_cv, pprt_b->getPosition(), pprt_b->vel, test_platform, tmp_codata.cv, &(tmp_codata.tmin), &(tmp_codata.tmax)))
-                        {
-                            tmp_codata.chra = pchr_a->getCharacterID();
-                            tmp_codata.prtb = iprt_b;
+//--------------------------------------------------------------------------------------------
+void detect_prt_interactions(Ego::Particle *particle, const int reaffirmation_list[], CollisionSystem::DetectionBuffer& buffer)
+{
+    /// @details Find the interactions of a particle which end-bumps or reaffirms characters.
+    ///          Nothing but the buffer is modified, so this can run in parallel for different particles.
 
-                            do_insert = true;
-                        }
-                    }
-                }
-                else
-                {
-                    // how did we get here?
-                    log_warning( "fill_interaction_list() - found non-particle in the particle BSP\n" );
-                }
+    oct_bb_t   tmp_oct;
+    aabb_t     tmp_aabb;
+    bool     can_reaffirm, needs_bump;
 
-                if ( do_insert )
-                {
-					CoHashList_insert_unique(coHashList, &tmp_codata, collNodeAry, hashNodeAry);
-                }
-            }
-        }
-    }
+    // does the particle potentially reaffirm a character?
+    can_reaffirm = TO_C_BOOL(( particle->damagetype < DAMAGE_COUNT ) && ( 0 != reaffirmation_list[particle->damagetype] ) );
 
-    //---- find some specialized character-particle interactions
-    //     namely particles that end-bump or particles that reaffirm characters
+    // does the particle end_bump or end_ground?
+    needs_bump = TO_C_BOOL( particle->getProfile()->end_bump || particle->getProfile()->end_ground );
 
-    for(const std::shared_ptr<Ego::Particle> &particle : ParticleHandler::get().iterator())
-    {
-        oct_bb_t   tmp_oct;
-        bool     can_reaffirm, needs_bump;
+    if ( !can_reaffirm && !needs_bump ) return;
 
-		if (particle->isTerminated()) continue;
+    // use the object velocity to figure out where the volume that the object will occupy during this
+    // update
+    phys_expand_prt_bb(particle, 0.0f, 1.0f, tmp_oct);
 
-        BSP_leaf_t *pleaf = &particle->getBSPLeaf();
+    // convert the oct_bb_t to a correct BSP_aabb_t
+    tmp_aabb = tmp_oct.toAABB();
 
-        // if the particle is in the BSP, then it has already had it's chance to collide
-        if (pleaf->isInList()) continue;
+    // find all collisions with characters
+    broadphase_collide(*getChrBSP(), &particle->getBSPLeaf(), tmp_aabb, chr_BSP_can_collide, buffer);
 
-        // does the particle potentially reaffirm a character?
-        can_reaffirm = TO_C_BOOL(( particle->damagetype < DAMAGE_COUNT ) && ( 0 != reaffirmation_list[particle->damagetype] ) );
+    // transfer valid leaves to the candidates
+    for (size_t j = 0; j < buffer.leaves.size(); j++)
+    {
+        CoNode_t     tmp_codata;
+        BIT_FIELD    test_platform;
 
-        // does the particle end_bump or end_ground?
-        needs_bump = TO_C_BOOL( particle->getProfile()->end_bump || particle->getProfile()->end_ground );
+        BSP_leaf_t *pleaf = buffer.leaves.ary[j];
+        if ( NULL == pleaf ) continue;
 
-        if ( !can_reaffirm && !needs_bump ) continue;
+        CHR_REF ichr_a = ( CHR_REF )( pleaf->_index );
 
-        // use the object velocity to figure out where the volume that the object will occupy during this
-        // update
-        phys_expand_prt_bb(particle.get(), 0.0f, 1.0f, tmp_oct);
+        if ( BSP_LEAF_CHR != pleaf->_type || !VALID_CHR_RANGE( ichr_a ) ) continue;
 
-        // convert the oct_bb_t to a correct BSP_aabb_t
-        tmp_aabb = tmp_oct.toAABB();
+        // collided with a character
+        bool loc_reaffirms     = can_reaffirm;
+        bool loc_needs_bump    = needs_bump;
 
-        // find all collisions with characters
-        CollisionSystem::get()->_coll_leaf_lst.clear();
-        getChrBSP()->collide(tmp_aabb, chr_BSP_can_collide, CollisionSystem::get()->_coll_leaf_lst);
+        Object * pchr_a = _currentModule->getObjectHandler().get( ichr_a );
 
-        // transfer valid _coll_leaf_lst entries to pchlst entries
-        // and sort them by their initial times
-        if (!CollisionSystem::get()->_coll_leaf_lst.empty())
+        // can this particle affect the character through reaffirmation
+        if ( loc_reaffirms )
         {
-            CoNode_t     tmp_codata;
-            BIT_FIELD    test_platform;
-            CHR_REF      ichr_a = INVALID_CHR_REF;
-            BSP_leaf_t * pleaf = NULL;
-            bool       do_insert = false;
+            // does this interaction support affirmation?
+            if ( particle->damagetype != pchr_a->reaffirm_damagetype )
+            {
+                loc_reaffirms = false;
+            }
 
-            for (size_t j = 0; j < CollisionSystem::get()->_coll_leaf_lst.size(); j++)
+            // if it is already attached to this character, no more reaffirmation
+            if ( particle->getAttachedObject().get() == pchr_a )
             {
-                pleaf = CollisionSystem::get()->_coll_leaf_lst.ary[j];
-                if ( NULL == pleaf ) continue;
+                loc_reaffirms = false;
+            }
+        }
 
-                ichr_a = ( CHR_REF )( pleaf->_index );
+        // you can't be bumped by items that you are attached to
+        if ( loc_needs_bump && particle->getAttachedObject().get() == pchr_a )
+        {
+            loc_needs_bump = false;
+        }
 
-                do_insert = false;
+        // can this character affect this particle through bumping?
+        if ( loc_needs_bump )
+        {
+            // the valid bump interactions
+            bool end_money  = TO_C_BOOL(( particle->getProfile()->bump_money > 0 ) && pchr_a->cangrabmoney );
+            bool end_bump   = TO_C_BOOL(( particle->getProfile()->end_bump ) && ( 0 != pchr_a->bump_stt.size ) );
+            bool end_ground = TO_C_BOOL(( particle->getProfile()->end_ground ) && (( 0 != pchr_a->bump_stt.size ) || pchr_a->platform ) );
 
-                if ( BSP_LEAF_CHR == pleaf->_type && VALID_CHR_RANGE( ichr_a ) )
-                {
-                    // collided with a character
-                    bool loc_reaffirms     = can_reaffirm;
-                    bool loc_needs_bump    = needs_bump;
-                    bool interaction_valid = false;
+            if ( !end_money && !end_bump && !end_ground )
+            {
+                loc_needs_bump = false;
+            }
+        }
 
-                    Object * pchr_a = _currentModule->getObjectHandler().get( ichr_a );
+        // do a little more logic on this to determine whether the collision is valid
+        if ( !loc_reaffirms && !loc_needs_bump ) continue;
+        if ( !detect_chr_prt_interaction_valid( pchr_a, particle ) ) continue;
 
-                    // can this particle affect the character through reaffirmation
-                    if ( loc_reaffirms )
-                    {
-                        // does this interaction support affirmation?
-                        if ( particle->damagetype != pchr_a->reaffirm_damagetype )
-                        {
-                            loc_reaffirms = false;
-                        }
+        // only do the more expensive calculation if the
+        // particle can interact with the object
+        CoNode_t::ctor( &tmp_codata );
 
-                        // if it is already attached to this character, no more reaffirmation
-                        if ( particle->getAttachedObject().get() == pchr_a )
-                        {
-                            loc_reaffirms = false;
-                        }
-                    }
+        // do a simple test, since I do not want to resolve the ObjectProfile for these objects here
+        test_platform = EMPTY_BIT_FIELD;
+        if ( pchr_a->platform && ( SPRITE_SOLID == particle->type ) ) SET_BIT( test_platform, PHYS_PLATFORM_OBJ1 );
 
-                    // you can't be bumped by items that you are attached to
-                    if ( loc_needs_bump && particle->getAttachedObject().get() == pchr_a )
-                    {
-                        loc_needs_bump = false;
-                    }
+        // detect a when the possible collision occurred
+        if (phys_intersect_oct_bb(pchr_a->chr_min_cv, pchr_a->getPosition(), pchr_a->vel, particle->prt_max_cv, particle->getPosition(), particle->vel, test_platform, tmp_codata.cv, &(tmp_codata.tmin), &(tmp_codata.tmax)))
+        {
+            tmp_codata.chra = ichr_a;
+            tmp_codata.prtb = particle->getParticleID();
 
-                    // can this character affect this particle through bumping?
-                    if ( loc_needs_bump )
-                    {
-                        // the valid bump interactions
-                        bool end_money  = TO_C_BOOL(( particle->getProfile()->bump_money > 0 ) && pchr_a->cangrabmoney );
-                        bool end_bump   = TO_C_BOOL(( particle->getProfile()->end_bump ) && ( 0 != pchr_a->bump_stt.size ) );
-                        bool end_ground = TO_C_BOOL(( particle->getProfile()->end_ground ) && (( 0 != pchr_a->bump_stt.size ) || pchr_a->platform ) );
-
-                        if ( !end_money && !end_bump && !end_ground )
-                        {
-                            loc_needs_bump = false;
-                        }
-                    }
+            buffer.candidates.push_back(tmp_codata);
+        }
+    }
+}
 
-                    // do a little more logic on this to determine whether the collision is valid
-                    interaction_valid = false;
-                    if ( loc_reaffirms || loc_needs_bump )
-                    {
-                        if ( detect_chr_prt_interaction_valid( ichr_a, particle->getParticleID() ) )
-                        {
-                            interaction_valid = true;
-                        }
-                        else
-                        {
-                            interaction_valid = false;
-                        }
-                    }
+//--------------------------------------------------------------------------------------------
+bool fill_interaction_list(CollisionSystem::CoNodeList& coNodeList)
+{
+    /// @details The detection is split into a parallel phase, in which each chunk of objects or
+    ///          particles only writes into its own CollisionSystem::DetectionBuffer, and a serial
+    ///          merge. The chunks are merged in order, so the collision list is the same as if
+    ///          all objects and particles were tested one after another on a single thread.
 
-                    // only do the more expensive calculation if the
-                    // particle can interact with the object
-                    if ( interaction_valid )
-                    {
-                        CoNode_t::ctor( &tmp_codata );
+    int              cnt;
+    int              reaffirmation_count;
+    int              reaffirmation_list[DAMAGE_COUNT];
 
-                        // do a simple test, since I do not want to resolve the ObjectProfile for these objects here
-                        test_platform = EMPTY_BIT_FIELD;
-                        if ( pchr_a->platform && ( SPRITE_SOLID == particle->type ) ) SET_BIT( test_platform, PHYS_PLATFORM_OBJ1 );
+    CollisionSystem *collisionSystem = CollisionSystem::get();
+    Ego::ThreadPool& threadPool = Ego::ThreadPool::get();
 
-                        // detect a when the possible collision occurred
-                        if (phys_intersect_oct_bb(pchr_a->chr_min_cv, pchr_a->getPosition(), pchr_a->vel, particle->prt_max_cv, particle->getPosition(), particle->vel, test_platform, tmp_codata.cv, &(tmp_codata.tmin), &(tmp_codata.tmax)))
-                        {
+    // Clear the collisions.
+    coNodeList.clear();
 
-                            tmp_codata.chra = ichr_a;
-                            tmp_codata.prtb = particle->getParticleID();
+    // initialize the reaffirmation counters
+    reaffirmation_count = 0;
+    for ( cnt = 0; cnt < DAMAGE_COUNT; cnt++ )
+    {
+        reaffirmation_list[cnt] = 0;
+    }
 
-                            do_insert = true;
-                        }
-                    }
-                }
-                else if ( BSP_LEAF_PRT == pleaf->_type )
-                {
-                    // this should never happen
-                }
+    // get a detection buffer for every chunk which can run at the same time
+    while (collisionSystem->_detection_buffers.size() < threadPool.getWorkerCount() + 1)
+    {
+        collisionSystem->_detection_buffers.emplace_back(new CollisionSystem::DetectionBuffer());
+    }
 
-                if ( do_insert )
-                {
-					CoHashList_insert_unique(coHashList, &tmp_codata, collNodeAry, hashNodeAry);
-                }
+    // merge the candidates of all chunks in chunk order
+    auto merge = [&coNodeList, collisionSystem](size_t chunkCount)
+    {
+        for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+        {
+            for (const CoNode_t& candidate : collisionSystem->_detection_buffers[chunk]->candidates)
+            {
+                CoNodeList_insert_unique(coNodeList, &candidate);
             }
+            collisionSystem->_broadphase_pairs += collisionSystem->_detection_buffers[chunk]->pairs;
+            collisionSystem->_broadphase_time += collisionSystem->_detection_buffers[chunk]->time;
         }
+    };
+
+    //---- find the character/particle interactions
+
+    // Gather the characters which can interact. Use the ChrList.used_ref, for a change
+    collisionSystem->_detection_objects.clear();
+    for(const std::shared_ptr<Object> &pchr_a : _currentModule->getObjectHandler().iterator())
+    {
+        // ignore in-accessible objects
+        if ( _currentModule->getObjectHandler().exists( pchr_a->inwhich_inventory ) || pchr_a->is_hidden ) continue;
+
+        // keep track of how many objects use reaffirmation, and what kinds of reaffirmation
+        if ( pchr_a->reaffirm_damagetype < DAMAGE_COUNT )
+        {
+            // only characters which are not full of particles can be reaffirmed
+            if ( number_of_attached_particles( pchr_a->getCharacterID() ) < pchr_a->getProfile()->getAttachedParticleAmount() )
+            {
+                reaffirmation_count++;
+                reaffirmation_list[pchr_a->reaffirm_damagetype]++;
+            }
+        }
+
+        collisionSystem->_detection_objects.push_back(pchr_a.get());
     }
 
+    // Find the character-character and character-particle interactions.
+    const size_t objectChunkCount = threadPool.getChunkCount(collisionSystem->_detection_objects.size(), 16);
+    threadPool.parallelFor(collisionSystem->_detection_objects.size(), 16,
+        [collisionSystem](size_t begin, size_t end, size_t chunk)
+    {
+        CollisionSystem::DetectionBuffer& buffer = *collisionSystem->_detection_buffers[chunk];
+        buffer.candidates.clear();
+        buffer.pairs = 0;
+        buffer.time = 0.0;
+        for (size_t i = begin; i < end; ++i)
+        {
+            detect_chr_interactions(collisionSystem->_detection_objects[i], buffer);
+        }
+    });
+    merge(objectChunkCount);
+
+    //---- find some specialized character-particle interactions
+    //     namely particles that end-bump or particles that reaffirm characters
+
+    collisionSystem->_detection_particles.clear();
+    for(const std::shared_ptr<Ego::Particle> &particle : ParticleHandler::get().iterator())
+    {
+		if (particle->isTerminated()) continue;
+
+        // if the particle is in the BSP, then it has already had it's chance to collide
+        if (particle->getBSPLeaf().isInList()) continue;
+
+        collisionSystem->_detection_particles.push_back(particle.get());
+    }
+
+    const size_t particleChunkCount = threadPool.getChunkCount(collisionSystem->_detection_particles.size(), 64);
+    threadPool.parallelFor(collisionSystem->_detection_particles.size(), 64,
+        [collisionSystem, &reaffirmation_list](size_t begin, size_t end, size_t chunk)
+    {
+        CollisionSystem::DetectionBuffer& buffer = *collisionSystem->_detection_buffers[chunk];
+        buffer.candidates.clear();
+        buffer.pairs = 0;
+        buffer.time = 0.0;
+        for (size_t i = begin; i < end; ++i)
+        {
+            detect_prt_interactions(collisionSystem->_detection_particles[i], reaffirmation_list, buffer);
+        }
+    });
+    merge(particleChunkCount);
+
     return true;
 }
 
@@ -997,6 +953,11 @@ bool fill_bumplists()
     /// @note Do not use BSP_tree_t::prune every frame, because the number of pre-allocated branches can be quite
 	/// large. Instead, just remove the leaves from the tree, fill the tree, and then prune any empty branches.
 
+    CollisionSystem *collisionSystem = CollisionSystem::get();
+    Ego::Time::Stopwatch stopwatch;
+
+    stopwatch.start();
+
     // empty out the BSP node lists
     chr_BSP_removeAllLeaves();
     prt_BSP_removeAllLeaves();
@@ -1005,6 +966,25 @@ bool fill_bumplists()
     chr_BSP_fill();
     prt_BSP_fill();
 
+    stopwatch.stop();
+
+    // The BSPs are always filled as they are used for rendering, too. If the sweep-and-prune
+    // broad phase is used for collisions, only its update counts as broad phase time.
+    if (use_sweep_and_prune())
+    {
+        stopwatch.reset();
+        stopwatch.start();
+        obj_SAP_fill();
+        stopwatch.stop();
+    }
+    else
+    {
+        // do not keep pointers to leaves which might be destroyed
+        getObjSweepAndPrune()->removeAllLeaves();
+    }
+    collisionSystem->_broadphase_pairs = 0;
+    collisionSystem->_broadphase_time = stopwatch.elapsed();
+
     // Remove empty branches from the tree.
     if (63 == ( game_frame_all & 63))
     {
@@ -1288,63 +1268,29 @@ void bump_all_objects()
 {
     /// @author ZZ
     /// @details This function sets handles characters hitting other characters or particles
-    size_t        co_node_count;
-
-    // Get the collision hash table.
-    CoHashList_t *hash = CollisionSystem::get()->_hash;
-    if (!hash)
-    {
-        log_error( "bump_all_objects() - cannot access the CoHashList_t singleton" );
-		return;
-    }
 
-    // Reset the collision node magazine.
-    CollisionSystem::get()->_cn_ary_2.reset();
-
-    // Reset the hash node magazine.
-    CollisionSystem::get()->_hn_ary_2.reset();
+    CollisionSystem::CoNodeList& coNodeList = CollisionSystem::get()->_coll_node_lst;
 
     // fill up the BSP structures
     fill_bumplists();
 
     // use the BSP structures to detect possible binary interactions
-    fill_interaction_list(hash, CollisionSystem::get()->_cn_ary_2, CollisionSystem::get()->_hn_ary_2);
-
-    // convert the CHashList_t into a CoNode_ary_t and sort
-    co_node_count = hash->getSize();
+    fill_interaction_list(coNodeList);
 
-    if ( co_node_count > 0 )
+    if ( !coNodeList.empty() )
     {
-        hash_list_iterator_t it;
-
-        CollisionSystem::get()->_coll_node_lst.clear();
-
-		it.ctor();
-        hash_list_iterator_set_begin(&it, hash);
-        for (/* Nothing. */; !hash_list_iterator_done(&it, hash); hash_list_iterator_next(&it, hash))
-        {
-            CoNode_t *coNode = (CoNode_t *)hash_list_iterator_ptr(&it);
-            if (NULL == coNode) break;
-
-            CollisionSystem::get()->_coll_node_lst.push_back(*coNode);
-        }
-
-        if (CollisionSystem::get()->_coll_node_lst.size() > 1)
-        {
-            // arrange the actual nodes by time order
-            qsort(CollisionSystem::get()->_coll_node_lst.ary, CollisionSystem::get()->_coll_node_lst.size(),
-                  sizeof(CoNode_t),(int (*)(const void *,const void *))(&CoNode_t::cmp));
-        }
+        // arrange the actual nodes by time order
+        coNodeList.sort();
 
         // handle interaction with mounts
         // put this before platforms, otherwise pointing is just too hard
-        bump_all_mounts(&CollisionSystem::get()->_coll_node_lst);
+        bump_all_mounts(&coNodeList);
 
         // handle interaction with platforms
-        bump_all_platforms(&CollisionSystem::get()->_coll_node_lst);
+        bump_all_platforms(&coNodeList);
 
         // handle all the collisions
-        bump_all_collisions(&CollisionSystem::get()->_coll_node_lst);
+        bump_all_collisions(&coNodeList);
     }
 
 #if 0
@@ -1362,7 +1308,7 @@ void bump_all_objects()
 }
 
 //--------------------------------------------------------------------------------------------
-bool bump_all_platforms( Ego::DynamicArray<CoNode_t> *pcn_ary )
+bool bump_all_platforms( CollisionSystem::CoNodeList *pcn_ary )
 {
     /// @author BB
     /// @details Detect all character and particle interactions with platforms, then attach them.
@@ -1378,7 +1324,7 @@ bool bump_all_platforms( Ego::DynamicArray<CoNode_t> *pcn_ary )
     //---- Detect all platform attachments
     for (size_t cnt = 0; cnt < pcn_ary->size(); cnt++ )
     {
-		CoNode_t *d = pcn_ary->ary + cnt;
+		CoNode_t *d = &(*pcn_ary)[cnt];
 
         // only look at character-platform or particle-platform interactions interactions
         if ( INVALID_PRT_REF != d->prta && INVALID_PRT_REF != d->prtb ) continue;
@@ -1404,7 +1350,7 @@ bool bump_all_platforms( Ego::DynamicArray<CoNode_t> *pcn_ary )
     // is still trying to find the best one
     for (size_t cnt = 0; cnt < pcn_ary->size(); cnt++ )
     {
-		CoNode_t *d = pcn_ary->ary + cnt;
+		CoNode_t *d = &(*pcn_ary)[cnt];
 
         // only look at character-character interactions
         //if ( INVALID_PRT_REF != d->prta && INVALID_PRT_REF != d->prtb ) continue;
@@ -1474,7 +1420,7 @@ bool bump_all_platforms( Ego::DynamicArray<CoNode_t> *pcn_ary )
 }
 
 //--------------------------------------------------------------------------------------------
-bool bump_all_mounts( Ego::DynamicArray<CoNode_t> *pcn_ary )
+bool bump_all_mounts( CollisionSystem::CoNodeList *pcn_ary )
 {
     /// @author BB
     /// @details Detect all character interactions with mounts, then attach them.
@@ -1483,7 +1429,7 @@ bool bump_all_mounts( Ego::DynamicArray<CoNode_t> *pcn_ary )
     // Do mounts
     for (size_t cnt = 0; cnt < pcn_ary->size(); cnt++)
     {
-		CoNode_t *d = pcn_ary->ary + cnt;
+		CoNode_t *d = &(*pcn_ary)[cnt];
 
         // only look at character-character interactions
         if ( INVALID_CHR_REF == d->chra || INVALID_CHR_REF == d->chrb ) continue;
@@ -1495,7 +1441,7 @@ bool bump_all_mounts( Ego::DynamicArray<CoNode_t> *pcn_ary )
 }
 
 //--------------------------------------------------------------------------------------------
-bool bump_all_collisions( Ego::DynamicArray<CoNode_t> *pcn_ary )
+bool bump_all_collisions( CollisionSystem::CoNodeList *pcn_ary )
 {
     /// @author BB
     /// @details Detect all character-character and character-particle collsions (with exclusions
@@ -1521,12 +1467,12 @@ bool bump_all_collisions( Ego::DynamicArray<CoNode_t> *pcn_ary )
         // rearrange them without needing to change anything
         if ( !handled )
         {
-            handled = do_chr_chr_collision( pcn_ary->ary + cnt );
+            handled = do_chr_chr_collision( &(*pcn_ary)[cnt] );
         }
 
         if ( !handled )
         {
-            handled = do_chr_prt_collision( pcn_ary->ary + cnt );
+            handled = do_chr_prt_collision( &(*pcn_ary)[cnt] );
         }
     }
 
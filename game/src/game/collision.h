@@ -22,16 +22,16 @@
 #pragma once
 
 #include "game/egoboo_typedef.h"
+#include "egolib/Core/PairList.hpp"
 
 //--------------------------------------------------------------------------------------------
 // external structs
 //--------------------------------------------------------------------------------------------
 
-#define CHR_MAX_COLLISIONS       (OBJECTS_MAX*8 + PARTICLES_MAX)
-#define COLLISION_HASH_NODES     (CHR_MAX_COLLISIONS*2)
 #define COLLISION_LIST_SIZE      256
 
 class Object;
+namespace Ego { class Particle; }
 
 //--------------------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------------------
@@ -42,11 +42,8 @@ struct CoNode_t;
 //--------------------------------------------------------------------------------------------
 
 /// element for storing pair-wise "collision" data
-/// @note this does not use the "standard" method of inheritance from hash_node_t, where an
-/// instance of hash_node_t is embedded inside CoNode_t as CoNode_t::base or something.
-/// Instead, a separate lists of free hash_nodes and free CoNodes are kept, and they are
-/// associated through the hash_node_t::data pointer when the hash node is added to the
-/// hash_list_t
+/// @note the collisions of one update are stored by value in a CollisionSystem::CoNodeList,
+/// which identifies them by CoNode_t::generate_key()
 struct CoNode_t
 {
 public:
@@ -67,19 +64,9 @@ public:
 
     static CoNode_t *ctor(CoNode_t *self);
 	static int matches(const CoNode_t *self, const CoNode_t *other);
-	/** @todo This test is broken or has dead code. */
-	static int cmp(const CoNode_t *self, const CoNode_t *other);
 	static int cmp_unique(const CoNode_t *self, const CoNode_t *other);
-	static Uint8 generate_hash(const CoNode_t *self);
-};
-
-//--------------------------------------------------------------------------------------------
-
-struct CoHashList_t : public hash_list_t
-{
-	CoHashList_t(size_t initialCapacity)
-		: hash_list_t(initialCapacity)
-	{}
+	/// Get a key which is equal for two nodes if and only if they match.
+	static uint64_t generate_key(const CoNode_t *self);
 };
 
 
@@ -87,69 +74,10 @@ struct CoHashList_t : public hash_list_t
 //--------------------------------------------------------------------------------------------
 // global functions
 
-// A temporary magazine allocator supporting the operations "acquire" and "refill".
-template <typename Type,size_t Capacity>
-struct Magazine : public Id::NonCopyable
-{
-public:
-
-    void reset()
-    {
-        _size = Capacity;
-    }
-
-    Type *acquire()
-    {
-        if (!_size) throw std::underflow_error("magazine underflow");
-        return _elements[--_size];
-    }
-
-    Magazine() :
-        _size(Capacity),
-        _elements()
-    {
-        size_t index;
-        try
-        {
-            for (index = 0; index < Capacity; ++index)
-            {
-                _elements[index] = new Type();
-            }
-        }
-        catch (std::exception& ex)
-        {
-            while (index > 0)
-            {
-                delete _elements[--index];
-                _elements[index] = nullptr;
-            }
-            _size = 0;
-        }
-    }
-
-    virtual ~Magazine()
-    {
-        if (_size != Capacity)
-        {
-            throw std::runtime_error("invalid magazine state");
-        }
-        for (size_t index = 0; index < Capacity; ++index)
-        {
-            delete _elements[index];
-            _elements[index] = nullptr;
-        }
-    }
-
-private:
-    size_t _size;
-    std::array<Type*, Capacity> _elements;
-};
-
 struct CollisionSystem : public Id::NonCopyable
 {
 public:
-    typedef Magazine < hash_node_t, COLLISION_HASH_NODES > HashNodeAry;
-    typedef Magazine < CoNode_t, CHR_MAX_COLLISIONS > CollNodeAry;
+    typedef Ego::PairList<CoNode_t> CoNodeList;
 
 protected:
     /**
@@ -173,16 +101,35 @@ protected:
     virtual ~CollisionSystem();
 
 public:
-    /// Magazine of hash nodes.
-    HashNodeAry _hn_ary_2;
-    
-    /// Magazine of collision nodes.
-    CollNodeAry _cn_ary_2;
-
-public:
-    CoHashList_t *_hash;
-    Ego::DynamicArray<BSP_leaf_t *> _coll_leaf_lst;
-    Ego::DynamicArray<CoNode_t> _coll_node_lst;
+    /// Scratch space of one chunk of the parallel collision detection.
+    struct DetectionBuffer : public Id::NonCopyable
+    {
+        /// The leaves found by a broad phase query.
+        Ego::DynamicArray<BSP_leaf_t *> leaves;
+        /// The collisions detected by the chunk, in the order in which they were found.
+        std::vector<CoNode_t> candidates;
+        /// The number of leaves found and the time in seconds spent by the broad phase queries of the chunk.
+        size_t pairs;
+        double time;
+
+        DetectionBuffer();
+        ~DetectionBuffer();
+    };
+
+    /// One detection buffer per chunk, reused between updates.
+    std::vector<std::unique_ptr<DetectionBuffer>> _detection_buffers;
+    /// The objects and particles which are tested in this update.
+    std::vector<Object *> _detection_objects;
+    std::vector<Ego::Particle *> _detection_particles;
+
+    /// The unique collisions of this update, sorted by time.
+    CoNodeList _coll_node_lst;
+
+    /// The number of potential collisions found by the broad phase in the last update.
+    size_t _broadphase_pairs;
+    /// The time in seconds spent in the broad phase in the last update,
+    /// i.e. filling its data structures and querying them.
+    double _broadphase_time;
 
 
     static bool initialize();
@@ -200,12 +147,11 @@ public:
 
 };
 
-/// Insert a collision into a collision hash list if it does not exist yet.
-/// @param self the collision hash list
-/// @param collision the collision
-/// @param collisions the list of collisions
-/// @param hashNodes the list of hash nodes
-bool CoHashList_insert_unique(CoHashList_t *coHashList, CoNode_t *coNode, CollisionSystem::CollNodeAry& collNodeAry, CollisionSystem::HashNodeAry& hashNodeAry);
+/// Insert a collision into a collision list if it does not exist yet.
+/// @param coNodeList the collision list
+/// @param coNode the collision
+/// @return @a true if the collision was inserted, @a false if it existed already
+bool CoNodeList_insert_unique(CollisionSystem::CoNodeList& coNodeList, const CoNode_t *coNode);
 
 
 void bump_all_objects();
\ No newline at end of file
@@ -43,6 +43,11 @@
 #include "game/Module/Passage.hpp"
 #include "game/Graphics/CameraSystem.hpp"
 #include "egolib/Graphics/ModelDescriptor.hpp"
+#include "egolib/FileFormats/module_bundle_file.h"
+#include "egolib/AI/FlowField.h"
+#include "egolib/AI/BlockGraph.h"
+#include "egolib/Core/ThreadPool.hpp"
+#include "game/replay.h"
 #include "game/Module/Module.hpp"
 #include "game/char.h"
 #include "game/physics.h"
@@ -52,6 +57,10 @@
 
 //--------------------------------------------------------------------------------------------
 
+/// If the teams a particle can target have at most this many objects, prt_find_target()
+/// visits them directly instead of searching the quad tree.
+#define TARGET_TEAM_SCAN_MAX 32
+
 bool  overrideslots      = false;
 
 // End text
@@ -74,6 +83,12 @@ Uint32          clock_chr_stat   = 0;
 Uint32          clock_pit        = 0;
 Uint32          update_wld       = 0;
 
+update_times_t  update_times;
+
+/// The objects thinking in this update and the per-chunk outcomes of the parallel think phase.
+static std::vector<Object *> _think_objects;
+static std::vector<std::unique_ptr<script_think_buffer_t>> _think_buffers;
+
 //--------------------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------------------
 
@@ -87,6 +102,7 @@ static void update_pits();
 static void do_damage_tiles();
 static void set_local_latches();
 static void let_all_characters_think();
+static bool chr_prepare_think( Object *pchr );
 static void do_weather_spawn_particles();
 
 // module initialization / deinitialization - not accessible by scripts
@@ -133,7 +149,7 @@ static void game_load_module_assets( const char *modname );
 static void load_all_profiles_import();
 static void import_dir_profiles_vfs(const std::string &importDirectory);
 static void game_load_global_profiles();
-static void game_load_module_profiles( const char *modname );
+static void game_load_module_profiles( const char *modname, const std::shared_ptr<const module_bundle_t> &bundle );
 
 static void initialize_all_objects();
 static void finalize_all_objects();
@@ -450,15 +466,33 @@ void update_used_lists()
     EnchantHandler::get().update_used();
 }
 
+//--------------------------------------------------------------------------------------------
+/// Run a part of update_game() and add the time spent in it to @a time
+template <typename Part>
+static void game_time_part( double& time, Part part )
+{
+    Ego::Time::Stopwatch stopwatch;
+    stopwatch.start();
+    part();
+    stopwatch.stop();
+    time += stopwatch.elapsed();
+}
+
+//--------------------------------------------------------------------------------------------
+void game_reset_update_times()
+{
+    update_times = update_times_t();
+}
+
 //--------------------------------------------------------------------------------------------
 void update_all_objects()
 {
     chr_stoppedby_tests = 0;
     chr_pressure_tests  = 0;
 
-    update_all_characters();
-    ParticleHandler::get().updateAllParticles();
-    update_all_enchants();
+    game_time_part( update_times.movement, update_all_characters );
+    game_time_part( update_times.particles, [] { ParticleHandler::get().updateAllParticles(); } );
+    game_time_part( update_times.enchants, update_all_enchants );
 }
 
 //--------------------------------------------------------------------------------------------
@@ -466,8 +500,8 @@ void move_all_objects()
 {
     mesh_mpdfx_tests = 0;
 
-    move_all_particles();
-    move_all_characters();
+    game_time_part( update_times.particles, move_all_particles );
+    game_time_part( update_times.movement, move_all_characters );
 }
 
 //--------------------------------------------------------------------------------------------
@@ -482,7 +516,7 @@ void cleanup_all_objects()
         object->requestTerminate();
     }
 
-    cleanup_all_enchants();
+    game_time_part( update_times.enchants, cleanup_all_enchants );
 }
 
 //--------------------------------------------------------------------------------------------
@@ -648,7 +682,7 @@ int update_game()
 
     set_local_latches();
 
-    //Rebuild the quadtree for fast object lookup
+    //Update the quadtree for fast object lookup
     _currentModule->getObjectHandler().updateQuadTree(0.0f, 0.0f, _currentModule->getMeshPointer()->info.tiles_x*256.0f, _currentModule->getMeshPointer()->info.tiles_y*256.0f);
 
     //---- begin the code for updating misc. game stuff
@@ -665,7 +699,7 @@ int update_game()
 
     //---- begin the code object I/O
     {
-        let_all_characters_think();           // sets the non-player latches
+        game_time_part( update_times.scripts, let_all_characters_think );    // sets the non-player latches
         net_unbuffer_player_latches();            // sets the player latches
     }
     //---- end the code object I/O
@@ -674,7 +708,7 @@ int update_game()
     initialize_all_objects();
     {
         move_all_objects();                   // clears some latches
-        bump_all_objects();                   // do the actual object interaction
+        game_time_part( update_times.collision, bump_all_objects );          // do the actual object interaction
     }
     finalize_all_objects();
     //---- end the code for updating in-game objects
@@ -728,6 +762,8 @@ CHR_REF prt_find_target( const fvec3_t& pos, FACING_T facing,
 {
     /// @author ZF
     /// @details This is the new improved targeting system for particles. Also includes distance in the Z direction.
+    ///          Only the objects of the teams the particle can target are visited, either directly if there
+    ///          are only a few of them or else through the quad tree within the maximum distance.
 
     const float max_dist2 = WIDE * WIDE;
 
@@ -739,49 +775,85 @@ CHR_REF prt_find_target( const fvec3_t& pos, FACING_T facing,
     if ( !LOADED_PIP( particletype ) ) return INVALID_CHR_REF;
     ppip = PipStack.get_ptr( particletype );
 
-    for(const std::shared_ptr<Object> &pchr : _currentModule->getObjectHandler().iterator())
+    ObjectHandler& objectHandler = _currentModule->getObjectHandler();
+    Team &particleTeam = _currentModule->getTeamList()[team];
+
+    // which teams can be targeted?
+    std::array<bool, Team::TEAM_MAX> targetTeams;
+    size_t targetTeamObjects = 0;
+    for ( TEAM_REF iteam = 0; iteam < Team::TEAM_MAX; iteam++ )
+    {
+        if ( ppip->onlydamagefriendly )
+        {
+            targetTeams[iteam] = ( iteam == team );
+        }
+        else
+        {
+            targetTeams[iteam] = particleTeam.hatesTeam( _currentModule->getTeamList()[iteam] );
+        }
+        if ( targetTeams[iteam] )
+        {
+            targetTeamObjects += objectHandler.getTeamObjects( iteam ).size();
+        }
+    }
+    if ( 0 == targetTeamObjects ) return INVALID_CHR_REF;
+
+    auto checkTarget = [&]( Object &object )
     {
-        bool target_friend, target_enemy;
+        Object *pchr = &object;
 
-        if ( !pchr->isAlive() || pchr->isitem || _currentModule->getObjectHandler().exists( pchr->inwhich_inventory ) ) continue;
+        if ( pchr->team >= Team::TEAM_MAX || !targetTeams[pchr->team] ) return;
+
+        if ( !pchr->isAlive() || pchr->isitem || objectHandler.exists( pchr->inwhich_inventory ) ) return;
 
         // prefer targeting riders over the mount itself
-        if ( pchr->isMount() && ( _currentModule->getObjectHandler().exists( pchr->holdingwhich[SLOT_LEFT] ) || _currentModule->getObjectHandler().exists( pchr->holdingwhich[SLOT_RIGHT] ) ) ) continue;
+        if ( pchr->isMount() && ( objectHandler.exists( pchr->holdingwhich[SLOT_LEFT] ) || objectHandler.exists( pchr->holdingwhich[SLOT_RIGHT] ) ) ) return;
 
         // ignore invictus
-        if ( pchr->invictus ) continue;
+        if ( pchr->invictus ) return;
 
         // we are going to give the player a break and not target things that
         // can't be damaged, unless the particle is homing. If it homes in,
         // the he damage_timer could drop off en route.
-        if ( !ppip->homing && ( 0 != pchr->damage_timer ) ) continue;
+        if ( !ppip->homing && ( 0 != pchr->damage_timer ) ) return;
 
         // Don't retarget someone we already had or not supposed to target
-        if ( pchr->getCharacterID() == oldtarget || pchr->getCharacterID() == donttarget ) continue;
+        if ( pchr->getCharacterID() == oldtarget || pchr->getCharacterID() == donttarget ) return;
 
-        Team &particleTeam = _currentModule->getTeamList()[team];
+        // Cull by distance before computing the angle
+        float dist2 = (pchr->getPosition() - pos).length_2();
+        if ( dist2 >= longdist2 || dist2 > max_dist2 ) return;
 
-        target_friend = ppip->onlydamagefriendly && particleTeam == pchr->getTeam();
-        target_enemy  = !ppip->onlydamagefriendly && particleTeam.hatesTeam(pchr->getTeam() );
+        FACING_T angle = - facing + vec_to_facing( pchr->getPosX() - pos[kX] , pchr->getPosY() - pos[kY] );
 
-        if ( target_friend || target_enemy )
+        // Only proceed if we are facing the target
+        if ( angle < ppip->targetangle || angle > ( 0xFFFF - ppip->targetangle ) )
+        {
+            (*targetAngle) = angle;
+            besttarget = pchr->getCharacterID();
+            longdist2 = dist2;
+        }
+    };
+
+    if ( targetTeamObjects <= TARGET_TEAM_SCAN_MAX )
+    {
+        for ( TEAM_REF iteam = 0; iteam < Team::TEAM_MAX; iteam++ )
         {
-            FACING_T angle = - facing + vec_to_facing( pchr->getPosX() - pos[kX] , pchr->getPosY() - pos[kY] );
+            if ( !targetTeams[iteam] ) continue;
 
-            // Only proceed if we are facing the target
-            if ( angle < ppip->targetangle || angle > ( 0xFFFF - ppip->targetangle ) )
+            for ( const CHR_REF ichr : objectHandler.getTeamObjects( iteam ) )
             {
-                float dist2 = (pchr->getPosition() - pos).length_2();
+                Object *pchr = objectHandler.get( ichr );
+                if ( !ACTIVE_PCHR( pchr ) ) continue;
 
-                if ( dist2 < longdist2 && dist2 <= max_dist2 )
-                {
-                    (*targetAngle) = angle;
-                    besttarget = pchr->getCharacterID();
-                    longdist2 = dist2;
-                }
+                checkTarget( *pchr );
             }
         }
     }
+    else
+    {
+        objectHandler.findObjects( pos[kX], pos[kY], WIDE, checkTarget );
+    }
 
     // All done
     return besttarget;
@@ -822,7 +894,7 @@ bool chr_check_target( Object * psrc, const CHR_REF iObjectest, IDSZ idsz, const
     if ( ptst->isAlive() == HAS_SOME_BITS( targeting_bits, TARGET_DEAD ) ) return false;
 
     // Don't target invisible stuff, unless we can actually see them
-    if ( !psrc->canSeeObject(ptst) ) return false;
+    if ( !psrc->canSeeObject(*ptst) ) return false;
 
     //Need specific skill? ([NONE] always passes)
     if ( HAS_SOME_BITS( targeting_bits, TARGET_SKILL ) && !chr_get_skill( ptst.get(), idsz ) ) return false;
@@ -892,36 +964,6 @@ CHR_REF chr_find_target( Object * psrc, float max_dist, IDSZ idsz, const BIT_FIE
 
     if ( !ACTIVE_PCHR( psrc ) ) return INVALID_CHR_REF;
 
-    std::vector<std::shared_ptr<Object>> searchList;
-
-    //Only loop through the players
-    if ( HAS_SOME_BITS( targeting_bits, TARGET_PLAYERS ) || HAS_SOME_BITS( targeting_bits, TARGET_QUEST ) )
-    {
-        for (PLA_REF ipla = 0; ipla < MAX_PLAYER; ipla++)
-        {
-            if (!PlaStack.lst[ipla].valid) continue;
-
-            const std::shared_ptr<Object> &player = _currentModule->getObjectHandler()[PlaStack.lst[ipla].index];
-            if(player) {
-                searchList.push_back(player);
-            }
-
-        }
-    }
-
-    //All objects in level
-    else if(max_dist == NEAREST)
-    {
-        searchList = _currentModule->getObjectHandler().getAllObjects();
-    }
-
-    //All objects within range
-    else
-    {
-        searchList = _currentModule->getObjectHandler().findObjects(psrc->getPosX(), psrc->getPosY(), max_dist);
-    }
-
-
     // set the line-of-sight source
     los_info.x0         = psrc->getPosX();
     los_info.y0         = psrc->getPosY();
@@ -930,9 +972,11 @@ CHR_REF chr_find_target( Object * psrc, float max_dist, IDSZ idsz, const BIT_FIE
 
     CHR_REF best_target = INVALID_CHR_REF;
     float best_dist2  = max_dist * max_dist;
-    for(const std::shared_ptr<Object> &ptst : searchList)
+    auto checkTarget = [&](Object &tst)
     {
-        if ( !chr_check_target( psrc, ptst->getCharacterID(), idsz, targeting_bits ) ) continue;
+        Object *ptst = &tst;
+
+        if ( !chr_check_target( psrc, ptst->getCharacterID(), idsz, targeting_bits ) ) return;
 
         fvec3_t diff = psrc->getPosition() - ptst->getPosition();
 		float dist2 = diff.length_2();
@@ -947,13 +991,62 @@ CHR_REF chr_find_target( Object * psrc, float max_dist, IDSZ idsz, const BIT_FIE
                 los_info.y1 = ptst->getPosition()[kY];
                 los_info.z1 = ptst->getPosition()[kZ] + std::max( 1.0f, ptst->bump.height );
 
-                if ( line_of_sight_blocked( &los_info ) ) continue;
+                if ( line_of_sight_blocked( &los_info ) ) return;
             }
 
             //Set the new best target found
             best_target = ptst->getCharacterID();
             best_dist2  = dist2;
         }
+    };
+
+    //Only loop through the players
+    if ( HAS_SOME_BITS( targeting_bits, TARGET_PLAYERS ) || HAS_SOME_BITS( targeting_bits, TARGET_QUEST ) )
+    {
+        for (PLA_REF ipla = 0; ipla < MAX_PLAYER; ipla++)
+        {
+            if (!PlaStack.lst[ipla].valid) continue;
+
+            Object *player = _currentModule->getObjectHandler().get(PlaStack.lst[ipla].index);
+            if(player) {
+                checkTarget(*player);
+            }
+
+        }
+    }
+
+    //All enemies or all friends in level, only look at the teams which can pass chr_check_target()
+    else if(max_dist == NEAREST && HAS_NO_BITS(targeting_bits, TARGET_ITEMS) &&
+            HAS_SOME_BITS(targeting_bits, TARGET_ENEMIES) != HAS_SOME_BITS(targeting_bits, TARGET_FRIENDS))
+    {
+        const bool targetEnemies = HAS_SOME_BITS(targeting_bits, TARGET_ENEMIES);
+        for (TEAM_REF iteam = 0; iteam < Team::TEAM_MAX; iteam++)
+        {
+            if (psrc->getTeam().hatesTeam(_currentModule->getTeamList()[iteam]) != targetEnemies) continue;
+
+            for (const CHR_REF ichr : _currentModule->getObjectHandler().getTeamObjects(iteam))
+            {
+                Object *object = _currentModule->getObjectHandler().get(ichr);
+                if (!ACTIVE_PCHR(object) || object->team != iteam) continue;
+
+                checkTarget(*object);
+            }
+        }
+    }
+
+    //All objects in level
+    else if(max_dist == NEAREST)
+    {
+        for(const std::shared_ptr<Object> &object : _currentModule->getObjectHandler().getAllObjects())
+        {
+            checkTarget(*object);
+        }
+    }
+
+    //All objects within range
+    else
+    {
+        _currentModule->getObjectHandler().findObjects(psrc->getPosX(), psrc->getPosY(), max_dist, checkTarget);
     }
 
     // make sure the target is valid
@@ -1914,7 +2007,7 @@ void game_load_profile_ai()
 }
 
 //--------------------------------------------------------------------------------------------
-void game_load_module_profiles( const char *modname )
+void game_load_module_profiles( const char *modname, const std::shared_ptr<const module_bundle_t> &bundle )
 {
     /// @author BB
     /// @details Search for .obj directories in the module directory and load them
@@ -1922,6 +2015,7 @@ void game_load_module_profiles( const char *modname )
     vfs_search_context_t * ctxt;
     const char *filehandle;
     STRING newloadname;
+    std::vector<std::string> folderPaths;
 
     import_data.slot = -100;
     make_newloadname( modname, "objects", newloadname );
@@ -1931,12 +2025,15 @@ void game_load_module_profiles( const char *modname )
 
     while ( NULL != ctxt && VALID_CSTR( filehandle ) )
     {
-        ProfileSystem::get().loadOneProfile(filehandle);
+        folderPaths.push_back(filehandle);
 
         ctxt = vfs_findNext( &ctxt );
         filehandle = vfs_search_context_get_current( ctxt );
     }
     vfs_findClose( &ctxt );
+
+    // Decode the objects in parallel
+    ProfileSystem::get().loadAllProfiles(folderPaths, bundle);
 }
 
 //--------------------------------------------------------------------------------------------
@@ -2399,6 +2496,10 @@ bool game_load_module_data( const char *smallname )
     //TODO: ZF> this should be moved to Module.cpp
     log_info( "Loading module \"%s\"\n", smallname );
 
+    Ego::Time::Stopwatch stopwatch;
+    stopwatch.start();
+    vfs_resetFailedOpenCount();
+
     // ensure that the script parser exists
     parser_state_t * ps = parser_state_t::get();
     parser_state_t::clear_error(ps);
@@ -2417,9 +2518,20 @@ bool game_load_module_data( const char *smallname )
     game_load_global_assets();
     game_load_module_assets( modname );
 
+    // load the data baked by the bake tool, if any. Stale entries are loaded from their sources.
+    std::shared_ptr<module_bundle_t> bundle = std::make_shared<module_bundle_t>();
+    if ( bundle->load( "mp_data/" MODULE_BUNDLE_FILENAME ) )
+    {
+        log_info( "Loaded module bundle with %" PRIuZ " entries\n", bundle->getEntryCount() );
+    }
+    else
+    {
+        bundle = nullptr;
+    }
+
     // load all module objects
-    game_load_global_profiles();            // load the global objects
-    game_load_module_profiles( modname );   // load the objects from the module's directory
+    game_load_global_profiles();                    // load the global objects
+    game_load_module_profiles( modname, bundle );   // load the objects from the module's directory
 
     ego_mesh_t * pmesh_rv = ego_mesh_load( modname, _currentModule->getMeshPointer() );
     if ( nullptr == pmesh_rv )
@@ -2441,6 +2553,27 @@ bool game_load_module_data( const char *smallname )
     // if it is started, populate the map_BSP
     mesh_BSP_fill(getMeshBSP(), pmesh_rv);
 
+    stopwatch.stop();
+    log_info( "Loaded module \"%s\" in %.3f seconds (text files %s, %" PRIuZ " failed file opens)\n", smallname, stopwatch.elapsed(),
+              egoboo_config_t::get().debug_textFiles_inMemory_enable.getValue() ? "in memory" : "streamed",
+              vfs_getFailedOpenCount() );
+
+    ObjectProfile::AssetCache &assetCache = ObjectProfile::getAssetCache();
+    const auto models = assetCache.models.getStats();
+    const auto particles = assetCache.particles.getStats();
+    const auto enchants = assetCache.enchants.getStats();
+    const auto images = assetCache.images.getStats();
+    log_info( "Asset cache hits/misses: models %" PRIuZ "/%" PRIuZ ", particles %" PRIuZ "/%" PRIuZ
+              ", enchants %" PRIuZ "/%" PRIuZ ", images %" PRIuZ "/%" PRIuZ "\n",
+              models.hits, models.misses, particles.hits, particles.misses,
+              enchants.hits, enchants.misses, images.hits, images.misses );
+
+    // keep only the assets of this module, so the cache does not grow with every module played
+    assetCache.removeUnused();
+
+    const auto sharing = Ego::ModelDescriptor::getSharingStats();
+    log_info( "MD2 models shared/loaded: %" PRIuZ "/%" PRIuZ "\n", sharing.hits, sharing.misses );
+
     return true;
 }
 
@@ -2450,21 +2583,18 @@ void disaffirm_attached_particles( const CHR_REF character )
     /// @author ZZ
     /// @details This function makes sure a character has no attached particles
 
-    for(const std::shared_ptr<Ego::Particle> &particle : ParticleHandler::get().iterator())
-    {
-        if(!particle->isAttached() || particle->isTerminated()) continue;
+    if ( !_currentModule->getObjectHandler().exists( character ) ) return;
 
-        if ( particle->getAttachedObject()->getCharacterID() == character )
-        {
-            particle->requestTerminate();
-        }
-    }
+    Object *pchr = _currentModule->getObjectHandler().get( character );
 
-    if ( _currentModule->getObjectHandler().exists( character ) )
+    // terminating a particle removes it from the list
+    while ( nullptr != pchr->getFirstAttachedParticle() )
     {
-        // Set the alert for disaffirmation ( wet torch )
-        SET_BIT( _currentModule->getObjectHandler().get(character)->ai.alert, ALERTIF_DISAFFIRMED );
+        pchr->getFirstAttachedParticle()->requestTerminate();
     }
+
+    // Set the alert for disaffirmation ( wet torch )
+    SET_BIT( pchr->ai.alert, ALERTIF_DISAFFIRMED );
 }
 
 //--------------------------------------------------------------------------------------------
@@ -2475,14 +2605,12 @@ int number_of_attached_particles( const CHR_REF character )
 
     int     cnt = 0;
 
-    for(const std::shared_ptr<Ego::Particle> &particle : ParticleHandler::get().iterator())
-    {
-        if(!particle->isAttached() || particle->isTerminated()) continue;
+    if ( !_currentModule->getObjectHandler().exists( character ) ) return 0;
 
-        if ( particle->getAttachedObject()->getCharacterID() == character )
-        {
-            cnt++;
-        }
+    const Object *pchr = _currentModule->getObjectHandler().get( character );
+    for ( const Ego::Particle *particle = pchr->getFirstAttachedParticle(); nullptr != particle; particle = particle->getNextAttachedParticle() )
+    {
+        cnt++;
     }
 
     return cnt;
@@ -2537,6 +2665,9 @@ void game_quit_module()
     /// @author BB
     /// @details all of the de-initialization code after the module actually ends
 
+    // save the recording of the input
+    replay_end_module();
+
     // stop the module
     _currentModule.reset(nullptr);
 
@@ -2568,8 +2699,10 @@ bool game_begin_module(const std::shared_ptr<ModuleProfile> &module)
     // make sure that the object lists are in a good state
     reset_all_object_lists();
 
-    // start the module
-    _currentModule = std::unique_ptr<GameModule>(new GameModule(module, time(NULL)));
+    // start the module, a replay uses the recorded seed
+    Uint32 seed = time(NULL);
+    replay_begin_module(module->getFolderName(), &seed);
+    _currentModule = std::unique_ptr<GameModule>(new GameModule(module, seed));
 
     // load all the in-game module data
     if ( !game_load_module_data( module->getPath().c_str() ) )
@@ -2655,6 +2788,15 @@ void game_release_module_data()
     mesh_BSP_system_end();
     obj_BSP_system_end();
     CollisionSystem::get()->reset();    
+
+    // the cached flow fields refer to the mesh of the module
+    const FlowField_Stats_t paths = FlowField_get_stats();
+    log_info( "Flow fields built %" PRIuZ ", paths requested/served %" PRIuZ "/%" PRIuZ "\n", paths.builds, paths.requests, paths.served );
+    FlowField_clear_cache();
+
+    const BlockGraph_Stats_t blocks = BlockGraph_get_stats();
+    log_info( "Block graphs built %" PRIuZ ", blocks refreshed %" PRIuZ ", paths planned over blocks %" PRIuZ "\n", blocks.builds, blocks.refreshedBlocks, blocks.paths );
+    BlockGraph_clear_cache();
 }
 
 //--------------------------------------------------------------------------------------------
@@ -2717,11 +2859,46 @@ bool add_player( const CHR_REF character, const PLA_REF player, input_device_t *
     return true;
 }
 
+//--------------------------------------------------------------------------------------------
+bool chr_prepare_think( Object *pchr )
+{
+    /// @details Is the object allowed to think? If so, set up its alerts.
+
+    if ( pchr->isTerminated() ) return false;
+
+    bool is_crushed, is_cleanedup, can_think;
+
+    // check for actions that must always be handled
+    is_cleanedup = HAS_SOME_BITS( pchr->ai.alert, ALERTIF_CLEANEDUP );
+    is_crushed   = HAS_SOME_BITS( pchr->ai.alert, ALERTIF_CRUSHED );
+
+    // let the script run sometimes even if the item is in your backpack
+    can_think = !pchr->isInsideInventory() || pchr->getProfile()->isEquipment();
+
+    // only let dead/destroyed things think if they have beem crushed/cleanedup
+    if ( !( pchr->isAlive() && can_think ) && !is_crushed && !is_cleanedup ) return false;
+
+    // Figure out alerts that weren't already set
+    set_alerts( pchr->getCharacterID() );
+
+    // Cleaned up characters shouldn't be alert to anything else
+    if ( is_cleanedup )  { pchr->ai.alert = ALERTIF_CLEANEDUP; /*pchr->ai.timer = update_wld + 1;*/ }
+
+    // Crushed characters shouldn't be alert to anything else
+    if ( is_crushed )  { pchr->ai.alert = ALERTIF_CRUSHED; pchr->ai.timer = update_wld + 1; }
+
+    return true;
+}
+
 //--------------------------------------------------------------------------------------------
 void let_all_characters_think()
 {
     /// @author ZZ
     /// @details This function funst the ai scripts for all eligible objects
+    ///
+    /// The scripts run in two phases. First all scripts run in parallel without modifying any
+    /// object (see scr_think_chr_script) and their outcomes are committed in order. Then the
+    /// scripts which have side effects on other objects run serially, in order.
 
     static Uint32 last_update = ( Uint32 )( ~0 );
 
@@ -2729,34 +2906,64 @@ void let_all_characters_think()
     if ( update_wld == last_update ) return;
     last_update = update_wld;
 
-    for(const std::shared_ptr<Object> &object : _currentModule->getObjectHandler().iterator())
+    // count the scripts run and skipped during this update
+    scr_reset_run_counts();
+
+    // keep the object list locked until all scripts ran
+    ObjectHandler::ObjectIterator objects = _currentModule->getObjectHandler().iterator();
+
+    if ( !scr_can_think_parallel() )
     {
-        if(object->isTerminated()) {
-            continue;
+        for ( const std::shared_ptr<Object> &object : objects )
+        {
+            if ( chr_prepare_think( object.get() ) )
+            {
+                scr_run_chr_script( object.get() );
+            }
         }
-        
-        bool is_crushed, is_cleanedup, can_think;        
-
-        // check for actions that must always be handled
-        is_cleanedup = HAS_SOME_BITS( object->ai.alert, ALERTIF_CLEANEDUP );
-        is_crushed   = HAS_SOME_BITS( object->ai.alert, ALERTIF_CRUSHED );
+        return;
+    }
 
-        // let the script run sometimes even if the item is in your backpack
-        can_think = !object->isInsideInventory() || object->getProfile()->isEquipment();
+    Ego::ThreadPool& threadPool = Ego::ThreadPool::get();
 
-        // only let dead/destroyed things think if they have beem crushed/cleanedup
-        if (( object->isAlive() && can_think ) || is_crushed || is_cleanedup )
+    _think_objects.clear();
+    for ( const std::shared_ptr<Object> &object : objects )
+    {
+        if ( chr_prepare_think( object.get() ) )
         {
-            // Figure out alerts that weren't already set
-            set_alerts( object->getCharacterID() );
+            _think_objects.push_back( object.get() );
+        }
+    }
 
-            // Cleaned up characters shouldn't be alert to anything else
-            if ( is_cleanedup )  { object->ai.alert = ALERTIF_CLEANEDUP; /*object->ai.timer = update_wld + 1;*/ }
+    while ( _think_buffers.size() < threadPool.getWorkerCount() + 1 )
+    {
+        _think_buffers.push_back( std::unique_ptr<script_think_buffer_t>( new script_think_buffer_t() ) );
+    }
+
+    // the parallel phase
+    const size_t chunkCount = threadPool.getChunkCount( _think_objects.size(), 16 );
+    threadPool.parallelFor( _think_objects.size(), 16, []( size_t begin, size_t end, size_t chunk )
+    {
+        script_think_buffer_t& buffer = *_think_buffers[chunk];
+        buffer.clear();
+        for ( size_t i = begin; i < end; ++i )
+        {
+            scr_think_chr_script( _think_objects[i], buffer );
+        }
+    });
 
-            // Crushed characters shouldn't be alert to anything else
-            if ( is_crushed )  { object->ai.alert = ALERTIF_CRUSHED; object->ai.timer = update_wld + 1; }
+    // commit the parallel phase in order
+    for ( size_t chunk = 0; chunk < chunkCount; ++chunk )
+    {
+        scr_commit_think_buffer( *_think_buffers[chunk] );
+    }
 
-            scr_run_chr_script(object.get());
+    // the serial phase, in order
+    for ( size_t chunk = 0; chunk < chunkCount; ++chunk )
+    {
+        for ( Object *pchr : _think_buffers[chunk]->serial )
+        {
+            scr_run_chr_script( pchr );
         }
     }
 }
@@ -3689,7 +3896,7 @@ bool do_shop_steal( const CHR_REF ithief, const CHR_REF iitem )
             Object * powner = _currentModule->getObjectHandler().get( iowner );
 
             can_steal = true;
-            if ( powner->canSeeObject(pthief) || detection <= 5 || ( detection - pthief->getAttribute(Ego::Attribute::AGILITY) + powner->getAttribute(Ego::Attribute::INTELLECT) ) > 50 )
+            if ( powner->canSeeObject(*pthief) || detection <= 5 || ( detection - pthief->getAttribute(Ego::Attribute::AGILITY) + powner->getAttribute(Ego::Attribute::INTELLECT) ) > 50 )
             {
                 ai_state_add_order(powner->ai, Passage::SHOP_STOLEN, Passage::SHOP_THEFT);
                 powner->ai.target = ithief;
@@ -3728,7 +3935,7 @@ bool can_grab_item_in_shop( const CHR_REF ichr, const CHR_REF iitem )
     if ( INGAME_PCHR( pkeeper ) )
     {
         // check for a stealthy pickup
-        is_invis  = !pkeeper->canSeeObject(pchr);
+        is_invis  = !pkeeper->canSeeObject(*pchr);
 
         // pets are automatically stealthy
         can_steal = is_invis || pchr->isItem();
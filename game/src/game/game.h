@@ -162,6 +162,9 @@ bool upload_animtile_data( animtile_instance_t dst[], const wawalite_animtile_t*
 
 int update_game();
 
+/// Reset the times measured by update_game()
+void game_reset_update_times();
+
 //--------------------------------------------------------------------------------------------
 
 /// The actual in-game state of the damage tiles
@@ -377,6 +380,22 @@ struct status_list_t
 	}
 };
 
+//--------------------------------------------------------------------------------------------
+
+/// The time, in seconds, spent in the parts of update_game() since game_reset_update_times()
+struct update_times_t
+{
+    double scripts;     ///< let_all_characters_think()
+    double movement;    ///< updating and moving the characters
+    double collision;   ///< bump_all_objects()
+    double particles;   ///< updating and moving the particles
+    double enchants;    ///< updating and cleaning up the enchants
+
+	update_times_t()
+		: scripts(0.0), movement(0.0), collision(0.0), particles(0.0), enchants(0.0) {
+	}
+};
+
 //--------------------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------------------
 
@@ -405,6 +424,8 @@ extern Uint32          clock_chr_stat;        ///< For enchant stat regeneration
 extern Uint32          clock_pit;             ///< For pit kills
 extern Uint32          update_wld;            ///< The number of times the game has been updated
 
+extern update_times_t  update_times;
+
 //--------------------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------------------
 
@@ -36,6 +36,8 @@
 #include "game/player.h"
 #include "game/collision.h"
 #include "egolib/Script/script.h"
+#include "egolib/AI/FlowField.h"
+#include "egolib/AI/BlockGraph.h"
 #include "game/input.h"
 #include "game/script_compile.h"
 #include "game/game.h"
@@ -394,6 +396,38 @@ void GFX::uninitialize()
     GFX::uninitializeSDLGraphics();
 }
 
+void GFX::initializeHeadless()
+{
+    // Start-up the texture manager, without OpenGL.
+    setTextureUploadEnabled(false);
+    TextureManager::initialize();
+    Ego::FontManager::initialize();
+
+    // begin the billboard system
+    BillboardSystem::initialize();
+
+    // Initialize the texture atlas manager.
+    TextureAtlasManager::initialize();
+
+    // The cameras are set up for the configured resolution, as if there was a window.
+    sdl_scr.x = egoboo_config_t::get().graphic_resolution_horizontal.getValue();
+    sdl_scr.y = egoboo_config_t::get().graphic_resolution_vertical.getValue();
+    GFX_WIDTH = (float)GFX_HEIGHT / (float)sdl_scr.y * (float)sdl_scr.x;
+}
+
+void GFX::uninitializeHeadless()
+{
+    // End the billboard system.
+    BillboardSystem::uninitialize();
+
+    // Uninitialize the texture atlas manager.
+    TextureAtlasManager::uninitialize();
+
+    Ego::FontManager::uninitialize();
+    TextureManager::uninitialize();
+    setTextureUploadEnabled(true);
+}
+
 void GFX::uninitializeOpenGL()
 {
     TextureManager::uninitialize();
@@ -615,6 +649,8 @@ void gfx_system_main()
     /// @author ZZ
     /// @details This function does all the drawing stuff
 
+    mad_reset_render_stats();
+
     CameraSystem::get()->renderAll(gfx_system_render_world);
 
     draw_hud();
@@ -748,9 +784,7 @@ void gfx_system_make_enviro()
     // Find the environment map positions
     for (size_t i = 0; i < EGO_NORMAL_COUNT; ++i)
     {
-        float x = MD2Model::getMD2Normal(i, 0);
-        float y = MD2Model::getMD2Normal(i, 1);
-        indextoenvirox[i] = std::atan2(y, x) * Ego::Math::invTwoPi<float>();
+        indextoenvirox[i] = MD2Model::getMD2EnviroX(i);
     }
 
     for (size_t i = 0; i < 256; ++i)
@@ -1340,6 +1374,21 @@ float draw_debug(float y)
         y = draw_string_raw(0, y, "!!!DEBUG MODE-6!!!");
         y = draw_string_raw(0, y, "~~FREEPRT %" PRIuZ, ParticleHandler::get().getFreeCount());
         y = draw_string_raw(0, y, "~~FREECHR %" PRIuZ, OBJECTS_MAX - _currentModule->getObjectHandler().getObjectCount());
+        y = draw_string_raw(0, y, "~~QUADTREE REINSERT %" PRIuZ, _currentModule->getObjectHandler().getQuadTreeReinsertions());
+        y = draw_string_raw(0, y, "~~AI RUN %" PRIuZ " SKIP %" PRIuZ, scr_get_run_count(), scr_get_skip_count());
+        y = draw_string_raw(0, y, "~~BROADPHASE %s PAIRS %" PRIuZ " TIME %.3f MS",
+                            Ego::CollisionBroadPhase::SweepAndPrune == egoboo_config_t::get().debug_collision_broadPhase.getValue() ? "SAP" : "BSP",
+                            CollisionSystem::get()->_broadphase_pairs, CollisionSystem::get()->_broadphase_time * 1000.0);
+        const TextureManager::StreamingStats& streaming = TextureManager::get().getStreamingStats();
+        y = draw_string_raw(0, y, "~~TEXSTREAM PENDING %" PRIuZ " UPLOAD %" PRIuZ "KB MAX %" PRIuZ "KB LATENCY %.1f MS MAX %.1f MS",
+                            streaming.pending, streaming.frameBytes / 1024, streaming.maxFrameBytes / 1024,
+                            streaming.averageLatency * 1000.0, streaming.maxLatency * 1000.0);
+        const mad_render_stats_t& madStats = mad_get_render_stats();
+        y = draw_string_raw(0, y, "~~MAD DRAWS %" PRIuZ " STREAMED %" PRIuZ "KB", madStats.draws, madStats.bytesStreamed / 1024);
+        const FlowField_Stats_t pathStats = FlowField_get_stats();
+        y = draw_string_raw(0, y, "~~FLOWFIELD BUILDS %" PRIuZ " PATHS %" PRIuZ "/%" PRIuZ, pathStats.builds, pathStats.served, pathStats.requests);
+        const BlockGraph_Stats_t blockStats = BlockGraph_get_stats();
+        y = draw_string_raw(0, y, "~~BLOCKGRAPH BUILDS %" PRIuZ " REFRESHED %" PRIuZ " PATHS %" PRIuZ, blockStats.builds, blockStats.refreshedBlocks, blockStats.paths);
 #if 0
         y = draw_string_raw( 0, y, "~~MACHINE %d", egonet_get_local_machine() );
 #endif
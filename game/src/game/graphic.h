@@ -394,6 +394,18 @@ struct GFX
      *  Rename to @a uninitialize.
      */
     static void uninitialize();
+    /**
+     * @brief
+     *  Initialize the parts of the GFX system a module needs to run without a window or an OpenGL context.
+     * @remark
+     *  The textures are not uploaded, see setTextureUploadEnabled(). Nothing can be drawn.
+     */
+    static void initializeHeadless();
+    /**
+     * @brief
+     *  Uninitialize the GFX system initialized by initializeHeadless().
+     */
+    static void uninitializeHeadless();
 protected:
     /**
      * @brief
@@ -31,6 +31,7 @@
 #include "game/egoboo.h"
 #include "game/char.h"
 #include "egolib/Graphics/MD2Model.hpp"
+#include "egolib/Graphics/MD2Interpolator.hpp"
 #include "egolib/Graphics/ModelDescriptor.hpp"
 
 #include "game/Graphics/CameraSystem.hpp"
@@ -248,6 +249,79 @@ else
 
 */
 
+//--------------------------------------------------------------------------------------------
+
+/// A vertex streamed by render_one_mad_tex(), in the layout of Ego::VertexFormat::P3FC4FT2FN3F
+struct mad_vertex_t
+{
+    float px, py, pz;
+    float r, g, b, a;
+    float s, t;
+    float nx, ny, nz;
+};
+
+static mad_render_stats_t mad_render_stats = { 0, 0 };
+
+/// The vertices of the textured models of a frame are written one after another into this buffer.
+/// Writing wraps to the start of the buffer if a model does not fit behind the previous model,
+/// the buffer only grows if a model does not fit at all. No memory is allocated per draw.
+struct mad_vertex_ring_t
+{
+    std::unique_ptr<Ego::VertexBuffer> buffer;
+    size_t next;
+
+    mad_vertex_ring_t() :
+        buffer(),
+        next(0)
+    {
+        assert(sizeof(mad_vertex_t) == Ego::VertexFormatDescriptor::get<Ego::VertexFormat::P3FC4FT2FN3F>().getVertexSize());
+    }
+
+    static mad_vertex_ring_t& get()
+    {
+        static mad_vertex_ring_t ring;
+        return ring;
+    }
+
+    /// @return space for @a count vertices, starting with the vertex @a first of the buffer
+    mad_vertex_t *reserve(size_t count, size_t& first)
+    {
+        if (!buffer || count > buffer->getNumberOfVertices())
+        {
+            const size_t capacity = std::max<size_t>(16 * 1024, 2 * count);
+            buffer.reset(new Ego::VertexBuffer(capacity, Ego::VertexFormatDescriptor::get<Ego::VertexFormat::P3FC4FT2FN3F>()));
+            next = 0;
+        }
+        if (next + count > buffer->getNumberOfVertices())
+        {
+            next = 0;
+        }
+        first = next;
+        next += count;
+        return static_cast<mad_vertex_t *>(buffer->lock()) + first;
+    }
+
+    void render(size_t first, size_t count)
+    {
+        buffer->unlock();
+        Ego::Renderer::get().render(*buffer, Ego::PrimitiveType::Triangles, first, count);
+
+        mad_render_stats.draws++;
+        mad_render_stats.bytesStreamed += count * sizeof(mad_vertex_t);
+    }
+};
+
+void mad_reset_render_stats()
+{
+    mad_render_stats.draws = 0;
+    mad_render_stats.bytesStreamed = 0;
+}
+
+const mad_render_stats_t& mad_get_render_stats()
+{
+    return mad_render_stats;
+}
+
 //--------------------------------------------------------------------------------------------
 gfx_rv render_one_mad_tex(Camera& camera, const CHR_REF character, GLXvector4f tint, const BIT_FIELD bits)
 {
@@ -286,21 +360,14 @@ gfx_rv render_one_mad_tex(Camera& camera, const CHR_REF character, GLXvector4f t
         base_amb = (255 == pinst->light) ? 0 : (pinst->light * INV_FF);
     }
 
-    // Get the maximum number of vertices per command.
-    size_t vertexBufferCapacity = 0;
-    for (const MD2_GLCommand& glcommand : pmd2->getGLCommands())
+    // Reserve the vertices of the triangle list of the model.
+    const MD2_TriangleList& triangleList = pmd2->getTriangleList();
+    if (triangleList.indices.empty() || pinst->vrt_count != pmd2->getVertexCount())
     {
-        vertexBufferCapacity = std::max(vertexBufferCapacity, glcommand.data.size());
+        return gfx_fail;
     }
-    // Allocate a vertex buffer.
-    struct Vertex
-    {
-        float px, py, pz;
-        float nx, ny, nz;
-        float r, g, b, a;
-        float s, t;
-    };
-    auto vertexBuffer = std::unique_ptr<Vertex[]>(new Vertex[vertexBufferCapacity]);
+    size_t firstVertex = 0;
+    mad_vertex_t *vertices = mad_vertex_ring_t::get().reserve(triangleList.indices.size(), firstVertex);
 
     // save the matrix mode
     glGetIntegerv(GL_MATRIX_MODE, &matrix_mode);
@@ -324,88 +391,68 @@ gfx_rv render_one_mad_tex(Camera& camera, const CHR_REF character, GLXvector4f t
 
     glPushAttrib(GL_CURRENT_BIT);
     {
-        // Render each command
-        for (const MD2_GLCommand& glcommand : pmd2->getGLCommands())
+        // Stream the interpolated vertices of each corner.
+        for (size_t corner = 0; corner < triangleList.indices.size(); ++corner)
         {
-            // Pre-render this command.
-            size_t vertexBufferSize = 0;
-            for (const id_glcmd_packed_t &cmd : glcommand.data)
+            auto& v = vertices[corner];
+            const GLvertex *pvrt = &(pinst->vrt_lst[triangleList.indices[corner]]);
+            v.px = pvrt->pos[XX];
+            v.py = pvrt->pos[YY];
+            v.pz = pvrt->pos[ZZ];
+            v.nx = pvrt->nrm[XX];
+            v.ny = pvrt->nrm[YY];
+            v.nz = pvrt->nrm[ZZ];
+
+            // Determine the texture coordinates.
+            v.s = triangleList.texCoords[corner][SS] + uoffset;
+            v.t = triangleList.texCoords[corner][TT] + voffset;
+
+            // Perform lighting.
+            if (HAS_NO_BITS(bits, CHR_LIGHT))
             {
-                Uint16 vertexIndex = cmd.index;
-                if (vertexIndex >= pinst->vrt_count)
-                {
-                    continue;
-                }
-                auto& v = vertexBuffer[vertexBufferSize++];
-                GLvertex *pvrt = &(pinst->vrt_lst[vertexIndex]);
-                v.px = pvrt->pos[XX];
-                v.py = pvrt->pos[YY];
-                v.pz = pvrt->pos[ZZ];
-                v.nx = pvrt->nrm[XX];
-                v.ny = pvrt->nrm[YY];
-                v.nz = pvrt->nrm[ZZ];
-
-                // Determine the texture coordinates.
-                v.s = cmd.s + uoffset;
-                v.t = cmd.t + voffset;
-
-                // Perform lighting.
-                if (HAS_NO_BITS(bits, CHR_LIGHT))
-                {
-                    // The directional lighting.
-                    float fcol = pvrt->color_dir * INV_FF;
+                // The directional lighting.
+                float fcol = pvrt->color_dir * INV_FF;
 
-                    v.r = fcol;
-                    v.g = fcol;
-                    v.b = fcol;
-                    v.a = 1.0f;
+                v.r = fcol;
+                v.g = fcol;
+                v.b = fcol;
+                v.a = 1.0f;
 
-                    // Ambient lighting.
-                    if (HAS_NO_BITS(bits, CHR_PHONG))
-                    {
-                        // Convert the "light" parameter to self-lighting for
-                        // every object that is not being rendered using CHR_LIGHT.
+                // Ambient lighting.
+                if (HAS_NO_BITS(bits, CHR_PHONG))
+                {
+                    // Convert the "light" parameter to self-lighting for
+                    // every object that is not being rendered using CHR_LIGHT.
 
-                        float acol = base_amb + pinst->color_amb * INV_FF;
+                    float acol = base_amb + pinst->color_amb * INV_FF;
 
-                        v.r += acol;
-                        v.g += acol;
-                        v.b += acol;
-                    }
+                    v.r += acol;
+                    v.g += acol;
+                    v.b += acol;
+                }
 
-                    // clip the colors
-                    v.r = Ego::Math::constrain(v.r, 0.0f, 1.0f);
-                    v.g = Ego::Math::constrain(v.g, 0.0f, 1.0f);
-                    v.b = Ego::Math::constrain(v.b, 0.0f, 1.0f);
+                // clip the colors
+                v.r = Ego::Math::constrain(v.r, 0.0f, 1.0f);
+                v.g = Ego::Math::constrain(v.g, 0.0f, 1.0f);
+                v.b = Ego::Math::constrain(v.b, 0.0f, 1.0f);
 
-                    // tint the object
-                    v.r *= tint[RR];
-                    v.g *= tint[GG];
-                    v.b *= tint[BB];
-                }
-                else
-                {
-                    // Set the basic tint.
-                    v.r = tint[RR];
-                    v.g = tint[GG];
-                    v.b = tint[BB];
-                    v.a = tint[AA];
-                }
+                // tint the object
+                v.r *= tint[RR];
+                v.g *= tint[GG];
+                v.b *= tint[BB];
             }
-            // Render this command.
-            glBegin(glcommand.glMode);
+            else
             {
-                for (size_t vertexIndex = 0; vertexIndex < vertexBufferSize; ++vertexIndex)
-                {
-                    const auto& v = vertexBuffer[vertexIndex];
-                    glColor4f(v.r, v.g, v.b, v.a);
-                    glNormal3f(v.nx, v.ny, v.nz);
-                    glTexCoord2f(v.s, v.t);
-                    glVertex3f(v.px, v.py, v.pz);
-                }
+                // Set the basic tint.
+                v.r = tint[RR];
+                v.g = tint[GG];
+                v.b = tint[BB];
+                v.a = tint[AA];
             }
-            glEnd();
         }
+
+        // Render all commands with a single draw call.
+        mad_vertex_ring_t::get().render(firstVertex, triangleList.indices.size());
     }
     glPopAttrib();
 
@@ -1144,80 +1191,16 @@ gfx_rv chr_instance_t::needs_update(chr_instance_t& self, int vmin, int vmax, bo
     return (!(*verts_match) || !( *frames_match )) ? gfx_success : gfx_fail;
 }
 
-void chr_instance_t::interpolate_vertices_raw( GLvertex dst_ary[], const std::vector<MD2_Vertex> &lst_ary, const std::vector<MD2_Vertex> &nxt_ary, int vmin, int vmax, float flip )
+void chr_instance_t::interpolate_vertices_raw( GLvertex dst_ary[], const MD2_FrameArrays &lst_ary, const MD2_FrameArrays &nxt_ary, int vmin, int vmax, float flip )
 {
     /// raw indicates no bounds checking, so be careful
 
-    int i;
-
-    GLvertex     * dst;
-
-    if ( 0.0f == flip )
-    {
-        for ( i = vmin; i <= vmax; i++ )
-        {
-            dst     = dst_ary + i;
-            const MD2_Vertex &srcLast = lst_ary[i];
+    static_assert(offsetof(GLvertex, pos) == offsetof(MD2_InterpolatedVertex, pos) &&
+                  offsetof(GLvertex, nrm) == offsetof(MD2_InterpolatedVertex, nrm) &&
+                  offsetof(GLvertex, env) == offsetof(MD2_InterpolatedVertex, env),
+                  "GLvertex must begin with the layout of MD2_InterpolatedVertex");
 
-			dst->pos[XX] = srcLast.pos[kX];
-			dst->pos[YY] = srcLast.pos[kY];
-			dst->pos[ZZ] = srcLast.pos[kZ];
-            dst->pos[WW] = 1.0f;
-
-			dst->nrm[XX] = srcLast.nrm[kX];
-			dst->nrm[YY] = srcLast.nrm[kY];
-			dst->nrm[ZZ] = srcLast.nrm[kZ];
-
-            dst->env[XX] = indextoenvirox[srcLast.normal];
-            dst->env[YY] = 0.5f * ( 1.0f + dst->nrm[ZZ] );
-        }
-    }
-    else if ( 1.0f == flip )
-    {
-        for ( i = vmin; i <= vmax; i++ )
-        {
-            dst     = dst_ary + i;
-            const MD2_Vertex &srcNext = nxt_ary[i];
-
-			dst->pos[XX] = srcNext.pos[kX];
-			dst->pos[YY] = srcNext.pos[kY];
-			dst->pos[ZZ] = srcNext.pos[kZ];
-            dst->pos[WW] = 1.0f;
-
-            dst->nrm[XX] = srcNext.nrm[kX];
-            dst->nrm[YY] = srcNext.nrm[kY];
-            dst->nrm[ZZ] = srcNext.nrm[kZ];
-
-            dst->env[XX] = indextoenvirox[srcNext.normal];
-            dst->env[YY] = 0.5f * ( 1.0f + dst->nrm[ZZ] );
-        }
-    }
-    else
-    {
-        Uint16 vrta_lst, vrta_nxt;
-
-        for ( i = vmin; i <= vmax; i++ )
-        {
-            dst     = dst_ary + i;
-            const MD2_Vertex &srcLast = lst_ary[i];
-            const MD2_Vertex &srcNext = nxt_ary[i];
-
-            dst->pos[XX] = srcLast.pos[kX] + ( srcNext.pos[kX] - srcLast.pos[kX] ) * flip;
-            dst->pos[YY] = srcLast.pos[kY] + ( srcNext.pos[kY] - srcLast.pos[kY] ) * flip;
-            dst->pos[ZZ] = srcLast.pos[kZ] + ( srcNext.pos[kZ] - srcLast.pos[kZ] ) * flip;
-            dst->pos[WW] = 1.0f;
-
-            dst->nrm[XX] = srcLast.nrm[kX] + ( srcNext.nrm[kX] - srcLast.nrm[kX] ) * flip;
-            dst->nrm[YY] = srcLast.nrm[kY] + ( srcNext.nrm[kY] - srcLast.nrm[kY] ) * flip;
-            dst->nrm[ZZ] = srcLast.nrm[kZ] + ( srcNext.nrm[kZ] - srcLast.nrm[kZ] ) * flip;
-
-            vrta_lst = srcLast.normal;
-            vrta_nxt = srcNext.normal;
-
-            dst->env[XX] = indextoenvirox[vrta_lst] + ( indextoenvirox[vrta_nxt] - indextoenvirox[vrta_lst] ) * flip;
-            dst->env[YY] = 0.5f * ( 1.0f + dst->nrm[ZZ] );
-        }
-    }
+    MD2Interpolator::interpolate(dst_ary, sizeof(GLvertex), lst_ary, nxt_ary, vmin, vmax, flip);
 }
 
 gfx_rv chr_instance_t::update_vertices(chr_instance_t& self, int vmin, int vmax, bool force)
@@ -1333,13 +1316,13 @@ gfx_rv chr_instance_t::update_vertices(chr_instance_t& self, int vmin, int vmax,
     // interpolate the 1st dirty region
     if ( vdirty1_min >= 0 && vdirty1_max >= 0 )
     {
-		chr_instance_t::interpolate_vertices_raw(self.vrt_lst, lastFrame.vertexList, nextFrame.vertexList, vdirty1_min, vdirty1_max, loc_flip);
+		chr_instance_t::interpolate_vertices_raw(self.vrt_lst, lastFrame.arrays, nextFrame.arrays, vdirty1_min, vdirty1_max, loc_flip);
     }
 
     // interpolate the 2nd dirty region
     if ( vdirty2_min >= 0 && vdirty2_max >= 0 )
     {
-		chr_instance_t::interpolate_vertices_raw(self.vrt_lst, lastFrame.vertexList, nextFrame.vertexList, vdirty2_min, vdirty2_max, loc_flip);
+		chr_instance_t::interpolate_vertices_raw(self.vrt_lst, lastFrame.arrays, nextFrame.arrays, vdirty2_min, vdirty2_max, loc_flip);
     }
 
     // update the saved parameters
@@ -1883,7 +1866,7 @@ gfx_rv chr_instance_t::spawn(chr_instance_t& self, const PRO_REF profileID, cons
 
 BIT_FIELD chr_instance_t::get_framefx(chr_instance_t& self)
 {
-    return chr_instance_t::get_frame_nxt(self).framefx;
+    return self.imad->getFrameFX(self.frame_nxt);
 }
 
 gfx_rv chr_instance_t::set_frame_full(chr_instance_t& self, int frame_along, int ilip, const std::shared_ptr<Ego::ModelDescriptor>& mad_override)
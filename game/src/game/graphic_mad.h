@@ -288,7 +288,7 @@ private:
 	static gfx_rv needs_update(chr_instance_t& self, int vmin, int vmax, bool *verts_match, bool *frames_match);
 	static gfx_rv set_frame(chr_instance_t& self, int frame);
 	static void clear_cache(chr_instance_t& self);
-	static void interpolate_vertices_raw(GLvertex dst_ary[], const std::vector<MD2_Vertex> &lst_ary, const std::vector<MD2_Vertex> &nxt_ary, int vmin, int vmax, float flip);
+	static void interpolate_vertices_raw(GLvertex dst_ary[], const MD2_FrameArrays &lst_ary, const MD2_FrameArrays &nxt_ary, int vmin, int vmax, float flip);
 };
 
 void chr_instance_flash(chr_instance_t& self, Uint8 value);
@@ -304,6 +304,16 @@ void chr_instance_flash(chr_instance_t& self, Uint8 value);
 
 //--------------------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------------------
+/// How many textured models were drawn and how many vertex bytes were streamed for them since the last reset
+struct mad_render_stats_t
+{
+    size_t draws;
+    size_t bytesStreamed;
+};
+
+void mad_reset_render_stats();
+const mad_render_stats_t& mad_get_render_stats();
+
 gfx_rv render_one_mad( Camera& cam, const CHR_REF ichr, GLXvector4f tint, const BIT_FIELD bits );
 gfx_rv render_one_mad_ref( Camera& cam, const CHR_REF ichr );
 gfx_rv render_one_mad_trans( Camera& cam, const CHR_REF ichr );
@@ -23,6 +23,7 @@
 
 #include "egolib/_math.h"
 #include "egolib/bbox.h"
+#include "egolib/AI/BlockGraph.h"
 #include "game/mesh.h"
 #include "game/graphic.h"
 #include "game/egoboo.h"
@@ -305,7 +306,8 @@ ego_mesh_t::ego_mesh_t() :
     info(),
     tmem(),
     gmem(),
-    fxlists()
+    fxlists(),
+    fxRevision(0)
 {
     tile_mem_t::ctor(&tmem);
     grid_mem_t::ctor(&gmem);
@@ -598,6 +600,13 @@ ego_mesh_t * ego_mesh_load( const char *modname, ego_mesh_t * mesh )
     // do some calculation to set up the mpd as a game mesh
     mesh = ego_mesh_t::finalize( mesh );
 
+    // precompute the block graph for the most common pathfinding, the graphs of the previous mesh are stale
+    BlockGraph_clear_cache();
+    if ( NULL != mesh )
+    {
+        BlockGraph_get( mesh, MAPFX_IMPASS | MAPFX_WALL );
+    }
+
     return mesh;
 }
 
@@ -2689,6 +2698,7 @@ bool ego_mesh_clear_fx( ego_mesh_t * mesh, const TileIndex& itile, const BIT_FIE
     if ( retval )
     {
         mesh->fxlists.dirty = true;
+        mesh->fxRevision++;
     }
 
     return retval;
@@ -2717,6 +2727,7 @@ bool ego_mesh_add_fx(ego_mesh_t *self, const TileIndex& index, const BIT_FIELD f
     if ( retval )
     {
         self->fxlists.dirty = true;
+        self->fxRevision++;
     }
 
     return retval;
@@ -549,6 +549,10 @@ public:
     grid_mem_t gmem;
     mpdfx_lists_t fxlists;
 
+    /// Incremented whenever ego_mesh_add_fx() or ego_mesh_clear_fx() change the fx bits of a tile,
+    /// so that data derived from the passability of the tiles can tell that it is stale.
+    Uint32 fxRevision;
+
     static fvec3_t get_diff(const ego_mesh_t *self, const fvec3_t& pos, float radius, float center_pressure, const BIT_FIELD bits);
     static float get_pressure(const ego_mesh_t *self, const fvec3_t& pos, float radius, const BIT_FIELD bits);
     static bool remove_ambient(ego_mesh_t *self);
@@ -23,6 +23,7 @@
 ///          Networked play doesn't really work at the moment.
 
 #include "game/network.h"
+#include "game/replay.h"
 #include "game/input.h"
 #include "game/game.h"
 #include "game/player.h"
@@ -145,6 +146,9 @@ void net_unbuffer_player_latches()
         ppla->net_latch = tmp_latch;
     }
 
+    // record the latches or replace them by a recording
+    replay_update_player_latches();
+
     // set the player latch
     for (PLA_REF ipla = 0; ipla < MAX_PLAYER; ++ipla)
     {
@@ -0,0 +1,224 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+
+/// @file  game/replay.c
+/// @brief Recording and replaying the input of the players.
+
+#include "game/replay.h"
+#include "game/player.h"
+#include "game/game.h"
+#include "egolib/FileFormats/module_bundle_file.h"
+
+//--------------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------------
+
+namespace
+{
+/// A change of the latch of a player
+struct LatchChange
+{
+    Uint32 update;
+    Uint32 player;
+    latch_t latch;
+};
+
+struct Replay
+{
+    Ego::InputRecording mode;        ///< The mode of the current module
+    std::string pathname;
+
+    std::vector<char> data;          ///< The recorded data
+    size_t offset;                   ///< The offset of the next change when replaying
+
+    bool hasNext;                    ///< Is there a change which was not applied yet?
+    LatchChange next;
+    Uint32 endUpdate;                ///< The last update recorded
+
+    latch_t latches[MAX_PLAYER];     ///< The latches recorded or replayed last
+
+    Replay() :
+        mode(Ego::InputRecording::Off),
+        pathname(),
+        data(),
+        offset(0),
+        hasNext(false),
+        next(),
+        endUpdate(0),
+        latches()
+    {
+    }
+};
+
+Replay replay;
+
+bool readChange()
+{
+    bundle_reader_t reader( replay.data.data() + replay.offset, replay.data.size() - replay.offset );
+    replay.next.update = reader.readUint32();
+    replay.next.player = reader.readUint32();
+    replay.next.latch.x = reader.readFloat();
+    replay.next.latch.y = reader.readFloat();
+    replay.next.latch.b = std::bitset<32>( reader.readUint32() );
+
+    replay.hasNext = reader.isGood() && replay.next.player < MAX_PLAYER;
+    replay.offset += reader.getOffset();
+    if ( reader.isGood() && INPUT_RECORDING_END == replay.next.player )
+    {
+        replay.endUpdate = replay.next.update;
+    }
+    return replay.hasNext;
+}
+}
+
+//--------------------------------------------------------------------------------------------
+void replay_begin_module( const std::string& moduleName, Uint32 *seed )
+{
+    replay = Replay();
+    replay.mode = egoboo_config_t::get().debug_inputRecording_mode.getValue();
+    replay.pathname = egoboo_config_t::get().debug_inputRecording_file.getValue();
+
+    if ( Ego::InputRecording::Record == replay.mode )
+    {
+        bundle_writer_t writer( replay.data );
+        writer.writeUint32( INPUT_RECORDING_ID );
+        writer.writeUint32( CURRENT_INPUT_RECORDING_VERSION );
+        writer.writeUint32( static_cast<Uint32>( moduleName.size() ) );
+        writer.writeBytes( moduleName.data(), moduleName.size() );
+        writer.writeUint32( *seed );
+
+        log_info( "%s - recording the input of \"%s\" with seed %u to \"%s\"\n", __FUNCTION__, moduleName.c_str(), *seed, replay.pathname.c_str() );
+    }
+    else if ( Ego::InputRecording::Replay == replay.mode )
+    {
+        char *buffer = nullptr;
+        size_t length = 0;
+        if ( !vfs_readEntireFile( replay.pathname, &buffer, &length ) )
+        {
+            log_warning( "%s - cannot read the recording \"%s\"\n", __FUNCTION__, replay.pathname.c_str() );
+            replay.mode = Ego::InputRecording::Off;
+            return;
+        }
+        replay.data.assign( buffer, buffer + length );
+        free( buffer );
+
+        bundle_reader_t reader( replay.data.data(), replay.data.size() );
+        const bool valid = INPUT_RECORDING_ID == reader.readUint32() && CURRENT_INPUT_RECORDING_VERSION == reader.readUint32();
+        std::string recordedName( valid ? reader.readCount( 1 ) : 0, '\0' );
+        reader.readBytes( &recordedName[0], recordedName.size() );
+        const Uint32 recordedSeed = reader.readUint32();
+
+        if ( !valid || !reader.isGood() )
+        {
+            log_warning( "%s - \"%s\" is not a recording of this version\n", __FUNCTION__, replay.pathname.c_str() );
+            replay.mode = Ego::InputRecording::Off;
+            return;
+        }
+        if ( recordedName != moduleName )
+        {
+            log_warning( "%s - \"%s\" is a recording of \"%s\", not of \"%s\"\n", __FUNCTION__, replay.pathname.c_str(), recordedName.c_str(), moduleName.c_str() );
+            replay.mode = Ego::InputRecording::Off;
+            return;
+        }
+
+        *seed = recordedSeed;
+        replay.offset = reader.getOffset();
+        readChange();
+
+        log_info( "%s - replaying the input of \"%s\" with seed %u from \"%s\"\n", __FUNCTION__, moduleName.c_str(), *seed, replay.pathname.c_str() );
+    }
+}
+
+//--------------------------------------------------------------------------------------------
+void replay_update_player_latches()
+{
+    if ( Ego::InputRecording::Record == replay.mode )
+    {
+        // only the changes are recorded
+        bundle_writer_t writer( replay.data );
+        for ( PLA_REF ipla = 0; ipla < MAX_PLAYER; ++ipla )
+        {
+            if ( !PlaStack.lst[ipla].valid ) continue;
+
+            const latch_t& latch = PlaStack.lst[ipla].net_latch;
+            latch_t& recorded = replay.latches[ipla];
+            if ( latch.x == recorded.x && latch.y == recorded.y && latch.b == recorded.b ) continue;
+
+            writer.writeUint32( update_wld );
+            writer.writeUint32( ipla );
+            writer.writeFloat( latch.x );
+            writer.writeFloat( latch.y );
+            writer.writeUint32( static_cast<Uint32>( latch.b.to_ulong() ) );
+            recorded = latch;
+        }
+    }
+    else if ( Ego::InputRecording::Replay == replay.mode )
+    {
+        // apply the changes up to this update, the local input is ignored
+        while ( replay.hasNext && replay.next.update <= update_wld )
+        {
+            replay.latches[replay.next.player] = replay.next.latch;
+            replay.endUpdate = std::max( replay.endUpdate, replay.next.update );
+            readChange();
+        }
+
+        for ( PLA_REF ipla = 0; ipla < MAX_PLAYER; ++ipla )
+        {
+            if ( !PlaStack.lst[ipla].valid ) continue;
+            PlaStack.lst[ipla].net_latch = replay.latches[ipla];
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------
+void replay_end_module()
+{
+    if ( Ego::InputRecording::Record == replay.mode )
+    {
+        bundle_writer_t writer( replay.data );
+        writer.writeUint32( update_wld );
+        writer.writeUint32( INPUT_RECORDING_END );
+        writer.writeFloat( 0.0f );
+        writer.writeFloat( 0.0f );
+        writer.writeUint32( 0 );
+
+        if ( vfs_writeEntireFile( replay.pathname, replay.data.data(), replay.data.size() ) )
+        {
+            log_info( "%s - recorded %u updates in %" PRIuZ " bytes to \"%s\"\n", __FUNCTION__, update_wld, replay.data.size(), replay.pathname.c_str() );
+        }
+        else
+        {
+            log_warning( "%s - cannot write the recording \"%s\"\n", __FUNCTION__, replay.pathname.c_str() );
+        }
+    }
+
+    replay = Replay();
+}
+
+//--------------------------------------------------------------------------------------------
+bool replay_is_replaying()
+{
+    return Ego::InputRecording::Replay == replay.mode;
+}
+
+//--------------------------------------------------------------------------------------------
+bool replay_is_finished()
+{
+    return Ego::InputRecording::Replay == replay.mode && !replay.hasNext && update_wld >= replay.endUpdate;
+}
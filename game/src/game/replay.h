@@ -0,0 +1,70 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+
+/// @file  game/replay.h
+/// @brief Recording and replaying the input of the players.
+/// @details A recording stores the module name, the random seed of the module and every change
+///          of a player latch with the update in which it was applied. Replaying it feeds the same
+///          latches to the same updates, so a session can be re-run for benchmarks and regression
+///          checks. The mode and the file are set with debug.inputRecording.mode and .file.
+///
+///          header:  Uint32 id ('EgoR'), Uint32 version, Uint32 name length, module name, Uint32 seed
+///          change:  Uint32 update, Uint32 player, float x, float y, Uint32 buttons
+///          end:     a change of the player INPUT_RECORDING_END in the last update recorded
+///
+///          All numbers are stored little-endian. A recording is only correct as long as the
+///          simulation depends on nothing else than the seed and the player latches.
+
+#pragma once
+
+#include "game/egoboo_typedef.h"
+
+//--------------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------------
+
+#   define INPUT_RECORDING_ID               0x52676F45 //'EgoR' in little-endian byte order
+#   define CURRENT_INPUT_RECORDING_VERSION  1
+#   define INPUT_RECORDING_END              0xFFFFFFFF
+
+//--------------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------------
+
+/**
+ * @brief
+ *  Start recording or replaying a module, before the module is created.
+ * @param moduleName
+ *  the folder name of the module
+ * @param seed
+ *  the random seed of the module. When replaying, it is replaced by the recorded seed.
+ */
+void replay_begin_module( const std::string& moduleName, Uint32 *seed );
+
+/// Record the player latches of this update or replace them by the recorded ones.
+/// Called by net_unbuffer_player_latches() before the latches are given to the characters.
+void replay_update_player_latches();
+
+/// Stop recording or replaying. A recording is saved.
+void replay_end_module();
+
+/// @return @a true if the current module is replayed
+bool replay_is_replaying();
+
+/// @return @a true if the current module is replayed and the last recorded update has passed
+bool replay_is_finished();
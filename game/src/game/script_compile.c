@@ -1225,6 +1225,7 @@ static void         emit_opcode( token_t * ptok, const BIT_FIELD highbits, scrip
 static void         parse_line_by_line( parser_state_t * ps, ObjectProfile *ppro, script_info_t *pscript );
 static Uint32       jump_goto( int index, int index_end, script_info_t *pscript );
 static void         parse_jumps( script_info_t *pscript );
+static void         parse_sensitivity( script_info_t *pscript );
 static egolib_rv    ai_script_upload_default( script_info_t *pscript );
 
 
@@ -2076,6 +2077,101 @@ void parse_jumps( script_info_t *pscript )
     }
 }
 
+//--------------------------------------------------------------------------------------------
+void parse_sensitivity( script_info_t *pscript )
+{
+    /// @details This function determines which alerts and timers a script reacts to.
+    ///    A failing function at the top level jumps to the next top level instruction, so
+    ///    if the top level consists of alert and timer checks only, nothing else can run
+    ///    unless one of them passes.
+
+    static const struct { Uint32 code; chr_alert_bits alert; } alert_checks[] =
+    {
+        { FIFSPAWNED,        ALERTIF_SPAWNED },
+        { FIFATWAYPOINT,     ALERTIF_ATWAYPOINT },
+        { FIFATLASTWAYPOINT, ALERTIF_ATLASTWAYPOINT },
+        { FIFATTACKED,       ALERTIF_ATTACKED },
+        { FIFBUMPED,         ALERTIF_BUMPED },
+        { FIFORDERED,        ALERTIF_ORDERED },
+        { FIFCALLEDFORHELP,  ALERTIF_CALLEDFORHELP },
+        { FIFKILLED,         ALERTIF_KILLED },
+        { FIFHEALED,         ALERTIF_HEALED },
+        { FIFGRABBED,        ALERTIF_GRABBED },
+        { FIFDROPPED,        ALERTIF_DROPPED },
+        { FIFREAFFIRMED,     ALERTIF_REAFFIRMED },
+        { FIFLEADERKILLED,   ALERTIF_LEADERKILLED },
+        { FIFUSED,           ALERTIF_USED },
+        { FIFCLEANEDUP,      ALERTIF_CLEANEDUP },
+        { FIFSCOREDAHIT,     ALERTIF_SCOREDAHIT },
+        { FIFDISAFFIRMED,    ALERTIF_DISAFFIRMED },
+        { FIFCHANGED,        ALERTIF_CHANGED },
+        { FIFINWATER,        ALERTIF_INWATER },
+        { FIFBORED,          ALERTIF_BORED },
+        { FIFTOOMUCHBAGGAGE, ALERTIF_TOOMUCHBAGGAGE },
+        { FIFNOTDROPPED,     ALERTIF_NOTDROPPED },
+        { FIFBLOCKED,        ALERTIF_BLOCKED },
+        { FIFHITGROUND,      ALERTIF_HITGROUND },
+        { FIFTHROWN,         ALERTIF_THROWN },
+        { FIFCRUSHED,        ALERTIF_CRUSHED },
+        { FIFNOTPUTAWAY,     ALERTIF_NOTPUTAWAY },
+        { FIFTAKENOUT,       ALERTIF_TAKENOUT },
+        { FIFHITVULNERABLE,  ALERTIF_HITVULNERABLE },
+        { FIFLEVELUP,        ALERTIF_LEVELUP }
+    };
+
+    Uint32 index, index_end;
+    Uint32 value, code;
+
+    pscript->alert_sensitivity = ALERT_NONE;
+    pscript->timer_sensitive   = false;
+    pscript->has_unconditional = false;
+
+    index     = 0;
+    index_end = pscript->length;
+    while ( index < index_end )
+    {
+        value = pscript->data[index];
+
+        if ( HAS_SOME_BITS( value, FUNCTION_BIT ) )
+        {
+            if ( 0 == GET_DATA_BITS( value ) )
+            {
+                code = value & VALUE_BITS;
+
+                if ( FIFTIMEOUT == code )
+                {
+                    pscript->timer_sensitive = true;
+                }
+                else if ( FEND != code )
+                {
+                    // End() only stops the script, anything else we do not know must be run
+                    bool found = false;
+                    for ( size_t i = 0; i < SDL_arraysize( alert_checks ); ++i )
+                    {
+                        if ( alert_checks[i].code == code )
+                        {
+                            SET_BIT( pscript->alert_sensitivity, alert_checks[i].alert );
+                            found = true;
+                            break;
+                        }
+                    }
+                    if ( !found ) pscript->has_unconditional = true;
+                }
+            }
+            index += 2;
+        }
+        else
+        {
+            // operations at the top level always run
+            if ( 0 == GET_DATA_BITS( value ) ) pscript->has_unconditional = true;
+
+            index++;
+            if ( index >= index_end ) break;
+            index += 1 + pscript->data[index];
+        }
+    }
+}
+
 //--------------------------------------------------------------------------------------------
 bool load_ai_codes_vfs()
 {
@@ -2105,11 +2201,14 @@ egolib_rv ai_script_upload_default( script_info_t * pscript )
     strncpy( pscript->name, default_ai_script.name, sizeof( STRING ) );
     memcpy( pscript->data, default_ai_script.data, sizeof( pscript->data ) );
 
-    pscript->indent = 0;
-    pscript->indent_last = 0;
-
     pscript->length = default_ai_script.length;
-    pscript->position = 0;
+
+    pscript->instructions = default_ai_script.instructions;
+    pscript->operands = default_ai_script.operands;
+
+    pscript->alert_sensitivity = default_ai_script.alert_sensitivity;
+    pscript->timer_sensitive = default_ai_script.timer_sensitive;
+    pscript->has_unconditional = default_ai_script.has_unconditional;
 
     return rv_success;
 }
@@ -2165,6 +2264,12 @@ egolib_rv load_ai_script_vfs( parser_state_t * ps, const char *loadname, ObjectP
     // determine the correct jumps
     parse_jumps( pscript );
 
+    // determine what can trigger the script
+    parse_sensitivity( pscript );
+
+    // pre-decode the compiled script for faster execution
+    scr_decode_script( pscript );
+
     return rv_success;
 }
 
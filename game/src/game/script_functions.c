@@ -966,7 +966,7 @@ Uint8 scr_Else( script_state_t * pstate, ai_state_t * pself )
 
     SCRIPT_FUNCTION_BEGIN();
 
-    returncode = ( ppro->getAIScript().indent >= ppro->getAIScript().indent_last );
+    returncode = ( pstate->indent >= pstate->indent_last );
 
     SCRIPT_FUNCTION_END();
 }
@@ -28,6 +28,8 @@
 #include "game/script_implementation.h"
 #include "game/game.h"
 #include "egolib/AI/AStar.h"
+#include "egolib/AI/FlowField.h"
+#include "egolib/AI/BlockGraph.h"
 #include "egolib/Graphics/ModelDescriptor.hpp"
 #include "game/renderer_2d.h"
 #include "game/Entities/_Include.hpp"
@@ -414,10 +416,34 @@ bool FindPath( waypoint_list_t * plst, Object * pchr, float dst_x, float dst_y,
 #ifdef DEBUG_ASTAR
         printf( "Finding a path from %d,%d to %d,%d: \n", src_ix, src_iy, dst_ix, dst_iy );
 #endif
-        //Try to find a path with the AStar algorithm
-        if ( AStar_find_path( _currentModule->getMeshPointer(), pchr->stoppedby, src_ix, src_iy, dst_ix, dst_iy ) )
+        ego_mesh_t *mesh = _currentModule->getMeshPointer();
+        AStar_ScopedContext context;
+
+        //Agents chasing the same goal follow a shared flow field
+        bool followed = false;
+        std::shared_ptr<const FlowField_t> field = FlowField_find( mesh, pchr->stoppedby, dst_ix, dst_iy, update_wld );
+        if ( field && FlowField_get_path( *field, mesh, src_ix, src_iy, *context ) )
         {
-            returncode = AStar_get_path( dst_x, dst_y, plst );
+            followed = true;
+            returncode = AStar_get_path( *context, dst_x, dst_y, plst );
+        }
+
+        //otherwise, e.g. if the agent stands on a tile the field does not reach, try to find a path with the AStar algorithm
+        if ( !followed )
+        {
+            //Long paths are planned over the blocks of the mesh first
+            bool planned = false;
+            if ( std::abs( src_ix - dst_ix ) + std::abs( src_iy - dst_iy ) >= BLOCKGRAPH_MIN_DISTANCE )
+            {
+                std::shared_ptr<const BlockGraph_t> graph = BlockGraph_get( mesh, pchr->stoppedby );
+                planned = BlockGraph_find_path( *graph, src_ix, src_iy, dst_ix, dst_iy, *context );
+            }
+
+            if ( planned || AStar_find_path( *context, mesh, pchr->stoppedby, src_ix, src_iy, dst_ix, dst_iy,
+                                             egoboo_config_t::get().game_pathfinding_nodeBudget.getValue() ) )
+            {
+                returncode = AStar_get_path( *context, dst_x, dst_y, plst );
+            }
         }
 
         if ( NULL != used_astar_ptr )